@@ -0,0 +1,960 @@
+#include "BlockDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+using namespace DX;
+using namespace DX::BlockDecoder;
+
+namespace
+{
+	// One block per 16 bytes, with pshufb emulated byte by byte.
+	struct Scalar
+	{
+		static const size_t Blocks = 1;
+		struct V { uint8_t b[16]; };
+
+		static V Load(const void* p) { V a; memcpy(a.b, p, 16); return a; }
+		static V LoadLanes(const uint8_t* const (&lanes)[1]) { return Load(lanes[0]); }
+		static V Broadcast(const uint8_t* p) { return Load(p); }
+		static void Store(void* p, const V& a) { memcpy(p, a.b, 16); }
+
+		static V Shuffle(const V& table, const V& control)
+		{
+			V result;
+			for (int i = 0; i < 16; i++)
+			{
+				result.b[i] = (control.b[i] & 0x80) ? 0 : table.b[control.b[i] & 15];
+			}
+			return result;
+		}
+		static V And(const V& a, const V& b)
+		{
+			V result;
+			for (int i = 0; i < 16; i++)
+			{
+				result.b[i] = a.b[i] & b.b[i];
+			}
+			return result;
+		}
+		static V Or(const V& a, const V& b)
+		{
+			V result;
+			for (int i = 0; i < 16; i++)
+			{
+				result.b[i] = a.b[i] | b.b[i];
+			}
+			return result;
+		}
+	};
+
+#include "BlockDecoderKernel.h"
+
+	// Block rows per ParallelFor item aim at this many blocks.
+	const size_t BlocksPerItem = 2048;
+
+	const uint16_t HalfOne = 0x3c00;
+
+	// BC7's 64 two-subset partitions (bit i is texel i's subset) and 64 three-subset ones
+	// (two bits per texel), the first 32 of the former shared with BC6H.
+	const uint16_t Partitions2[64] =
+	{
+		0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+		0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+		0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+		0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+	};
+
+	const uint32_t Partitions3[64] =
+	{
+		0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+		0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+		0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+		0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+		0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+		0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+		0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+		0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254
+	};
+
+	// The texel holding each subset's anchor index, which is stored a bit short (texel 0
+	// anchors subset 0 everywhere).
+	const uint8_t Anchors2[64] =
+	{
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+		15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+		6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+	};
+
+	const uint8_t Anchors3Second[64] =
+	{
+		3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+		3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+		8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+		3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3
+	};
+
+	const uint8_t Anchors3Third[64] =
+	{
+		15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+		15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+		15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+		15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8
+	};
+
+	// Interpolation weights out of 64 for 2-, 3- and 4-bit indices.
+	const uint8_t Weights2[4] = { 0, 21, 43, 64 };
+	const uint8_t Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	const uint8_t Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	const uint8_t* GetWeights(unsigned int indexBits)
+	{
+		return indexBits == 2 ? Weights2 : indexBits == 3 ? Weights3 : Weights4;
+	}
+
+	// A 128-bit block, read from its lowest bit up.
+	class BlockBits
+	{
+	public:
+		explicit BlockBits(const uint8_t* block) : m_low(0), m_high(0), m_position(0)
+		{
+			for (int i = 0; i < 8; i++)
+			{
+				m_low |= static_cast<uint64_t>(block[i]) << (8 * i);
+				m_high |= static_cast<uint64_t>(block[8 + i]) << (8 * i);
+			}
+		}
+
+		uint32_t Read(unsigned int count)
+		{
+			if (count == 0)
+			{
+				return 0;
+			}
+			uint64_t bits;
+			if (m_position >= 64)
+			{
+				bits = m_high >> (m_position - 64);
+			}
+			else
+			{
+				bits = m_low >> m_position;
+				if (m_position + count > 64)
+				{
+					bits |= m_high << (64 - m_position);
+				}
+			}
+			m_position += count;
+			return static_cast<uint32_t>(bits & ((1ull << count) - 1));
+		}
+
+	private:
+		uint64_t		m_low;
+		uint64_t		m_high;
+		unsigned int	m_position;
+	};
+
+	struct BC7Mode
+	{
+		uint8_t	subsets;
+		uint8_t	partitionBits;
+		uint8_t	rotationBits;
+		uint8_t	indexSelectionBits;
+		uint8_t	colorBits;
+		uint8_t	alphaBits;				// 0 for opaque modes
+		uint8_t	endpointPBits;			// a p-bit per endpoint
+		uint8_t	sharedPBits;			// a p-bit per subset
+		uint8_t	indexBits;
+		uint8_t	secondaryIndexBits;		// modes 4 and 5 index alpha separately
+	};
+
+	const BC7Mode BC7Modes[8] =
+	{
+		{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+		{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+		{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+		{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+		{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+	};
+
+	// Where a BC6H header field's bits go: an endpoint channel (endpoint * 3 + channel, with
+	// endpoints w, x, y, z as the spec names them) or the partition, from bit lsb up.
+	enum BC6HTarget : uint8_t
+	{
+		RW, GW, BW, RX, GX, BX, RY, GY, BY, RZ, GZ, BZ, D
+	};
+
+	struct BC6HField
+	{
+		uint8_t	target;
+		uint8_t	lsb;
+		uint8_t	count;
+	};
+
+	// A BC6H mode's header, after its mode bits. Transformed modes store x, y and z as signed
+	// deltas from w.
+	struct BC6HMode
+	{
+		uint8_t		modeBits;
+		uint8_t		subsets;
+		bool		transformed;
+		uint8_t		endpointBits;
+		uint8_t		deltaBits[3];
+		BC6HField	fields[24];
+	};
+
+	const BC6HMode BC6HModes[14] =
+	{
+		{ 0x00, 2, true, 10, { 5, 5, 5 }, {
+			{ GY, 4, 1 }, { BY, 4, 1 }, { BZ, 4, 1 }, { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { GZ, 4, 1 },
+			{ GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 },
+			{ BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x01, 2, true, 7, { 6, 6, 6 }, {
+			{ GY, 5, 1 }, { GZ, 4, 1 }, { GZ, 5, 1 }, { RW, 0, 7 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 7 },
+			{ BY, 5, 1 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 7 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 },
+			{ GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 }, { D, 0, 5 } } },
+		{ 0x02, 2, true, 11, { 5, 4, 4 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { RW, 10, 1 }, { GY, 0, 4 }, { GX, 0, 4 }, { GW, 10, 1 },
+			{ BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 },
+			{ RZ, 0, 5 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x06, 2, true, 11, { 4, 5, 4 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 },
+			{ GW, 10, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 0, 1 },
+			{ BZ, 2, 1 }, { RZ, 0, 4 }, { GY, 4, 1 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x0a, 2, true, 11, { 4, 4, 5 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { BY, 4, 1 }, { GY, 0, 4 }, { GX, 0, 4 },
+			{ GW, 10, 1 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BW, 10, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 1, 1 },
+			{ BZ, 2, 1 }, { RZ, 0, 4 }, { BZ, 4, 1 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x0e, 2, true, 9, { 5, 5, 5 }, {
+			{ RW, 0, 9 }, { BY, 4, 1 }, { GW, 0, 9 }, { GY, 4, 1 }, { BW, 0, 9 }, { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 },
+			{ GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 },
+			{ BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x12, 2, true, 8, { 6, 5, 5 }, {
+			{ RW, 0, 8 }, { GZ, 4, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 3, 1 },
+			{ BZ, 4, 1 }, { RX, 0, 6 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 },
+			{ BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 }, { D, 0, 5 } } },
+		{ 0x16, 2, true, 8, { 5, 6, 5 }, {
+			{ RW, 0, 8 }, { BZ, 0, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { GY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { GZ, 5, 1 },
+			{ BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 },
+			{ BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x1a, 2, true, 8, { 5, 5, 6 }, {
+			{ RW, 0, 8 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 5, 1 },
+			{ BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 6 },
+			{ BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 }, { D, 0, 5 } } },
+		{ 0x1e, 2, false, 6, { 6, 6, 6 }, {
+			{ RW, 0, 6 }, { GZ, 4, 1 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 6 }, { GY, 5, 1 }, { BY, 5, 1 },
+			{ BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 6 }, { GZ, 5, 1 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 },
+			{ GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 }, { D, 0, 5 } } },
+		{ 0x03, 1, false, 10, { 10, 10, 10 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 10 }, { GX, 0, 10 }, { BX, 0, 10 } } },
+		{ 0x07, 1, true, 11, { 9, 9, 9 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 9 }, { RW, 10, 1 }, { GX, 0, 9 }, { GW, 10, 1 }, { BX, 0, 9 },
+			{ BW, 10, 1 } } },
+		{ 0x0b, 1, true, 12, { 8, 8, 8 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 8 }, { RW, 11, 1 }, { RW, 10, 1 }, { GX, 0, 8 }, { GW, 11, 1 },
+			{ GW, 10, 1 }, { BX, 0, 8 }, { BW, 11, 1 }, { BW, 10, 1 } } },
+		{ 0x0f, 1, true, 16, { 4, 4, 4 }, {
+			{ RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 15, 1 }, { RW, 14, 1 }, { RW, 13, 1 }, { RW, 12, 1 },
+			{ RW, 11, 1 }, { RW, 10, 1 }, { GX, 0, 4 }, { GW, 15, 1 }, { GW, 14, 1 }, { GW, 13, 1 }, { GW, 12, 1 }, { GW, 11, 1 },
+			{ GW, 10, 1 }, { BX, 0, 4 }, { BW, 15, 1 }, { BW, 14, 1 }, { BW, 13, 1 }, { BW, 12, 1 }, { BW, 11, 1 }, { BW, 10, 1 } } }
+	};
+
+	int SignExtend(int value, unsigned int bits)
+	{
+		int sign = 1 << (bits - 1);
+		value &= (sign << 1) - 1;
+		return (value ^ sign) - sign;
+	}
+
+	// A BC6H endpoint of the given bits, scaled so the interpolation below has 16 bits (or
+	// a sign and 15) to work in.
+	int UnquantizeBC6H(int value, unsigned int bits, bool isSigned)
+	{
+		if (!isSigned)
+		{
+			if (bits >= 15 || value == 0)
+			{
+				return value;
+			}
+			if (value == (1 << bits) - 1)
+			{
+				return 0xffff;
+			}
+			return ((value << 16) + 0x8000) >> bits;
+		}
+
+		if (bits >= 16)
+		{
+			return value;
+		}
+		bool negative = value < 0;
+		int magnitude = negative ? -value : value;
+		int result;
+		if (magnitude == 0)
+		{
+			result = 0;
+		}
+		else if (magnitude >= (1 << (bits - 1)) - 1)
+		{
+			result = 0x7fff;
+		}
+		else
+		{
+			result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+		}
+		return negative ? -result : result;
+	}
+
+	// An interpolated BC6H value as the bits of a half float (0x7bff at most, so never infinite).
+	uint16_t FinishBC6H(int value, bool isSigned)
+	{
+		if (!isSigned)
+		{
+			return static_cast<uint16_t>((value * 31) >> 6);
+		}
+		return value < 0 ? static_cast<uint16_t>((((-value) * 31) >> 5) | 0x8000) : static_cast<uint16_t>((value * 31) >> 5);
+	}
+
+	// BC4 and BC5 SNORM: channel c of each texel from the signed block at block, as halves.
+	void DecodeSignedChannel(const uint8_t* block, int c, uint16_t (&texels)[64])
+	{
+		int e0 = std::max(static_cast<int>(static_cast<int8_t>(block[0])), -127);
+		int e1 = std::max(static_cast<int>(static_cast<int8_t>(block[1])), -127);
+		float palette[8];
+		palette[0] = e0 / 127.0f;
+		palette[1] = e1 / 127.0f;
+		if (e0 > e1)
+		{
+			for (int i = 1; i <= 6; i++)
+			{
+				palette[1 + i] = ((7 - i) * e0 + i * e1) / (7.0f * 127.0f);
+			}
+		}
+		else
+		{
+			for (int i = 1; i <= 4; i++)
+			{
+				palette[1 + i] = ((5 - i) * e0 + i * e1) / (5.0f * 127.0f);
+			}
+			palette[6] = -1.0f;
+			palette[7] = 1.0f;
+		}
+
+		uint16_t halves[8];
+		for (int i = 0; i < 8; i++)
+		{
+			halves[i] = FloatToHalf(palette[i]);
+		}
+		uint64_t bits = 0;
+		for (int k = 0; k < 6; k++)
+		{
+			bits |= static_cast<uint64_t>(block[2 + k]) << (8 * k);
+		}
+		for (int x = 0; x < 16; x++)
+		{
+			texels[4 * x + c] = halves[(bits >> (3 * x)) & 7];
+		}
+	}
+
+	// How a format's blocks are decoded: to RGBA8 rows, or a block at a time to halves.
+	enum class BlockKind
+	{
+		None,
+		Row,
+		BC4Signed,
+		BC5Signed,
+		BC6HUnsigned,
+		BC6HSigned
+	};
+
+	struct BlockFormatInfo
+	{
+		BlockKind	kind;
+		RowFormat	rowFormat;
+		size_t		blockBytes;
+	};
+
+	BlockFormatInfo GetBlockFormatInfo(DXGI_FORMAT fmt)
+	{
+		switch (fmt)
+		{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:	return { BlockKind::Row, RowFormat::BC1, 8 };
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:	return { BlockKind::Row, RowFormat::BC2, 16 };
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:	return { BlockKind::Row, RowFormat::BC3, 16 };
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:			return { BlockKind::Row, RowFormat::BC4, 8 };
+		case DXGI_FORMAT_BC4_SNORM:			return { BlockKind::BC4Signed, RowFormat::BC4, 8 };
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:			return { BlockKind::Row, RowFormat::BC5, 16 };
+		case DXGI_FORMAT_BC5_SNORM:			return { BlockKind::BC5Signed, RowFormat::BC5, 16 };
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:			return { BlockKind::BC6HUnsigned, RowFormat::BC7, 16 };
+		case DXGI_FORMAT_BC6H_SF16:			return { BlockKind::BC6HSigned, RowFormat::BC7, 16 };
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:	return { BlockKind::Row, RowFormat::BC7, 16 };
+		default:							return { BlockKind::None, RowFormat::BC1, 0 };
+		}
+	}
+
+	// Halves of the 256 UNORM8 values.
+	struct UnormHalves
+	{
+		uint16_t values[256];
+
+		UnormHalves()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				values[i] = FloatToHalf(i / 255.0f);
+			}
+		}
+	};
+
+	uint8_t HalfToUnorm8(uint16_t value)
+	{
+		float f = HalfToFloat(value);
+		f = f > 0.0f ? std::min(f, 1.0f) : 0.0f;	// NaN goes to 0
+		return static_cast<uint8_t>(f * 255.0f + 0.5f);
+	}
+
+	// A run of block rows of one depth slice of one subresource.
+	struct DecodeItem
+	{
+		size_t	image;
+		size_t	slice;
+		size_t	firstRow;
+		size_t	rowCount;
+	};
+
+	void DecodeBlockRows(const DDSSubresource& subresource, const BlockFormatInfo& info, DecodeRowFunc decodeRow, const DecodeItem& item, DecodedImage& image, std::vector<uint8_t>& scratch)
+	{
+		static const UnormHalves unormHalves;
+
+		size_t blocksWide = (subresource.width + 3) / 4;
+		size_t texelBytes = image.GetTexelBytes();
+		size_t rowPitch = image.GetRowPitch();
+		uint8_t* slice = image.texels.data() + item.slice * image.height * rowPitch;
+		bool toHalf = image.format == DecodedFormat::RGBA16F;
+
+		// Four rows of whole blocks, as RGBA8 for row formats and halves for the rest.
+		size_t scratchRowBytes = blocksWide * 4 * (info.kind == BlockKind::Row ? 4 : 8);
+		if (scratch.size() < 4 * scratchRowBytes)
+		{
+			scratch.resize(4 * scratchRowBytes);
+		}
+		uint8_t* scratchRows[4];
+		for (int r = 0; r < 4; r++)
+		{
+			scratchRows[r] = scratch.data() + r * scratchRowBytes;
+		}
+
+		for (size_t by = item.firstRow; by < item.firstRow + item.rowCount; by++)
+		{
+			const uint8_t* blocks = subresource.data + item.slice * subresource.slicePitch + by * subresource.rowPitch;
+			size_t y = 4 * by;
+			size_t rows = std::min<size_t>(4, image.height - y);
+
+			if (info.kind == BlockKind::Row)
+			{
+				// Whole rows of whole blocks decode straight into the image.
+				if (!toHalf && image.width % 4 == 0 && rows == 4)
+				{
+					uint8_t* const direct[4] = { slice + y * rowPitch, slice + (y + 1) * rowPitch, slice + (y + 2) * rowPitch, slice + (y + 3) * rowPitch };
+					decodeRow(info.rowFormat, blocks, blocksWide, direct);
+					continue;
+				}
+				uint8_t* const rowsOut[4] = { scratchRows[0], scratchRows[1], scratchRows[2], scratchRows[3] };
+				decodeRow(info.rowFormat, blocks, blocksWide, rowsOut);
+			}
+			else
+			{
+				for (size_t bx = 0; bx < blocksWide; bx++)
+				{
+					const uint8_t* block = blocks + bx * info.blockBytes;
+					uint16_t texels[64];
+					switch (info.kind)
+					{
+					case BlockKind::BC4Signed:
+					case BlockKind::BC5Signed:
+						for (int x = 0; x < 16; x++)
+						{
+							texels[4 * x + 1] = 0;
+							texels[4 * x + 2] = 0;
+							texels[4 * x + 3] = HalfOne;
+						}
+						DecodeSignedChannel(block, 0, texels);
+						if (info.kind == BlockKind::BC5Signed)
+						{
+							DecodeSignedChannel(block + 8, 1, texels);
+						}
+						break;
+					default:
+						DecodeBC6HBlock(block, info.kind == BlockKind::BC6HSigned, texels);
+						break;
+					}
+					for (int r = 0; r < 4; r++)
+					{
+						memcpy(scratchRows[r] + bx * 32, texels + 16 * r, 32);
+					}
+				}
+			}
+
+			for (size_t r = 0; r < rows; r++)
+			{
+				uint8_t* out = slice + (y + r) * rowPitch;
+				const uint8_t* in = scratchRows[r];
+				if ((info.kind == BlockKind::Row) != toHalf)
+				{
+					memcpy(out, in, image.width * texelBytes);
+				}
+				else if (toHalf)
+				{
+					uint16_t* halves = reinterpret_cast<uint16_t*>(out);
+					for (size_t i = 0; i < image.width * 4; i++)
+					{
+						halves[i] = unormHalves.values[in[i]];
+					}
+				}
+				else
+				{
+					const uint16_t* halves = reinterpret_cast<const uint16_t*>(in);
+					for (size_t i = 0; i < image.width * 4; i++)
+					{
+						out[i] = HalfToUnorm8(halves[i]);
+					}
+				}
+			}
+		}
+	}
+
+	DDSStatus DecodeSubresources(const DDSSubresource* subresources, size_t count, DXGI_FORMAT fmt, DecodedFormat output, DecodedImage* images, ThreadPool& threadPool, SimdLevel level)
+	{
+		BlockFormatInfo info = GetBlockFormatInfo(fmt);
+		if (info.kind == BlockKind::None)
+		{
+			return DDSStatus::NotSupported;
+		}
+		DecodeRowFunc decodeRow = GetDecodeRowFunc(level);
+
+		std::vector<DecodeItem> items;
+		for (size_t i = 0; i < count; i++)
+		{
+			const DDSSubresource& subresource = subresources[i];
+			DecodedImage& image = images[i];
+			image.width = subresource.width;
+			image.height = subresource.height;
+			image.depth = subresource.depth;
+			image.format = output;
+			image.texels.resize(image.GetRowPitch() * image.height * image.depth);
+
+			size_t blocksWide = (subresource.width + 3) / 4;
+			size_t rowsPerItem = std::max<size_t>(1, BlocksPerItem / blocksWide);
+			for (size_t z = 0; z < subresource.depth; z++)
+			{
+				for (size_t row = 0; row < subresource.rowCount; row += rowsPerItem)
+				{
+					items.push_back({ i, z, row, std::min(rowsPerItem, subresource.rowCount - row) });
+				}
+			}
+		}
+
+		threadPool.ParallelFor(items.size(), [&](size_t i)
+		{
+			std::vector<uint8_t> scratch;
+			const DecodeItem& item = items[i];
+			DecodeBlockRows(subresources[item.image], info, decodeRow, item, images[item.image], scratch);
+		});
+		return DDSStatus::Ok;
+	}
+}
+
+uint16_t DX::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & 0x7fffffff;
+
+	if (magnitude >= 0x7f800000)
+	{
+		return static_cast<uint16_t>(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0));
+	}
+	if (magnitude >= 0x477ff000)
+	{
+		return static_cast<uint16_t>(sign | 0x7c00);
+	}
+	if (magnitude < 0x38800000)
+	{
+		// Below the smallest normal half: shift the mantissa, with its hidden bit, into
+		// units of 2^-24.
+		if (magnitude < 0x33000000)
+		{
+			return static_cast<uint16_t>(sign);
+		}
+		uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+		uint32_t shift = 126 - (magnitude >> 23);
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1)))
+		{
+			half++;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	uint32_t half = (magnitude - 0x38000000) >> 13;
+	uint32_t remainder = magnitude & 0x1fff;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		half++;
+	}
+	return static_cast<uint16_t>(sign | half);
+}
+
+float DX::HalfToFloat(uint16_t value)
+{
+	uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 31;
+	uint32_t mantissa = value & 0x3ff;
+	if (exponent == 0)
+	{
+		float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+		return sign ? -magnitude : magnitude;
+	}
+
+	uint32_t bits = exponent == 31 ? (sign | 0x7f800000 | (mantissa << 13)) : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+const BlockDecoder::Tables& BlockDecoder::GetTables()
+{
+	struct Builder
+	{
+		Tables tables;
+
+		Builder()
+		{
+			for (int indices = 0; indices < 256; indices++)
+			{
+				for (int x = 0; x < 4; x++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						tables.colorShuffle[indices][4 * x + c] = static_cast<uint8_t>(4 * ((indices >> (2 * x)) & 3) + c);
+					}
+				}
+			}
+			for (uint32_t indices = 0; indices < 4096; indices++)
+			{
+				uint32_t bytes = 0;
+				for (int x = 0; x < 4; x++)
+				{
+					bytes |= ((indices >> (3 * x)) & 7) << (8 * x);
+				}
+				tables.alphaIndices[indices] = bytes;
+			}
+			for (int r = 0; r < 4; r++)
+			{
+				for (int i = 0; i < 16; i++)
+				{
+					uint8_t source = static_cast<uint8_t>(4 * r + i / 4);
+					tables.toRed[r][i] = i % 4 == 0 ? source : 0x80;
+					tables.toGreen[r][i] = i % 4 == 1 ? source : 0x80;
+					tables.toAlpha[r][i] = i % 4 == 3 ? source : 0x80;
+				}
+			}
+			for (int i = 0; i < 16; i++)
+			{
+				tables.rgbMask[i] = i % 4 == 3 ? 0 : 0xff;
+				tables.opaque[i] = i % 4 == 3 ? 0xff : 0;
+			}
+		}
+	};
+
+	static const Builder builder;
+	return builder.tables;
+}
+
+void BlockDecoder::DecodeRowScalar(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4])
+{
+	BlockKernel<Scalar>::DecodeRow(format, blocks, count, rows);
+}
+
+BlockDecoder::DecodeRowFunc BlockDecoder::GetDecodeRowFunc(SimdLevel level)
+{
+	if (level > GetSupportedSimdLevel())
+	{
+		level = GetSupportedSimdLevel();
+	}
+
+	// A 512-bit shuffle would only add a wider tail; AVX-512 machines take the AVX2 path.
+	switch (level)
+	{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	case SimdLevel::AVX512:
+	case SimdLevel::AVX2:	return &DecodeRowAVX2;
+	case SimdLevel::SSE41:	return &DecodeRowSSE41;
+#endif
+	default:				return &DecodeRowScalar;
+	}
+}
+
+void BlockDecoder::DecodeBC7Block(const uint8_t* block, uint8_t (&texels)[64])
+{
+	// The mode is the position of the lowest set bit.
+	int modeIndex = 0;
+	while (modeIndex < 8 && !(block[0] & (1 << modeIndex)))
+	{
+		modeIndex++;
+	}
+	if (modeIndex == 8)
+	{
+		memset(texels, 0, sizeof(texels));
+		return;
+	}
+
+	const BC7Mode& mode = BC7Modes[modeIndex];
+	BlockBits bits(block);
+	bits.Read(modeIndex + 1);
+	unsigned int partition = bits.Read(mode.partitionBits);
+	unsigned int rotation = bits.Read(mode.rotationBits);
+	unsigned int indexSelection = bits.Read(mode.indexSelectionBits);
+
+	// Endpoints channel by channel, then their p-bits.
+	unsigned int endpointCount = 2 * mode.subsets;
+	uint32_t endpoints[6][4];
+	for (int c = 0; c < 3; c++)
+	{
+		for (unsigned int e = 0; e < endpointCount; e++)
+		{
+			endpoints[e][c] = bits.Read(mode.colorBits);
+		}
+	}
+	for (unsigned int e = 0; e < endpointCount; e++)
+	{
+		endpoints[e][3] = bits.Read(mode.alphaBits);
+	}
+
+	unsigned int colorBits = mode.colorBits;
+	unsigned int alphaBits = mode.alphaBits;
+	if (mode.endpointPBits || mode.sharedPBits)
+	{
+		uint32_t pBits[6];
+		for (unsigned int e = 0; e < endpointCount; e++)
+		{
+			pBits[e] = mode.endpointPBits || e % 2 == 0 ? bits.Read(1) : pBits[e - 1];
+		}
+		for (unsigned int e = 0; e < endpointCount; e++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+			}
+		}
+		colorBits++;
+		if (alphaBits)
+		{
+			alphaBits++;
+		}
+	}
+
+	// Widen to 8 bits by repeating the top bits below.
+	for (unsigned int e = 0; e < endpointCount; e++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			unsigned int channelBits = c < 3 ? colorBits : alphaBits;
+			uint32_t value = endpoints[e][c];
+			endpoints[e][c] = channelBits ? ((value << (8 - channelBits)) | (value >> (2 * channelBits - 8))) & 255 : 255;
+		}
+	}
+
+	unsigned int subsetOf[16];
+	bool isAnchor[16];
+	for (int x = 0; x < 16; x++)
+	{
+		subsetOf[x] = mode.subsets == 1 ? 0 : mode.subsets == 2 ? (Partitions2[partition] >> x) & 1 : (Partitions3[partition] >> (2 * x)) & 3;
+		isAnchor[x] = x == 0;
+	}
+	if (mode.subsets == 2)
+	{
+		isAnchor[Anchors2[partition]] = true;
+	}
+	else if (mode.subsets == 3)
+	{
+		isAnchor[Anchors3Second[partition]] = true;
+		isAnchor[Anchors3Third[partition]] = true;
+	}
+
+	unsigned int indices[16];
+	unsigned int secondaryIndices[16];
+	for (int x = 0; x < 16; x++)
+	{
+		indices[x] = bits.Read(mode.indexBits - (isAnchor[x] ? 1 : 0));
+	}
+	for (int x = 0; x < 16; x++)
+	{
+		secondaryIndices[x] = mode.secondaryIndexBits ? bits.Read(mode.secondaryIndexBits - (x == 0 ? 1 : 0)) : indices[x];
+	}
+
+	// Mode 4's index selection swaps which index set colours and alpha use.
+	unsigned int colorIndexBits = mode.indexBits;
+	unsigned int alphaIndexBits = mode.secondaryIndexBits ? mode.secondaryIndexBits : mode.indexBits;
+	const unsigned int* colorIndices = indices;
+	const unsigned int* alphaIndices = secondaryIndices;
+	if (indexSelection)
+	{
+		std::swap(colorIndexBits, alphaIndexBits);
+		std::swap(colorIndices, alphaIndices);
+	}
+	const uint8_t* colorWeights = GetWeights(colorIndexBits);
+	const uint8_t* alphaWeights = GetWeights(alphaIndexBits);
+
+	for (int x = 0; x < 16; x++)
+	{
+		const uint32_t* e0 = endpoints[2 * subsetOf[x]];
+		const uint32_t* e1 = endpoints[2 * subsetOf[x] + 1];
+		uint32_t colorWeight = colorWeights[colorIndices[x]];
+		uint32_t alphaWeight = alphaWeights[alphaIndices[x]];
+		uint8_t* texel = texels + 4 * x;
+		for (int c = 0; c < 4; c++)
+		{
+			uint32_t w = c < 3 ? colorWeight : alphaWeight;
+			texel[c] = static_cast<uint8_t>(((64 - w) * e0[c] + w * e1[c] + 32) >> 6);
+		}
+		if (rotation)
+		{
+			std::swap(texel[rotation - 1], texel[3]);
+		}
+	}
+}
+
+void BlockDecoder::DecodeBC6HBlock(const uint8_t* block, bool isSigned, uint16_t (&texels)[64])
+{
+	BlockBits bits(block);
+	unsigned int modeBits = bits.Read(2);
+	if (modeBits > 1)
+	{
+		modeBits |= bits.Read(3) << 2;
+	}
+
+	const BC6HMode* mode = nullptr;
+	for (const BC6HMode& candidate : BC6HModes)
+	{
+		if (candidate.modeBits == modeBits)
+		{
+			mode = &candidate;
+		}
+	}
+	if (!mode)
+	{
+		memset(texels, 0, sizeof(texels));
+		return;
+	}
+
+	int endpoints[4][3] = {};
+	unsigned int partition = 0;
+	for (const BC6HField& field : mode->fields)
+	{
+		if (field.count == 0)
+		{
+			break;
+		}
+		uint32_t value = bits.Read(field.count) << field.lsb;
+		if (field.target == D)
+		{
+			partition |= value;
+		}
+		else
+		{
+			endpoints[field.target / 3][field.target % 3] |= static_cast<int>(value);
+		}
+	}
+
+	unsigned int endpointCount = 2 * mode->subsets;
+	unsigned int endpointBits = mode->endpointBits;
+	int mask = (1 << endpointBits) - 1;
+	for (int c = 0; c < 3; c++)
+	{
+		if (isSigned)
+		{
+			endpoints[0][c] = SignExtend(endpoints[0][c], endpointBits);
+		}
+		for (unsigned int e = 1; e < endpointCount; e++)
+		{
+			if (mode->transformed)
+			{
+				endpoints[e][c] = (endpoints[0][c] + SignExtend(endpoints[e][c], mode->deltaBits[c])) & mask;
+			}
+			if (isSigned)
+			{
+				endpoints[e][c] = SignExtend(endpoints[e][c], endpointBits);
+			}
+		}
+		for (unsigned int e = 0; e < endpointCount; e++)
+		{
+			endpoints[e][c] = UnquantizeBC6H(endpoints[e][c], endpointBits, isSigned);
+		}
+	}
+
+	unsigned int indexBits = mode->subsets == 2 ? 3 : 4;
+	unsigned int anchor = mode->subsets == 2 ? Anchors2[partition] : 0;
+	const uint8_t* weights = GetWeights(indexBits);
+	for (unsigned int x = 0; x < 16; x++)
+	{
+		unsigned int index = bits.Read(indexBits - (x == 0 || x == anchor ? 1 : 0));
+		unsigned int subset = mode->subsets == 2 ? (Partitions2[partition] >> x) & 1 : 0;
+		const int* e0 = endpoints[2 * subset];
+		const int* e1 = endpoints[2 * subset + 1];
+		int w = weights[index];
+		for (int c = 0; c < 3; c++)
+		{
+			texels[4 * x + c] = FinishBC6H(((64 - w) * e0[c] + w * e1[c] + 32) >> 6, isSigned);
+		}
+		texels[4 * x + 3] = HalfOne;
+	}
+}
+
+bool DX::IsBlockDecodable(DXGI_FORMAT fmt)
+{
+	return GetBlockFormatInfo(fmt).kind != BlockKind::None;
+}
+
+DDSStatus DX::DecodeSubresource(const DDSSubresource& subresource, DXGI_FORMAT fmt, DecodedFormat output, DecodedImage& image, ThreadPool& threadPool, SimdLevel level)
+{
+	return DecodeSubresources(&subresource, 1, fmt, output, &image, threadPool, level);
+}
+
+DDSStatus DX::DecodeDDS(const DDSFile& file, DecodedFormat output, std::vector<DecodedImage>& images, ThreadPool& threadPool, SimdLevel level)
+{
+	if (!IsBlockDecodable(file.desc.format))
+	{
+		return DDSStatus::NotSupported;
+	}
+
+	std::vector<DDSSubresource> subresources;
+	size_t skipMip = 0;
+	DDSStatus status = GetDDSSubresources(file, 0, subresources, skipMip);
+	if (status != DDSStatus::Ok)
+	{
+		return status;
+	}
+
+	images.resize(subresources.size());
+	return DecodeSubresources(subresources.data(), subresources.size(), file.desc.format, output, images.data(), threadPool, level);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CpuFeatures.h"
+#include "DDSFile.h"
+#include "ThreadPool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// CPU decoding of block-compressed DDS surfaces (BC1 to BC7, and the legacy DXT1 to DXT5,
+// ATI1, ATI2, BC4U/S and BC5U/S FourCCs GetDXGIFormat maps onto them) into plain texels, for
+// tools and the software renderer. Block rows are split across a thread pool, and BC1 to BC5
+// expand each row of texels with byte shuffles at the widest SIMD level available.
+namespace DX
+{
+	enum class DecodedFormat
+	{
+		RGBA8,		// 8-bit channels, each saturated to [0, 1]; sRGB data stays sRGB encoded
+		RGBA16F		// half floats; the only format that keeps BC6H's range and SNORM's sign
+	};
+
+	// One decoded subresource: depth slices of height rows of width texels, tightly packed.
+	struct DecodedImage
+	{
+		size_t					width;
+		size_t					height;
+		size_t					depth;
+		DecodedFormat			format;
+		std::vector<uint8_t>	texels;
+
+		size_t GetTexelBytes() const { return format == DecodedFormat::RGBA8 ? 4 : 8; }
+		size_t GetRowPitch() const { return width * GetTexelBytes(); }
+	};
+
+	// True if fmt is one of the block-compressed formats DecodeDDS understands.
+	bool IsBlockDecodable(DXGI_FORMAT fmt);
+
+	// Decodes one subresource of fmt into image, split into block rows across threadPool.
+	DDSStatus DecodeSubresource(const DDSSubresource& subresource, DXGI_FORMAT fmt, DecodedFormat output, DecodedImage& image, ThreadPool& threadPool, SimdLevel level = GetSupportedSimdLevel());
+
+	// Decodes every subresource of file (every mip of every array item, in Direct3D's
+	// subresource order) in one dispatch across threadPool.
+	DDSStatus DecodeDDS(const DDSFile& file, DecodedFormat output, std::vector<DecodedImage>& images, ThreadPool& threadPool, SimdLevel level = GetSupportedSimdLevel());
+
+	// IEEE half float conversions; FloatToHalf rounds to nearest even.
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	namespace BlockDecoder
+	{
+		// The formats decoded to 8-bit texels by the row decoders below.
+		enum class RowFormat
+		{
+			BC1,
+			BC2,
+			BC3,
+			BC4,
+			BC5,
+			BC7
+		};
+
+		// Decodes count adjacent blocks of format at blocks into four rows of RGBA8 texels:
+		// block i's texel row r goes to rows[r] + 16 * i.
+		typedef void (*DecodeRowFunc)(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4]);
+
+		// Returns the row decoder for level, falling back to the best supported one below it.
+		// Every level produces the same bytes.
+		DecodeRowFunc GetDecodeRowFunc(SimdLevel level);
+
+		// The reference: one block at a time, emulating the byte shuffles.
+		void DecodeRowScalar(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4]);
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+		// Implemented in BlockDecoderSSE41.cpp (a block per shuffle) and BlockDecoderAVX2.cpp
+		// (two blocks per shuffle), each built for its own instruction set. Only call through
+		// GetDecodeRowFunc.
+		void DecodeRowSSE41(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4]);
+		void DecodeRowAVX2(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4]);
+#endif
+
+		// BC7's eight modes and BC6H's fourteen choose their bit layout per block, so every level
+		// decodes them a block at a time with these. Reserved modes decode to zero.
+		void DecodeBC7Block(const uint8_t* block, uint8_t (&texels)[64]);
+		void DecodeBC6HBlock(const uint8_t* block, bool isSigned, uint16_t (&texels)[64]);
+
+		// Tables shared by every level, built on first use.
+		struct Tables
+		{
+			// Shuffle control taking a texel row's four 2-bit colour indices to the RGBA of
+			// each from a 16-byte palette of four colours.
+			uint8_t		colorShuffle[256][16];
+
+			// A texel row's four 3-bit alpha indices, one per byte.
+			uint32_t	alphaIndices[4096];
+
+			// Shuffle controls moving byte 4r + x of a 16-byte vector to texel x's alpha, red
+			// or green, for texel row r; every other byte is zeroed.
+			uint8_t		toAlpha[4][16];
+			uint8_t		toRed[4][16];
+			uint8_t		toGreen[4][16];
+
+			// Masks keeping red, green and blue, and setting alpha to 255.
+			uint8_t		rgbMask[16];
+			uint8_t		opaque[16];
+		};
+
+		const Tables& GetTables();
+	}
+}
@@ -0,0 +1,56 @@
+#include "BlockDecoder.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+#include <string.h>
+
+// Everything below is compiled for AVX2; callers must check the CPU first.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+using namespace DX;
+
+namespace
+{
+	// Two adjacent blocks per register, one per 128-bit lane; vpshufb never crosses lanes, so
+	// each block shuffles within its own palette.
+	struct AVX2
+	{
+		static const size_t Blocks = 2;
+		typedef __m256i V;
+
+		static V Load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+		static V LoadLanes(const uint8_t* const (&lanes)[2])
+		{
+			__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes[0]));
+			__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes[1]));
+			return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+		}
+		static V Broadcast(const uint8_t* p) { return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+		static void Store(void* p, V a) { _mm256_storeu_si256(static_cast<__m256i*>(p), a); }
+
+		static V Shuffle(V table, V control) { return _mm256_shuffle_epi8(table, control); }
+		static V And(V a, V b) { return _mm256_and_si256(a, b); }
+		static V Or(V a, V b) { return _mm256_or_si256(a, b); }
+	};
+
+#include "BlockDecoderKernel.h"
+}
+
+void BlockDecoder::DecodeRowAVX2(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4])
+{
+	BlockKernel<AVX2>::DecodeRow(format, blocks, count, rows);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,269 @@
+// Lane-generic BC1 to BC5 row decoding for BlockDecoder.
+//
+// Only include this from the BlockDecoder*.cpp translation units, inside their anonymous
+// namespace and after the instruction set has been enabled. S supplies the vector type S::V
+// of S::Blocks 16-byte lanes, one block's texel row per lane, and the static operations used
+// below; Load, LoadLanes and Store are unaligned. Palettes and indices are unpacked with the
+// same integer code at every level and only placed by byte shuffles, so every level writes
+// the same bytes.
+
+// RGBA (red in the low byte) of a 5:6:5 colour, with its top bits repeated below.
+inline uint32_t Unpack565(uint32_t c)
+{
+	uint32_t r = (c >> 11) & 31;
+	uint32_t g = (c >> 5) & 63;
+	uint32_t b = c & 31;
+	r = (r << 3) | (r >> 2);
+	g = (g << 2) | (g >> 4);
+	b = (b << 3) | (b >> 2);
+	return r | (g << 8) | (b << 16) | 0xff000000u;
+}
+
+// (wa * a + wb * b) / (wa + wb) in each byte, rounded.
+inline uint32_t Blend(uint32_t a, uint32_t b, uint32_t wa, uint32_t wb)
+{
+	uint32_t sum = wa + wb;
+	uint32_t result = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		uint32_t x = (a >> shift) & 255;
+		uint32_t y = (b >> shift) & 255;
+		result |= ((wa * x + wb * y + sum / 2) / sum) << shift;
+	}
+	return result;
+}
+
+// The four colours of the BC1-style colour block at block. When allowThreeColors is set (BC1)
+// and the first endpoint is not the larger, the block has three and transparent black.
+inline void ColorPalette(const uint8_t* block, bool allowThreeColors, uint32_t* palette)
+{
+	uint32_t c0 = block[0] | (block[1] << 8);
+	uint32_t c1 = block[2] | (block[3] << 8);
+	uint32_t a = Unpack565(c0);
+	uint32_t b = Unpack565(c1);
+	palette[0] = a;
+	palette[1] = b;
+	if (c0 > c1 || !allowThreeColors)
+	{
+		palette[2] = Blend(a, b, 2, 1);
+		palette[3] = Blend(a, b, 1, 2);
+	}
+	else
+	{
+		palette[2] = Blend(a, b, 1, 1);
+		palette[3] = 0;
+	}
+}
+
+// The eight values of the BC3 alpha or BC4 block at block, then eight zeros: six between the
+// endpoints, or four, 0 and 255 when the first endpoint is not the larger.
+inline void AlphaPalette(const uint8_t* block, uint8_t* palette)
+{
+	uint32_t a0 = block[0];
+	uint32_t a1 = block[1];
+	palette[0] = static_cast<uint8_t>(a0);
+	palette[1] = static_cast<uint8_t>(a1);
+	if (a0 > a1)
+	{
+		for (uint32_t i = 1; i <= 6; i++)
+		{
+			palette[1 + i] = static_cast<uint8_t>(((7 - i) * a0 + i * a1 + 3) / 7);
+		}
+	}
+	else
+	{
+		for (uint32_t i = 1; i <= 4; i++)
+		{
+			palette[1 + i] = static_cast<uint8_t>(((5 - i) * a0 + i * a1 + 2) / 5);
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	for (int i = 8; i < 16; i++)
+	{
+		palette[i] = 0;
+	}
+}
+
+template <typename S>
+struct BlockKernel
+{
+	typedef typename S::V V;
+	static const size_t Blocks = S::Blocks;
+
+	static void DecodeRow(BlockDecoder::RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4])
+	{
+		using BlockDecoder::RowFormat;
+
+		if (format == RowFormat::BC7)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				uint8_t texels[64];
+				BlockDecoder::DecodeBC7Block(blocks + 16 * i, texels);
+				for (int r = 0; r < 4; r++)
+				{
+					memcpy(rows[r] + 16 * i, texels + 16 * r, 16);
+				}
+			}
+			return;
+		}
+
+		size_t blockBytes = format == RowFormat::BC1 || format == RowFormat::BC4 ? 8 : 16;
+		size_t whole = count - count % Blocks;
+		DecodeGroups(format, blocks, whole, rows);
+
+		// The last blocks that do not fill a vector go through a copy padded with zeros.
+		if (whole < count)
+		{
+			uint8_t tail[16 * Blocks] = {};
+			memcpy(tail, blocks + whole * blockBytes, (count - whole) * blockBytes);
+			uint8_t tailTexels[4][16 * Blocks];
+			uint8_t* const tailRows[4] = { tailTexels[0], tailTexels[1], tailTexels[2], tailTexels[3] };
+			DecodeGroups(format, tail, Blocks, tailRows);
+			for (int r = 0; r < 4; r++)
+			{
+				memcpy(rows[r] + 16 * whole, tailTexels[r], 16 * (count - whole));
+			}
+		}
+	}
+
+private:
+	// Decodes count blocks, a multiple of Blocks.
+	static void DecodeGroups(BlockDecoder::RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4])
+	{
+		using BlockDecoder::RowFormat;
+
+		const BlockDecoder::Tables& tables = BlockDecoder::GetTables();
+		switch (format)
+		{
+		case RowFormat::BC1:
+			for (size_t i = 0; i < count; i += Blocks)
+			{
+				const uint8_t* group = blocks + 8 * i;
+				alignas(16) uint32_t palette[4 * Blocks];
+				for (size_t b = 0; b < Blocks; b++)
+				{
+					ColorPalette(group + 8 * b, true, palette + 4 * b);
+				}
+				V colors = S::Load(palette);
+				for (int r = 0; r < 4; r++)
+				{
+					S::Store(rows[r] + 16 * i, S::Shuffle(colors, ColorControl(tables, group, 8, r)));
+				}
+			}
+			break;
+
+		case RowFormat::BC2:
+			for (size_t i = 0; i < count; i += Blocks)
+			{
+				const uint8_t* group = blocks + 16 * i;
+				WriteWithAlpha(tables, ExplicitAlpha(group), group, rows, 16 * i);
+			}
+			break;
+
+		case RowFormat::BC3:
+			for (size_t i = 0; i < count; i += Blocks)
+			{
+				const uint8_t* group = blocks + 16 * i;
+				WriteWithAlpha(tables, InterpolatedAlpha(tables, group, 16), group, rows, 16 * i);
+			}
+			break;
+
+		case RowFormat::BC4:
+			for (size_t i = 0; i < count; i += Blocks)
+			{
+				V red = InterpolatedAlpha(tables, blocks + 8 * i, 8);
+				V opaque = S::Broadcast(tables.opaque);
+				for (int r = 0; r < 4; r++)
+				{
+					S::Store(rows[r] + 16 * i, S::Or(S::Shuffle(red, S::Broadcast(tables.toRed[r])), opaque));
+				}
+			}
+			break;
+
+		case RowFormat::BC5:
+			for (size_t i = 0; i < count; i += Blocks)
+			{
+				const uint8_t* group = blocks + 16 * i;
+				V red = InterpolatedAlpha(tables, group, 16);
+				V green = InterpolatedAlpha(tables, group + 8, 16);
+				V opaque = S::Broadcast(tables.opaque);
+				for (int r = 0; r < 4; r++)
+				{
+					V rg = S::Or(S::Shuffle(red, S::Broadcast(tables.toRed[r])), S::Shuffle(green, S::Broadcast(tables.toGreen[r])));
+					S::Store(rows[r] + 16 * i, S::Or(rg, opaque));
+				}
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	// Shuffle control for texel row r of the colour blocks stride bytes apart at group.
+	static V ColorControl(const BlockDecoder::Tables& tables, const uint8_t* group, size_t stride, int r)
+	{
+		const uint8_t* lanes[Blocks];
+		for (size_t b = 0; b < Blocks; b++)
+		{
+			lanes[b] = tables.colorShuffle[group[stride * b + 4 + r]];
+		}
+		return S::LoadLanes(lanes);
+	}
+
+	// The sixteen values of each BC3-style alpha block stride bytes apart at group, looked up
+	// in its palette a block per lane.
+	static V InterpolatedAlpha(const BlockDecoder::Tables& tables, const uint8_t* group, size_t stride)
+	{
+		alignas(16) uint8_t palette[16 * Blocks];
+		alignas(16) uint32_t control[4 * Blocks];
+		for (size_t b = 0; b < Blocks; b++)
+		{
+			const uint8_t* block = group + stride * b;
+			AlphaPalette(block, palette + 16 * b);
+			uint64_t bits = 0;
+			for (int k = 0; k < 6; k++)
+			{
+				bits |= static_cast<uint64_t>(block[2 + k]) << (8 * k);
+			}
+			for (int r = 0; r < 4; r++)
+			{
+				control[4 * b + r] = tables.alphaIndices[(bits >> (12 * r)) & 0xfff];
+			}
+		}
+		return S::Shuffle(S::Load(palette), S::Load(control));
+	}
+
+	// BC2's sixteen 4-bit alphas, widened to bytes, a block per lane.
+	static V ExplicitAlpha(const uint8_t* group)
+	{
+		alignas(16) uint8_t alpha[16 * Blocks];
+		for (size_t b = 0; b < Blocks; b++)
+		{
+			for (int x = 0; x < 16; x++)
+			{
+				alpha[16 * b + x] = static_cast<uint8_t>(((group[16 * b + x / 2] >> (4 * (x & 1))) & 15) * 17);
+			}
+		}
+		return S::Load(alpha);
+	}
+
+	// BC2 and BC3: the colour block after each alpha block always has four colours.
+	static void WriteWithAlpha(const BlockDecoder::Tables& tables, V alpha, const uint8_t* group, uint8_t* const (&rows)[4], size_t offset)
+	{
+		alignas(16) uint32_t palette[4 * Blocks];
+		for (size_t b = 0; b < Blocks; b++)
+		{
+			ColorPalette(group + 16 * b + 8, false, palette + 4 * b);
+		}
+		V colors = S::Load(palette);
+		V rgbMask = S::Broadcast(tables.rgbMask);
+		for (int r = 0; r < 4; r++)
+		{
+			V rgb = S::And(S::Shuffle(colors, ColorControl(tables, group + 8, 16, r)), rgbMask);
+			S::Store(rows[r] + offset, S::Or(rgb, S::Shuffle(alpha, S::Broadcast(tables.toAlpha[r]))));
+		}
+	}
+};
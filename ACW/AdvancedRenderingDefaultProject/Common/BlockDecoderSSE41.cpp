@@ -0,0 +1,50 @@
+#include "BlockDecoder.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <smmintrin.h>
+#include <string.h>
+
+// Everything below is compiled for SSE41; callers must check the CPU first.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+using namespace DX;
+
+namespace
+{
+	// A block per register.
+	struct SSE41
+	{
+		static const size_t Blocks = 1;
+		typedef __m128i V;
+
+		static V Load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+		static V LoadLanes(const uint8_t* const (&lanes)[1]) { return Load(lanes[0]); }
+		static V Broadcast(const uint8_t* p) { return Load(p); }
+		static void Store(void* p, V a) { _mm_storeu_si128(static_cast<__m128i*>(p), a); }
+
+		static V Shuffle(V table, V control) { return _mm_shuffle_epi8(table, control); }
+		static V And(V a, V b) { return _mm_and_si128(a, b); }
+		static V Or(V a, V b) { return _mm_or_si128(a, b); }
+	};
+
+#include "BlockDecoderKernel.h"
+}
+
+void BlockDecoder::DecodeRowSSE41(RowFormat format, const uint8_t* blocks, size_t count, uint8_t* const (&rows)[4])
+{
+	BlockKernel<SSE41>::DecodeRow(format, blocks, count, rows);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
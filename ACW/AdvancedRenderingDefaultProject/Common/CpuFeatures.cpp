@@ -0,0 +1,101 @@
+#include "CpuFeatures.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define DX_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+using namespace DX;
+
+namespace
+{
+#if defined(DX_CPU_X86)
+	void CpuId(int leaf, int subLeaf, unsigned int regs[4])
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuidex(info, leaf, subLeaf);
+		for (int i = 0; i < 4; i++)
+		{
+			regs[i] = static_cast<unsigned int>(info[i]);
+		}
+#else
+		__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	unsigned long long ReadXcr0()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+	}
+#endif
+
+	SimdLevel DetectSimdLevel()
+	{
+#if defined(DX_CPU_X86)
+		unsigned int regs[4];
+		CpuId(0, 0, regs);
+		int maxLeaf = static_cast<int>(regs[0]);
+
+		CpuId(1, 0, regs);
+		bool sse41 = (regs[2] & (1u << 19)) != 0;
+		bool osxsave = (regs[2] & (1u << 27)) != 0;
+		bool avx = (regs[2] & (1u << 28)) != 0;
+
+		if (!sse41)
+		{
+			return SimdLevel::Scalar;
+		}
+
+		// The OS must save the YMM (and for AVX-512 the ZMM/opmask) state across context switches.
+		unsigned long long xcr0 = osxsave ? ReadXcr0() : 0;
+		bool osYmm = (xcr0 & 0x6) == 0x6;
+		bool osZmm = (xcr0 & 0xe6) == 0xe6;
+
+		if (!avx || !osYmm || maxLeaf < 7)
+		{
+			return SimdLevel::SSE41;
+		}
+
+		CpuId(7, 0, regs);
+		bool avx2 = (regs[1] & (1u << 5)) != 0;
+		bool avx512f = (regs[1] & (1u << 16)) != 0;
+
+		if (avx512f && osZmm)
+		{
+			return SimdLevel::AVX512;
+		}
+
+		return avx2 ? SimdLevel::AVX2 : SimdLevel::SSE41;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+}
+
+SimdLevel DX::GetSupportedSimdLevel()
+{
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+const char* DX::SimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::SSE41:	return "sse4.1";
+	case SimdLevel::AVX2:	return "avx2";
+	case SimdLevel::AVX512:	return "avx512";
+	default:				return "scalar";
+	}
+}
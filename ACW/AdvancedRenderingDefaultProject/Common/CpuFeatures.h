@@ -0,0 +1,21 @@
+#pragma once
+
+namespace DX
+{
+	// Widest vector instruction set a CPU code path may use.
+	enum class SimdLevel
+	{
+		Scalar,
+		SSE41,
+		AVX2,
+		AVX512
+	};
+
+	// Highest level supported by both the CPU and the operating system (checked once via cpuid/xgetbv).
+	SimdLevel GetSupportedSimdLevel();
+
+	// True if level can run on this machine.
+	inline bool IsSimdLevelSupported(SimdLevel level) { return level <= GetSupportedSimdLevel(); }
+
+	const char* SimdLevelName(SimdLevel level);
+}
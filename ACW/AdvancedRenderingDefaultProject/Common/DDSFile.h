@@ -0,0 +1,245 @@
+//--------------------------------------------------------------------------------------
+// File: DDSFile.h
+//
+// DDS header parsing and subresource layout, split out of DDSTextureLoader so it builds
+// without Direct3D. DDSTextureLoader creates the D3D11 resource from what this finds.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+// http://go.microsoft.com/fwlink/?LinkId=248929
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// A DDS file names its format with a DXGI_FORMAT. The enum comes from the Windows SDK
+// where there is one, and is declared here, with the same values, everywhere else.
+#define DDS_DXGI_FORMATS(X) \
+	X(UNKNOWN, 0) X(R32G32B32A32_TYPELESS, 1) X(R32G32B32A32_FLOAT, 2) X(R32G32B32A32_UINT, 3) \
+	X(R32G32B32A32_SINT, 4) X(R32G32B32_TYPELESS, 5) X(R32G32B32_FLOAT, 6) X(R32G32B32_UINT, 7) \
+	X(R32G32B32_SINT, 8) X(R16G16B16A16_TYPELESS, 9) X(R16G16B16A16_FLOAT, 10) X(R16G16B16A16_UNORM, 11) \
+	X(R16G16B16A16_UINT, 12) X(R16G16B16A16_SNORM, 13) X(R16G16B16A16_SINT, 14) X(R32G32_TYPELESS, 15) \
+	X(R32G32_FLOAT, 16) X(R32G32_UINT, 17) X(R32G32_SINT, 18) X(R32G8X24_TYPELESS, 19) \
+	X(D32_FLOAT_S8X24_UINT, 20) X(R32_FLOAT_X8X24_TYPELESS, 21) X(X32_TYPELESS_G8X24_UINT, 22) \
+	X(R10G10B10A2_TYPELESS, 23) X(R10G10B10A2_UNORM, 24) X(R10G10B10A2_UINT, 25) X(R11G11B10_FLOAT, 26) \
+	X(R8G8B8A8_TYPELESS, 27) X(R8G8B8A8_UNORM, 28) X(R8G8B8A8_UNORM_SRGB, 29) X(R8G8B8A8_UINT, 30) \
+	X(R8G8B8A8_SNORM, 31) X(R8G8B8A8_SINT, 32) X(R16G16_TYPELESS, 33) X(R16G16_FLOAT, 34) \
+	X(R16G16_UNORM, 35) X(R16G16_UINT, 36) X(R16G16_SNORM, 37) X(R16G16_SINT, 38) X(R32_TYPELESS, 39) \
+	X(D32_FLOAT, 40) X(R32_FLOAT, 41) X(R32_UINT, 42) X(R32_SINT, 43) X(R24G8_TYPELESS, 44) \
+	X(D24_UNORM_S8_UINT, 45) X(R24_UNORM_X8_TYPELESS, 46) X(X24_TYPELESS_G8_UINT, 47) X(R8G8_TYPELESS, 48) \
+	X(R8G8_UNORM, 49) X(R8G8_UINT, 50) X(R8G8_SNORM, 51) X(R8G8_SINT, 52) X(R16_TYPELESS, 53) \
+	X(R16_FLOAT, 54) X(D16_UNORM, 55) X(R16_UNORM, 56) X(R16_UINT, 57) X(R16_SNORM, 58) X(R16_SINT, 59) \
+	X(R8_TYPELESS, 60) X(R8_UNORM, 61) X(R8_UINT, 62) X(R8_SNORM, 63) X(R8_SINT, 64) X(A8_UNORM, 65) \
+	X(R1_UNORM, 66) X(R9G9B9E5_SHAREDEXP, 67) X(R8G8_B8G8_UNORM, 68) X(G8R8_G8B8_UNORM, 69) \
+	X(BC1_TYPELESS, 70) X(BC1_UNORM, 71) X(BC1_UNORM_SRGB, 72) X(BC2_TYPELESS, 73) X(BC2_UNORM, 74) \
+	X(BC2_UNORM_SRGB, 75) X(BC3_TYPELESS, 76) X(BC3_UNORM, 77) X(BC3_UNORM_SRGB, 78) X(BC4_TYPELESS, 79) \
+	X(BC4_UNORM, 80) X(BC4_SNORM, 81) X(BC5_TYPELESS, 82) X(BC5_UNORM, 83) X(BC5_SNORM, 84) \
+	X(B5G6R5_UNORM, 85) X(B5G5R5A1_UNORM, 86) X(B8G8R8A8_UNORM, 87) X(B8G8R8X8_UNORM, 88) \
+	X(R10G10B10_XR_BIAS_A2_UNORM, 89) X(B8G8R8A8_TYPELESS, 90) X(B8G8R8A8_UNORM_SRGB, 91) \
+	X(B8G8R8X8_TYPELESS, 92) X(B8G8R8X8_UNORM_SRGB, 93) X(BC6H_TYPELESS, 94) X(BC6H_UF16, 95) \
+	X(BC6H_SF16, 96) X(BC7_TYPELESS, 97) X(BC7_UNORM, 98) X(BC7_UNORM_SRGB, 99) X(AYUV, 100) \
+	X(Y410, 101) X(Y416, 102) X(NV12, 103) X(P010, 104) X(P016, 105) X(420_OPAQUE, 106) X(YUY2, 107) \
+	X(Y210, 108) X(Y216, 109) X(NV11, 110) X(AI44, 111) X(IA44, 112) X(P8, 113) X(A8P8, 114) \
+	X(B4G4R4A4_UNORM, 115) X(P208, 130) X(V208, 131) X(V408, 132)
+
+#if defined(_WIN32)
+#include <dxgiformat.h>
+#else
+#define DDS_DXGI_FORMAT_ENUM(name, value) DXGI_FORMAT_##name = value,
+enum DXGI_FORMAT
+{
+	DDS_DXGI_FORMATS(DDS_DXGI_FORMAT_ENUM)
+	DXGI_FORMAT_FORCE_UINT = 0xffffffff
+};
+#undef DDS_DXGI_FORMAT_ENUM
+#endif
+
+#ifndef MAKEFOURCC
+	#define MAKEFOURCC(ch0, ch1, ch2, ch3)                              \
+				((uint32_t)(uint8_t)(ch0) | ((uint32_t)(uint8_t)(ch1) << 8) |       \
+				((uint32_t)(uint8_t)(ch2) << 16) | ((uint32_t)(uint8_t)(ch3) << 24 ))
+#endif /* defined(MAKEFOURCC) */
+
+//--------------------------------------------------------------------------------------
+// DDS file structure definitions
+//
+// See DDS.h in the 'Texconv' sample and the 'DirectXTex' library
+//--------------------------------------------------------------------------------------
+#pragma pack(push,1)
+
+const uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+struct DDS_PIXELFORMAT
+{
+	uint32_t	size;
+	uint32_t	flags;
+	uint32_t	fourCC;
+	uint32_t	RGBBitCount;
+	uint32_t	RBitMask;
+	uint32_t	GBitMask;
+	uint32_t	BBitMask;
+	uint32_t	ABitMask;
+};
+
+#define DDS_FOURCC      0x00000004  // DDPF_FOURCC
+#define DDS_RGB         0x00000040  // DDPF_RGB
+#define DDS_LUMINANCE   0x00020000  // DDPF_LUMINANCE
+#define DDS_ALPHA       0x00000002  // DDPF_ALPHA
+#define DDS_BUMPDUDV    0x00080000  // DDPF_BUMPDUDV
+
+#define DDS_HEADER_FLAGS_VOLUME         0x00800000  // DDSD_DEPTH
+
+#define DDS_HEIGHT 0x00000002 // DDSD_HEIGHT
+#define DDS_WIDTH  0x00000004 // DDSD_WIDTH
+
+#define DDS_CUBEMAP_POSITIVEX 0x00000600 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEX
+#define DDS_CUBEMAP_NEGATIVEX 0x00000a00 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEX
+#define DDS_CUBEMAP_POSITIVEY 0x00001200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEY
+#define DDS_CUBEMAP_NEGATIVEY 0x00002200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEY
+#define DDS_CUBEMAP_POSITIVEZ 0x00004200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEZ
+#define DDS_CUBEMAP_NEGATIVEZ 0x00008200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEZ
+
+#define DDS_CUBEMAP_ALLFACES ( DDS_CUBEMAP_POSITIVEX | DDS_CUBEMAP_NEGATIVEX |\
+                               DDS_CUBEMAP_POSITIVEY | DDS_CUBEMAP_NEGATIVEY |\
+                               DDS_CUBEMAP_POSITIVEZ | DDS_CUBEMAP_NEGATIVEZ )
+
+#define DDS_CUBEMAP 0x00000200 // DDSCAPS2_CUBEMAP
+
+// The DX10 header's resource dimensions and cube flag, with the values of
+// D3D11_RESOURCE_DIMENSION and D3D11_RESOURCE_MISC_TEXTURECUBE.
+enum DDS_RESOURCE_DIMENSION
+{
+	DDS_DIMENSION_TEXTURE1D = 2,
+	DDS_DIMENSION_TEXTURE2D = 3,
+	DDS_DIMENSION_TEXTURE3D = 4,
+};
+
+#define DDS_RESOURCE_MISC_TEXTURECUBE 0x4
+
+enum DDS_MISC_FLAGS2
+{
+	DDS_MISC_FLAGS2_ALPHA_MODE_MASK = 0x7L,
+};
+
+enum DDS_ALPHA_MODE
+{
+	DDS_ALPHA_MODE_UNKNOWN = 0,
+	DDS_ALPHA_MODE_STRAIGHT = 1,
+	DDS_ALPHA_MODE_PREMULTIPLIED = 2,
+	DDS_ALPHA_MODE_OPAQUE = 3,
+	DDS_ALPHA_MODE_CUSTOM = 4,
+};
+
+struct DDS_HEADER
+{
+	uint32_t		size;
+	uint32_t		flags;
+	uint32_t		height;
+	uint32_t		width;
+	uint32_t		pitchOrLinearSize;
+	uint32_t		depth; // only if DDS_HEADER_FLAGS_VOLUME is set in flags
+	uint32_t		mipMapCount;
+	uint32_t		reserved1[11];
+	DDS_PIXELFORMAT	ddspf;
+	uint32_t		caps;
+	uint32_t		caps2;
+	uint32_t		caps3;
+	uint32_t		caps4;
+	uint32_t		reserved2;
+};
+
+struct DDS_HEADER_DXT10
+{
+	DXGI_FORMAT		dxgiFormat;
+	uint32_t		resourceDimension;
+	uint32_t		miscFlag; // see DDS_RESOURCE_MISC_TEXTURECUBE
+	uint32_t		arraySize;
+	uint32_t		miscFlags2;
+};
+
+#pragma pack(pop)
+
+namespace DX
+{
+	// Why a DDS file was rejected. DDSTextureLoader reports each as the HRESULT it always has.
+	enum class DDSStatus
+	{
+		Ok,
+		NotDDS,				// too short, wrong magic number or header sizes (E_FAIL)
+		InvalidData,		// the headers contradict each other
+		NotSupported,		// a format or dimension with no DXGI equivalent
+		EndOfFile,			// the surfaces run past the end of the file
+		ArithmeticOverflow,	// a surface too big to address on this platform
+		InvalidFormat		// a format with no size (E_INVALIDARG)
+	};
+
+	// What a DDS file holds, after the legacy header or DX10 extension is decoded. Cube maps
+	// count six array items per cube.
+	struct DDSTextureDesc
+	{
+		uint32_t		resourceDimension;	// DDS_RESOURCE_DIMENSION
+		DXGI_FORMAT		format;
+		size_t			width;
+		size_t			height;				// 1 for 1D textures
+		size_t			depth;				// 1 unless 3D
+		size_t			mipCount;			// at least 1
+		size_t			arraySize;
+		bool			isCubeMap;
+		DDS_ALPHA_MODE	alphaMode;
+	};
+
+	// A DDS file in memory. The pointers are into the caller's data, which must outlive it.
+	struct DDSFile
+	{
+		const DDS_HEADER*		header;
+		const DDS_HEADER_DXT10*	headerDX10;		// null without the DX10 extension
+		const uint8_t*			bitData;		// the surfaces, after the headers
+		size_t					bitSize;
+		DDSTextureDesc			desc;
+	};
+
+	// One mip level of one array item: its size in texels, and its rows of texels or 4x4
+	// blocks (rowCount of them, rowPitch bytes apart, per depth slice).
+	struct DDSSubresource
+	{
+		const uint8_t*	data;
+		size_t			width;
+		size_t			height;
+		size_t			depth;
+		size_t			rowPitch;
+		size_t			slicePitch;
+		size_t			rowCount;
+	};
+
+	// Validates the headers of the size bytes at data and decodes what they describe.
+	DDSStatus ParseDDS(const uint8_t* data, size_t size, DDSFile& file);
+
+	// Lays out file's surfaces in Direct3D's subresource order (each array item's mips in
+	// turn), leaving out the top skipMip levels of any mipmapped texture wider, taller or
+	// deeper than maxsize (0 keeps them all).
+	DDSStatus GetDDSSubresources(const DDSFile& file, size_t maxsize, std::vector<DDSSubresource>& subresources, size_t& skipMip);
+
+	// Bytes, bytes per row and rows of a width x height surface of fmt. Block-compressed
+	// formats count rows of 4x4 blocks.
+	DDSStatus GetSurfaceInfo(size_t width, size_t height, DXGI_FORMAT fmt, size_t* outNumBytes, size_t* outRowBytes, size_t* outNumRows);
+
+	// Bits per texel of fmt, or 0 when it has no size.
+	size_t BitsPerPixel(DXGI_FORMAT fmt);
+
+	// The format a legacy (pre-DX10) pixel format describes, or DXGI_FORMAT_UNKNOWN.
+	DXGI_FORMAT GetDXGIFormat(const DDS_PIXELFORMAT& ddpf);
+
+	// The sRGB variant of format, or format when it has none.
+	DXGI_FORMAT MakeSRGB(DXGI_FORMAT format);
+
+	bool IsCompressed(DXGI_FORMAT fmt);
+
+	// fmt's name without the DXGI_FORMAT_ prefix, and status's name, for tools and logs.
+	const char* GetDXGIFormatName(DXGI_FORMAT fmt);
+	const char* GetDDSStatusName(DDSStatus status);
+}
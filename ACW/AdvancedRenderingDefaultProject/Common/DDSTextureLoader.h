@@ -19,14 +19,9 @@
 #include <d3d11_1.h>
 #include <stdint.h>
 
-enum DDS_ALPHA_MODE
-{
-	DDS_ALPHA_MODE_UNKNOWN = 0,
-	DDS_ALPHA_MODE_STRAIGHT = 1,
-	DDS_ALPHA_MODE_PREMULTIPLIED = 2,
-	DDS_ALPHA_MODE_OPAQUE = 3,
-	DDS_ALPHA_MODE_CUSTOM = 4,
-};
+// Parsing and the subresource layout live in DDSFile, which builds without D3D; these
+// functions only read files and create the resources.
+#include "DDSFile.h"
 
 // Standard version
 HRESULT CreateDDSTextureFromMemory(
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// Minimal HLSL-style vector types so shader code can be ported to the CPU line by line.
+// Deliberately free of any Windows or DirectXMath dependency so it builds on Linux.
+namespace DX
+{
+	struct float2
+	{
+		float x, y;
+
+		float2() : x(0.0f), y(0.0f) {}
+		explicit float2(float s) : x(s), y(s) {}
+		float2(float x, float y) : x(x), y(y) {}
+	};
+
+	struct float3
+	{
+		float x, y, z;
+
+		float3() : x(0.0f), y(0.0f), z(0.0f) {}
+		explicit float3(float s) : x(s), y(s), z(s) {}
+		float3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+		float2 xy() const { return float2(x, y); }
+		float2 xz() const { return float2(x, z); }
+	};
+
+	struct float4
+	{
+		float x, y, z, w;
+
+		float4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+		explicit float4(float s) : x(s), y(s), z(s), w(s) {}
+		float4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+		float4(const float3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+		float3 xyz() const { return float3(x, y, z); }
+	};
+
+	// float2
+	inline float2 operator+(const float2& a, const float2& b) { return float2(a.x + b.x, a.y + b.y); }
+	inline float2 operator-(const float2& a, const float2& b) { return float2(a.x - b.x, a.y - b.y); }
+	inline float2 operator*(const float2& a, const float2& b) { return float2(a.x * b.x, a.y * b.y); }
+	inline float2 operator*(const float2& a, float s) { return float2(a.x * s, a.y * s); }
+	inline float2 operator*(float s, const float2& a) { return float2(a.x * s, a.y * s); }
+	inline float2 operator-(const float2& a) { return float2(-a.x, -a.y); }
+
+	inline float dot(const float2& a, const float2& b) { return a.x * b.x + a.y * b.y; }
+	inline float length(const float2& a) { return std::sqrt(dot(a, a)); }
+	inline float2 max(const float2& a, float s) { return float2(std::max(a.x, s), std::max(a.y, s)); }
+
+	// float3
+	inline float3 operator+(const float3& a, const float3& b) { return float3(a.x + b.x, a.y + b.y, a.z + b.z); }
+	inline float3 operator-(const float3& a, const float3& b) { return float3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	inline float3 operator*(const float3& a, const float3& b) { return float3(a.x * b.x, a.y * b.y, a.z * b.z); }
+	inline float3 operator+(const float3& a, float s) { return float3(a.x + s, a.y + s, a.z + s); }
+	inline float3 operator-(const float3& a, float s) { return float3(a.x - s, a.y - s, a.z - s); }
+	inline float3 operator*(const float3& a, float s) { return float3(a.x * s, a.y * s, a.z * s); }
+	inline float3 operator*(float s, const float3& a) { return float3(a.x * s, a.y * s, a.z * s); }
+	inline float3 operator/(const float3& a, float s) { return float3(a.x / s, a.y / s, a.z / s); }
+	inline float3 operator-(const float3& a) { return float3(-a.x, -a.y, -a.z); }
+	inline float3& operator+=(float3& a, const float3& b) { a = a + b; return a; }
+
+	inline float dot(const float3& a, const float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline float length(const float3& a) { return std::sqrt(dot(a, a)); }
+	inline float3 normalize(const float3& a) { return a * (1.0f / length(a)); }
+	inline float3 cross(const float3& a, const float3& b) { return float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
+	inline float3 abs(const float3& a) { return float3(std::fabs(a.x), std::fabs(a.y), std::fabs(a.z)); }
+	inline float3 max(const float3& a, float s) { return float3(std::max(a.x, s), std::max(a.y, s), std::max(a.z, s)); }
+	inline float3 min(const float3& a, float s) { return float3(std::min(a.x, s), std::min(a.y, s), std::min(a.z, s)); }
+	inline float3 min(const float3& a, const float3& b) { return float3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)); }
+	inline float3 max(const float3& a, const float3& b) { return float3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)); }
+	inline float3 lerp(const float3& a, const float3& b, float t) { return a + (b - a) * t; }
+	inline float3 reflect(const float3& i, const float3& n) { return i - 2.0f * dot(n, i) * n; }
+
+	// float4
+	inline float4 operator+(const float4& a, const float4& b) { return float4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w); }
+	inline float4 operator-(const float4& a, const float4& b) { return float4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w); }
+	inline float4 operator*(const float4& a, const float4& b) { return float4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w); }
+	inline float4 operator*(const float4& a, float s) { return float4(a.x * s, a.y * s, a.z * s, a.w * s); }
+	inline float4 operator*(float s, const float4& a) { return float4(a.x * s, a.y * s, a.z * s, a.w * s); }
+	inline float4 lerp(const float4& a, const float4& b, float t) { return a + (b - a) * t; }
+
+	// Row-major matrix applied to row vectors, as DirectXMath builds them. The renderer uploads
+	// them transposed, so mul(v, m) here is mul(v, m) in the shaders.
+	struct float4x4
+	{
+		float m[4][4];
+
+		float4x4()
+		{
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					m[r][c] = r == c ? 1.0f : 0.0f;
+				}
+			}
+		}
+	};
+
+	inline float4 mul(const float4& v, const float4x4& a)
+	{
+		return float4(
+			v.x * a.m[0][0] + v.y * a.m[1][0] + v.z * a.m[2][0] + v.w * a.m[3][0],
+			v.x * a.m[0][1] + v.y * a.m[1][1] + v.z * a.m[2][1] + v.w * a.m[3][1],
+			v.x * a.m[0][2] + v.y * a.m[1][2] + v.z * a.m[2][2] + v.w * a.m[3][2],
+			v.x * a.m[0][3] + v.y * a.m[1][3] + v.z * a.m[2][3] + v.w * a.m[3][3]);
+	}
+
+	inline float4x4 mul(const float4x4& a, const float4x4& b)
+	{
+		float4x4 result;
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				result.m[r][c] = a.m[r][0] * b.m[0][c] + a.m[r][1] * b.m[1][c] + a.m[r][2] * b.m[2][c] + a.m[r][3] * b.m[3][c];
+			}
+		}
+		return result;
+	}
+
+	// Scalar intrinsics
+	inline float clamp(float x, float lo, float hi) { return std::min(std::max(x, lo), hi); }
+	inline float saturate(float x) { return clamp(x, 0.0f, 1.0f); }
+	inline float sign(float x) { return x > 0.0f ? 1.0f : (x < 0.0f ? -1.0f : 0.0f); }
+	inline float lerp(float a, float b, float t) { return a + (b - a) * t; }
+	inline float frac(float x) { return x - std::floor(x); }
+
+	// GLSL style modulo used throughout the shaders.
+	inline float mod(float x, float y) { return x - y * std::floor(x / y); }
+}
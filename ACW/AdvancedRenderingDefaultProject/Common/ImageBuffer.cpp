@@ -0,0 +1,33 @@
+#include "ImageBuffer.h"
+
+#include <cstdio>
+
+using namespace DX;
+
+bool ImageBuffer::SavePPM(const std::string& path) const
+{
+	FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	std::fprintf(file, "P6\n%u %u\n255\n", m_width, m_height);
+
+	std::vector<unsigned char> row(static_cast<size_t>(m_width) * 3);
+	for (unsigned int y = 0; y < m_height; y++)
+	{
+		for (unsigned int x = 0; x < m_width; x++)
+		{
+			const float4& pixel = At(x, y);
+			row[x * 3 + 0] = static_cast<unsigned char>(saturate(pixel.x) * 255.0f + 0.5f);
+			row[x * 3 + 1] = static_cast<unsigned char>(saturate(pixel.y) * 255.0f + 0.5f);
+			row[x * 3 + 2] = static_cast<unsigned char>(saturate(pixel.z) * 255.0f + 0.5f);
+		}
+		std::fwrite(row.data(), 1, row.size(), file);
+	}
+
+	bool ok = std::ferror(file) == 0;
+	std::fclose(file);
+	return ok;
+}
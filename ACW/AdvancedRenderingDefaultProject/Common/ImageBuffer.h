@@ -0,0 +1,43 @@
+#pragma once
+
+#include "HlslMath.h"
+
+#include <string>
+#include <vector>
+
+namespace DX
+{
+	// Linear float RGBA image used as the render target for the CPU renderers.
+	class ImageBuffer
+	{
+	public:
+		ImageBuffer() : m_width(0), m_height(0) {}
+		ImageBuffer(unsigned int width, unsigned int height) { Resize(width, height); }
+
+		void Resize(unsigned int width, unsigned int height)
+		{
+			m_width = width;
+			m_height = height;
+			m_pixels.assign(static_cast<size_t>(width) * height, float4());
+		}
+
+		void Clear(const float4& color) { std::fill(m_pixels.begin(), m_pixels.end(), color); }
+
+		unsigned int GetWidth() const { return m_width; }
+		unsigned int GetHeight() const { return m_height; }
+
+		float4& At(unsigned int x, unsigned int y) { return m_pixels[static_cast<size_t>(y) * m_width + x]; }
+		const float4& At(unsigned int x, unsigned int y) const { return m_pixels[static_cast<size_t>(y) * m_width + x]; }
+
+		float4* GetData() { return m_pixels.data(); }
+		const float4* GetData() const { return m_pixels.data(); }
+
+		// Writes a binary PPM (P6), clamping each channel to [0,1]. Alpha is dropped.
+		bool SavePPM(const std::string& path) const;
+
+	private:
+		unsigned int		m_width;
+		unsigned int		m_height;
+		std::vector<float4>	m_pixels;
+	};
+}
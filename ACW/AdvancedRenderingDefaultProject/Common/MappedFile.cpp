@@ -0,0 +1,175 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DX;
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const wchar_t* path)
+{
+	Close();
+
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+	HANDLE file = CreateFile2(path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+#else
+	HANDLE file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		m_error = static_cast<int>(GetLastError());
+		return false;
+	}
+
+	// The mapping and its view keep the file open; the handle is not needed past here.
+	FILE_STANDARD_INFO fileInfo;
+	bool mapped = false;
+	if (!GetFileInformationByHandleEx(file, FileStandardInfo, &fileInfo, sizeof(fileInfo)))
+	{
+		m_error = static_cast<int>(GetLastError());
+	}
+	else if (fileInfo.EndOfFile.QuadPart == 0)
+	{
+		mapped = true;
+	}
+	else if (static_cast<unsigned long long>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
+	{
+		m_error = ERROR_ARITHMETIC_OVERFLOW;
+	}
+	else
+	{
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+		HANDLE mapping = CreateFileMappingFromApp(file, nullptr, PAGE_READONLY, 0, nullptr);
+#else
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+#endif
+		if (mapping)
+		{
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+			void* view = MapViewOfFileFromApp(mapping, FILE_MAP_READ, 0, 0);
+#else
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#endif
+			if (view)
+			{
+				m_mapping = mapping;
+				m_data = static_cast<const uint8_t*>(view);
+				m_size = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
+				mapped = true;
+			}
+			else
+			{
+				m_error = static_cast<int>(GetLastError());
+				CloseHandle(mapping);
+			}
+		}
+		else
+		{
+			m_error = static_cast<int>(GetLastError());
+		}
+	}
+
+	CloseHandle(file);
+	return mapped;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping)
+	{
+		CloseHandle(m_mapping);
+	}
+	m_data = nullptr;
+	m_mapping = nullptr;
+	m_size = 0;
+}
+
+void MappedFile::Prefetch() const
+{
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+	if (m_data)
+	{
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = const_cast<uint8_t*>(m_data);
+		range.NumberOfBytes = m_size;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#endif
+}
+
+#else
+
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+	{
+		m_error = errno;
+		return false;
+	}
+
+	// The mapping keeps the file open; the descriptor is not needed past here.
+	struct stat status;
+	bool mapped = false;
+	if (fstat(file, &status) != 0)
+	{
+		m_error = errno;
+	}
+	else if (status.st_size == 0)
+	{
+		mapped = true;
+	}
+	else
+	{
+		void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED)
+		{
+			m_data = static_cast<const uint8_t*>(view);
+			m_size = static_cast<size_t>(status.st_size);
+			mapped = true;
+		}
+		else
+		{
+			m_error = errno;
+		}
+	}
+
+	close(file);
+	return mapped;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+	m_data = nullptr;
+	m_size = 0;
+}
+
+void MappedFile::Prefetch() const
+{
+	if (m_data)
+	{
+		void* view = const_cast<uint8_t*>(m_data);
+		madvise(view, m_size, MADV_SEQUENTIAL);
+		madvise(view, m_size, MADV_WILLNEED);
+	}
+}
+
+#endif
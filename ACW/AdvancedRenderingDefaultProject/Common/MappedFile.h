@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DX
+{
+	// A whole file mapped read-only into memory, unmapped when closed or destroyed. Pages are
+	// read from the file as they are first touched, so texture loaders can hand pointers into
+	// the view straight to resource creation instead of reading the file into a copy first.
+	// Uses a file mapping on Windows and mmap everywhere else.
+	class MappedFile
+	{
+	public:
+		MappedFile() : m_data(nullptr), m_size(0), m_error(0), m_mapping(nullptr) {}
+		~MappedFile() { Close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// Maps the file at path, closing any file already mapped. An empty file opens with no
+		// data. On failure GetError holds the reason (GetLastError() or errno).
+#if defined(_WIN32)
+		bool Open(const wchar_t* path);
+#else
+		bool Open(const char* path);
+#endif
+		void Close();
+
+		// Asks for the whole view to be read ahead, sequentially, before it is touched
+		// (PrefetchVirtualMemory, or madvise WILLNEED and SEQUENTIAL).
+		void Prefetch() const;
+
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+		int GetError() const { return m_error; }
+
+	private:
+		const uint8_t*	m_data;
+		size_t			m_size;
+		int				m_error;
+		void*			m_mapping;		// the file mapping object's handle on Windows
+	};
+}
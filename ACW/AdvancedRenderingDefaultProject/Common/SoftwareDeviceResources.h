@@ -0,0 +1,40 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+#include "ThreadPool.h"
+
+#include <memory>
+
+namespace DX
+{
+	// Portable stand-in for DeviceResources: owns an offscreen colour and depth target drawn by
+	// the software rasterizer instead of a swap chain, so the explicit passes can run headless.
+	class SoftwareDeviceResources
+	{
+	public:
+		SoftwareDeviceResources(unsigned int width, unsigned int height, const std::shared_ptr<ThreadPool>& threadPool) :
+			m_threadPool(threadPool),
+			m_rasterizer(threadPool)
+		{
+			SetOutputSize(width, height);
+		}
+
+		void SetOutputSize(unsigned int width, unsigned int height) { m_rasterizer.Resize(width, height); }
+
+		// Finishes the frame; the result is then in GetBackBuffer.
+		void Present() { m_rasterizer.Flush(); }
+
+		// The size of the render target, in pixels.
+		unsigned int			GetOutputWidth() const		{ return m_rasterizer.GetWidth(); }
+		unsigned int			GetOutputHeight() const		{ return m_rasterizer.GetHeight(); }
+		float					GetAspectRatio() const		{ return static_cast<float>(GetOutputWidth()) / static_cast<float>(GetOutputHeight()); }
+
+		SoftwareRasterizer&		GetRasterizer()				{ return m_rasterizer; }
+		const ImageBuffer&		GetBackBuffer() const		{ return m_rasterizer.GetColor(); }
+		ThreadPool&				GetThreadPool() const		{ return *m_threadPool; }
+
+	private:
+		std::shared_ptr<ThreadPool>	m_threadPool;
+		SoftwareRasterizer			m_rasterizer;
+	};
+}
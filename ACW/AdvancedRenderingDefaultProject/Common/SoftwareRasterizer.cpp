@@ -0,0 +1,491 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define SOFTWARE_RASTERIZER_SSE2 1
+#endif
+
+using namespace DX;
+
+namespace
+{
+	// Clip-space x and y are clipped to this multiple of w; the rest of the screen-space guard
+	// band is handled by the bounding box, as on hardware.
+	const float GuardBand = 4.0f;
+
+	// D3D11 snaps vertices to 8 bits of sub-pixel precision.
+	const float SubPixelSteps = 256.0f;
+
+	const unsigned int MaxClipVertices = 9;
+
+	// Signed distances to the clip planes: 0 <= z <= w and |x|, |y| <= GuardBand * w.
+	const unsigned int ClipPlaneCount = 6;
+
+	float ClipDistance(const RasterVertex& v, unsigned int plane)
+	{
+		const float4& p = v.position;
+		switch (plane)
+		{
+		case 0: return p.z;
+		case 1: return p.w - p.z;
+		case 2: return GuardBand * p.w - p.x;
+		case 3: return GuardBand * p.w + p.x;
+		case 4: return GuardBand * p.w - p.y;
+		default: return GuardBand * p.w + p.y;
+		}
+	}
+
+	RasterVertex LerpVertex(const RasterVertex& a, const RasterVertex& b, float t)
+	{
+		RasterVertex v;
+		v.position = lerp(a.position, b.position, t);
+		v.varying = lerp(a.varying, b.varying, t);
+		return v;
+	}
+
+	// Sutherland-Hodgman against one plane. Returns the new vertex count.
+	unsigned int ClipPolygon(const RasterVertex* in, unsigned int count, unsigned int plane, RasterVertex* out)
+	{
+		unsigned int outCount = 0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const RasterVertex& a = in[i];
+			const RasterVertex& b = in[(i + 1) % count];
+			float da = ClipDistance(a, plane);
+			float db = ClipDistance(b, plane);
+
+			if (da >= 0.0f)
+			{
+				out[outCount++] = a;
+			}
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				out[outCount++] = LerpVertex(a, b, da / (da - db));
+			}
+		}
+		return outCount;
+	}
+
+	float Snap(float x)
+	{
+		return std::floor(x * SubPixelSteps + 0.5f) / SubPixelSteps;
+	}
+
+	float SignedArea(float ax, float ay, float bx, float by, float cx, float cy)
+	{
+		// Positive for triangles that are clockwise on screen (y pointing down).
+		return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+	}
+
+	double SecondsSince(const std::chrono::high_resolution_clock::time_point& start)
+	{
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+}
+
+SoftwareRasterizer::SoftwareRasterizer(const std::shared_ptr<ThreadPool>& threadPool) :
+	m_threadPool(threadPool),
+	m_tilesX(0),
+	m_tilesY(0)
+{
+}
+
+void SoftwareRasterizer::Resize(unsigned int width, unsigned int height)
+{
+	m_color.Resize(width, height);
+	m_tilesX = (width + TileSize - 1) / TileSize;
+	m_tilesY = (height + TileSize - 1) / TileSize;
+	m_depth.assign(static_cast<size_t>(m_tilesX) * m_tilesY * TileSize * TileSize, 1.0f);
+	m_bins.assign(static_cast<size_t>(m_tilesX) * m_tilesY, std::vector<unsigned int>());
+	m_states.clear();
+	m_triangles.clear();
+}
+
+void SoftwareRasterizer::Clear(const float4& color, float depth)
+{
+	// Anything still queued would be overwritten, so it is dropped rather than drawn.
+	m_states.clear();
+	m_triangles.clear();
+	for (auto& bin : m_bins)
+	{
+		bin.clear();
+	}
+
+	m_color.Clear(color);
+	std::fill(m_depth.begin(), m_depth.end(), depth);
+}
+
+float SoftwareRasterizer::GetDepth(unsigned int x, unsigned int y) const
+{
+	size_t tile = static_cast<size_t>(y / TileSize) * m_tilesX + x / TileSize;
+	return m_depth[tile * TileSize * TileSize + (y % TileSize) * TileSize + x % TileSize];
+}
+
+void SoftwareRasterizer::DrawTriangles(const RasterVertex* vertices, size_t vertexCount, const RasterState& state)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	unsigned int stateIndex = static_cast<unsigned int>(m_states.size());
+	m_states.push_back(state);
+
+	const float width = static_cast<float>(m_color.GetWidth());
+	const float height = static_cast<float>(m_color.GetHeight());
+
+	RasterVertex polygon[MaxClipVertices];
+	RasterVertex clipped[MaxClipVertices];
+
+	for (size_t t = 0; t + 2 < vertexCount; t += 3)
+	{
+		m_stats.trianglesIn++;
+
+		// Trivially reject triangles outside one plane; clip only those crossing one.
+		unsigned int count = 3;
+		polygon[0] = vertices[t];
+		polygon[1] = vertices[t + 1];
+		polygon[2] = vertices[t + 2];
+
+		bool outside = false;
+		bool crossing = false;
+		for (unsigned int plane = 0; plane < ClipPlaneCount; plane++)
+		{
+			unsigned int in = 0;
+			for (unsigned int v = 0; v < 3; v++)
+			{
+				in += ClipDistance(polygon[v], plane) >= 0.0f ? 1 : 0;
+			}
+			outside = outside || in == 0;
+			crossing = crossing || (in > 0 && in < 3);
+		}
+		if (outside)
+		{
+			continue;
+		}
+
+		if (crossing)
+		{
+			for (unsigned int plane = 0; plane < ClipPlaneCount && count >= 3; plane++)
+			{
+				count = ClipPolygon(polygon, count, plane, clipped);
+				std::copy(clipped, clipped + count, polygon);
+			}
+			if (count < 3)
+			{
+				continue;
+			}
+		}
+
+		// Perspective divide and viewport transform, y down.
+		ScreenVertex screen[MaxClipVertices];
+		for (unsigned int v = 0; v < count; v++)
+		{
+			const float4& p = polygon[v].position;
+			float invW = 1.0f / p.w;
+			screen[v].x = Snap((p.x * invW * 0.5f + 0.5f) * width);
+			screen[v].y = Snap((0.5f - p.y * invW * 0.5f) * height);
+			screen[v].z = p.z * invW;
+			screen[v].invW = invW;
+			screen[v].varyingOverW = polygon[v].varying * invW;
+		}
+
+		for (unsigned int v = 1; v + 1 < count; v++)
+		{
+			const ScreenVertex& a = screen[0];
+			const ScreenVertex& b = screen[v];
+			const ScreenVertex& c = screen[v + 1];
+
+			if (state.fill == RasterFillMode::Solid)
+			{
+				SetupTriangle(a, b, c, state.cull, stateIndex);
+				continue;
+			}
+
+			// Culling applies to the triangle, not to the quads drawn for its edges.
+			if (state.cull == RasterCullMode::Back && SignedArea(a.x, a.y, b.x, b.y, c.x, c.y) < 0.0f)
+			{
+				continue;
+			}
+
+			// Each edge becomes a one pixel wide quad. Edges the clipper added are drawn too.
+			const ScreenVertex* corners[3] = { &a, &b, &c };
+			for (unsigned int e = 0; e < 3; e++)
+			{
+				const ScreenVertex& p = *corners[e];
+				const ScreenVertex& q = *corners[(e + 1) % 3];
+				float dx = q.x - p.x;
+				float dy = q.y - p.y;
+				float edgeLength = std::sqrt(dx * dx + dy * dy);
+				if (edgeLength <= 0.0f)
+				{
+					continue;
+				}
+
+				float nx = -dy / edgeLength * 0.5f;
+				float ny = dx / edgeLength * 0.5f;
+
+				ScreenVertex p0 = p, p1 = p, q0 = q, q1 = q;
+				p0.x += nx; p0.y += ny;
+				p1.x -= nx; p1.y -= ny;
+				q0.x += nx; q0.y += ny;
+				q1.x -= nx; q1.y -= ny;
+
+				SetupTriangle(p0, q0, p1, RasterCullMode::None, stateIndex);
+				SetupTriangle(q0, q1, p1, RasterCullMode::None, stateIndex);
+			}
+		}
+	}
+
+	m_stats.setupSeconds += SecondsSince(start);
+}
+
+void SoftwareRasterizer::SetupTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c, RasterCullMode cull, unsigned int state)
+{
+	float area = SignedArea(a.x, a.y, b.x, b.y, c.x, c.y);
+	if (area == 0.0f || (cull == RasterCullMode::Back && area < 0.0f))
+	{
+		return;
+	}
+
+	// Make the triangle clockwise so all three edge functions are positive inside.
+	const ScreenVertex* v[3] = { &a, &b, &c };
+	if (area < 0.0f)
+	{
+		std::swap(v[1], v[2]);
+		area = -area;
+	}
+
+	// Pixel centres covered by the bounding box, clamped to the screen.
+	float minX = std::min(v[0]->x, std::min(v[1]->x, v[2]->x));
+	float maxX = std::max(v[0]->x, std::max(v[1]->x, v[2]->x));
+	float minY = std::min(v[0]->y, std::min(v[1]->y, v[2]->y));
+	float maxY = std::max(v[0]->y, std::max(v[1]->y, v[2]->y));
+
+	Triangle tri;
+	tri.minX = std::max(static_cast<int>(std::ceil(minX - 0.5f)), 0);
+	tri.minY = std::max(static_cast<int>(std::ceil(minY - 0.5f)), 0);
+	tri.maxX = std::min(static_cast<int>(std::floor(maxX - 0.5f)), static_cast<int>(m_color.GetWidth()) - 1);
+	tri.maxY = std::min(static_cast<int>(std::floor(maxY - 0.5f)), static_cast<int>(m_color.GetHeight()) - 1);
+	if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+	{
+		return;
+	}
+
+	// Edge i is opposite vertex i, so its function is that vertex's barycentric weight times the area.
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		const ScreenVertex& p = *v[(i + 1) % 3];
+		const ScreenVertex& q = *v[(i + 2) % 3];
+		tri.edgeA[i] = p.y - q.y;
+		tri.edgeB[i] = q.x - p.x;
+		tri.edgeC[i] = -(tri.edgeA[i] * p.x + tri.edgeB[i] * p.y);
+
+		// Top-left rule: pixels exactly on a top or left edge belong to this triangle.
+		tri.topLeft[i] = (tri.edgeA[i] == 0.0f && tri.edgeB[i] > 0.0f) || tri.edgeA[i] > 0.0f;
+
+		tri.z[i] = v[i]->z;
+		tri.invW[i] = v[i]->invW;
+		tri.varyingOverW[i] = v[i]->varyingOverW;
+	}
+	tri.invArea = 1.0f / area;
+	tri.state = state;
+
+	unsigned int index = static_cast<unsigned int>(m_triangles.size());
+	m_triangles.push_back(tri);
+	m_stats.trianglesBinned++;
+
+	// Bin to every tile the bounding box touches, unless one edge has the whole tile outside it.
+	unsigned int tileMinX = tri.minX / TileSize;
+	unsigned int tileMaxX = tri.maxX / TileSize;
+	unsigned int tileMinY = tri.minY / TileSize;
+	unsigned int tileMaxY = tri.maxY / TileSize;
+	bool singleTile = tileMinX == tileMaxX && tileMinY == tileMaxY;
+
+	for (unsigned int ty = tileMinY; ty <= tileMaxY; ty++)
+	{
+		for (unsigned int tx = tileMinX; tx <= tileMaxX; tx++)
+		{
+			if (!singleTile)
+			{
+				float x0 = static_cast<float>(tx * TileSize);
+				float y0 = static_cast<float>(ty * TileSize);
+				float x1 = x0 + TileSize;
+				float y1 = y0 + TileSize;
+
+				bool rejected = false;
+				for (unsigned int i = 0; i < 3 && !rejected; i++)
+				{
+					// The tile corner furthest inside the edge.
+					float x = tri.edgeA[i] > 0.0f ? x1 : x0;
+					float y = tri.edgeB[i] > 0.0f ? y1 : y0;
+					rejected = tri.edgeA[i] * x + tri.edgeB[i] * y + tri.edgeC[i] < 0.0f;
+				}
+				if (rejected)
+				{
+					continue;
+				}
+			}
+
+			m_bins[static_cast<size_t>(ty) * m_tilesX + tx].push_back(index);
+			m_stats.tileTriangles++;
+		}
+	}
+}
+
+void SoftwareRasterizer::Flush()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<unsigned long long> pixelsShaded(m_bins.size(), 0);
+	m_threadPool->ParallelFor(m_bins.size(), [&](size_t tile)
+	{
+		RasterizeTile(static_cast<unsigned int>(tile), pixelsShaded[tile]);
+		m_bins[tile].clear();
+	});
+
+	for (unsigned long long pixels : pixelsShaded)
+	{
+		m_stats.pixelsShaded += pixels;
+	}
+
+	m_states.clear();
+	m_triangles.clear();
+
+	m_stats.rasterSeconds += SecondsSince(start);
+}
+
+void SoftwareRasterizer::RasterizeTile(unsigned int tile, unsigned long long& pixelsShaded)
+{
+	const int tileX = static_cast<int>(tile % m_tilesX * TileSize);
+	const int tileY = static_cast<int>(tile / m_tilesX * TileSize);
+	float* tileDepth = &m_depth[static_cast<size_t>(tile) * TileSize * TileSize];
+
+	for (unsigned int index : m_bins[tile])
+	{
+		const Triangle& tri = m_triangles[index];
+		const RasterState& state = m_states[tri.state];
+
+		// Rows and columns of the tile the triangle can cover. Columns start on a multiple of
+		// four so each group of pixels is one aligned run of the tile's depth row.
+		int minX = std::max(tri.minX, tileX);
+		int maxX = std::min(tri.maxX, tileX + static_cast<int>(TileSize) - 1);
+		int minY = std::max(tri.minY, tileY);
+		int maxY = std::min(tri.maxY, tileY + static_cast<int>(TileSize) - 1);
+		if (minX > maxX || minY > maxY)
+		{
+			continue;
+		}
+		minX -= (minX - tileX) % 4;
+
+		// Depth interpolates linearly in screen space: z = zA * x + zB * y + zC.
+		float zA = 0.0f, zB = 0.0f, zC = 0.0f;
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			zA += tri.edgeA[i] * tri.z[i] * tri.invArea;
+			zB += tri.edgeB[i] * tri.z[i] * tri.invArea;
+			zC += tri.edgeC[i] * tri.z[i] * tri.invArea;
+		}
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float py = y + 0.5f;
+			float* depthRow = tileDepth + (y - tileY) * TileSize;
+
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				float px = x + 0.5f;
+				float edges[3][4];
+				float depths[4];
+				int mask = 0;
+
+#if SOFTWARE_RASTERIZER_SSE2
+				const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+				__m128 vx = _mm_add_ps(_mm_set1_ps(px), lanes);
+				__m128 vy = _mm_set1_ps(py);
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (unsigned int i = 0; i < 3; i++)
+				{
+					__m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri.edgeA[i]), vx),
+						_mm_mul_ps(_mm_set1_ps(tri.edgeB[i]), vy)), _mm_set1_ps(tri.edgeC[i]));
+					__m128 covered = tri.topLeft[i] ? _mm_cmpge_ps(e, _mm_setzero_ps()) : _mm_cmpgt_ps(e, _mm_setzero_ps());
+					inside = _mm_and_ps(inside, covered);
+					_mm_storeu_ps(edges[i], e);
+				}
+
+				__m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(zA), vx), _mm_mul_ps(_mm_set1_ps(zB), vy)), _mm_set1_ps(zC));
+				_mm_storeu_ps(depths, z);
+				if (state.depthTest)
+				{
+					inside = _mm_and_ps(inside, _mm_cmplt_ps(z, _mm_loadu_ps(depthRow + (x - tileX))));
+				}
+				mask = _mm_movemask_ps(inside);
+#else
+				for (int lane = 0; lane < 4; lane++)
+				{
+					float lx = px + lane;
+					bool covered = true;
+					for (unsigned int i = 0; i < 3; i++)
+					{
+						float e = tri.edgeA[i] * lx + tri.edgeB[i] * py + tri.edgeC[i];
+						covered = covered && (tri.topLeft[i] ? e >= 0.0f : e > 0.0f);
+						edges[i][lane] = e;
+					}
+					depths[lane] = zA * lx + zB * py + zC;
+					if (covered && (!state.depthTest || depths[lane] < depthRow[x - tileX + lane]))
+					{
+						mask |= 1 << lane;
+					}
+				}
+#endif
+
+				// Lanes past the triangle's last column may still be inside the tile row; drop them.
+				mask &= (1 << std::min(4, maxX - x + 1)) - 1;
+				if (x < tri.minX)
+				{
+					mask &= ~((1 << (tri.minX - x)) - 1);
+				}
+
+				for (int lane = 0; mask != 0; lane++, mask >>= 1)
+				{
+					if ((mask & 1) == 0)
+					{
+						continue;
+					}
+
+					// Perspective-correct interpolant.
+					float w0 = edges[0][lane], w1 = edges[1][lane], w2 = edges[2][lane];
+					float invW = w0 * tri.invW[0] + w1 * tri.invW[1] + w2 * tri.invW[2];
+					float4 varying = (tri.varyingOverW[0] * w0 + tri.varyingOverW[1] * w1 + tri.varyingOverW[2] * w2) * (1.0f / invW);
+
+					float4 color;
+					if (!state.pixelShader(varying, color))
+					{
+						continue;
+					}
+					pixelsShaded++;
+
+					// UNORM target: output is clamped before blending.
+					color = float4(saturate(color.x), saturate(color.y), saturate(color.z), saturate(color.w));
+
+					float4& target = m_color.At(x + lane, y);
+					if (state.alphaBlend)
+					{
+						float4 blended = lerp(target, color, color.w);
+						target = float4(blended.x, blended.y, blended.z, 0.0f);
+					}
+					else
+					{
+						target = color;
+					}
+
+					if (state.depthTest)
+					{
+						depthRow[x - tileX + lane] = depths[lane];
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "HlslMath.h"
+#include "ImageBuffer.h"
+#include "ThreadPool.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace DX
+{
+	// Output of the last shader stage before rasterization: a clip-space position and one
+	// perspective-correct interpolant (the passes only need a texture coordinate).
+	struct RasterVertex
+	{
+		float4 position;
+		float4 varying;
+	};
+
+	enum class RasterCullMode
+	{
+		None,
+		Back		// counter-clockwise on screen, as D3D11_CULL_BACK with clockwise front faces
+	};
+
+	enum class RasterFillMode
+	{
+		Solid,
+		Wireframe	// one pixel wide edges
+	};
+
+	// Pixel shader: colours the pixel from the interpolant, or returns false to discard it.
+	typedef std::function<bool(const float4& varying, float4& color)> RasterPixelShader;
+
+	struct RasterState
+	{
+		RasterCullMode		cull = RasterCullMode::Back;
+		RasterFillMode		fill = RasterFillMode::Solid;
+
+		// LESS test with depth writes, as D3D11's default depth-stencil state.
+		bool				depthTest = true;
+
+		// The renderer's blend state: SRC_ALPHA / INV_SRC_ALPHA on colour, zero alpha.
+		bool				alphaBlend = false;
+
+		RasterPixelShader	pixelShader;
+	};
+
+	struct RasterStats
+	{
+		unsigned long long	trianglesIn = 0;
+		unsigned long long	trianglesBinned = 0;	// after clipping, culling and wireframe expansion
+		unsigned long long	tileTriangles = 0;		// triangle / tile pairs rasterized
+		unsigned long long	pixelsShaded = 0;
+		double				setupSeconds = 0.0;
+		double				rasterSeconds = 0.0;
+	};
+
+	// Tile-binned triangle rasterizer. Draws are clipped, set up and binned to the screen tiles
+	// they touch as they are queued; Flush then rasterizes every tile on the thread pool, each
+	// tile walking its bin in submission order so blending matches the draw order. Coverage and
+	// the depth test are evaluated four pixels at a time, against a depth buffer laid out tile
+	// by tile so a tile's depth stays in cache while its bin is drawn.
+	class SoftwareRasterizer
+	{
+	public:
+		static const unsigned int TileSize = 64;
+
+		explicit SoftwareRasterizer(const std::shared_ptr<ThreadPool>& threadPool);
+
+		void Resize(unsigned int width, unsigned int height);
+		void Clear(const float4& color, float depth);
+
+		// Queues a triangle list, three vertices per triangle. The state is copied.
+		void DrawTriangles(const RasterVertex* vertices, size_t vertexCount, const RasterState& state);
+
+		// Rasterizes everything queued since the last Flush.
+		void Flush();
+
+		unsigned int GetWidth() const { return m_color.GetWidth(); }
+		unsigned int GetHeight() const { return m_color.GetHeight(); }
+		const ImageBuffer& GetColor() const { return m_color; }
+		float GetDepth(unsigned int x, unsigned int y) const;
+
+		// Counts since the last ResetStats.
+		const RasterStats& GetStats() const { return m_stats; }
+		void ResetStats() { m_stats = RasterStats(); }
+
+	private:
+		// Screen-space vertex: pixel position, depth, 1/w and the interpolant divided by w.
+		struct ScreenVertex
+		{
+			float	x, y, z, invW;
+			float4	varyingOverW;
+		};
+
+		// Edge functions A * x + B * y + C, positive inside, for a clockwise triangle.
+		struct Triangle
+		{
+			float			edgeA[3], edgeB[3], edgeC[3];
+			bool			topLeft[3];
+			float			invArea;
+			float			z[3];
+			float			invW[3];
+			float4			varyingOverW[3];
+			int				minX, minY, maxX, maxY;
+			unsigned int	state;
+		};
+
+		void SetupTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c, RasterCullMode cull, unsigned int state);
+		void RasterizeTile(unsigned int tile, unsigned long long& pixelsShaded);
+
+	private:
+		std::shared_ptr<ThreadPool>				m_threadPool;
+
+		ImageBuffer								m_color;
+		std::vector<float>						m_depth;		// TileSize * TileSize per tile
+		unsigned int							m_tilesX;
+		unsigned int							m_tilesY;
+
+		std::vector<RasterState>				m_states;
+		std::vector<Triangle>					m_triangles;
+		std::vector<std::vector<unsigned int>>	m_bins;			// triangle indices per tile
+
+		RasterStats								m_stats;
+	};
+}
@@ -0,0 +1,30 @@
+#include "SoftwareTexture.h"
+
+using namespace DX;
+
+float4 SoftwareTexture::Sample(const float2& uv) const
+{
+	if (m_texels.empty())
+	{
+		return float4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	// Texel centres sit at half-integer coordinates.
+	float x = clamp(uv.x, 0.0f, 1.0f) * m_width - 0.5f;
+	float y = clamp(uv.y, 0.0f, 1.0f) * m_height - 0.5f;
+	float fx = std::floor(x);
+	float fy = std::floor(y);
+	float tx = x - fx;
+	float ty = y - fy;
+
+	int maxX = static_cast<int>(m_width) - 1;
+	int maxY = static_cast<int>(m_height) - 1;
+	int x0 = std::min(std::max(static_cast<int>(fx), 0), maxX);
+	int y0 = std::min(std::max(static_cast<int>(fy), 0), maxY);
+	int x1 = std::min(std::max(static_cast<int>(fx) + 1, 0), maxX);
+	int y1 = std::min(std::max(static_cast<int>(fy) + 1, 0), maxY);
+
+	float4 top = lerp(At(x0, y0), At(x1, y0), tx);
+	float4 bottom = lerp(At(x0, y1), At(x1, y1), tx);
+	return lerp(top, bottom, ty);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "HlslMath.h"
+
+#include <vector>
+
+namespace DX
+{
+	// Float RGBA texture for the software rasterizer, sampled like the renderer's default
+	// sampler state (bilinear, clamped addressing). Only the top mip level is kept.
+	class SoftwareTexture
+	{
+	public:
+		SoftwareTexture() : m_width(0), m_height(0) {}
+		SoftwareTexture(unsigned int width, unsigned int height, const float4& color) { Resize(width, height, color); }
+
+		void Resize(unsigned int width, unsigned int height, const float4& color)
+		{
+			m_width = width;
+			m_height = height;
+			m_texels.assign(static_cast<size_t>(width) * height, color);
+		}
+
+		unsigned int GetWidth() const { return m_width; }
+		unsigned int GetHeight() const { return m_height; }
+
+		float4& At(unsigned int x, unsigned int y) { return m_texels[static_cast<size_t>(y) * m_width + x]; }
+		const float4& At(unsigned int x, unsigned int y) const { return m_texels[static_cast<size_t>(y) * m_width + x]; }
+
+		// Texture2D.Sample / SampleLevel(.., 0) with a linear, clamping sampler.
+		float4 Sample(const float2& uv) const;
+
+	private:
+		unsigned int		m_width;
+		unsigned int		m_height;
+		std::vector<float4>	m_texels;
+	};
+}
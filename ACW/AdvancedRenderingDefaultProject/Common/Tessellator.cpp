@@ -0,0 +1,1179 @@
+//--------------------------------------------------------------------------------------
+// File: Tessellator.cpp
+//
+// Software fixed-function tessellator, ported from the Direct3D 11 reference tessellator
+// (CHWTessellator in tessellator.cpp, published in Microsoft's DirectX-Specs repository,
+// https://github.com/microsoft/DirectX-Specs) and reorganised around HlslMath.
+//
+// Copyright (c) Microsoft Corporation.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this
+// software and associated documentation files (the "Software"), to deal in the Software
+// without restriction, including without limitation the rights to use, copy, modify, merge,
+// publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+// to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+// PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+// FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//--------------------------------------------------------------------------------------
+
+#include "Tessellator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DX;
+
+namespace
+{
+	// 16.16 unsigned fixed point, as the tessellator works in.
+	typedef unsigned int Fixed;
+
+	const int FixedFractionBits = 16;
+	const Fixed FixedFractionMask = 0x0000ffff;
+	const Fixed FixedOne = 0x00010000;
+	const Fixed FixedOneHalf = 0x00008000;
+	const Fixed FixedOneThird = 0x00005555;
+	const Fixed FixedTwoThirds = 0x0000aaaa;
+
+	const float MinOddFactor = 1.0f;
+	const float MaxOddFactor = 63.0f;
+	const float MinEvenFactor = 2.0f;
+	const float MaxEvenFactor = 64.0f;
+	const float FactorEpsilon = 1.0f / 65536.0f;
+
+	const int TriEdges = 3;
+	const int QuadEdges = 4;
+	const int U = 0;
+	const int V = 1;
+
+	// Rounds to nearest, ties to even, as the reference does; x * FixedOne is exact, so
+	// factors a half unit apart only differ in how the tie goes.
+	Fixed FloatToFixed(float x)
+	{
+		return static_cast<Fixed>(std::nearbyint(x * FixedOne));
+	}
+
+	float FixedToFloat(Fixed x)
+	{
+		return static_cast<float>(x) / FixedOne;
+	}
+
+	Fixed FixedFloor(Fixed x) { return x & ~FixedFractionMask; }
+	Fixed FixedCeil(Fixed x) { return (x + FixedFractionMask) & ~FixedFractionMask; }
+	bool IsEven(float x) { return (static_cast<int>(x) & 1) == 0; }
+
+	Fixed FixedReciprocal(int n)
+	{
+		return n > 0 ? FloatToFixed(1.0f / n) : 0xffffffff;
+	}
+
+	// Clears the highest set bit of an 8, 16, 24 or 32 bit value.
+	int RemoveMSB(int value)
+	{
+		unsigned int check;
+		if (value <= 0x0000ffff)
+		{
+			check = value <= 0x000000ff ? 0x00000080 : 0x00008000;
+		}
+		else
+		{
+			check = value <= 0x00ffffff ? 0x00800000 : 0x80000000;
+		}
+
+		for (int i = 0; i < 8; i++, check >>= 1)
+		{
+			if (value & check)
+			{
+				return static_cast<int>(value & ~check);
+			}
+		}
+		return 0;
+	}
+
+	// Where the points of one processed tess factor fall along [0, 1]. Only half of the points
+	// are placed; the other half mirrors them.
+	struct FactorContext
+	{
+		bool	odd;
+		Fixed	halfFactorFraction;
+		int		numHalfFactorPoints;
+		int		splitPointOnFloorHalfFactor;
+		Fixed	invNumSegmentsOnFloorFactor;
+		Fixed	invNumSegmentsOnCeilFactor;
+	};
+
+	FactorContext MakeFactorContext(Fixed factor, bool odd)
+	{
+		FactorContext context;
+		context.odd = odd;
+
+		Fixed halfFactor = (factor + 1) / 2;
+		if (odd || halfFactor == FixedOneHalf)
+		{
+			// A factor of 1 is treated as odd even in even partitioning.
+			halfFactor += FixedOneHalf;
+		}
+
+		Fixed floorHalfFactor = FixedFloor(halfFactor);
+		Fixed ceilHalfFactor = FixedCeil(halfFactor);
+		context.halfFactorFraction = halfFactor - floorHalfFactor;
+		context.numHalfFactorPoints = static_cast<int>(ceilHalfFactor >> FixedFractionBits);
+
+		if (ceilHalfFactor == floorHalfFactor)
+		{
+			// No split point: a value past the end is never matched.
+			context.splitPointOnFloorHalfFactor = context.numHalfFactorPoints + 1;
+		}
+		else if (odd)
+		{
+			context.splitPointOnFloorHalfFactor = floorHalfFactor == FixedOne ? 0 :
+				(RemoveMSB(static_cast<int>(floorHalfFactor >> FixedFractionBits) - 1) << 1) + 1;
+		}
+		else
+		{
+			context.splitPointOnFloorHalfFactor = (RemoveMSB(static_cast<int>(floorHalfFactor >> FixedFractionBits)) << 1) + 1;
+		}
+
+		int numFloorSegments = static_cast<int>((floorHalfFactor * 2) >> FixedFractionBits);
+		int numCeilSegments = static_cast<int>((ceilHalfFactor * 2) >> FixedFractionBits);
+		if (odd)
+		{
+			numFloorSegments -= 1;
+			numCeilSegments -= 1;
+		}
+		context.invNumSegmentsOnFloorFactor = FixedReciprocal(numFloorSegments);
+		context.invNumSegmentsOnCeilFactor = FixedReciprocal(numCeilSegments);
+		return context;
+	}
+
+	int NumPointsForFactor(Fixed factor, bool odd)
+	{
+		if (odd)
+		{
+			return static_cast<int>((FixedCeil(FixedOneHalf + (factor + 1) / 2) * 2) >> FixedFractionBits);
+		}
+		return static_cast<int>((FixedCeil((factor + 1) / 2) * 2) >> FixedFractionBits) + 1;
+	}
+
+	Fixed PlacePointIn1D(const FactorContext& context, int point)
+	{
+		bool flip = false;
+		if (point >= context.numHalfFactorPoints)
+		{
+			point = (context.numHalfFactorPoints << 1) - point;
+			if (context.odd)
+			{
+				point -= 1;
+			}
+			flip = true;
+		}
+
+		// The middle is special cased since the fixed point lerp below can't reproduce 0.5.
+		if (point == context.numHalfFactorPoints)
+		{
+			return FixedOneHalf;
+		}
+
+		unsigned int indexOnCeilHalfFactor = static_cast<unsigned int>(point);
+		unsigned int indexOnFloorHalfFactor = indexOnCeilHalfFactor;
+		if (point > context.splitPointOnFloorHalfFactor)
+		{
+			indexOnFloorHalfFactor -= 1;
+		}
+
+		// Both locations are at most 0.5, so the lerp fits in 32 bits before the shift.
+		Fixed locationOnFloorHalfFactor = indexOnFloorHalfFactor * context.invNumSegmentsOnFloorFactor;
+		Fixed locationOnCeilHalfFactor = indexOnCeilHalfFactor * context.invNumSegmentsOnCeilFactor;
+		Fixed location = locationOnFloorHalfFactor * (FixedOne - context.halfFactorFraction) +
+			locationOnCeilHalfFactor * context.halfFactorFraction;
+		location = (location + FixedOneHalf) >> FixedFractionBits;
+
+		return flip ? FixedOne - location : location;
+	}
+
+	struct ProcessedTriFactors
+	{
+		bool			culled;
+		bool			minimum;
+		Fixed			outside[TriEdges];
+		bool			outsideOdd[TriEdges];
+		FactorContext	outsideContext[TriEdges];
+		int				numPointsForOutsideEdge[TriEdges];
+		Fixed			inside;
+		bool			insideOdd;
+		FactorContext	insideContext;
+		int				numPointsForInsideFactor;
+		int				insideEdgePointBaseOffset;
+	};
+
+	struct ProcessedQuadFactors
+	{
+		bool			culled;
+		bool			minimum;
+		Fixed			outside[QuadEdges];
+		bool			outsideOdd[QuadEdges];
+		FactorContext	outsideContext[QuadEdges];
+		int				numPointsForOutsideEdge[QuadEdges];
+		Fixed			inside[2];
+		bool			insideOdd[2];
+		FactorContext	insideContext[2];
+		int				numPointsForInsideFactor[2];
+		int				insideEdgePointBaseOffset;
+	};
+
+	// Builds one pattern. Stitching walks two rows of points with sequential indices; where a
+	// ring wraps around or a degenerate row runs backwards, the indices are remapped as they
+	// are stored, as the reference implementation does.
+	class PatternBuilder
+	{
+	public:
+		PatternBuilder(TessellatorPartitioning partitioning, TessellatorOutput output, TessellatorPattern& pattern) :
+			m_partitioning(partitioning),
+			m_clockwise(output == TessellatorOutput::TriangleCW),
+			m_pattern(pattern),
+			m_patchMode(PatchMode::None)
+		{
+			m_pattern.points.clear();
+			m_pattern.indices.clear();
+		}
+
+		void TessellateTri(const float edges[3], float inside);
+		void TessellateQuad(const float edges[4], const float inside[2]);
+
+	private:
+		enum class PatchMode
+		{
+			None,
+			RingWrap,		// last edge of a ring: its final points are the ring's first ones
+			Inversion		// a degenerate row of points stored in reverse
+		};
+
+		enum class Diagonals
+		{
+			InsideToOutside,
+			InsideToOutsideExceptMiddle,	// odd rows only: the middle quad's diagonal is flipped
+			Mirrored
+		};
+
+		bool IntegerPartitioning() const
+		{
+			return m_partitioning == TessellatorPartitioning::Integer || m_partitioning == TessellatorPartitioning::Pow2;
+		}
+
+		bool OriginalOdd() const
+		{
+			return m_partitioning == TessellatorPartitioning::Integer || m_partitioning == TessellatorPartitioning::FractionalOdd;
+		}
+
+		void ClampBounds(float& lower, float& upper) const
+		{
+			switch (m_partitioning)
+			{
+			case TessellatorPartitioning::FractionalEven:
+				lower = MinEvenFactor;
+				upper = MaxEvenFactor;
+				break;
+			case TessellatorPartitioning::FractionalOdd:
+				lower = MinOddFactor;
+				upper = MaxOddFactor;
+				break;
+			default:
+				lower = MinOddFactor;
+				upper = MaxEvenFactor;
+				break;
+			}
+		}
+
+		// Clamps, mapping NaN to the lower bound.
+		static float ClampFactor(float factor, float lower, float upper)
+		{
+			float clamped = factor > lower ? factor : lower;
+			return upper < clamped ? upper : clamped;
+		}
+
+		void DefinePoint(Fixed u, Fixed v, int offset)
+		{
+			m_pattern.points[offset] = float2(FixedToFloat(u), FixedToFloat(v));
+		}
+
+		int PatchIndex(int index) const;
+
+		void DefineIndex(int index)
+		{
+			m_pattern.indices.push_back(static_cast<unsigned int>(PatchIndex(index)));
+		}
+
+		void DefineClockwiseTriangle(int index0, int index1, int index2)
+		{
+			DefineIndex(index0);
+			DefineIndex(m_clockwise ? index1 : index2);
+			DefineIndex(m_clockwise ? index2 : index1);
+		}
+
+		void StitchRegular(bool trapezoid, Diagonals diagonals, int numInsideEdgePoints, int insideEdgePointBaseOffset, int outsideEdgePointBaseOffset);
+		void StitchTransition(int insideEdgePointBaseOffset, int insideNumHalfFactorPoints, bool insideOdd,
+			int outsideEdgePointBaseOffset, int outsideNumHalfFactorPoints, bool outsideOdd);
+
+		void ProcessTriFactors(const float edges[3], float inside, ProcessedTriFactors& factors);
+		void TriGeneratePoints(const ProcessedTriFactors& factors);
+		void TriGenerateConnectivity(const ProcessedTriFactors& factors);
+
+		void ProcessQuadFactors(const float edges[4], const float inside[2], ProcessedQuadFactors& factors);
+		void QuadGeneratePoints(const ProcessedQuadFactors& factors);
+		void QuadGenerateConnectivity(const ProcessedQuadFactors& factors);
+
+	private:
+		TessellatorPartitioning	m_partitioning;
+		bool					m_clockwise;
+		TessellatorPattern&		m_pattern;
+
+		PatchMode				m_patchMode;
+
+		// RingWrap
+		int						m_insidePointIndexDeltaToRealValue;
+		int						m_insidePointIndexBadValue;
+		int						m_insidePointIndexReplacementValue;
+		int						m_outsidePointIndexPatchBase;
+		int						m_outsidePointIndexDeltaToRealValue;
+		int						m_outsidePointIndexBadValue;
+		int						m_outsidePointIndexReplacementValue;
+
+		// Inversion
+		int						m_baseIndexToInvert;
+		int						m_indexInversionEndPoint;
+		int						m_cornerCaseBadValue;
+		int						m_cornerCaseReplacementValue;
+	};
+
+	int PatternBuilder::PatchIndex(int index) const
+	{
+		if (m_patchMode == PatchMode::RingWrap)
+		{
+			// Outside indices were offset past the inside ones.
+			if (index >= m_outsidePointIndexPatchBase)
+			{
+				return index == m_outsidePointIndexBadValue ? m_outsidePointIndexReplacementValue : index + m_outsidePointIndexDeltaToRealValue;
+			}
+			return index == m_insidePointIndexBadValue ? m_insidePointIndexReplacementValue : index + m_insidePointIndexDeltaToRealValue;
+		}
+
+		if (m_patchMode == PatchMode::Inversion)
+		{
+			if (index == m_cornerCaseBadValue)
+			{
+				return m_cornerCaseReplacementValue;
+			}
+			if (index >= m_baseIndexToInvert)
+			{
+				return m_indexInversionEndPoint - index;
+			}
+		}
+
+		return index;
+	}
+
+	void PatternBuilder::StitchRegular(bool trapezoid, Diagonals diagonals, int numInsideEdgePoints, int insideEdgePointBaseOffset, int outsideEdgePointBaseOffset)
+	{
+		int insidePoint = insideEdgePointBaseOffset;
+		int outsidePoint = outsideEdgePointBaseOffset;
+
+		if (trapezoid)
+		{
+			DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+			outsidePoint++;
+		}
+
+		int p = 0;
+		if (diagonals == Diagonals::InsideToOutside)
+		{
+			for (; p < numInsideEdgePoints - 1; p++, insidePoint++, outsidePoint++)
+			{
+				DefineClockwiseTriangle(insidePoint, outsidePoint, outsidePoint + 1);
+				DefineClockwiseTriangle(insidePoint, outsidePoint + 1, insidePoint + 1);
+			}
+		}
+		else if (diagonals == Diagonals::InsideToOutsideExceptMiddle)
+		{
+			int middle = numInsideEdgePoints / 2 - 1;
+			for (; p < numInsideEdgePoints - 1; p++, insidePoint++, outsidePoint++)
+			{
+				if (p == middle)
+				{
+					DefineClockwiseTriangle(outsidePoint, insidePoint + 1, insidePoint);
+					DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint + 1);
+				}
+				else
+				{
+					DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+					DefineClockwiseTriangle(insidePoint, outsidePoint + 1, insidePoint + 1);
+				}
+			}
+		}
+		else
+		{
+			// First half from the outside of the outer row to the inside of the inner, then back.
+			for (; p < numInsideEdgePoints / 2; p++, insidePoint++, outsidePoint++)
+			{
+				DefineClockwiseTriangle(outsidePoint, insidePoint + 1, insidePoint);
+				DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint + 1);
+			}
+			for (; p < numInsideEdgePoints - 1; p++, insidePoint++, outsidePoint++)
+			{
+				DefineClockwiseTriangle(insidePoint, outsidePoint, outsidePoint + 1);
+				DefineClockwiseTriangle(insidePoint, outsidePoint + 1, insidePoint + 1);
+			}
+		}
+
+		if (trapezoid)
+		{
+			DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+		}
+	}
+
+	void PatternBuilder::StitchTransition(int insideEdgePointBaseOffset, int insideNumHalfFactorPoints, bool insideOdd,
+		int outsideEdgePointBaseOffset, int outsideNumHalfFactorPoints, bool outsideOdd)
+	{
+		// Where point i of a half edge lands at the maximum factor in ruler-function split
+		// order. A row advances at step i when its half edge has more points than that, which
+		// decides when the inside or the outside row moves on.
+		static const int finalPointPosition[33] =
+		{
+			0, 32, 16, 8, 17, 4, 18, 9, 19, 2, 20, 10, 21, 5, 22, 11, 23,
+			1, 24, 12, 25, 6, 26, 13, 27, 3, 28, 14, 29, 7, 30, 15, 31
+		};
+
+		if (insideOdd)
+		{
+			insideNumHalfFactorPoints -= 1;
+		}
+		if (outsideOdd)
+		{
+			outsideNumHalfFactorPoints -= 1;
+		}
+
+		int outsidePoint = outsideEdgePointBaseOffset;
+		int insidePoint = insideEdgePointBaseOffset;
+
+		// First half.
+		if (finalPointPosition[0] < outsideNumHalfFactorPoints)
+		{
+			DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+			outsidePoint++;
+		}
+		for (int i = 1; i <= 32; i++)
+		{
+			if (finalPointPosition[i] < insideNumHalfFactorPoints)
+			{
+				DefineClockwiseTriangle(insidePoint, outsidePoint, insidePoint + 1);
+				insidePoint++;
+			}
+			if (finalPointPosition[i] < outsideNumHalfFactorPoints)
+			{
+				DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+				outsidePoint++;
+			}
+		}
+
+		// Middle.
+		if (insideOdd != outsideOdd || insideOdd)
+		{
+			if (insideOdd == outsideOdd)
+			{
+				DefineClockwiseTriangle(insidePoint, outsidePoint, insidePoint + 1);
+				DefineClockwiseTriangle(insidePoint + 1, outsidePoint, outsidePoint + 1);
+				insidePoint++;
+				outsidePoint++;
+			}
+			else if (!insideOdd)
+			{
+				// Triangle pointing inside.
+				DefineClockwiseTriangle(insidePoint, outsidePoint, outsidePoint + 1);
+				outsidePoint++;
+			}
+			else
+			{
+				// Triangle pointing outside.
+				DefineClockwiseTriangle(insidePoint, outsidePoint, insidePoint + 1);
+				insidePoint++;
+			}
+		}
+
+		// Second half, mirroring the first.
+		for (int i = 32; i >= 1; i--)
+		{
+			if (finalPointPosition[i] < outsideNumHalfFactorPoints)
+			{
+				DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+				outsidePoint++;
+			}
+			if (finalPointPosition[i] < insideNumHalfFactorPoints)
+			{
+				DefineClockwiseTriangle(insidePoint, outsidePoint, insidePoint + 1);
+				insidePoint++;
+			}
+		}
+		if (finalPointPosition[0] < outsideNumHalfFactorPoints)
+		{
+			DefineClockwiseTriangle(outsidePoint, outsidePoint + 1, insidePoint);
+			outsidePoint++;
+		}
+	}
+
+	void PatternBuilder::ProcessTriFactors(const float edges[3], float inside, ProcessedTriFactors& factors)
+	{
+		// NaN fails the comparison and culls too.
+		factors.culled = !(edges[0] > 0.0f) || !(edges[1] > 0.0f) || !(edges[2] > 0.0f);
+		factors.minimum = false;
+		if (factors.culled)
+		{
+			return;
+		}
+
+		float lower, upper;
+		ClampBounds(lower, upper);
+
+		float outside[TriEdges];
+		for (int edge = 0; edge < TriEdges; edge++)
+		{
+			outside[edge] = ClampFactor(edges[edge], lower, upper);
+			if (IntegerPartitioning())
+			{
+				outside[edge] = std::ceil(outside[edge]);
+			}
+		}
+
+		// With fractional odd, any edge above 1 forces an inside factor above 1 so the outer
+		// ring is a picture frame around the inside.
+		if (m_partitioning == TessellatorPartitioning::FractionalOdd)
+		{
+			const float minPlusHalfEpsilon = MinOddFactor + FactorEpsilon / 2.0f;
+			if (outside[0] > minPlusHalfEpsilon || outside[1] > minPlusHalfEpsilon || outside[2] > minPlusHalfEpsilon)
+			{
+				lower = MinOddFactor + FactorEpsilon;
+			}
+		}
+
+		inside = ClampFactor(inside, lower, upper);
+		if (IntegerPartitioning())
+		{
+			inside = std::ceil(inside);
+		}
+
+		for (int edge = 0; edge < TriEdges; edge++)
+		{
+			factors.outsideOdd[edge] = IntegerPartitioning() ? !IsEven(outside[edge]) : OriginalOdd();
+			factors.outside[edge] = FloatToFixed(outside[edge]);
+		}
+		factors.insideOdd = IntegerPartitioning() ? !(IsEven(inside) || inside == 1.0f) : OriginalOdd();
+		factors.inside = FloatToFixed(inside);
+
+		if ((IntegerPartitioning() || m_partitioning == TessellatorPartitioning::FractionalOdd) &&
+			factors.inside == FixedOne && factors.outside[0] == FixedOne && factors.outside[1] == FixedOne && factors.outside[2] == FixedOne)
+		{
+			factors.minimum = true;
+			return;
+		}
+
+		int numPoints = 0;
+		for (int edge = 0; edge < TriEdges; edge++)
+		{
+			factors.outsideContext[edge] = MakeFactorContext(factors.outside[edge], factors.outsideOdd[edge]);
+			factors.numPointsForOutsideEdge[edge] = NumPointsForFactor(factors.outside[edge], factors.outsideOdd[edge]);
+			numPoints += factors.numPointsForOutsideEdge[edge];
+		}
+		numPoints -= 3;
+
+		factors.insideContext = MakeFactorContext(factors.inside, factors.insideOdd);
+
+		// The minimum allows degenerate transition regions when the inside factor is 1.
+		factors.numPointsForInsideFactor = std::max(factors.insideOdd ? 4 : 3, NumPointsForFactor(factors.inside, factors.insideOdd));
+		factors.insideEdgePointBaseOffset = numPoints;
+
+		int numInteriorRings = (factors.numPointsForInsideFactor >> 1) - 1;
+		if (factors.insideOdd)
+		{
+			numPoints += TriEdges * (numInteriorRings * (numInteriorRings + 1) - numInteriorRings);
+		}
+		else
+		{
+			numPoints += TriEdges * (numInteriorRings * (numInteriorRings + 1)) + 1;
+		}
+
+		m_pattern.points.resize(numPoints);
+	}
+
+	void PatternBuilder::TriGeneratePoints(const ProcessedTriFactors& factors)
+	{
+		// Outer ring, clockwise from V: edge 0 (U == 0) has V decreasing, edge 1 (V == 0) has U
+		// increasing and edge 2 (W == 0) has U decreasing. Each edge stops short of its last
+		// point, which the next edge starts with.
+		int pointOffset = 0;
+		for (int edge = 0; edge < TriEdges; edge++)
+		{
+			bool reverse = (edge & 1) == 0;
+			int endPoint = factors.numPointsForOutsideEdge[edge] - 1;
+			for (int p = 0; p < endPoint; p++, pointOffset++)
+			{
+				Fixed param = PlacePointIn1D(factors.outsideContext[edge], reverse ? endPoint - p : p);
+				if (edge == 0)
+				{
+					DefinePoint(0, param, pointOffset);
+				}
+				else
+				{
+					DefinePoint(param, edge == 2 ? FixedOne - param : 0, pointOffset);
+				}
+			}
+		}
+
+		// Inner rings, spiralling in. Each ring is the outer ring's parameterization over
+		// [start, end], pushed in by the ring's perpendicular location.
+		int numRings = factors.numPointsForInsideFactor >> 1;
+		for (int ring = 1; ring < numRings; ring++)
+		{
+			int startPoint = ring;
+			int endPoint = factors.numPointsForInsideFactor - 1 - startPoint;
+
+			for (int edge = 0; edge < TriEdges; edge++)
+			{
+				bool reverse = (edge & 1) == 0;
+
+				// Scaled to barycentric space; the fixed point maths can't overflow here.
+				Fixed perpParam = PlacePointIn1D(factors.insideContext, startPoint);
+				perpParam *= FixedTwoThirds;
+				perpParam = (perpParam + FixedOneHalf) >> FixedFractionBits;
+
+				for (int p = startPoint; p < endPoint; p++, pointOffset++)
+				{
+					Fixed param = PlacePointIn1D(factors.insideContext, reverse ? endPoint - (p - startPoint) : p);
+					Fixed shifted = param - (perpParam + 1) / 2;
+					switch (edge)
+					{
+					case 0:
+						DefinePoint(perpParam, shifted, pointOffset);
+						break;
+					case 1:
+						DefinePoint(shifted, perpParam, pointOffset);
+						break;
+					default:
+						DefinePoint(shifted, FixedOne - shifted - perpParam, pointOffset);
+						break;
+					}
+				}
+			}
+		}
+
+		// Even inside factors end in a centre point.
+		if (!factors.insideOdd)
+		{
+			DefinePoint(FixedOneThird, FixedOneThird, pointOffset);
+		}
+	}
+
+	void PatternBuilder::TriGenerateConnectivity(const ProcessedTriFactors& factors)
+	{
+		// One side of one ring at a time, from the outer ring in. +1 makes even factors include
+		// the centre point.
+		int numRings = (factors.numPointsForInsideFactor + 1) >> 1;
+		int numPointsForOutsideEdge[TriEdges] =
+		{
+			factors.numPointsForOutsideEdge[0], factors.numPointsForOutsideEdge[1], factors.numPointsForOutsideEdge[2]
+		};
+
+		int insideEdgePointBaseOffset = factors.insideEdgePointBaseOffset;
+		int outsideEdgePointBaseOffset = 0;
+
+		for (int ring = 1; ring < numRings; ring++)
+		{
+			int numPointsForInsideEdge = factors.numPointsForInsideFactor - 2 * ring;
+			int edge0InsidePointBaseOffset = insideEdgePointBaseOffset;
+			int edge0OutsidePointBaseOffset = outsideEdgePointBaseOffset;
+
+			for (int edge = 0; edge < TriEdges; edge++)
+			{
+				int insideBaseOffset = insideEdgePointBaseOffset;
+				int outsideBaseOffset = outsideEdgePointBaseOffset;
+
+				if (edge == 2)
+				{
+					// The last edge wraps back to the first points of both rings.
+					m_insidePointIndexDeltaToRealValue = insideEdgePointBaseOffset;
+					m_insidePointIndexBadValue = numPointsForInsideEdge - 1;
+					m_insidePointIndexReplacementValue = edge0InsidePointBaseOffset;
+					m_outsidePointIndexPatchBase = m_insidePointIndexBadValue + 1;
+					m_outsidePointIndexDeltaToRealValue = outsideEdgePointBaseOffset - m_outsidePointIndexPatchBase;
+					m_outsidePointIndexBadValue = m_outsidePointIndexPatchBase + numPointsForOutsideEdge[edge] - 1;
+					m_outsidePointIndexReplacementValue = edge0OutsidePointBaseOffset;
+					m_patchMode = PatchMode::RingWrap;
+
+					insideBaseOffset = 0;
+					outsideBaseOffset = m_outsidePointIndexPatchBase;
+				}
+
+				if (ring == 1)
+				{
+					StitchTransition(insideBaseOffset, factors.insideContext.numHalfFactorPoints, factors.insideOdd,
+						outsideBaseOffset, factors.outsideContext[edge].numHalfFactorPoints, factors.outsideOdd[edge]);
+				}
+				else
+				{
+					StitchRegular(true, Diagonals::Mirrored, numPointsForInsideEdge, insideBaseOffset, outsideBaseOffset);
+				}
+				m_patchMode = PatchMode::None;
+
+				outsideEdgePointBaseOffset += numPointsForOutsideEdge[edge] - 1;
+				insideEdgePointBaseOffset += numPointsForInsideEdge - 1;
+				numPointsForOutsideEdge[edge] = numPointsForInsideEdge;
+			}
+		}
+
+		// Odd inside factors end in a centre triangle.
+		if (factors.insideOdd)
+		{
+			DefineClockwiseTriangle(outsideEdgePointBaseOffset, outsideEdgePointBaseOffset + 1, outsideEdgePointBaseOffset + 2);
+		}
+	}
+
+	void PatternBuilder::TessellateTri(const float edges[3], float inside)
+	{
+		ProcessedTriFactors factors;
+		ProcessTriFactors(edges, inside, factors);
+
+		if (factors.culled)
+		{
+			return;
+		}
+
+		if (factors.minimum)
+		{
+			m_pattern.points.resize(3);
+			DefinePoint(0, FixedOne, 0);
+			DefinePoint(0, 0, 1);
+			DefinePoint(FixedOne, 0, 2);
+			DefineClockwiseTriangle(0, 1, 2);
+			return;
+		}
+
+		TriGeneratePoints(factors);
+		TriGenerateConnectivity(factors);
+	}
+
+	void PatternBuilder::ProcessQuadFactors(const float edges[4], const float inside[2], ProcessedQuadFactors& factors)
+	{
+		factors.culled = !(edges[0] > 0.0f) || !(edges[1] > 0.0f) || !(edges[2] > 0.0f) || !(edges[3] > 0.0f);
+		factors.minimum = false;
+		if (factors.culled)
+		{
+			return;
+		}
+
+		float lower, upper;
+		ClampBounds(lower, upper);
+
+		float outside[QuadEdges];
+		for (int edge = 0; edge < QuadEdges; edge++)
+		{
+			outside[edge] = ClampFactor(edges[edge], lower, upper);
+			if (IntegerPartitioning())
+			{
+				outside[edge] = std::ceil(outside[edge]);
+			}
+		}
+
+		if (m_partitioning == TessellatorPartitioning::FractionalOdd)
+		{
+			const float minPlusHalfEpsilon = MinOddFactor + FactorEpsilon / 2.0f;
+			if (outside[0] > minPlusHalfEpsilon || outside[1] > minPlusHalfEpsilon || outside[2] > minPlusHalfEpsilon ||
+				outside[3] > minPlusHalfEpsilon || inside[U] > minPlusHalfEpsilon || inside[V] > minPlusHalfEpsilon)
+			{
+				lower = MinOddFactor + FactorEpsilon;
+			}
+		}
+
+		float insideFactor[2];
+		for (int axis = U; axis <= V; axis++)
+		{
+			insideFactor[axis] = ClampFactor(inside[axis], lower, upper);
+			if (IntegerPartitioning())
+			{
+				insideFactor[axis] = std::ceil(insideFactor[axis]);
+			}
+		}
+
+		for (int edge = 0; edge < QuadEdges; edge++)
+		{
+			factors.outsideOdd[edge] = IntegerPartitioning() ? !IsEven(outside[edge]) : OriginalOdd();
+			factors.outside[edge] = FloatToFixed(outside[edge]);
+		}
+		for (int axis = U; axis <= V; axis++)
+		{
+			factors.insideOdd[axis] = IntegerPartitioning() ? !(IsEven(insideFactor[axis]) || insideFactor[axis] == 1.0f) : OriginalOdd();
+			factors.inside[axis] = FloatToFixed(insideFactor[axis]);
+		}
+
+		if ((IntegerPartitioning() || m_partitioning == TessellatorPartitioning::FractionalOdd) &&
+			factors.inside[U] == FixedOne && factors.inside[V] == FixedOne &&
+			factors.outside[0] == FixedOne && factors.outside[1] == FixedOne && factors.outside[2] == FixedOne && factors.outside[3] == FixedOne)
+		{
+			factors.minimum = true;
+			return;
+		}
+
+		int numPoints = 0;
+		for (int edge = 0; edge < QuadEdges; edge++)
+		{
+			factors.outsideContext[edge] = MakeFactorContext(factors.outside[edge], factors.outsideOdd[edge]);
+			factors.numPointsForOutsideEdge[edge] = NumPointsForFactor(factors.outside[edge], factors.outsideOdd[edge]);
+			numPoints += factors.numPointsForOutsideEdge[edge];
+		}
+		numPoints -= 4;
+
+		for (int axis = U; axis <= V; axis++)
+		{
+			factors.insideContext[axis] = MakeFactorContext(factors.inside[axis], factors.insideOdd[axis]);
+			factors.numPointsForInsideFactor[axis] = std::max(factors.insideOdd[axis] ? 4 : 3,
+				NumPointsForFactor(factors.inside[axis], factors.insideOdd[axis]));
+		}
+
+		factors.insideEdgePointBaseOffset = numPoints;
+		numPoints += (factors.numPointsForInsideFactor[U] - 2) * (factors.numPointsForInsideFactor[V] - 2);
+
+		m_pattern.points.resize(numPoints);
+	}
+
+	void PatternBuilder::QuadGeneratePoints(const ProcessedQuadFactors& factors)
+	{
+		// Outer ring, clockwise from (0, 1): edge 0 (U == 0) down V, edge 1 (V == 0) along U,
+		// edge 2 (U == 1) up V and edge 3 (V == 1) back along U.
+		int pointOffset = 0;
+		for (int edge = 0; edge < QuadEdges; edge++)
+		{
+			bool alongU = (edge & 1) != 0;
+			bool reverse = edge == 0 || edge == 3;
+			int endPoint = factors.numPointsForOutsideEdge[edge] - 1;
+			for (int p = 0; p < endPoint; p++, pointOffset++)
+			{
+				Fixed param = PlacePointIn1D(factors.outsideContext[edge], reverse ? endPoint - p : p);
+				if (alongU)
+				{
+					DefinePoint(param, edge == 3 ? FixedOne : 0, pointOffset);
+				}
+				else
+				{
+					DefinePoint(edge == 2 ? FixedOne : 0, param, pointOffset);
+				}
+			}
+		}
+
+		// Inner rings, in the same order, spiralling toward the centre.
+		int minNumPoints = std::min(factors.numPointsForInsideFactor[U], factors.numPointsForInsideFactor[V]);
+		int numRings = minNumPoints >> 1;
+		for (int ring = 1; ring < numRings; ring++)
+		{
+			int startPoint = ring;
+			int endPoint[2] =
+			{
+				factors.numPointsForInsideFactor[U] - 1 - startPoint,
+				factors.numPointsForInsideFactor[V] - 1 - startPoint
+			};
+
+			for (int edge = 0; edge < QuadEdges; edge++)
+			{
+				int perpAxis = edge & 1;
+				int alongAxis = (edge + 1) & 1;
+				bool reverse = edge == 0 || edge == 3;
+
+				Fixed perpParam = PlacePointIn1D(factors.insideContext[perpAxis], edge < 2 ? startPoint : endPoint[perpAxis]);
+				for (int p = startPoint; p < endPoint[alongAxis]; p++, pointOffset++)
+				{
+					Fixed param = PlacePointIn1D(factors.insideContext[alongAxis], reverse ? endPoint[alongAxis] - (p - startPoint) : p);
+					if (alongAxis == V)
+					{
+						DefinePoint(perpParam, param, pointOffset);
+					}
+					else
+					{
+						DefinePoint(param, perpParam, pointOffset);
+					}
+				}
+			}
+		}
+
+		// An even factor on the shorter axis leaves a degenerate ring: one row of points
+		// through the middle.
+		if (factors.numPointsForInsideFactor[U] > factors.numPointsForInsideFactor[V] && !factors.insideOdd[V])
+		{
+			int endPoint = factors.numPointsForInsideFactor[U] - 1 - numRings;
+			for (int p = numRings; p <= endPoint; p++, pointOffset++)
+			{
+				DefinePoint(PlacePointIn1D(factors.insideContext[U], p), FixedOneHalf, pointOffset);
+			}
+		}
+		else if (factors.numPointsForInsideFactor[V] >= factors.numPointsForInsideFactor[U] && !factors.insideOdd[U])
+		{
+			int endPoint = factors.numPointsForInsideFactor[V] - 1 - numRings;
+			for (int p = endPoint; p >= numRings; p--, pointOffset++)
+			{
+				DefinePoint(FixedOneHalf, PlacePointIn1D(factors.insideContext[V], p), pointOffset);
+			}
+		}
+	}
+
+	void PatternBuilder::QuadGenerateConnectivity(const ProcessedQuadFactors& factors)
+	{
+		// +1 makes even factors include the centre row.
+		int numPointRowsToCenter[2] =
+		{
+			(factors.numPointsForInsideFactor[U] + 1) >> 1,
+			(factors.numPointsForInsideFactor[V] + 1) >> 1
+		};
+		int numRings = std::min(numPointRowsToCenter[U], numPointRowsToCenter[V]);
+
+		// The ring that is a degenerate row of points, per axis of its edges, if any. Its
+		// points run against the usual order around a ring.
+		const int noRing = 0x7fffffff;
+		int degeneratePointRing[2] =
+		{
+			factors.insideOdd[V] ? noRing : numPointRowsToCenter[V] - 1,
+			factors.insideOdd[U] ? noRing : numPointRowsToCenter[U] - 1
+		};
+
+		const FactorContext* outsideContext[QuadEdges];
+		bool outsideOdd[QuadEdges];
+		int numPointsForOutsideEdge[QuadEdges];
+		for (int edge = 0; edge < QuadEdges; edge++)
+		{
+			outsideContext[edge] = &factors.outsideContext[edge];
+			outsideOdd[edge] = factors.outsideOdd[edge];
+			numPointsForOutsideEdge[edge] = factors.numPointsForOutsideEdge[edge];
+		}
+
+		int insideEdgePointBaseOffset = factors.insideEdgePointBaseOffset;
+		int outsideEdgePointBaseOffset = 0;
+
+		for (int ring = 1; ring < numRings; ring++)
+		{
+			int numPointsForInsideEdge[2] =
+			{
+				factors.numPointsForInsideFactor[U] - 2 * ring,
+				factors.numPointsForInsideFactor[V] - 2 * ring
+			};
+
+			int edge0InsidePointBaseOffset = insideEdgePointBaseOffset;
+			int edge0OutsidePointBaseOffset = outsideEdgePointBaseOffset;
+
+			for (int edge = 0; edge < QuadEdges; edge++)
+			{
+				int axis = (edge + 1) & 1;
+				bool degenerate = ring == degeneratePointRing[axis];
+
+				int insideBaseOffset = insideEdgePointBaseOffset;
+				int outsideBaseOffset = outsideEdgePointBaseOffset;
+
+				if (edge == 3 && degenerate)
+				{
+					m_baseIndexToInvert = insideEdgePointBaseOffset + 1;
+					m_cornerCaseBadValue = outsideEdgePointBaseOffset + numPointsForOutsideEdge[edge] - 1;
+					m_cornerCaseReplacementValue = edge0OutsidePointBaseOffset;
+					m_indexInversionEndPoint = (m_baseIndexToInvert << 1) - 1;
+					m_patchMode = PatchMode::Inversion;
+
+					insideBaseOffset = m_baseIndexToInvert;
+				}
+				else if (edge == 3)
+				{
+					// The last edge wraps back to the first points of both rings.
+					m_insidePointIndexDeltaToRealValue = insideEdgePointBaseOffset;
+					m_insidePointIndexBadValue = numPointsForInsideEdge[axis] - 1;
+					m_insidePointIndexReplacementValue = edge0InsidePointBaseOffset;
+					m_outsidePointIndexPatchBase = m_insidePointIndexBadValue + 1;
+					m_outsidePointIndexDeltaToRealValue = outsideEdgePointBaseOffset - m_outsidePointIndexPatchBase;
+					m_outsidePointIndexBadValue = m_outsidePointIndexPatchBase + numPointsForOutsideEdge[edge] - 1;
+					m_outsidePointIndexReplacementValue = edge0OutsidePointBaseOffset;
+					m_patchMode = PatchMode::RingWrap;
+
+					insideBaseOffset = 0;
+					outsideBaseOffset = m_outsidePointIndexPatchBase;
+				}
+				else if (edge == 2 && degenerate)
+				{
+					m_baseIndexToInvert = insideEdgePointBaseOffset;
+					m_cornerCaseBadValue = -1;
+					m_cornerCaseReplacementValue = -1;
+					m_indexInversionEndPoint = m_baseIndexToInvert << 1;
+					m_patchMode = PatchMode::Inversion;
+
+					insideBaseOffset = m_baseIndexToInvert;
+				}
+
+				if (ring == 1)
+				{
+					StitchTransition(insideBaseOffset, factors.insideContext[axis].numHalfFactorPoints, factors.insideOdd[axis],
+						outsideBaseOffset, outsideContext[edge]->numHalfFactorPoints, outsideOdd[edge]);
+				}
+				else
+				{
+					StitchRegular(true, Diagonals::Mirrored, numPointsForInsideEdge[axis], insideBaseOffset, outsideBaseOffset);
+				}
+				m_patchMode = PatchMode::None;
+
+				outsideEdgePointBaseOffset += numPointsForOutsideEdge[edge] - 1;
+				if (edge == 2 && degenerate)
+				{
+					insideEdgePointBaseOffset -= numPointsForInsideEdge[axis] - 1;
+				}
+				else
+				{
+					insideEdgePointBaseOffset += numPointsForInsideEdge[axis] - 1;
+				}
+				numPointsForOutsideEdge[edge] = numPointsForInsideEdge[axis];
+			}
+
+			if (ring == 1)
+			{
+				for (int edge = 0; edge < QuadEdges; edge++)
+				{
+					outsideContext[edge] = &factors.insideContext[edge & 1];
+					outsideOdd[edge] = factors.insideOdd[edge & 1];
+				}
+			}
+		}
+
+		// With an odd factor on the shorter axis the centre is a strip of quads, the innermost
+		// ring's far side stored in reverse.
+		if (factors.numPointsForInsideFactor[U] > factors.numPointsForInsideFactor[V] && factors.insideOdd[V])
+		{
+			int stripNumQuads = (((factors.numPointsForInsideFactor[U] >> 1) - (factors.numPointsForInsideFactor[V] >> 1)) << 1) +
+				(factors.insideOdd[U] ? 1 : 2);
+			m_baseIndexToInvert = outsideEdgePointBaseOffset + stripNumQuads + 2;
+			m_cornerCaseBadValue = m_baseIndexToInvert;
+			m_cornerCaseReplacementValue = outsideEdgePointBaseOffset;
+			m_indexInversionEndPoint = m_baseIndexToInvert + m_baseIndexToInvert + stripNumQuads;
+			m_patchMode = PatchMode::Inversion;
+			StitchRegular(false, Diagonals::InsideToOutside, stripNumQuads + 1, m_baseIndexToInvert, outsideEdgePointBaseOffset + 1);
+			m_patchMode = PatchMode::None;
+		}
+		else if (factors.numPointsForInsideFactor[V] >= factors.numPointsForInsideFactor[U] && factors.insideOdd[U])
+		{
+			int stripNumQuads = (((factors.numPointsForInsideFactor[V] >> 1) - (factors.numPointsForInsideFactor[U] >> 1)) << 1) +
+				(factors.insideOdd[V] ? 1 : 2);
+			m_baseIndexToInvert = outsideEdgePointBaseOffset + stripNumQuads + 1;
+			m_cornerCaseBadValue = -1;
+			m_cornerCaseReplacementValue = -1;
+			m_indexInversionEndPoint = m_baseIndexToInvert + m_baseIndexToInvert + stripNumQuads;
+			m_patchMode = PatchMode::Inversion;
+			StitchRegular(false, factors.insideOdd[V] ? Diagonals::InsideToOutsideExceptMiddle : Diagonals::InsideToOutside,
+				stripNumQuads + 1, m_baseIndexToInvert, outsideEdgePointBaseOffset);
+			m_patchMode = PatchMode::None;
+		}
+	}
+
+	void PatternBuilder::TessellateQuad(const float edges[4], const float inside[2])
+	{
+		ProcessedQuadFactors factors;
+		ProcessQuadFactors(edges, inside, factors);
+
+		if (factors.culled)
+		{
+			return;
+		}
+
+		if (factors.minimum)
+		{
+			m_pattern.points.resize(4);
+			DefinePoint(0, 0, 0);
+			DefinePoint(FixedOne, 0, 1);
+			DefinePoint(FixedOne, FixedOne, 2);
+			DefinePoint(0, FixedOne, 3);
+			DefineClockwiseTriangle(0, 1, 3);
+			DefineClockwiseTriangle(1, 2, 3);
+			return;
+		}
+
+		QuadGeneratePoints(factors);
+		QuadGenerateConnectivity(factors);
+	}
+}
+
+Tessellator::Tessellator(TessellatorPartitioning partitioning, TessellatorOutput output) :
+	m_partitioning(partitioning),
+	m_output(output)
+{
+}
+
+void Tessellator::Tessellate(TessellatorDomain domain, const TessellatorFactors& factors, TessellatorPattern& pattern) const
+{
+	PatternBuilder builder(m_partitioning, m_output, pattern);
+	if (domain == TessellatorDomain::Tri)
+	{
+		builder.TessellateTri(factors.edges, factors.inside[0]);
+	}
+	else
+	{
+		builder.TessellateQuad(factors.edges, factors.inside);
+	}
+}
+
+bool TessellatorCache::Key::operator<(const Key& other) const
+{
+	// Bitwise, so NaN factors are cached like any other.
+	return std::memcmp(this, &other, sizeof(Key)) < 0;
+}
+
+std::shared_ptr<const TessellatorPattern> TessellatorCache::Get(TessellatorDomain domain, TessellatorPartitioning partitioning,
+	TessellatorOutput output, const TessellatorFactors& factors)
+{
+	Key key;
+	std::memset(&key, 0, sizeof(key));
+	key.domain = static_cast<int>(domain);
+	key.partitioning = static_cast<int>(partitioning);
+	key.output = static_cast<int>(output);
+	int edgeCount = domain == TessellatorDomain::Tri ? 3 : 4;
+	int insideCount = domain == TessellatorDomain::Tri ? 1 : 2;
+	for (int i = 0; i < edgeCount; i++)
+	{
+		key.factors[i] = factors.edges[i];
+	}
+	for (int i = 0; i < insideCount; i++)
+	{
+		key.factors[4 + i] = factors.inside[i];
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		auto found = m_patterns.find(key);
+		if (found != m_patterns.end())
+		{
+			return found->second;
+		}
+	}
+
+	// Tessellated outside the lock; a racing thread may do the same work, and the first
+	// pattern stored wins.
+	auto pattern = std::make_shared<TessellatorPattern>();
+	Tessellator(partitioning, output).Tessellate(domain, factors, *pattern);
+
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_patterns.insert(std::make_pair(key, std::shared_ptr<const TessellatorPattern>(pattern))).first->second;
+}
+
+size_t TessellatorCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_patterns.size();
+}
+
+void TessellatorCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_patterns.clear();
+}
@@ -0,0 +1,129 @@
+//--------------------------------------------------------------------------------------
+// File: Tessellator.h
+//
+// Software fixed-function tessellator, ported from the Direct3D 11 reference tessellator
+// (CHWTessellator in tessellator.cpp, published in Microsoft's DirectX-Specs repository,
+// https://github.com/microsoft/DirectX-Specs) and reorganised around HlslMath.
+//
+// Copyright (c) Microsoft Corporation.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this
+// software and associated documentation files (the "Software"), to deal in the Software
+// without restriction, including without limitation the rights to use, copy, modify, merge,
+// publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+// to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+// PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+// FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "HlslMath.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DX
+{
+	// [domain(..)]
+	enum class TessellatorDomain
+	{
+		Tri,
+		Quad
+	};
+
+	// [partitioning(..)]
+	enum class TessellatorPartitioning
+	{
+		Integer,
+		Pow2,			// tessellated as integer, as hardware does
+		FractionalOdd,
+		FractionalEven
+	};
+
+	// [outputtopology(..)]
+	enum class TessellatorOutput
+	{
+		TriangleCW,
+		TriangleCCW
+	};
+
+	// Output of the fixed-function stage for one patch: the SV_DomainLocation of every domain
+	// shader invocation and a triangle list over them. Tri domain points hold (u, v); w is
+	// 1 - u - v. An empty pattern means the patch was culled by a factor of zero or NaN.
+	struct TessellatorPattern
+	{
+		std::vector<float2>			points;
+		std::vector<unsigned int>	indices;
+	};
+
+	// Tess factors as a patch constant function writes them: SV_TessFactor then
+	// SV_InsideTessFactor. Tri patches use edges[0..2] and inside[0].
+	struct TessellatorFactors
+	{
+		float edges[4];
+		float inside[2];
+
+		TessellatorFactors() : edges{ 1.0f, 1.0f, 1.0f, 1.0f }, inside{ 1.0f, 1.0f } {}
+
+		static TessellatorFactors Uniform(float factor)
+		{
+			TessellatorFactors factors;
+			factors.edges[0] = factors.edges[1] = factors.edges[2] = factors.edges[3] = factor;
+			factors.inside[0] = factors.inside[1] = factor;
+			return factors;
+		}
+	};
+
+	// Emulation of the D3D11 tessellator. Points are placed with the same 16.16 fixed point
+	// arithmetic, in the same order, and rings are stitched with the same ruler-function split
+	// order as the reference rasterizer, so the domain points and topology match what the
+	// hardware feeds the domain shader.
+	class Tessellator
+	{
+	public:
+		Tessellator(TessellatorPartitioning partitioning, TessellatorOutput output);
+
+		void Tessellate(TessellatorDomain domain, const TessellatorFactors& factors, TessellatorPattern& pattern) const;
+
+	private:
+		TessellatorPartitioning	m_partitioning;
+		TessellatorOutput		m_output;
+	};
+
+	// Tessellates each distinct set of factors once. Patterns are immutable once made and the
+	// cache can be shared between threads.
+	class TessellatorCache
+	{
+	public:
+		std::shared_ptr<const TessellatorPattern> Get(TessellatorDomain domain, TessellatorPartitioning partitioning,
+			TessellatorOutput output, const TessellatorFactors& factors);
+
+		size_t GetSize() const;
+		void Clear();
+
+	private:
+		struct Key
+		{
+			int		domain;
+			int		partitioning;
+			int		output;
+			float	factors[6];
+
+			bool operator<(const Key& other) const;
+		};
+
+		mutable std::mutex										m_lock;
+		std::map<Key, std::shared_ptr<const TessellatorPattern>>	m_patterns;
+	};
+}
@@ -0,0 +1,170 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace DX;
+
+// Pool whose body the current thread is running, to catch a nested ParallelFor.
+static thread_local const ThreadPool* t_runningPool = nullptr;
+
+ThreadPool::ThreadPool(unsigned int threadCount) :
+	m_body(nullptr),
+	m_remaining(0),
+	m_generation(0),
+	m_stop(false)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeLock);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	assert(t_runningPool != this && "ParallelFor called from inside a body on the same pool");
+
+	// One dispatch at a time; the queues only ever hold items of the current body.
+	std::lock_guard<std::mutex> dispatch(m_dispatchLock);
+	const ThreadPool* outerPool = t_runningPool;
+	t_runningPool = this;
+
+	m_body = &body;
+	m_remaining = count;
+
+	// Contiguous ranges keep neighbouring items (adjacent tiles) on the same core.
+	size_t queueCount = m_queues.size();
+	for (size_t q = 0; q < queueCount; q++)
+	{
+		size_t begin = count * q / queueCount;
+		size_t end = count * (q + 1) / queueCount;
+
+		std::lock_guard<std::mutex> lock(m_queues[q]->lock);
+		for (size_t i = begin; i < end; i++)
+		{
+			m_queues[q]->items.push_back(i);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeLock);
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	// Help out rather than sleep.
+	size_t item;
+	while (TrySteal(static_cast<unsigned int>(queueCount), item))
+	{
+		Execute(item);
+	}
+
+	std::unique_lock<std::mutex> lock(m_doneLock);
+	m_done.wait(lock, [this]() { return m_remaining.load() == 0; });
+	m_body = nullptr;
+	t_runningPool = outerPool;
+}
+
+void ThreadPool::WorkerLoop(unsigned int index)
+{
+	unsigned long long seenGeneration = 0;
+	t_runningPool = this;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_wakeLock);
+			m_wake.wait(lock, [&]() { return m_stop || m_generation != seenGeneration; });
+
+			if (m_stop)
+			{
+				return;
+			}
+
+			seenGeneration = m_generation;
+		}
+
+		size_t item;
+		while (TryPop(index, item) || TrySteal(index, item))
+		{
+			Execute(item);
+		}
+	}
+}
+
+// Owner takes from the front of its own queue...
+bool ThreadPool::TryPop(unsigned int index, size_t& item)
+{
+	WorkQueue& queue = *m_queues[index];
+	std::lock_guard<std::mutex> lock(queue.lock);
+
+	if (queue.items.empty())
+	{
+		return false;
+	}
+
+	item = queue.items.front();
+	queue.items.pop_front();
+	return true;
+}
+
+// ...thieves take from the back, away from where the owner is working.
+bool ThreadPool::TrySteal(unsigned int thief, size_t& item)
+{
+	size_t queueCount = m_queues.size();
+
+	for (size_t offset = 1; offset <= queueCount; offset++)
+	{
+		WorkQueue& queue = *m_queues[(thief + offset) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.lock);
+
+		if (!queue.items.empty())
+		{
+			item = queue.items.back();
+			queue.items.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::Execute(size_t item)
+{
+	(*m_body)(item);
+
+	if (m_remaining.fetch_sub(1) == 1)
+	{
+		std::lock_guard<std::mutex> lock(m_doneLock);
+		m_done.notify_all();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DX
+{
+	// Fixed set of worker threads with one work queue each. Work is handed out in contiguous
+	// ranges and idle workers steal from the back of their neighbours' queues, so uneven items
+	// (e.g. tiles covering the fractal vs. empty background) still balance across all cores.
+	class ThreadPool
+	{
+	public:
+		// A thread count of zero uses every hardware thread.
+		explicit ThreadPool(unsigned int threadCount = 0);
+		~ThreadPool();
+
+		unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+		// Runs body(i) for every i in [0, count) and blocks until all of them have finished.
+		// The calling thread takes part in the work. body must not call ParallelFor on the same
+		// pool, which would deadlock on the dispatch lock (asserted in debug builds), and must
+		// not throw, as an exception escaping a worker thread calls std::terminate.
+		void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+	private:
+		struct WorkQueue
+		{
+			std::mutex			lock;
+			std::deque<size_t>	items;
+		};
+
+		void WorkerLoop(unsigned int index);
+		bool TryPop(unsigned int index, size_t& item);
+		bool TrySteal(unsigned int thief, size_t& item);
+		void Execute(size_t item);
+
+	private:
+		std::vector<std::thread>					m_workers;
+		std::vector<std::unique_ptr<WorkQueue>>	m_queues;
+
+		// Current ParallelFor dispatch.
+		std::mutex									m_dispatchLock;
+		const std::function<void(size_t)>*			m_body;
+		std::atomic<size_t>							m_remaining;
+
+		// Wakes workers when a new dispatch is published.
+		std::mutex									m_wakeLock;
+		std::condition_variable						m_wake;
+		unsigned long long							m_generation;
+		bool										m_stop;
+
+		// Signals the dispatching thread once the last item completes.
+		std::mutex									m_doneLock;
+		std::condition_variable						m_done;
+	};
+}
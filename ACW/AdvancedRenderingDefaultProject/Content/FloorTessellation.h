@@ -0,0 +1,31 @@
+#pragma once
+
+// Adaptive floor tessellation, shared by the renderer and the CPU port. Kept free of includes
+// so Sample3DSceneRenderer can use it directly. HullShader.hlsl computes the factors.
+namespace AdvancedRenderingDefaultProject
+{
+	// The floor is a grid of FloorPatchGrid x FloorPatchGrid quad patches over [-1, 1] in x and
+	// z, so each patch gets its own factors.
+	static const unsigned int FloorPatchGrid = 16;
+
+	// What ConstantHS used for the whole floor, and still uses when adaptive is off.
+	static const float FloorFixedTessFactor = 31.0f;
+
+	// Samples of the displacement map along each edge for its variance.
+	static const unsigned int FloorEdgeSamples = 8;
+
+	struct FloorTessellationSettings
+	{
+		bool	adaptive = true;
+
+		// Triangles per pixel of projected edge squared: an edge of L pixels is cut into
+		// L * sqrt(trianglesPerPixel / 2) segments, which gives a patch about that many
+		// triangles per pixel of screen area.
+		float	trianglesPerPixel = 1.0f / 16.0f;
+
+		// Scale on the factor of an edge over flat displacement, rising to 1 once the standard
+		// deviation of the displacement along it reaches detailDeviation.
+		float	flatDetail = 0.25f;
+		float	detailDeviation = 0.1f;
+	};
+}
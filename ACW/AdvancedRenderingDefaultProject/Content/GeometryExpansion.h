@@ -0,0 +1,22 @@
+#pragma once
+
+// How the grass cards and snake segments become triangles, shared by the renderer and the CPU
+// port. Kept free of includes so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	enum class GeometryExpansion
+	{
+		// GrassParticleGS.hlsl and SnakeGS.hlsl amplify each point or line segment.
+		GeometryShader,
+
+		// No geometry shader. GrassInstancedVS.hlsl draws each card as an instance of a
+		// four-vertex strip, reading the card as per-instance data; SnakePullVS.hlsl draws each
+		// segment as an instance of a strip, fetching its ends from a raw buffer by
+		// SV_InstanceID and its ring vertex by SV_VertexID.
+		Instanced
+	};
+
+	// Vertices either path emits per grass card and per snake segment, as one strip each.
+	static const unsigned int GrassCardVertices = 4;
+	static const unsigned int SnakeSegmentVertices = 22;
+}
@@ -0,0 +1,618 @@
+#include "GrassField.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace AdvancedRenderingDefaultProject;
+
+namespace
+{
+	// Chunks per ParallelFor item when culling or building clumps, and cards per item when
+	// writing.
+	const size_t CullBatch = 64;
+	const size_t WriteBatch = 16384;
+
+	// Widest clump card, in blades. A card is the square root of the blades it merges wide:
+	// they stand in a patch about that many blades across.
+	const float ClumpMaxScale = 4.0f;
+
+	// True when the box is wholly outside one of the clip planes, or past maxDistance. The box
+	// is tested by its corners; clip coordinates are linear in position, so if every corner is
+	// outside a plane the whole box is. depth is the nearest corner's view depth, at least 0.
+	bool IsBoxCulled(const float (&m)[4][4], const float boxMin[3], const float boxMax[3], float maxDistance, float& depth)
+	{
+		// Outside -w <= x, x <= w, -w <= y, y <= w, 0 <= z, z <= w, and w <= maxDistance.
+		bool outside[7] = { true, true, true, true, true, true, maxDistance > 0.0f };
+		depth = FLT_MAX;
+		for (int corner = 0; corner < 8; corner++)
+		{
+			float p[3] = { (corner & 1) ? boxMax[0] : boxMin[0], (corner & 2) ? boxMax[1] : boxMin[1], (corner & 4) ? boxMax[2] : boxMin[2] };
+			float clip[4];
+			for (int c = 0; c < 4; c++)
+			{
+				clip[c] = p[0] * m[0][c] + p[1] * m[1][c] + p[2] * m[2][c] + m[3][c];
+			}
+
+			outside[0] = outside[0] && clip[0] < -clip[3];
+			outside[1] = outside[1] && clip[0] > clip[3];
+			outside[2] = outside[2] && clip[1] < -clip[3];
+			outside[3] = outside[3] && clip[1] > clip[3];
+			outside[4] = outside[4] && clip[2] < 0.0f;
+			outside[5] = outside[5] && clip[2] > clip[3];
+			outside[6] = outside[6] && clip[3] > maxDistance;
+			depth = std::min(depth, clip[3]);
+		}
+		depth = std::max(depth, 0.0f);
+
+		for (bool o : outside)
+		{
+			if (o)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Candidates tried around an active point before it is retired, and the blades per r^2 the
+	// fill then reaches with minimum distance r, measured; it sets r from the blade count.
+	const int PoissonAttempts = 16;
+	const float PoissonPacking = 0.84f;
+
+	// Poisson-disc tiles are TileCells grid cells on a side. Tiles are filled in four phases
+	// by the parity of their x and z, so tiles filled together are a whole tile apart and
+	// only ever read or write their own cells and the two-cell ring around them.
+	const int TileCells = 32;
+
+	// Coordinates of an empty Poisson-disc cell: far enough that its squared distance to any
+	// point is over any radius, near enough that it stays finite.
+	const float EmptyCell = 1e18f;
+
+	unsigned int Hash(unsigned int x)
+	{
+		x ^= x >> 16;
+		x *= 0x7feb352dU;
+		x ^= x >> 15;
+		x *= 0x846ca68bU;
+		x ^= x >> 16;
+		return x;
+	}
+
+	void ScatterUniform(const GrassFieldSettings& settings, std::vector<float>& x, std::vector<float>& z)
+	{
+		std::mt19937 mt(settings.seed);
+		std::uniform_real_distribution<float> distrib(-settings.extent, settings.extent);
+		x.resize(settings.bladeCount);
+		z.resize(settings.bladeCount);
+		for (unsigned int i = 0; i < settings.bladeCount; i++)
+		{
+			x[i] = distrib(mt);
+			z[i] = distrib(mt);
+		}
+	}
+
+	// Bridson's algorithm on a background grid of r / sqrt(2) cells, each holding at most one
+	// point, with candidates spread evenly round a circle just over r from the active point
+	// from a random start angle rather than scattered over the annulus out to 2r: the fill is
+	// as tight with far fewer tries, and stepping round the circle needs no sin or cos. Each
+	// tile grows from the points already placed around it, or from a random point when there
+	// are none, and only accepts candidates inside itself.
+	class PoissonDiscScatter
+	{
+	public:
+		PoissonDiscScatter(const GrassFieldSettings& settings) :
+			m_extent(settings.extent),
+			m_seed(settings.seed)
+		{
+			float area = 4.0f * settings.extent * settings.extent;
+			m_radius = std::sqrt(PoissonPacking * area / std::max(1u, settings.bladeCount));
+			m_cellSize = m_radius / std::sqrt(2.0f);
+			m_stepCos = std::cos(6.28318531f / PoissonAttempts);
+			m_stepSin = std::sin(6.28318531f / PoissonAttempts);
+			m_cells = std::max(1, static_cast<int>(std::ceil(2.0f * settings.extent / m_cellSize)));
+			m_tiles = (m_cells + TileCells - 1) / TileCells;
+			m_x.assign(static_cast<size_t>(m_cells) * m_cells, EmptyCell);
+			m_z.assign(m_x.size(), EmptyCell);
+		}
+
+		void Run(DX::ThreadPool& threadPool)
+		{
+			for (int phase = 0; phase < 4; phase++)
+			{
+				int phaseX = phase & 1, phaseZ = phase >> 1;
+				int columns = (m_tiles - phaseX + 1) / 2;
+				int rows = (m_tiles - phaseZ + 1) / 2;
+				threadPool.ParallelFor(static_cast<size_t>(columns) * rows, [&](size_t item)
+				{
+					FillTile(phaseX + 2 * static_cast<int>(item % columns), phaseZ + 2 * static_cast<int>(item / columns));
+				});
+			}
+		}
+
+		// The points in grid order, thinned to the density mask.
+		void Collect(const GrassDensityMask& density, std::vector<float>& x, std::vector<float>& z) const
+		{
+			x.clear();
+			z.clear();
+			for (size_t cell = 0; cell < m_x.size(); cell++)
+			{
+				if (m_x[cell] == EmptyCell)
+				{
+					continue;
+				}
+
+				float keep = density.Sample((m_x[cell] + m_extent) / (2.0f * m_extent), (m_z[cell] + m_extent) / (2.0f * m_extent));
+				if (keep < 1.0f && static_cast<float>(Hash(static_cast<unsigned int>(cell) ^ Hash(m_seed)) >> 8) * (1.0f / 16777216.0f) >= keep)
+				{
+					continue;
+				}
+
+				x.push_back(m_x[cell]);
+				z.push_back(m_z[cell]);
+			}
+		}
+
+	private:
+		int CellOf(float p) const
+		{
+			return std::min(m_cells - 1, std::max(0, static_cast<int>((p + m_extent) / m_cellSize)));
+		}
+
+		// No point within r in the 5 x 5 cells around x, z. Empty cells hold a point far off, so
+		// every cell is tested the same way without a branch.
+		bool IsFree(float x, float z) const
+		{
+			int cx = CellOf(x), cz = CellOf(z);
+			int j0 = std::max(0, cz - 2), j1 = std::min(m_cells - 1, cz + 2);
+			int i0 = std::max(0, cx - 2), i1 = std::min(m_cells - 1, cx + 2);
+			float radius2 = m_radius * m_radius;
+			bool near = false;
+			for (int j = j0; j <= j1; j++)
+			{
+				const float* rowX = &m_x[static_cast<size_t>(j) * m_cells];
+				const float* rowZ = &m_z[static_cast<size_t>(j) * m_cells];
+				for (int i = i0; i <= i1; i++)
+				{
+					float dx = rowX[i] - x, dz = rowZ[i] - z;
+					near |= dx * dx + dz * dz < radius2;
+				}
+			}
+			return !near;
+		}
+
+		void Insert(float x, float z)
+		{
+			size_t cell = static_cast<size_t>(CellOf(z)) * m_cells + CellOf(x);
+			m_x[cell] = x;
+			m_z[cell] = z;
+		}
+
+		void FillTile(int tileX, int tileZ)
+		{
+			int cellMin[2] = { tileX * TileCells, tileZ * TileCells };
+			int cellMax[2] = { std::min(m_cells, cellMin[0] + TileCells), std::min(m_cells, cellMin[1] + TileCells) };
+			float minX = -m_extent + cellMin[0] * m_cellSize, maxX = std::min(m_extent, -m_extent + cellMax[0] * m_cellSize);
+			float minZ = -m_extent + cellMin[1] * m_cellSize, maxZ = std::min(m_extent, -m_extent + cellMax[1] * m_cellSize);
+
+			std::seed_seq seed = { m_seed, static_cast<unsigned int>(tileX), static_cast<unsigned int>(tileZ) };
+			std::mt19937 mt(seed);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+			// Neighbouring tiles' points next to this one carry their fill across the seam.
+			std::vector<float> activeX, activeZ;
+			for (int j = std::max(0, cellMin[1] - 2); j < std::min(m_cells, cellMax[1] + 2); j++)
+			{
+				for (int i = std::max(0, cellMin[0] - 2); i < std::min(m_cells, cellMax[0] + 2); i++)
+				{
+					size_t cell = static_cast<size_t>(j) * m_cells + i;
+					if (m_x[cell] != EmptyCell)
+					{
+						activeX.push_back(m_x[cell]);
+						activeZ.push_back(m_z[cell]);
+					}
+				}
+			}
+
+			if (activeX.empty())
+			{
+				float x = minX + unit(mt) * (maxX - minX);
+				float z = minZ + unit(mt) * (maxZ - minZ);
+				Insert(x, z);
+				activeX.push_back(x);
+				activeZ.push_back(z);
+			}
+
+			while (!activeX.empty())
+			{
+				size_t index = std::min(activeX.size() - 1, static_cast<size_t>(unit(mt) * activeX.size()));
+				float angle = unit(mt) * 6.28318531f;
+				float dx = std::cos(angle) * m_radius * 1.0001f, dz = std::sin(angle) * m_radius * 1.0001f;
+				bool placed = false;
+				for (int attempt = 0; attempt < PoissonAttempts && !placed; attempt++)
+				{
+					float x = activeX[index] + dx;
+					float z = activeZ[index] + dz;
+					if (x >= minX && x < maxX && z >= minZ && z < maxZ && IsFree(x, z))
+					{
+						Insert(x, z);
+						activeX.push_back(x);
+						activeZ.push_back(z);
+						placed = true;
+					}
+
+					float rotatedX = dx * m_stepCos - dz * m_stepSin;
+					dz = dx * m_stepSin + dz * m_stepCos;
+					dx = rotatedX;
+				}
+
+				if (!placed)
+				{
+					activeX[index] = activeX.back();
+					activeZ[index] = activeZ.back();
+					activeX.pop_back();
+					activeZ.pop_back();
+				}
+			}
+		}
+
+	private:
+		float						m_extent;
+		unsigned int				m_seed;
+		float						m_radius;
+		float						m_cellSize;
+		float						m_stepCos;
+		float						m_stepSin;
+		int							m_cells;	// along x and z
+		int							m_tiles;	// along x and z
+		std::vector<float>			m_x;		// EmptyCell where there is no point
+		std::vector<float>			m_z;
+	};
+
+	double SecondsSince(const std::chrono::high_resolution_clock::time_point& start)
+	{
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+}
+
+float GrassDensityMask::Sample(float u, float v) const
+{
+	if (values.empty())
+	{
+		return 1.0f;
+	}
+
+	float x = std::min(std::max(u, 0.0f), 1.0f) * (width - 1);
+	float y = std::min(std::max(v, 0.0f), 1.0f) * (height - 1);
+	unsigned int x0 = std::min(width - 1, static_cast<unsigned int>(x)), y0 = std::min(height - 1, static_cast<unsigned int>(y));
+	unsigned int x1 = std::min(width - 1, x0 + 1), y1 = std::min(height - 1, y0 + 1);
+	float fx = x - x0, fy = y - y0;
+	float top = values[y0 * width + x0] + (values[y0 * width + x1] - values[y0 * width + x0]) * fx;
+	float bottom = values[y1 * width + x0] + (values[y1 * width + x1] - values[y1 * width + x0]) * fx;
+	return top + (bottom - top) * fy;
+}
+
+void GrassField::Generate(const GrassFieldSettings& settings, DX::ThreadPool& threadPool)
+{
+	std::vector<float> x, z;
+	if (settings.distribution == GrassDistribution::PoissonDisc)
+	{
+		PoissonDiscScatter scatter(settings);
+		scatter.Run(threadPool);
+		scatter.Collect(settings.density, x, z);
+	}
+	else
+	{
+		ScatterUniform(settings, x, z);
+		size_t kept = 0;
+		for (size_t i = 0; i < x.size(); i++)
+		{
+			if (settings.density.Sample((x[i] + settings.extent) / (2.0f * settings.extent), (z[i] + settings.extent) / (2.0f * settings.extent)) >
+				static_cast<float>(Hash(static_cast<unsigned int>(i) ^ Hash(settings.seed)) >> 8) * (1.0f / 16777216.0f))
+			{
+				x[kept] = x[i];
+				z[kept] = z[i];
+				kept++;
+			}
+		}
+		x.resize(kept);
+		z.resize(kept);
+	}
+
+	size_t bladeCount = x.size();
+	double chunks = static_cast<double>(bladeCount) / std::max(1u, settings.bladesPerChunk);
+	m_gridSize = std::min(1024u, std::max(1u, static_cast<unsigned int>(std::lround(std::sqrt(chunks)))));
+	m_extent = settings.extent;
+	m_height = settings.height;
+
+	// Bucketed into the grid with a counting sort.
+	std::vector<unsigned int> cell(bladeCount);
+	m_chunkStart.assign(GetChunkCount() + 1, 0);
+	float cellScale = m_gridSize / (2.0f * settings.extent);
+	for (size_t i = 0; i < bladeCount; i++)
+	{
+		unsigned int cx = std::min(m_gridSize - 1, static_cast<unsigned int>(std::max(0.0f, (x[i] + settings.extent) * cellScale)));
+		unsigned int cz = std::min(m_gridSize - 1, static_cast<unsigned int>(std::max(0.0f, (z[i] + settings.extent) * cellScale)));
+		cell[i] = cz * m_gridSize + cx;
+		m_chunkStart[cell[i] + 1]++;
+	}
+
+	for (size_t c = 0; c < GetChunkCount(); c++)
+	{
+		m_chunkStart[c + 1] += m_chunkStart[c];
+	}
+
+	m_x.resize(bladeCount);
+	m_y.assign(bladeCount, settings.height);
+	m_z.resize(bladeCount);
+	std::vector<size_t> next(m_chunkStart.begin(), m_chunkStart.end() - 1);
+	for (size_t i = 0; i < bladeCount; i++)
+	{
+		size_t slot = next[cell[i]]++;
+		m_x[slot] = x[i];
+		m_z[slot] = z[i];
+	}
+
+	// The ground layer's texels: the share of each chunk's ground its blades' quads would
+	// cover if laid flat side by side.
+	float cellSize = 2.0f * settings.extent / m_gridSize;
+	float bladeArea = 4.0f * GrassBladeSize * GrassBladeSize;
+	m_coverage.resize(GetChunkCount());
+	for (size_t c = 0; c < GetChunkCount(); c++)
+	{
+		float covered = (m_chunkStart[c + 1] - m_chunkStart[c]) * bladeArea / (cellSize * cellSize);
+		m_coverage[c] = static_cast<unsigned char>(std::lround(255.0f * std::min(covered, 1.0f)));
+	}
+
+	BuildClumps(settings.bladesPerClump, threadPool);
+}
+
+void GrassField::BuildClumps(unsigned int bladesPerClump, DX::ThreadPool& threadPool)
+{
+	// Each chunk is split into a square grid holding about bladesPerClump blades a cell, and
+	// the blades in a cell are merged into one card. Chunks are built into lists of their own
+	// in parallel, then packed in chunk order.
+	struct ChunkClumps
+	{
+		std::vector<float>	x;
+		std::vector<float>	z;
+		std::vector<float>	scale;
+	};
+
+	unsigned int chunkCount = GetChunkCount();
+	float cellSize = 2.0f * m_extent / m_gridSize;
+	std::vector<ChunkClumps> chunks(chunkCount);
+	threadPool.ParallelFor((chunkCount + CullBatch - 1) / CullBatch, [&](size_t batch)
+	{
+		std::vector<float> sumX, sumZ;
+		std::vector<unsigned int> count;
+		size_t end = std::min(static_cast<size_t>(chunkCount), (batch + 1) * CullBatch);
+		for (size_t c = batch * CullBatch; c < end; c++)
+		{
+			size_t blades = m_chunkStart[c + 1] - m_chunkStart[c];
+			if (blades == 0)
+			{
+				continue;
+			}
+
+			int split = std::min(256, std::max(1, static_cast<int>(std::lround(std::sqrt(static_cast<double>(blades) / std::max(1u, bladesPerClump))))));
+			sumX.assign(split * split, 0.0f);
+			sumZ.assign(split * split, 0.0f);
+			count.assign(split * split, 0);
+
+			float originX = -m_extent + cellSize * static_cast<float>(c % m_gridSize);
+			float originZ = -m_extent + cellSize * static_cast<float>(c / m_gridSize);
+			float scale = split / cellSize;
+			for (size_t b = m_chunkStart[c]; b < m_chunkStart[c + 1]; b++)
+			{
+				int i = std::min(split - 1, std::max(0, static_cast<int>((m_x[b] - originX) * scale)));
+				int j = std::min(split - 1, std::max(0, static_cast<int>((m_z[b] - originZ) * scale)));
+				sumX[j * split + i] += m_x[b];
+				sumZ[j * split + i] += m_z[b];
+				count[j * split + i]++;
+			}
+
+			for (int cell = 0; cell < split * split; cell++)
+			{
+				if (count[cell] > 0)
+				{
+					chunks[c].x.push_back(sumX[cell] / count[cell]);
+					chunks[c].z.push_back(sumZ[cell] / count[cell]);
+					chunks[c].scale.push_back(std::min(ClumpMaxScale, std::sqrt(static_cast<float>(count[cell]))));
+				}
+			}
+		}
+	});
+
+	m_clumpStart.assign(chunkCount + 1, 0);
+	for (unsigned int c = 0; c < chunkCount; c++)
+	{
+		m_clumpStart[c + 1] = m_clumpStart[c] + chunks[c].x.size();
+	}
+
+	size_t clumpCount = m_clumpStart[chunkCount];
+	m_clumpX.resize(clumpCount);
+	m_clumpZ.resize(clumpCount);
+	m_clumpScale.resize(clumpCount);
+	float maxScale = 1.0f;
+	for (unsigned int c = 0; c < chunkCount; c++)
+	{
+		size_t first = m_clumpStart[c];
+		for (size_t k = 0; k < chunks[c].x.size(); k++)
+		{
+			float scale = chunks[c].scale[k];
+			m_clumpX[first + k] = chunks[c].x[k];
+			m_clumpZ[first + k] = chunks[c].z[k];
+			m_clumpScale[first + k] = scale;
+			maxScale = std::max(maxScale, scale);
+		}
+	}
+
+	m_cardRadius = GrassBladeRadius + (maxScale - 1.0f) * GrassBladeSize;
+}
+
+GrassCullStats GrassField::Cull(const GrassView& view, DX::ThreadPool& threadPool, GrassVisibleSet& visible) const
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	unsigned int chunkCount = GetChunkCount();
+	visible.depths.resize(chunkCount);
+	float cellSize = 2.0f * m_extent / m_gridSize;
+
+	threadPool.ParallelFor((chunkCount + CullBatch - 1) / CullBatch, [&](size_t batch)
+	{
+		size_t end = std::min(static_cast<size_t>(chunkCount), (batch + 1) * CullBatch);
+		for (size_t c = batch * CullBatch; c < end; c++)
+		{
+			if (m_chunkStart[c] == m_chunkStart[c + 1])
+			{
+				visible.depths[c] = -1.0f;
+				continue;
+			}
+
+			float cx = -m_extent + cellSize * static_cast<float>(c % m_gridSize);
+			float cz = -m_extent + cellSize * static_cast<float>(c / m_gridSize);
+			float boxMin[3] = { cx - m_cardRadius, m_height - m_cardRadius, cz - m_cardRadius };
+			float boxMax[3] = { cx + cellSize + m_cardRadius, m_height + m_cardRadius, cz + cellSize + m_cardRadius };
+			float depth;
+			visible.depths[c] = IsBoxCulled(view.modelViewProjection, boxMin, boxMax, view.maxDistance, depth) ? -1.0f : depth;
+		}
+	});
+
+	GrassCullStats stats;
+	visible.chunks.clear();
+	for (unsigned int c = 0; c < chunkCount; c++)
+	{
+		stats.chunks += m_chunkStart[c + 1] > m_chunkStart[c] ? 1 : 0;
+		if (visible.depths[c] >= 0.0f)
+		{
+			visible.chunks.push_back(c);
+		}
+	}
+	stats.visibleChunks = static_cast<unsigned int>(visible.chunks.size());
+
+	// LODs are handed out nearest first, so the blades and clumps within budget go to the
+	// chunks that need them most. Without LOD the grid order is kept.
+	const GrassLodSettings& lod = view.lod;
+	if (lod.enabled)
+	{
+		const std::vector<float>& depths = visible.depths;
+		std::sort(visible.chunks.begin(), visible.chunks.end(), [&depths](unsigned int a, unsigned int b)
+		{
+			return depths[a] < depths[b] || (depths[a] == depths[b] && a < b);
+		});
+	}
+
+	visible.offsets.clear();
+	visible.ground.assign(chunkCount, 0);
+	visible.bladeChunks = 0;
+	visible.bladeCount = 0;
+	visible.clumpCount = 0;
+	visible.groundChunks = 0;
+	GrassLod level = GrassLod::Blades;
+	size_t kept = 0;
+	for (unsigned int c : visible.chunks)
+	{
+		size_t blades = m_chunkStart[c + 1] - m_chunkStart[c];
+		size_t clumps = m_clumpStart[c + 1] - m_clumpStart[c];
+		if (lod.enabled && level == GrassLod::Blades && (visible.depths[c] >= lod.clumpDistance || visible.bladeCount + blades > lod.bladeBudget))
+		{
+			level = GrassLod::Clumps;
+		}
+		if (lod.enabled && level == GrassLod::Clumps && (visible.depths[c] >= lod.groundDistance || visible.clumpCount + clumps > lod.clumpBudget))
+		{
+			level = GrassLod::Ground;
+		}
+
+		if (level == GrassLod::Ground)
+		{
+			visible.ground[c] = m_coverage[c];
+			visible.groundChunks++;
+			continue;
+		}
+
+		visible.chunks[kept++] = c;
+		visible.offsets.push_back(visible.bladeCount + visible.clumpCount);
+		if (level == GrassLod::Blades)
+		{
+			visible.bladeChunks++;
+			visible.bladeCount += blades;
+		}
+		else
+		{
+			visible.clumpCount += clumps;
+		}
+	}
+	visible.chunks.resize(kept);
+
+	stats.visibleBlades = visible.bladeCount;
+	stats.visibleClumps = visible.clumpCount;
+	stats.groundChunks = visible.groundChunks;
+	stats.seconds = SecondsSince(start);
+	return stats;
+}
+
+void GrassField::Write(const GrassVisibleSet& visible, float* destination, DX::ThreadPool& threadPool) const
+{
+	auto cards = [&](size_t i)
+	{
+		unsigned int c = visible.chunks[i];
+		return i < visible.bladeChunks ? m_chunkStart[c + 1] - m_chunkStart[c] : m_clumpStart[c + 1] - m_clumpStart[c];
+	};
+
+	// Batches of whole chunks, cut after WriteBatch cards, so big and small chunks balance.
+	std::vector<size_t> batches;
+	size_t batchCards = 0;
+	for (size_t i = 0; i < visible.chunks.size(); i++)
+	{
+		if (batches.empty() || batchCards >= WriteBatch)
+		{
+			batches.push_back(i);
+			batchCards = 0;
+		}
+		batchCards += cards(i);
+	}
+	batches.push_back(visible.chunks.size());
+
+	threadPool.ParallelFor(batches.size() - 1, [&](size_t batch)
+	{
+		for (size_t i = batches[batch]; i < batches[batch + 1]; i++)
+		{
+			unsigned int c = visible.chunks[i];
+			float* out = destination + visible.offsets[i] * 4;
+			if (i < visible.bladeChunks)
+			{
+				for (size_t b = m_chunkStart[c]; b < m_chunkStart[c + 1]; b++)
+				{
+					out[0] = m_x[b];
+					out[1] = m_y[b];
+					out[2] = m_z[b];
+					out[3] = 1.0f;
+					out += 4;
+				}
+			}
+			else
+			{
+				for (size_t k = m_clumpStart[c]; k < m_clumpStart[c + 1]; k++)
+				{
+					out[0] = m_clumpX[k];
+					out[1] = m_height;
+					out[2] = m_clumpZ[k];
+					out[3] = m_clumpScale[k];
+					out += 4;
+				}
+			}
+		}
+	});
+}
+
+size_t GrassRing::Allocate(size_t& count, bool& wrapped)
+{
+	count = std::min(count, m_capacity);
+	wrapped = m_head == 0 || m_head + count > m_capacity;
+	size_t first = wrapped ? 0 : m_head;
+	m_head = first + count;
+	return first;
+}
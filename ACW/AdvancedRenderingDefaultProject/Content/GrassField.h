@@ -0,0 +1,189 @@
+#pragma once
+
+#include "../Common/ThreadPool.h"
+
+#include <stddef.h>
+#include <vector>
+
+// Grass blades for GrassParticleGS.hlsl, stored in chunks on a uniform grid over the floor so
+// that whole chunks are culled and uploaded at once. Only depends on the standard library and
+// the thread pool, so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	// Half the width and height of GrassParticleGS.hlsl's quad. Clump cards are as tall and
+	// their scale times as wide.
+	static const float GrassBladeSize = 0.05f;
+
+	// How far a blade reaches from its point: its quad corners plus the sway of its top corners
+	// (0.025), rounded up.
+	static const float GrassBladeRadius = 0.1f;
+
+	// How a chunk is drawn. Chunks near the camera draw every blade; further out each clump of
+	// nearby blades is merged into one wider card, and past that the chunk only tints the
+	// ground layer, a single quad over the field at the height of the blade tips.
+	enum class GrassLod : unsigned char
+	{
+		Blades,
+		Clumps,
+		Ground
+	};
+
+	enum class GrassDistribution
+	{
+		Uniform,		// independent uniform points; they clump and leave gaps
+		PoissonDisc		// no two blades closer than a minimum distance, so coverage is even
+	};
+
+	// Relative blade density over the field, 0 to 1. u runs along x and v along z, row-major
+	// from (-extent, -extent). An empty mask is 1 everywhere.
+	struct GrassDensityMask
+	{
+		unsigned int		width = 0;
+		unsigned int		height = 0;
+		std::vector<float>	values;
+
+		// Bilinear, with u and v in [0, 1].
+		float Sample(float u, float v) const;
+	};
+
+	struct GrassFieldSettings
+	{
+		unsigned int		bladeCount = 200;		// at full density
+		float				extent = 0.95f;			// blades cover [-extent, extent] in x and z
+		float				height = 0.04f;			// the y every blade stands at
+		unsigned int		seed = 1;
+		unsigned int		bladesPerChunk = 1024;	// sets the grid resolution
+		unsigned int		bladesPerClump = 8;		// blades merged into each clump card
+		GrassDistribution	distribution = GrassDistribution::PoissonDisc;
+		GrassDensityMask	density;
+	};
+
+	// Where chunks switch LOD. Chunks are taken nearest first by the view depth (clip w) of
+	// their closest corner; a chunk draws blades while it is nearer than clumpDistance and its
+	// blades still fit in bladeBudget, then clumps while nearer than groundDistance and within
+	// clumpBudget, and is ground from there on. The budgets bound the cards drawn however many
+	// blades the field holds.
+	struct GrassLodSettings
+	{
+		bool			enabled = true;			// false draws every visible chunk's blades
+		float			clumpDistance = 1.5f;
+		float			groundDistance = 2.2f;
+		size_t			bladeBudget = 131072;
+		size_t			clumpBudget = 65536;
+	};
+
+	// The camera a field is culled for.
+	struct GrassView
+	{
+		// Row-vector model * view * projection, the product GrassParticleGS.hlsl applies.
+		float			modelViewProjection[4][4];
+
+		// View depth (clip w) past which chunks are dropped; zero keeps every distance.
+		float			maxDistance = 0.0f;
+
+		GrassLodSettings	lod;
+	};
+
+	struct GrassCullStats
+	{
+		double			seconds = 0.0;
+		unsigned int	chunks = 0;				// non-empty chunks tested
+		unsigned int	visibleChunks = 0;
+		size_t			visibleBlades = 0;		// drawn as blades
+		size_t			visibleClumps = 0;
+		unsigned int	groundChunks = 0;
+	};
+
+	// Chunks that survived culling, nearest first, and where their cards start in the upload:
+	// the chunks drawing blades, then those drawing clumps.
+	struct GrassVisibleSet
+	{
+		std::vector<unsigned int>	chunks;
+		std::vector<size_t>			offsets;
+		size_t						bladeChunks = 0;	// chunks[0, bladeChunks) draw blades
+		size_t						bladeCount = 0;
+		size_t						clumpCount = 0;		// clump cards, after the blades
+
+		// The ground layer, one texel per chunk in grid order: the chunk's coverage where it
+		// is drawn as ground, zero elsewhere.
+		std::vector<unsigned char>	ground;
+		unsigned int				groundChunks = 0;
+
+		// Per chunk view depth, negative when culled, kept between frames to avoid reallocating.
+		std::vector<float>			depths;
+
+		size_t GetCardCount() const { return bladeCount + clumpCount; }
+	};
+
+	// Blades in structure-of-arrays form, sorted by chunk, with each chunk's clump cards beside
+	// them. Chunks are the cells of a square grid over the field, each bounded by its cell
+	// grown by the reach of its largest card.
+	class GrassField
+	{
+	public:
+		GrassField() : m_gridSize(0), m_extent(0.0f), m_height(0.0f), m_cardRadius(GrassBladeRadius) {}
+
+		// Scatters the blades. Poisson-disc fields are filled tile by tile on threadPool; every
+		// tile draws from its own generator, so the same settings give the same field on any
+		// number of threads.
+		void Generate(const GrassFieldSettings& settings, DX::ThreadPool& threadPool);
+
+		size_t GetBladeCount() const { return m_x.size(); }
+		size_t GetClumpCount() const { return m_clumpX.size(); }
+		unsigned int GetChunkCount() const { return m_gridSize * m_gridSize; }
+		unsigned int GetGridSize() const { return m_gridSize; }
+		float GetExtent() const { return m_extent; }
+
+		// The ground layer's height: the tips of the blades.
+		float GetGroundHeight() const { return m_height + GrassBladeSize; }
+
+		// Tests every chunk's bounds against the view frustum and distance and measures its
+		// depth, split across threadPool, then picks each visible chunk's LOD.
+		GrassCullStats Cull(const GrassView& view, DX::ThreadPool& threadPool, GrassVisibleSet& visible) const;
+
+		// Writes the visible cards to destination as a position and a scale (GrassCard), in the
+		// order and at the offsets Cull gave them. destination holds visible.GetCardCount().
+		void Write(const GrassVisibleSet& visible, float* destination, DX::ThreadPool& threadPool) const;
+
+	private:
+		void BuildClumps(unsigned int bladesPerClump, DX::ThreadPool& threadPool);
+
+		std::vector<float>	m_x;
+		std::vector<float>	m_y;
+		std::vector<float>	m_z;
+		std::vector<size_t>	m_chunkStart;	// first blade of each chunk, then the blade count
+
+		// Clump cards, sorted by chunk the same way: the centroid of the blades they merge and
+		// the card's scale.
+		std::vector<float>	m_clumpX;
+		std::vector<float>	m_clumpZ;
+		std::vector<float>	m_clumpScale;
+		std::vector<size_t>	m_clumpStart;
+
+		std::vector<unsigned char>	m_coverage;	// per chunk, 255 where blades cover the ground
+		unsigned int		m_gridSize;		// chunks along x and z
+		float				m_extent;
+		float				m_height;
+		float				m_cardRadius;	// GrassBladeRadius, or more for the largest clump
+	};
+
+	// Allocator for a persistent upload buffer that is written front to back across frames.
+	// Ranges are handed out after the previous frame's, so the GPU can still be reading those
+	// while the next is written (D3D11_MAP_WRITE_NO_OVERWRITE). Once the end is reached the
+	// ring starts over at zero and the caller discards the buffer instead.
+	class GrassRing
+	{
+	public:
+		explicit GrassRing(size_t capacity = 0) : m_capacity(capacity), m_head(0) {}
+
+		size_t GetCapacity() const { return m_capacity; }
+
+		// Reserves count elements, clamping count to the capacity, and returns the first one.
+		// wrapped is set when the range starts over at zero.
+		size_t Allocate(size_t& count, bool& wrapped);
+
+	private:
+		size_t				m_capacity;
+		size_t				m_head;
+	};
+}
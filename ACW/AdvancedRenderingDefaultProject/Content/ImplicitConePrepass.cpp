@@ -0,0 +1,153 @@
+#include "ImplicitConePrepass.h"
+#include "ImplicitCpuRenderer.h"
+#include "ImplicitSceneKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace AdvancedRenderingDefaultProject::Implicit;
+
+namespace
+{
+	// Cone through the pixel rays of a block: the axis and the largest distance between the axis
+	// and a ray direction, i.e. how far apart they are per unit of depth.
+	struct Cone
+	{
+		Ray		axis;
+		float	spread;
+	};
+
+	Cone BlockCone(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, unsigned int width, unsigned int height)
+	{
+		// The rays pass through a flat canvas, so the corner pixels are the furthest from the axis.
+		float2 c00 = ImplicitCpuRenderer::PixelToCanvas(x0, y0, width, height);
+		float2 c11 = ImplicitCpuRenderer::PixelToCanvas(x1 - 1, y1 - 1, width, height);
+
+		Cone cone;
+		cone.axis = eyeRayForCanvas(0.5f * (c00 + c11));
+
+		float3 corners[4] =
+		{
+			eyeRayForCanvas(c00).direction,
+			eyeRayForCanvas(float2(c11.x, c00.y)).direction,
+			eyeRayForCanvas(float2(c00.x, c11.y)).direction,
+			eyeRayForCanvas(c11).direction
+		};
+
+		cone.spread = 0.0f;
+		for (const float3& corner : corners)
+		{
+			cone.spread = std::max(cone.spread, length(corner - cone.axis.direction));
+		}
+
+		// Margin for the rounding in the directions above.
+		cone.spread = cone.spread * 1.01f + 1e-6f;
+		return cone;
+	}
+
+	// Furthest depth no ray of the cone can hit anything before. The march stops once the free
+	// radius around the cone is smaller than the cone itself, where the steps stop paying off.
+	float MarchCone(SceneDistFunc dist, const Cone& cone, float start, float end, unsigned long long& steps)
+	{
+		float depth = start;
+
+		for (int i = 0; i < MAX_MARCH; i++)
+		{
+			float coneRadius = depth * cone.spread;
+			float free = dist(cone.axis.origin + depth * cone.axis.direction) - coneRadius;
+			steps++;
+
+			if (free < std::max(coneRadius, EPSILON))
+			{
+				break;
+			}
+
+			depth += free;
+			if (depth >= end)
+			{
+				return end;
+			}
+		}
+
+		return depth;
+	}
+}
+
+void ImplicitConePrepass::Run(ImplicitSceneType scene, unsigned int width, unsigned int height, const std::vector<unsigned int>& blockSizes, DX::ThreadPool& threadPool)
+{
+	SceneDistFunc dist = GetSceneDistFunc(scene);
+
+	m_width = width;
+	m_height = height;
+	m_passStats.clear();
+
+	// One block per pixel with no passes, which starts every ray at the near plane.
+	m_blockSize = 1;
+	m_blocksX = width;
+	m_depths.assign(static_cast<size_t>(width) * height, nearPlane);
+
+	std::vector<float> parentDepths;
+	unsigned int parentSize = 0;
+	unsigned int parentBlocksX = 0;
+
+	for (unsigned int blockSize : blockSizes)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		const unsigned int blocksX = (width + blockSize - 1) / blockSize;
+		const unsigned int blocksY = (height + blockSize - 1) / blockSize;
+		std::vector<float> depths(static_cast<size_t>(blocksX) * blocksY);
+		std::atomic<unsigned long long> passSteps(0);
+
+		// One row of blocks per item, as one thread group row of the compute version would be.
+		threadPool.ParallelFor(blocksY, [&](size_t by)
+		{
+			unsigned long long rowSteps = 0;
+
+			for (unsigned int bx = 0; bx < blocksX; bx++)
+			{
+				unsigned int x0 = bx * blockSize;
+				unsigned int y0 = static_cast<unsigned int>(by) * blockSize;
+
+				float from = nearPlane;
+				if (!parentDepths.empty())
+				{
+					from = parentDepths[static_cast<size_t>(y0 / parentSize) * parentBlocksX + x0 / parentSize];
+				}
+
+				float depth = farPlane;
+				if (from < farPlane)
+				{
+					Cone cone = BlockCone(x0, y0, std::min(x0 + blockSize, width), std::min(y0 + blockSize, height), width, height);
+					depth = MarchCone(dist, cone, from, farPlane, rowSteps);
+				}
+
+				depths[by * blocksX + bx] = depth;
+			}
+
+			passSteps += rowSteps;
+		});
+
+		auto end = std::chrono::high_resolution_clock::now();
+
+		ImplicitConePassStats stats;
+		stats.blockSize = blockSize;
+		stats.blocks = blocksX * blocksY;
+		stats.steps = passSteps.load();
+		stats.seconds = std::chrono::duration<double>(end - start).count();
+		m_passStats.push_back(stats);
+
+		parentDepths.swap(depths);
+		parentSize = blockSize;
+		parentBlocksX = blocksX;
+	}
+
+	if (!parentDepths.empty())
+	{
+		m_blockSize = parentSize;
+		m_blocksX = parentBlocksX;
+		m_depths.swap(parentDepths);
+	}
+}
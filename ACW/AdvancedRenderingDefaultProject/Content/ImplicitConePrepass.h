@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ImplicitScene.h"
+#include "../Common/ThreadPool.h"
+
+#include <vector>
+
+namespace AdvancedRenderingDefaultProject
+{
+	struct ImplicitConePassStats
+	{
+		unsigned int		blockSize = 0;
+		unsigned int		blocks = 0;
+		unsigned long long	steps = 0;		// distance evaluations over all blocks of the pass
+		double				seconds = 0.0;
+	};
+
+	// Safe starting depths for the primary rays, found by marching one cone per block of pixels.
+	// A cone holds every pixel ray of its block; at depth t those rays are within t * spread of
+	// the axis, so the axis distance minus that bounds the distance along all of them. Passes go
+	// from coarse to fine blocks and each block continues from the depth of the block above it,
+	// so a pass is one dispatch over its blocks reading the previous pass' depths.
+	class ImplicitConePrepass
+	{
+	public:
+		ImplicitConePrepass() : m_width(0), m_height(0), m_blockSize(1), m_blocksX(0) {}
+
+		// blockSizes run coarse to fine, each a multiple of the next (e.g. { 8, 2 }).
+		void Run(ImplicitSceneType scene, unsigned int width, unsigned int height, const std::vector<unsigned int>& blockSizes, DX::ThreadPool& threadPool);
+
+		// Depth the pixel ray can start from; farPlane when its whole block missed.
+		float GetStartDepth(unsigned int x, unsigned int y) const
+		{
+			return m_depths[static_cast<size_t>(y / m_blockSize) * m_blocksX + x / m_blockSize];
+		}
+
+		unsigned int GetWidth() const { return m_width; }
+		unsigned int GetHeight() const { return m_height; }
+		const std::vector<ImplicitConePassStats>& GetPassStats() const { return m_passStats; }
+
+	private:
+		unsigned int						m_width;
+		unsigned int						m_height;
+		unsigned int						m_blockSize;	// of the finest pass
+		unsigned int						m_blocksX;
+		std::vector<float>					m_depths;		// per finest block
+		std::vector<ImplicitConePassStats>	m_passStats;
+	};
+}
@@ -0,0 +1,155 @@
+#include "ImplicitCpuRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace DX;
+
+ImplicitCpuRenderer::ImplicitCpuRenderer(const std::shared_ptr<DX::ThreadPool>& threadPool) :
+	m_threadPool(threadPool)
+{
+}
+
+DX::float2 ImplicitCpuRenderer::PixelToCanvas(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	// The vertex shader scales x by the projection aspect ratio; y runs up the screen.
+	float aRatio = static_cast<float>(width) / static_cast<float>(height);
+	float ndcX = (x + 0.5f) / width * 2.0f - 1.0f;
+	float ndcY = 1.0f - (y + 0.5f) / height * 2.0f;
+	return float2(ndcX * aRatio, ndcY);
+}
+
+ImplicitRenderStats ImplicitCpuRenderer::Render(const ImplicitRenderSettings& settings, DX::ImageBuffer& target)
+{
+	ImplicitRenderStats stats;
+
+	const unsigned int width = target.GetWidth();
+	const unsigned int height = target.GetHeight();
+	const unsigned int tileSize = std::max(1u, settings.tileSize);
+	const unsigned int tilesX = (width + tileSize - 1) / tileSize;
+	const unsigned int tilesY = (height + tileSize - 1) / tileSize;
+
+	stats.tileCount = tilesX * tilesY;
+
+	Implicit::MarchRaysFunc marchRays = Implicit::GetMarchRaysFunc(settings.simd);
+	const bool relaxed = settings.march.relaxation != 1.0f || settings.march.hitPixels != 0.0f;
+	const float canvasPerPixel = 2.0f / height;
+	const bool fractalLod = settings.fractalLod && settings.scene == ImplicitSceneType::Fractal;
+	const float pixelAngle = Implicit::pixelFootprint(float2(0.0f, 0.0f), canvasPerPixel);
+
+	const bool allSlices = settings.sliceCount >= ImplicitInterleave::SliceCount;
+
+	std::atomic<unsigned long long> marchSteps(0);
+	std::atomic<unsigned long long> tracedPixels(0);
+	auto start = std::chrono::high_resolution_clock::now();
+
+	m_threadPool->ParallelFor(stats.tileCount, [&](size_t tile)
+	{
+		unsigned int x0 = static_cast<unsigned int>(tile % tilesX) * tileSize;
+		unsigned int y0 = static_cast<unsigned int>(tile / tilesX) * tileSize;
+		unsigned int x1 = std::min(x0 + tileSize, width);
+		unsigned int y1 = std::min(y0 + tileSize, height);
+
+		Implicit::Ray rays[64];
+		unsigned int xs[64];
+		float starts[64];
+		float depths[64];
+		unsigned long long tileSteps = 0;
+		unsigned long long tilePixels = 0;
+
+		for (unsigned int y = y0; y < y1; y++)
+		{
+			// March the row's traced pixels in spans that fit the local buffers, then shade them.
+			for (unsigned int x = x0; x < x1;)
+			{
+				unsigned int spanCount = 0;
+				for (; x < x1 && spanCount < 64; x++)
+				{
+					if (allSlices || ImplicitInterleave::InSlices(ImplicitInterleave::SliceOfPixel(x, y), settings.sliceFirst, settings.sliceCount))
+					{
+						xs[spanCount] = x;
+						rays[spanCount] = Implicit::eyeRayForCanvas(PixelToCanvas(x, y, width, height), settings.eye);
+						starts[spanCount] = settings.conePrepass ? settings.conePrepass->GetStartDepth(x, y) : Implicit::nearPlane;
+						spanCount++;
+					}
+				}
+
+				if (settings.brickMap)
+				{
+					for (unsigned int i = 0; i < spanCount; i++)
+					{
+						int raySteps = 0;
+						depths[i] = settings.brickMap->March(rays[i], starts[i], Implicit::farPlane, &raySteps);
+						tileSteps += raySteps;
+					}
+				}
+				else if (fractalLod)
+				{
+					for (unsigned int i = 0; i < spanCount; i++)
+					{
+						int raySteps = 0;
+						depths[i] = Implicit::shortestDistanceToSurfaceLod(settings.scene, rays[i], starts[i], Implicit::farPlane, pixelAngle, &raySteps);
+						tileSteps += raySteps;
+					}
+				}
+				else if (relaxed)
+				{
+					for (unsigned int i = 0; i < spanCount; i++)
+					{
+						float2 canvasXY = PixelToCanvas(xs[i], y, width, height);
+						float hitRadius = settings.march.hitPixels * Implicit::pixelFootprint(canvasXY, canvasPerPixel);
+						int raySteps = 0;
+						depths[i] = Implicit::shortestDistanceToSurfaceRelaxed(settings.scene, rays[i], starts[i], Implicit::farPlane,
+							settings.march.relaxation, hitRadius, &raySteps);
+						tileSteps += raySteps;
+					}
+				}
+				else
+				{
+					// Runs of rays sharing a start depth go to the marcher together; rays whose cone
+					// block missed everything are already done.
+					for (unsigned int i = 0; i < spanCount;)
+					{
+						unsigned int run = 1;
+						while (i + run < spanCount && starts[i + run] == starts[i])
+						{
+							run++;
+						}
+
+						if (starts[i] >= Implicit::farPlane)
+						{
+							std::fill(depths + i, depths + i + run, Implicit::farPlane);
+						}
+						else
+						{
+							marchRays(settings.scene, rays + i, run, starts[i], Implicit::farPlane, depths + i, &tileSteps);
+						}
+						i += run;
+					}
+				}
+
+				for (unsigned int i = 0; i < spanCount; i++)
+				{
+					target.At(xs[i], y) = Implicit::shadeHit(settings.scene, rays[i], depths[i], settings.normals);
+					if (settings.depths)
+					{
+						settings.depths[static_cast<size_t>(y) * width + xs[i]] = depths[i];
+					}
+				}
+				tilePixels += spanCount;
+			}
+		}
+
+		marchSteps += tileSteps;
+		tracedPixels += tilePixels;
+	});
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.seconds = std::chrono::duration<double>(end - start).count();
+	stats.marchSteps = marchSteps.load();
+	stats.tracedPixels = tracedPixels.load();
+
+	return stats;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ImplicitScene.h"
+#include "ImplicitConePrepass.h"
+#include "ImplicitPacket.h"
+#include "ImplicitTimeSlicing.h"
+#include "SdfBrickMap.h"
+#include "../Common/ImageBuffer.h"
+#include "../Common/ThreadPool.h"
+
+#include <memory>
+
+namespace AdvancedRenderingDefaultProject
+{
+	struct ImplicitRenderSettings
+	{
+		ImplicitSceneType	scene = ImplicitSceneType::Default;
+		unsigned int		tileSize = 16;
+
+		// Scalar marches one ray at a time; any other level marches each tile row in ray packets.
+		DX::SimdLevel		simd = DX::SimdLevel::Scalar;
+
+		// When set, rays march this baked field instead of sceneDistFunc (shading stays analytic).
+		const SdfBrickMap*	brickMap = nullptr;
+
+		// When set, each ray starts from the prepass depth for its pixel instead of nearPlane.
+		// The prepass has to have been run at the size of the target.
+		const ImplicitConePrepass*	conePrepass = nullptr;
+
+		// Marches the fractal at the detail a pixel can show (fractalLod); shading is unchanged.
+		bool					fractalLod = false;
+
+		// Central matches the pixel shaders the app draws with.
+		ImplicitNormalMode		normals = ImplicitNormalMode::Central;
+
+		// Anything but the plain march uses shortestDistanceToSurfaceRelaxed, one ray at a time.
+		ImplicitMarchSettings	march = ImplicitPlainMarch();
+
+		// Eye the primary rays leave from. The cone prepass and fractal LOD assume eyePos.
+		DX::float3				eye = Implicit::eyePos;
+
+		// Only pixels whose ImplicitInterleave slice is among sliceCount slices from sliceFirst
+		// are traced; the rest of the target is left as it was.
+		unsigned int			sliceFirst = 0;
+		unsigned int			sliceCount = ImplicitInterleave::SliceCount;
+
+		// When set, receives the hit depth of each traced pixel (farPlane on a miss), row-major
+		// at the size of the target.
+		float*					depths = nullptr;
+	};
+
+	struct ImplicitRenderStats
+	{
+		double				seconds = 0.0;
+		unsigned int		tileCount = 0;
+		unsigned long long	tracedPixels = 0;
+		unsigned long long	marchSteps = 0;
+	};
+
+	// Headless reference renderer for the implicit scenes. The frame is cut into square tiles
+	// which are shaded on the shared thread pool, each pixel running the same code path as
+	// ImplicitPixelShader.hlsl.
+	class ImplicitCpuRenderer
+	{
+	public:
+		ImplicitCpuRenderer(const std::shared_ptr<DX::ThreadPool>& threadPool);
+
+		// Renders into target at its current size.
+		ImplicitRenderStats Render(const ImplicitRenderSettings& settings, DX::ImageBuffer& target);
+
+		// Canvas coordinate of a pixel centre, matching the interpolated canvasXY from ImplicitVS.hlsl.
+		static DX::float2 PixelToCanvas(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
+	private:
+		std::shared_ptr<DX::ThreadPool> m_threadPool;
+	};
+}
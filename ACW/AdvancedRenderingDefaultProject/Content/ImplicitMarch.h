@@ -0,0 +1,38 @@
+#pragma once
+
+// Marcher selection for the implicit scenes, shared by the renderer (ControlBuffer marching)
+// and the CPU port. Kept free of includes so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	struct ImplicitMarchSettings
+	{
+		// Step factor for over-relaxed sphere tracing; 1 is plain sphere tracing.
+		float relaxation;
+
+		// Hit distance as a fraction of the pixel footprint at the current depth; 0 keeps the
+		// fixed EPSILON of shortestDistanceToSurface.
+		float hitPixels;
+	};
+
+	// What shortestDistanceToSurface does.
+	inline ImplicitMarchSettings ImplicitPlainMarch()
+	{
+		return ImplicitMarchSettings{ 1.0f, 0.0f };
+	}
+
+	// Per-scene settings for the relaxed marcher, indexed by ImplicitSceneType, picked with
+	// "headless implicit-relaxed". The repetition's mod() field overestimates across cells, so
+	// larger steps there start skipping surfaces.
+	inline ImplicitMarchSettings ImplicitRelaxedMarch(int scene)
+	{
+		static const ImplicitMarchSettings settings[] =
+		{
+			{ 1.8f, 0.5f },		// Default
+			{ 1.2f, 0.5f },		// Repeating
+			{ 1.8f, 0.5f },		// Deforming
+			{ 1.6f, 0.5f },		// Fractal
+			{ 1.2f, 0.5f }		// Shiny
+		};
+		return scene >= 0 && scene < 5 ? settings[scene] : ImplicitPlainMarch();
+	}
+}
@@ -0,0 +1,51 @@
+#include "ImplicitPacket.h"
+#include "ImplicitSceneKernels.h"
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace DX;
+
+unsigned int Implicit::PacketLanes(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::SSE41:	return 8;
+	case SimdLevel::AVX2:	return 8;
+	case SimdLevel::AVX512:	return 16;
+	default:				return 1;
+	}
+}
+
+Implicit::MarchRaysFunc Implicit::GetMarchRaysFunc(SimdLevel level)
+{
+	if (level > GetSupportedSimdLevel())
+	{
+		level = GetSupportedSimdLevel();
+	}
+
+	switch (level)
+	{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	case SimdLevel::AVX512:	return &MarchRaysAVX512;
+	case SimdLevel::AVX2:	return &MarchRaysAVX2;
+	case SimdLevel::SSE41:	return &MarchRaysSSE41;
+#endif
+	default:				return &MarchRaysCompiled;
+	}
+}
+
+void Implicit::MarchRaysScalar(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps)
+{
+	unsigned long long totalSteps = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		int raySteps = 0;
+		depths[i] = shortestDistanceToSurface(scene, rays[i], start, end, &raySteps);
+		totalSteps += raySteps;
+	}
+
+	if (steps)
+	{
+		*steps += totalSteps;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ImplicitScene.h"
+#include "../Common/CpuFeatures.h"
+
+#include <stddef.h>
+
+// Ray-packet sphere tracing for the implicit scenes. Rays are marched 8 (SSE4.1, AVX2) or
+// 16 (AVX-512) at a time; lanes drop out of the packet once they hit (dist < EPSILON) or
+// pass the far plane, and the packet finishes when no lane is left active.
+namespace AdvancedRenderingDefaultProject
+{
+	namespace Implicit
+	{
+		// Marches count rays. depths receives what shortestDistanceToSurface would return for
+		// each ray; steps (optional) is incremented by the number of per-ray distance evaluations.
+		typedef void (*MarchRaysFunc)(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps);
+
+		// Lane count of the packet used at a given level (1 for scalar).
+		unsigned int PacketLanes(DX::SimdLevel level);
+
+		// Returns the marcher for level, falling back to the best supported one below it.
+		MarchRaysFunc GetMarchRaysFunc(DX::SimdLevel level);
+
+		// Reference: shortestDistanceToSurface per ray. The scalar level of GetMarchRaysFunc is
+		// MarchRaysCompiled (ImplicitSceneKernels.h), which gives the same depths.
+		void MarchRaysScalar(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps);
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+		// Implemented in ImplicitPacketSSE41.cpp, ImplicitPacketAVX2.cpp and ImplicitPacketAVX512.cpp,
+		// each built for its own instruction set. Only call through GetMarchRaysFunc.
+		void MarchRaysSSE41(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps);
+		void MarchRaysAVX2(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps);
+		void MarchRaysAVX512(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps);
+#endif
+	}
+}
@@ -0,0 +1,83 @@
+#include "ImplicitPacket.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+// Everything below is compiled for AVX2; callers must check the CPU first.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+// Keep mul/add separate (no FMA contraction) so results match the scalar path bit for bit.
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+using namespace AdvancedRenderingDefaultProject;
+
+namespace
+{
+	int BitCount(unsigned int bits)
+	{
+		int count = 0;
+		for (; bits; bits &= bits - 1)
+		{
+			count++;
+		}
+		return count;
+	}
+
+	struct AVX2
+	{
+		static const int Lanes = 8;
+		struct F { __m256 v; };
+		struct M { __m256 v; };
+
+		static F Set(float s) { return F{ _mm256_set1_ps(s) }; }
+		static F Load(const float* p) { return F{ _mm256_load_ps(p) }; }
+		static void Store(float* p, F a) { _mm256_store_ps(p, a.v); }
+
+		static F Add(F a, F b) { return F{ _mm256_add_ps(a.v, b.v) }; }
+		static F Sub(F a, F b) { return F{ _mm256_sub_ps(a.v, b.v) }; }
+		static F Mul(F a, F b) { return F{ _mm256_mul_ps(a.v, b.v) }; }
+		static F Div(F a, F b) { return F{ _mm256_div_ps(a.v, b.v) }; }
+		static F Min(F a, F b) { return F{ _mm256_min_ps(a.v, b.v) }; }
+		static F Max(F a, F b) { return F{ _mm256_max_ps(a.v, b.v) }; }
+		static F Sqrt(F a) { return F{ _mm256_sqrt_ps(a.v) }; }
+		static F Floor(F a) { return F{ _mm256_floor_ps(a.v) }; }
+		static F Abs(F a) { return F{ _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+		static F Neg(F a) { return F{ _mm256_xor_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+
+		static M Less(F a, F b) { return M{ _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+		static M GreaterEqual(F a, F b) { return M{ _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+		static M And(M a, M b) { return M{ _mm256_and_ps(a.v, b.v) }; }
+		static M Or(M a, M b) { return M{ _mm256_or_ps(a.v, b.v) }; }
+		// a & ~b
+		static M AndNot(M a, M b) { return M{ _mm256_andnot_ps(b.v, a.v) }; }
+		static F Select(M m, F a, F b) { return F{ _mm256_blendv_ps(b.v, a.v, m.v) }; }
+
+		static bool Any(M m) { return _mm256_movemask_ps(m.v) != 0; }
+		static int Count(M m) { return BitCount(static_cast<unsigned int>(_mm256_movemask_ps(m.v))); }
+		static M FirstLanes(int n)
+		{
+			__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			return M{ _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(n), index)) };
+		}
+	};
+
+#include "ImplicitPacketKernel.h"
+}
+
+void Implicit::MarchRaysAVX2(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps)
+{
+	PacketKernel<AVX2>::MarchRays(scene, rays, count, start, end, depths, steps);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,291 @@
+// Lane-generic port of the ImplicitPixelShader.hlsl distance functions and marcher.
+//
+// Only include this from the ImplicitPacket*.cpp translation units, inside their anonymous
+// namespace and after the instruction set has been enabled. S supplies the vector types:
+//   S::Lanes, S::F (float lanes), S::M (lane mask) and the static operations used below.
+// Nothing from the standard library is called here so no inline library code is compiled
+// for the wider instruction set and then shared with the rest of the program.
+
+template <typename S>
+struct PacketKernel
+{
+	typedef typename S::F F;
+	typedef typename S::M M;
+
+	static F Set(float s) { return S::Set(s); }
+	static F Add(F a, F b) { return S::Add(a, b); }
+	static F Sub(F a, F b) { return S::Sub(a, b); }
+	static F Mul(F a, F b) { return S::Mul(a, b); }
+	static F Div(F a, F b) { return S::Div(a, b); }
+	static F Min(F a, F b) { return S::Min(a, b); }
+	static F Max(F a, F b) { return S::Max(a, b); }
+	static F Clamp(F x, F lo, F hi) { return S::Min(S::Max(x, lo), hi); }
+
+	static F Length2(F x, F y) { return S::Sqrt(Add(Mul(x, x), Mul(y, y))); }
+	static F Length3(F x, F y, F z) { return S::Sqrt(Add(Add(Mul(x, x), Mul(y, y)), Mul(z, z))); }
+
+	static F Mod(F x, float y)
+	{
+		F yy = Set(y);
+		return Sub(x, Mul(yy, S::Floor(Div(x, yy))));
+	}
+
+	static F Sign(F x)
+	{
+		F zero = Set(0.0f);
+		return S::Select(S::Less(zero, x), Set(1.0f), S::Select(S::Less(x, zero), Set(-1.0f), zero));
+	}
+
+	// PRIMITIVES
+	static F Sphere(F x, F y, F z, float radius)
+	{
+		return Sub(Length3(x, y, z), Set(radius));
+	}
+
+	static F Cube(F x, F y, F z)
+	{
+		F one = Set(1.0f);
+		F zero = Set(0.0f);
+		F dx = Sub(S::Abs(x), one);
+		F dy = Sub(S::Abs(y), one);
+		F dz = Sub(S::Abs(z), one);
+
+		F insideDist = Min(Max(dx, Max(dy, dz)), zero);
+		F outsideDist = Length3(Max(dx, zero), Max(dy, zero), Max(dz, zero));
+
+		return Add(insideDist, outsideDist);
+	}
+
+	static F Torus(F x, F y, F z, float radiusX, float radiusY)
+	{
+		F qx = Sub(Length2(x, z), Set(radiusX));
+		return Sub(Length2(qx, y), Set(radiusY));
+	}
+
+	static F Hex(F x, F y, F z, float hx, float hy)
+	{
+		const float kx = -0.8660254f;
+		const float ky = 0.5f;
+		const float kz = 0.57735f;
+		F zero = Set(0.0f);
+
+		x = S::Abs(x);
+		y = S::Abs(y);
+		z = S::Abs(z);
+
+		F m = Mul(Set(2.0f), Min(Add(Mul(Set(kx), x), Mul(Set(ky), y)), zero));
+		x = Sub(x, Mul(m, Set(kx)));
+		y = Sub(y, Mul(m, Set(ky)));
+
+		F cx = Clamp(x, Set(-kz * hx), Set(kz * hx));
+		F dyh = Sub(y, Set(hx));
+		F dX = Mul(Length2(Sub(x, cx), dyh), Sign(dyh));
+		F dY = Sub(z, Set(hy));
+
+		return Add(Min(Max(dX, dY), zero), Length2(Max(dX, zero), Max(dY, zero)));
+	}
+
+	static F Octahedron(F x, F y, F z, float size)
+	{
+		x = S::Abs(x);
+		y = S::Abs(y);
+		z = S::Abs(z);
+		F sz = Set(size);
+		F three = Set(3.0f);
+		F m = Sub(Add(Add(x, y), z), sz);
+
+		// The shader picks the first matching swizzle; evaluate all lanes and select.
+		M c1 = S::Less(Mul(three, x), m);
+		M c2 = S::AndNot(S::Less(Mul(three, y), m), c1);
+		M c3 = S::AndNot(S::AndNot(S::Less(Mul(three, z), m), c1), c2);
+
+		F qx = S::Select(c1, x, S::Select(c2, y, z));
+		F qy = S::Select(c1, y, S::Select(c2, z, x));
+		F qz = S::Select(c1, z, S::Select(c2, x, y));
+
+		F k = Clamp(Mul(Set(0.5f), Add(Sub(qz, qy), sz)), Set(0.0f), sz);
+		F d = Length3(qx, Add(Sub(qy, sz), k), Sub(qz, k));
+
+		return S::Select(S::Or(S::Or(c1, c2), c3), d, Mul(m, Set(0.57735027f)));
+	}
+
+	static F Tetra(F x, F y, F z)
+	{
+		// sqrt(3.0f), spelt out so no library call is compiled here.
+		const float sqrt3 = 1.7320508f;
+		F a = Sub(S::Abs(Add(x, y)), z);
+		F b = Add(S::Abs(Sub(x, y)), z);
+		return Div(Sub(Max(a, b), Set(1.0f)), Set(sqrt3));
+	}
+
+	static F Fractal(F x, F y, F z)
+	{
+		F zero = Set(0.0f);
+		F two = Set(2.0f);
+		F one = Set(1.0f);
+
+		for (int n = 0; n < 20; n++)
+		{
+			M f1 = S::Less(Add(x, y), zero); // fold 1
+			F nx = S::Select(f1, S::Neg(y), x);
+			F ny = S::Select(f1, S::Neg(x), y);
+			x = nx; y = ny;
+
+			M f2 = S::Less(Add(x, z), zero); // fold 2
+			nx = S::Select(f2, S::Neg(z), x);
+			F nz = S::Select(f2, S::Neg(x), z);
+			x = nx; z = nz;
+
+			M f3 = S::Less(Add(y, z), zero); // fold 3
+			nz = S::Select(f3, S::Neg(y), z);
+			ny = S::Select(f3, S::Neg(z), y);
+			y = ny; z = nz;
+
+			x = Sub(Mul(x, two), one);
+			y = Sub(Mul(y, two), one);
+			z = Sub(Mul(z, two), one);
+		}
+
+		// pow(2, -20)
+		return Mul(Length3(x, y, z), Set(9.5367431640625e-07f));
+	}
+
+	// SCENES
+	static F SceneDist(ImplicitSceneType scene, F x, F y, F z)
+	{
+		switch (scene)
+		{
+		case ImplicitSceneType::Repeating:
+		{
+			F offset = Set(4.0f);
+			F sphere = Sphere(Add(x, offset), y, Mod(z, 1.5f), 1.0f);
+			F cube = Cube(Sub(x, offset), y, Mod(z, 1.5f));
+			F octa = Octahedron(x, y, Mod(z, 2.25f), 1.0f);
+			return Min(cube, Min(sphere, octa));
+		}
+		case ImplicitSceneType::Deforming:
+		{
+			F offset = Set(3.0f);
+			F scale = Set(1.2f);
+
+			F nx = Add(x, offset);
+			F cube = Cube(nx, y, z);
+			F sphere = Mul(Sphere(Div(nx, scale), Div(y, scale), Div(z, scale), 1.0f), scale);
+
+			F sx2 = Sub(x, offset);
+			F s2 = Mul(Sphere(Div(sx2, scale), Div(y, scale), Div(z, scale), 1.0f), scale);
+
+			F sx3 = Sub(x, Set(3.0f + 0.25f));
+			F s3 = Mul(Sphere(Div(sx3, scale), Div(y, scale), Div(z, scale), 1.0f), scale);
+
+			F s4 = Cube(sx2, Add(y, Set(0.3f)), z);
+			F s5 = Torus(sx2, Sub(y, Set(0.7f)), z, 1.0f, 1.0f);
+
+			F final = Max(cube, sphere);
+			F s2s5 = Max(Max(Max(s2, s3), s4), S::Neg(s5));
+			return Min(final, s2s5);
+		}
+		case ImplicitSceneType::Fractal:
+			return Fractal(x, y, z);
+		case ImplicitSceneType::Shiny:
+		{
+			const float offset = 3.0f;
+			F tx = Add(x, Set(offset));
+			F sx = Sub(x, Set(offset));
+			F yDown = Sub(y, Set(offset / 1.25f));
+			F yUp = Add(y, Set(offset / 1.25f));
+
+			F final = Min(Tetra(tx, y, z), Tetra(tx, yDown, z));
+			final = Min(final, Tetra(tx, yUp, z));
+			final = Min(final, Sphere(sx, y, z, 1.0f));
+			final = Min(final, Sphere(sx, yDown, z, 1.0f));
+			final = Min(final, Sphere(sx, yUp, z, 1.0f));
+			return final;
+		}
+		default:
+		{
+			F sphere = Sphere(x, y, z, 1.0f);
+			F cubeOffset = Set(-2.0f);
+			F cube = Cube(Add(x, cubeOffset), Add(y, cubeOffset), Add(z, cubeOffset));
+			F torusOffset = Set(5.0f);
+			F torus = Torus(Add(x, torusOffset), Add(y, torusOffset), Add(z, torusOffset), 1.5f, 0.5f);
+			F octa = Octahedron(Sub(x, Set(3.0f)), Add(y, Set(3.0f)), z, 1.0f);
+			F hex = Hex(Add(x, Set(3.0f)), Sub(y, Set(3.0f)), z, 1.0f, 1.0f);
+
+			F final = Min(sphere, cube);
+			final = Min(final, torus);
+			final = Min(final, octa);
+			final = Min(final, hex);
+			return final;
+		}
+		}
+	}
+
+	// RAY MARCH
+	// Marches S::Lanes rays held in SoA form. valid masks off padding lanes of a partial packet.
+	static F March(ImplicitSceneType scene, const float* ox, const float* oy, const float* oz, const float* dx, const float* dy, const float* dz, M valid, float start, float end, unsigned long long& steps)
+	{
+		F originX = S::Load(ox), originY = S::Load(oy), originZ = S::Load(oz);
+		F dirX = S::Load(dx), dirY = S::Load(dy), dirZ = S::Load(dz);
+
+		F epsilon = Set(Implicit::EPSILON);
+		F farDepth = Set(end);
+		F depth = Set(start);
+		F result = farDepth;
+		M active = valid;
+
+		for (int i = 0; i < Implicit::MAX_MARCH && S::Any(active); i++)
+		{
+			steps += S::Count(active);
+
+			F dist = SceneDist(scene,
+				Add(originX, Mul(depth, dirX)),
+				Add(originY, Mul(depth, dirY)),
+				Add(originZ, Mul(depth, dirZ)));
+
+			M hit = S::And(active, S::Less(dist, epsilon));
+			result = S::Select(hit, depth, result);
+			active = S::AndNot(active, hit);
+
+			depth = S::Select(active, Add(depth, dist), depth);
+			M passed = S::And(active, S::GreaterEqual(depth, farDepth));
+			active = S::AndNot(active, passed);
+		}
+
+		return result;
+	}
+
+	static void MarchRays(ImplicitSceneType scene, const Implicit::Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps)
+	{
+		const size_t packetSize = S::Lanes;
+		alignas(64) float ox[S::Lanes], oy[S::Lanes], oz[S::Lanes];
+		alignas(64) float dx[S::Lanes], dy[S::Lanes], dz[S::Lanes];
+		alignas(64) float out[S::Lanes];
+		unsigned long long packetSteps = 0;
+
+		for (size_t base = 0; base < count; base += packetSize)
+		{
+			size_t lanes = count - base < packetSize ? count - base : packetSize;
+
+			// Pad a partial packet with its last ray; the padding is masked out.
+			for (size_t i = 0; i < packetSize; i++)
+			{
+				const Implicit::Ray& ray = rays[base + (i < lanes ? i : lanes - 1)];
+				ox[i] = ray.origin.x; oy[i] = ray.origin.y; oz[i] = ray.origin.z;
+				dx[i] = ray.direction.x; dy[i] = ray.direction.y; dz[i] = ray.direction.z;
+			}
+
+			S::Store(out, March(scene, ox, oy, oz, dx, dy, dz, S::FirstLanes(static_cast<int>(lanes)), start, end, packetSteps));
+
+			for (size_t i = 0; i < lanes; i++)
+			{
+				depths[base + i] = out[i];
+			}
+		}
+
+		if (steps)
+		{
+			*steps += packetSteps;
+		}
+	}
+};
@@ -0,0 +1,87 @@
+#include "ImplicitPacket.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <smmintrin.h>
+
+// Everything below is compiled for SSE41; callers must check the CPU first.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+// Keep mul/add separate (no FMA contraction) so results match the scalar path bit for bit.
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+using namespace AdvancedRenderingDefaultProject;
+
+namespace
+{
+	int BitCount(unsigned int bits)
+	{
+		int count = 0;
+		for (; bits; bits &= bits - 1)
+		{
+			count++;
+		}
+		return count;
+	}
+
+	// Two SSE registers per packet so it is as wide as the AVX2 one.
+	struct SSE41
+	{
+		static const int Lanes = 8;
+		struct F { __m128 lo, hi; };
+		struct M { __m128 lo, hi; };
+
+		static F Set(float s) { __m128 v = _mm_set1_ps(s); return F{ v, v }; }
+		static F Load(const float* p) { return F{ _mm_load_ps(p), _mm_load_ps(p + 4) }; }
+		static void Store(float* p, F a) { _mm_store_ps(p, a.lo); _mm_store_ps(p + 4, a.hi); }
+
+		static F Add(F a, F b) { return F{ _mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi) }; }
+		static F Sub(F a, F b) { return F{ _mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi) }; }
+		static F Mul(F a, F b) { return F{ _mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi) }; }
+		static F Div(F a, F b) { return F{ _mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi) }; }
+		static F Min(F a, F b) { return F{ _mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi) }; }
+		static F Max(F a, F b) { return F{ _mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi) }; }
+		static F Sqrt(F a) { return F{ _mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi) }; }
+		static F Floor(F a) { return F{ _mm_floor_ps(a.lo), _mm_floor_ps(a.hi) }; }
+		static F Abs(F a) { __m128 s = _mm_set1_ps(-0.0f); return F{ _mm_andnot_ps(s, a.lo), _mm_andnot_ps(s, a.hi) }; }
+		static F Neg(F a) { __m128 s = _mm_set1_ps(-0.0f); return F{ _mm_xor_ps(s, a.lo), _mm_xor_ps(s, a.hi) }; }
+
+		static M Less(F a, F b) { return M{ _mm_cmplt_ps(a.lo, b.lo), _mm_cmplt_ps(a.hi, b.hi) }; }
+		static M GreaterEqual(F a, F b) { return M{ _mm_cmpge_ps(a.lo, b.lo), _mm_cmpge_ps(a.hi, b.hi) }; }
+		static M And(M a, M b) { return M{ _mm_and_ps(a.lo, b.lo), _mm_and_ps(a.hi, b.hi) }; }
+		static M Or(M a, M b) { return M{ _mm_or_ps(a.lo, b.lo), _mm_or_ps(a.hi, b.hi) }; }
+		// a & ~b
+		static M AndNot(M a, M b) { return M{ _mm_andnot_ps(b.lo, a.lo), _mm_andnot_ps(b.hi, a.hi) }; }
+		static F Select(M m, F a, F b) { return F{ _mm_blendv_ps(b.lo, a.lo, m.lo), _mm_blendv_ps(b.hi, a.hi, m.hi) }; }
+
+		static unsigned int Bits(M m) { return static_cast<unsigned int>(_mm_movemask_ps(m.lo) | (_mm_movemask_ps(m.hi) << 4)); }
+		static bool Any(M m) { return Bits(m) != 0; }
+		static int Count(M m) { return BitCount(Bits(m)); }
+		static M FirstLanes(int n)
+		{
+			__m128i count = _mm_set1_epi32(n);
+			return M{
+				_mm_castsi128_ps(_mm_cmpgt_epi32(count, _mm_setr_epi32(0, 1, 2, 3))),
+				_mm_castsi128_ps(_mm_cmpgt_epi32(count, _mm_setr_epi32(4, 5, 6, 7))) };
+		}
+	};
+
+#include "ImplicitPacketKernel.h"
+}
+
+void Implicit::MarchRaysSSE41(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps)
+{
+	PacketKernel<SSE41>::MarchRays(scene, rays, count, start, end, depths, steps);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
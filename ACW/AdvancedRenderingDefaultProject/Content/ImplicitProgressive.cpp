@@ -0,0 +1,202 @@
+#include "ImplicitProgressive.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace DX;
+
+namespace
+{
+	// Inverse of ImplicitCpuRenderer::PixelToCanvas, rounded to the nearest pixel.
+	bool CanvasToPixel(const float2& canvasXY, unsigned int width, unsigned int height, unsigned int& x, unsigned int& y)
+	{
+		float aRatio = static_cast<float>(width) / static_cast<float>(height);
+		float px = std::floor((canvasXY.x / aRatio + 1.0f) * 0.5f * width);
+		float py = std::floor((1.0f - canvasXY.y) * 0.5f * height);
+
+		if (px < 0.0f || py < 0.0f || px >= width || py >= height)
+		{
+			return false;
+		}
+
+		x = static_cast<unsigned int>(px);
+		y = static_cast<unsigned int>(py);
+		return true;
+	}
+
+	bool SameEye(const float3& a, const float3& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+}
+
+ImplicitProgressiveRenderer::ImplicitProgressiveRenderer(const std::shared_ptr<DX::ThreadPool>& threadPool) :
+	m_renderer(threadPool),
+	m_nextSlice(0),
+	m_eye(Implicit::eyePos)
+{
+}
+
+void ImplicitProgressiveRenderer::Reset()
+{
+	m_nextSlice = 0;
+	std::fill(m_valid.begin(), m_valid.end(), static_cast<unsigned char>(0));
+}
+
+ImplicitProgressiveStats ImplicitProgressiveRenderer::Render(const ImplicitRenderSettings& settings, unsigned int slices, DX::ImageBuffer& target)
+{
+	ImplicitProgressiveStats stats;
+
+	const unsigned int width = target.GetWidth();
+	const unsigned int height = target.GetHeight();
+	const size_t pixels = static_cast<size_t>(width) * height;
+
+	slices = std::max(1u, std::min(slices, ImplicitInterleave::SliceCount));
+	stats.slices = slices;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (m_color.GetWidth() != width || m_color.GetHeight() != height)
+	{
+		m_color.Resize(width, height);
+		m_depths.assign(pixels, Implicit::farPlane);
+		m_valid.assign(pixels, 0);
+		m_nextSlice = 0;
+	}
+	else if (!SameEye(settings.eye, m_eye))
+	{
+		stats.reprojectedPixels = Reproject(settings.eye);
+	}
+	m_eye = settings.eye;
+
+	ImplicitRenderSettings frameSettings = settings;
+	frameSettings.sliceFirst = m_nextSlice;
+	frameSettings.sliceCount = slices;
+	frameSettings.depths = m_depths.data();
+
+	ImplicitRenderStats traceStats = m_renderer.Render(frameSettings, m_color);
+	stats.tracedPixels = traceStats.tracedPixels;
+	stats.marchSteps = traceStats.marchSteps;
+
+	// Where this frame's slices sit in a cell, to fill the pixels the history can't.
+	unsigned int sliceX[ImplicitInterleave::SliceCount];
+	unsigned int sliceY[ImplicitInterleave::SliceCount];
+	for (unsigned int y = 0; y < ImplicitInterleave::CellSize; y++)
+	{
+		for (unsigned int x = 0; x < ImplicitInterleave::CellSize; x++)
+		{
+			unsigned int slice = ImplicitInterleave::SliceOfPixel(x, y);
+			sliceX[slice] = x;
+			sliceY[slice] = y;
+		}
+	}
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			size_t i = static_cast<size_t>(y) * width + x;
+			if (ImplicitInterleave::InSlices(ImplicitInterleave::SliceOfPixel(x, y), m_nextSlice, slices))
+			{
+				m_valid[i] = 1;
+			}
+
+			if (m_valid[i])
+			{
+				target.At(x, y) = m_color.At(x, y);
+				continue;
+			}
+
+			// The first of this frame's pixels in the cell that is inside the image.
+			unsigned int cellX = x - x % ImplicitInterleave::CellSize;
+			unsigned int cellY = y - y % ImplicitInterleave::CellSize;
+			target.At(x, y) = float4(0.0f, 0.0f, 0.0f, 0.0f);
+			for (unsigned int s = 0; s < slices; s++)
+			{
+				unsigned int slice = (m_nextSlice + s) % ImplicitInterleave::SliceCount;
+				unsigned int fx = cellX + sliceX[slice];
+				unsigned int fy = cellY + sliceY[slice];
+				if (fx < width && fy < height)
+				{
+					target.At(x, y) = m_color.At(fx, fy);
+					break;
+				}
+			}
+			stats.filledPixels++;
+		}
+	}
+
+	m_nextSlice = (m_nextSlice + slices) % ImplicitInterleave::SliceCount;
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.seconds = std::chrono::duration<double>(end - start).count();
+
+	return stats;
+}
+
+unsigned long long ImplicitProgressiveRenderer::Reproject(const DX::float3& eye)
+{
+	const unsigned int width = m_color.GetWidth();
+	const unsigned int height = m_color.GetHeight();
+	const size_t pixels = static_cast<size_t>(width) * height;
+
+	m_reprojectedColor.Resize(width, height);
+	m_reprojectedDepths.assign(pixels, Implicit::farPlane);
+	m_reprojectedValid.assign(pixels, 0);
+
+	unsigned long long reprojected = 0;
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			size_t i = static_cast<size_t>(y) * width + x;
+			if (!m_valid[i])
+			{
+				continue;
+			}
+
+			// Misses are the same black from every eye, so they stay where they are and any
+			// surface that lands on them wins.
+			if (m_depths[i] >= Implicit::farPlane)
+			{
+				if (!m_reprojectedValid[i])
+				{
+					m_reprojectedColor.At(x, y) = m_color.At(x, y);
+					m_reprojectedValid[i] = 1;
+					reprojected++;
+				}
+				continue;
+			}
+
+			Implicit::Ray ray = Implicit::eyeRayForCanvas(ImplicitCpuRenderer::PixelToCanvas(x, y, width, height), m_eye);
+			float3 point = ray.origin + m_depths[i] * ray.direction;
+
+			float2 canvasXY;
+			unsigned int nx, ny;
+			if (!Implicit::canvasForPoint(point, eye, canvasXY) || !CanvasToPixel(canvasXY, width, height, nx, ny))
+			{
+				continue;
+			}
+
+			// Nearest surface wins where several land on one pixel.
+			size_t n = static_cast<size_t>(ny) * width + nx;
+			float depth = length(point - eye);
+			if (!m_reprojectedValid[n] || depth < m_reprojectedDepths[n])
+			{
+				reprojected += m_reprojectedValid[n] ? 0 : 1;
+				m_reprojectedColor.At(nx, ny) = m_color.At(x, y);
+				m_reprojectedDepths[n] = depth;
+				m_reprojectedValid[n] = 1;
+			}
+		}
+	}
+
+	std::swap(m_color, m_reprojectedColor);
+	m_depths.swap(m_reprojectedDepths);
+	m_valid.swap(m_reprojectedValid);
+
+	return reprojected;
+}
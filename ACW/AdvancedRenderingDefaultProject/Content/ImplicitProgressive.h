@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ImplicitCpuRenderer.h"
+#include "ImplicitTimeSlicing.h"
+#include "../Common/ImageBuffer.h"
+#include "../Common/ThreadPool.h"
+
+#include <memory>
+#include <vector>
+
+namespace AdvancedRenderingDefaultProject
+{
+	struct ImplicitProgressiveStats
+	{
+		double				seconds = 0.0;			// reprojection, tracing and hole filling
+		unsigned int		slices = 0;
+		unsigned long long	tracedPixels = 0;
+		unsigned long long	reprojectedPixels = 0;	// history pixels carried to the new eye
+		unsigned long long	filledPixels = 0;		// pixels with neither, copied from their cell
+		unsigned long long	marchSteps = 0;
+	};
+
+	// Spreads the implicit render over frames. Each frame traces a few ImplicitInterleave slices
+	// and takes the other pixels from a history of earlier frames, reprojected to the current eye
+	// with the depth of each history pixel. Pixels the history doesn't cover borrow the colour of
+	// a pixel of their cell traced this frame. With a still eye, a frame matches a full render
+	// once every slice has been traced since the last Reset.
+	class ImplicitProgressiveRenderer
+	{
+	public:
+		ImplicitProgressiveRenderer(const std::shared_ptr<DX::ThreadPool>& threadPool);
+
+		// Renders the next frame seen from settings.eye into target, tracing slices slices.
+		// settings.sliceFirst, sliceCount and depths are managed here.
+		ImplicitProgressiveStats Render(const ImplicitRenderSettings& settings, unsigned int slices, DX::ImageBuffer& target);
+
+		// Drops the history, e.g. when the scene changes.
+		void Reset();
+
+	private:
+		unsigned long long Reproject(const DX::float3& eye);
+
+		ImplicitCpuRenderer					m_renderer;
+		unsigned int						m_nextSlice;
+
+		// History at m_eye. Only pixels with m_valid set hold a traced or reprojected result.
+		DX::float3							m_eye;
+		DX::ImageBuffer						m_color;
+		std::vector<float>					m_depths;
+		std::vector<unsigned char>			m_valid;
+
+		// Reprojection targets, kept to avoid reallocating each frame.
+		DX::ImageBuffer						m_reprojectedColor;
+		std::vector<float>					m_reprojectedDepths;
+		std::vector<unsigned char>			m_reprojectedValid;
+	};
+}
@@ -0,0 +1,408 @@
+#include "ImplicitScene.h"
+#include "ImplicitSceneKernels.h"
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace AdvancedRenderingDefaultProject::Implicit;
+
+ImplicitSceneType AdvancedRenderingDefaultProject::ImplicitSceneFromControl(const DX::float4& repDefFrac)
+{
+	if (repDefFrac.x == 1) return ImplicitSceneType::Repeating;
+	if (repDefFrac.y == 1) return ImplicitSceneType::Deforming;
+	if (repDefFrac.z == 1) return ImplicitSceneType::Fractal;
+	if (repDefFrac.w == 1) return ImplicitSceneType::Shiny;
+	return ImplicitSceneType::Default;
+}
+
+DX::float4 AdvancedRenderingDefaultProject::ImplicitSceneToControl(ImplicitSceneType scene)
+{
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return DX::float4(1.0f, 0.0f, 0.0f, 0.0f);
+	case ImplicitSceneType::Deforming:	return DX::float4(0.0f, 1.0f, 0.0f, 0.0f);
+	case ImplicitSceneType::Fractal:	return DX::float4(0.0f, 0.0f, 1.0f, 0.0f);
+	case ImplicitSceneType::Shiny:		return DX::float4(0.0f, 0.0f, 0.0f, 1.0f);
+	default:							return DX::float4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+const char* AdvancedRenderingDefaultProject::ImplicitSceneName(ImplicitSceneType scene)
+{
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return "repeating";
+	case ImplicitSceneType::Deforming:	return "deforming";
+	case ImplicitSceneType::Fractal:	return "fractal";
+	case ImplicitSceneType::Shiny:		return "shiny";
+	default:							return "default";
+	}
+}
+
+// Scene Sampling
+float Implicit::sceneDistFunc(ImplicitSceneType scene, const float3& samplePoint)
+{
+	float final;
+
+	switch (scene)
+	{
+	// Repetition
+	case ImplicitSceneType::Repeating:
+	{
+		float offset = 4.0f;
+
+		float3 newSamplePoint = float3(samplePoint.x + offset, samplePoint.y, DX::mod(samplePoint.z, 1.5f));
+		float sphere = sphereDistFunc(newSamplePoint, 1.0f);
+
+		float3 cubeSamplePoint = float3(samplePoint.x - offset, samplePoint.y, DX::mod(samplePoint.z, 1.5f));
+		float cube = cubeDistFunc(cubeSamplePoint);
+
+		float3 octaSamplePoint = float3(samplePoint.x, samplePoint.y, DX::mod(samplePoint.z, 2.25f));
+		float octa = octahedronDF(octaSamplePoint, 1.0f);
+
+		final = unionDF(cube, unionDF(sphere, octa));
+		break;
+	}
+	// Deformation
+	case ImplicitSceneType::Deforming:
+	{
+		float cubeSphereOffset = 3.0f;
+		float3 newSamplePoint = float3(samplePoint.x + cubeSphereOffset, samplePoint.y, samplePoint.z);
+
+		float cube = cubeDistFunc(newSamplePoint);
+		float sphere = sphereDistFunc(newSamplePoint / 1.2f, 1.0f) * 1.2f;
+
+		// Main sphere
+		float3 sp2 = float3(samplePoint.x - cubeSphereOffset, samplePoint.y, samplePoint.z);
+		float s2 = sphereDistFunc(sp2 / 1.2f, 1.0f) * 1.2f;
+
+		// Intersection1
+		float3 sp3 = float3(samplePoint.x - (cubeSphereOffset + 0.25f), samplePoint.y, samplePoint.z);
+		float s3 = sphereDistFunc(sp3 / 1.2f, 1.0f) * 1.2f;
+
+		// Intersection2
+		float3 sp4 = float3(samplePoint.x - cubeSphereOffset, samplePoint.y + 0.3f, samplePoint.z);
+		float s4 = cubeDistFunc(sp4);
+
+		// Intersection3
+		float3 sp5 = float3(samplePoint.x - cubeSphereOffset, samplePoint.y - 0.7f, samplePoint.z);
+		float s5 = torusDistFunc(sp5, float2(1.0f, 1.0f));
+
+		final = intersectDF(cube, sphere);
+
+		float s2s3 = intersectDF(s2, s3);
+		float s2s4 = intersectDF(s2s3, s4);
+		float s2s5 = diffDF(s2s4, s5);
+
+		final = unionDF(final, s2s5);
+		break;
+	}
+	// Fractal
+	case ImplicitSceneType::Fractal:
+	{
+		final = fractal(samplePoint);
+		break;
+	}
+	// Shiny
+	case ImplicitSceneType::Shiny:
+	{
+		float offset = 3.0f;
+		float t1 = tetraDF(float3(samplePoint.x + offset, samplePoint.y, samplePoint.z));
+		float t2 = tetraDF(float3(samplePoint.x + offset, samplePoint.y - (offset / 1.25f), samplePoint.z));
+		float t3 = tetraDF(float3(samplePoint.x + offset, samplePoint.y + (offset / 1.25f), samplePoint.z));
+
+		float s1 = sphereDistFunc(float3(samplePoint.x - offset, samplePoint.y, samplePoint.z), 1.0f);
+		float s2 = sphereDistFunc(float3(samplePoint.x - offset, samplePoint.y - (offset / 1.25f), samplePoint.z), 1.0f);
+		float s3 = sphereDistFunc(float3(samplePoint.x - offset, samplePoint.y + (offset / 1.25f), samplePoint.z), 1.0f);
+
+		final = unionDF(t1, t2);
+		final = unionDF(final, t3);
+		final = unionDF(final, s1);
+		final = unionDF(final, s2);
+		final = unionDF(final, s3);
+		break;
+	}
+	// No modifiers
+	default:
+	{
+		float cubeOffset = -2.0f;
+		float torusOffset = 5.0f;
+		float octaOffset = 3.0f;
+		float hexOffset = 3.0f;
+
+		float sphere = sphereDistFunc(samplePoint, 1.0f);
+		float cube = cubeDistFunc(samplePoint + cubeOffset);
+		float torus = torusDistFunc(samplePoint + torusOffset, float2(1.5f, 0.5f));
+		float octa = octahedronDF(float3(samplePoint.x - octaOffset, samplePoint.y + octaOffset, samplePoint.z), 1.0f);
+		float hex = hexDF(float3(samplePoint.x + hexOffset, samplePoint.y - hexOffset, samplePoint.z), float2(1.0f, 1.0f));
+
+		final = unionDF(sphere, cube);
+		final = unionDF(final, torus);
+		final = unionDF(final, octa);
+		final = unionDF(final, hex);
+		break;
+	}
+	}
+
+	return final;
+}
+
+// Calculate Normals
+float3 Implicit::calcNormals(ImplicitSceneType scene, const float3& pos)
+{
+	return normalize(float3(
+		sceneDistFunc(scene, float3(pos.x + EPSILON, pos.y, pos.z)) - sceneDistFunc(scene, float3(pos.x - EPSILON, pos.y, pos.z)),
+		sceneDistFunc(scene, float3(pos.x, pos.y + EPSILON, pos.z)) - sceneDistFunc(scene, float3(pos.x, pos.y - EPSILON, pos.z)),
+		sceneDistFunc(scene, float3(pos.x, pos.y, pos.z + EPSILON)) - sceneDistFunc(scene, float3(pos.x, pos.y, pos.z - EPSILON))));
+}
+
+float3 Implicit::calcNormalsTetra(ImplicitSceneType scene, const float3& pos)
+{
+	const float3 a(1.0f, -1.0f, -1.0f), b(-1.0f, -1.0f, 1.0f), c(-1.0f, 1.0f, -1.0f), d(1.0f, 1.0f, 1.0f);
+
+	return normalize(
+		a * sceneDistFunc(scene, pos + a * EPSILON) + b * sceneDistFunc(scene, pos + b * EPSILON) +
+		c * sceneDistFunc(scene, pos + c * EPSILON) + d * sceneDistFunc(scene, pos + d * EPSILON));
+}
+
+float3 Implicit::sceneNormal(ImplicitSceneType scene, const float3& pos, ImplicitNormalMode mode)
+{
+	switch (mode)
+	{
+	case ImplicitNormalMode::Tetrahedral:	return calcNormalsTetra(scene, pos);
+	case ImplicitNormalMode::Analytic:		return normalize(SceneGradient(scene, pos));
+	default:								return calcNormals(scene, pos);
+	}
+}
+
+// RAY MARCH
+float Implicit::shortestDistanceToSurface(ImplicitSceneType scene, const Ray& ray, float start, float end, int* steps)
+{
+	float depth = start;
+	int i = 0;
+	float result = end;
+
+	for (; i < MAX_MARCH; i++)
+	{
+		float dist = sceneDistFunc(scene, ray.origin + depth * ray.direction);
+		if (dist < EPSILON)
+		{
+			result = depth;
+			i++;
+			break;
+		}
+
+		depth += dist;
+		if (depth >= end)
+		{
+			i++;
+			break;
+		}
+	}
+
+	if (steps)
+	{
+		*steps = i;
+	}
+
+	return result;
+}
+
+float Implicit::sceneDistFuncLod(ImplicitSceneType scene, const float3& samplePoint, float pixelAngle)
+{
+	if (scene == ImplicitSceneType::Fractal)
+	{
+		return fractalLod(samplePoint, eyePos, pixelAngle);
+	}
+	return sceneDistFunc(scene, samplePoint);
+}
+
+float Implicit::shortestDistanceToSurfaceLod(ImplicitSceneType scene, const Ray& ray, float start, float end, float pixelAngle, int* steps)
+{
+	float depth = start;
+	int i = 0;
+	float result = end;
+
+	for (; i < MAX_MARCH; i++)
+	{
+		float dist = sceneDistFuncLod(scene, ray.origin + depth * ray.direction, pixelAngle);
+		if (dist < EPSILON)
+		{
+			result = depth;
+			i++;
+			break;
+		}
+
+		depth += dist;
+		if (depth >= end)
+		{
+			i++;
+			break;
+		}
+	}
+
+	if (steps)
+	{
+		*steps = i;
+	}
+
+	return result;
+}
+
+float Implicit::shortestDistanceToSurfaceRelaxed(ImplicitSceneType scene, const Ray& ray, float start, float end, float relaxation, float hitRadius, int* steps)
+{
+	float omega = relaxation;
+	float depth = start;
+	float previousDepth = start;
+	float previousDist = 0.0f;
+	int i = 0;
+	float result = end;
+
+	for (; i < MAX_MARCH; i++)
+	{
+		float dist = sceneDistFunc(scene, ray.origin + depth * ray.direction);
+
+		// The relaxed step left the previous unbounding sphere (or crossed the surface): go back
+		// to the safe step from there, and relax again on the step after it.
+		if (omega > 1.0f && i > 0 && (dist < 0.0f || dist + previousDist < depth - previousDepth))
+		{
+			depth = previousDepth + previousDist;
+			omega = 1.0f;
+			continue;
+		}
+
+		if (dist < std::max(EPSILON, hitRadius * depth))
+		{
+			result = depth;
+			i++;
+			break;
+		}
+
+		previousDepth = depth;
+		previousDist = dist;
+		depth += omega * dist;
+		omega = relaxation;
+		if (depth >= end)
+		{
+			i++;
+			break;
+		}
+	}
+
+	if (steps)
+	{
+		*steps = i;
+	}
+
+	return result;
+}
+
+float Implicit::pixelFootprint(const float2& canvasXY, float canvasPerPixel)
+{
+	return length(eyeRayForCanvas(canvasXY + float2(0.0f, canvasPerPixel)).direction - eyeRayForCanvas(canvasXY).direction);
+}
+
+// PHONG SHADING
+static float3 phongLightObstruction(const float3& normal, const float3& diffuseFactor, const float3& specularFactor, float shininess, const float3& pos, const float3& eye, const float3& lightPos, const float3& lightIntensity)
+{
+	float3 lightDir = normalize(lightPos - pos);
+	float3 viewDir = normalize(eye - pos);
+	float3 reflectVector = normalize(reflect(-lightDir, normal));
+
+	float dotLN = dot(lightDir, normal);
+	float dotRV = dot(reflectVector, viewDir);
+
+	if (dotLN < 0.0f)
+	{
+		// Obstruction from pixel pos to light
+		return float3(0.0f, 0.0f, 0.0f);
+	}
+
+	if (dotRV < 0.0f)
+	{
+		// Reflection along view dir vector, only diffuse lighting
+		return lightIntensity * (diffuseFactor * dotLN);
+	}
+
+	return lightIntensity * (diffuseFactor * dotLN + specularFactor * std::pow(dotRV, shininess));
+}
+
+// ILLUMINATION
+float3 Implicit::phongIllumination(const float3& normal, const float3& ambientFactor, const float3& diffuseFactor, const float3& specularFactor, float shininess, const float3& pos, const float3& eye)
+{
+	float3 ambientLight = 0.5f * float3(1.0f, 1.0f, 1.0f);
+	float3 color = ambientLight * ambientFactor;
+
+	float3 light1Pos = float3(4.0f, 2.0f, 4.0f);
+	float3 light1Intensity = float3(0.4f, 0.4f, 0.4f);
+
+	color += phongLightObstruction(normal, diffuseFactor, specularFactor, shininess, pos, eye, light1Pos, light1Intensity);
+
+	float3 light2Pos = float3(2.0f, 2.0f, 2.0f);
+	float3 light2Intensity = float3(0.4f, 0.4f, 0.4f);
+
+	color += phongLightObstruction(normal, diffuseFactor, specularFactor, shininess, pos, eye, light2Pos, light2Intensity);
+
+	return color;
+}
+
+Ray Implicit::eyeRayForCanvas(const float2& canvasXY)
+{
+	return eyeRayForCanvas(canvasXY, eyePos);
+}
+
+Ray Implicit::eyeRayForCanvas(const float2& canvasXY, const float3& eye)
+{
+	float2 xy = zoom * canvasXY;
+	float distEye2Canvas = nearPlane;
+	float3 pixelPos = float3(xy.x, xy.y, -distEye2Canvas);
+
+	Ray eyeRay;
+	eyeRay.origin = eye;
+	eyeRay.direction = normalize(pixelPos - eye);
+	return eyeRay;
+}
+
+bool Implicit::canvasForPoint(const float3& point, const float3& eye, float2& canvasXY)
+{
+	// Where the line from the eye through the point crosses the canvas plane.
+	float distEye2Canvas = nearPlane;
+	float dz = point.z - eye.z;
+	if (std::fabs(dz) < 1e-6f)
+	{
+		return false;
+	}
+
+	float t = (-distEye2Canvas - eye.z) / dz;
+	if (t <= 0.0f)
+	{
+		return false;
+	}
+
+	float3 pixelPos = eye + t * (point - eye);
+	canvasXY = float2(pixelPos.x / zoom, pixelPos.y / zoom);
+	return true;
+}
+
+float4 Implicit::shadeHit(ImplicitSceneType scene, const Ray& eyeRay, float distance, ImplicitNormalMode normals)
+{
+	if (distance > farPlane - EPSILON)
+	{
+		return float4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	float3 pos = eyeRay.origin + distance * eyeRay.direction;
+
+	float3 ambientFactor = float3(0.1f, 0.1f, 0.1f);
+	float3 diffuseFactor = float3(0.7f, 0.2f, 0.2f);
+	float3 specularFactor = float3(1.0f, 1.0f, 1.0f);
+	float shininess = scene == ImplicitSceneType::Shiny ? 1000.0f : 10.0f;
+
+	float3 color = phongIllumination(sceneNormal(scene, pos, normals), ambientFactor, diffuseFactor, specularFactor, shininess, pos, eyeRay.origin);
+	return float4(color, 1.0f);
+}
+
+float4 Implicit::shadePixel(ImplicitSceneType scene, const float2& canvasXY, ImplicitNormalMode normals)
+{
+	Ray eyeRay = eyeRayForCanvas(canvasXY);
+	float distance = shortestDistanceToSurface(scene, eyeRay, nearPlane, farPlane);
+	return shadeHit(scene, eyeRay, distance, normals);
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "ImplicitMarch.h"
+#include "../Common/HlslMath.h"
+
+// CPU port of ImplicitPixelShader.hlsl. Function names and constants follow the shader so the
+// two can be compared side by side; keep them in sync when either one changes.
+namespace AdvancedRenderingDefaultProject
+{
+	// The scenes selected by the ControlBuffer booleans (repDefFrac in the shader).
+	enum class ImplicitSceneType
+	{
+		Default,
+		Repeating,
+		Deforming,
+		Fractal,
+		Shiny
+	};
+
+	static const int ImplicitSceneCount = 5;
+
+	// How a hit's normal is estimated (sceneNormal in the shader).
+	enum class ImplicitNormalMode
+	{
+		Central,		// central differences, six scene samples (the shader's default)
+		Tetrahedral,	// tetrahedral differences, four scene samples (IMPLICIT_TETRAHEDRAL_NORMALS)
+		Analytic		// primitive gradients (IMPLICIT_ANALYTIC_NORMALS, per-scene shaders only)
+	};
+
+	// Same priority order as the if/else chain in sceneDistFunc.
+	ImplicitSceneType ImplicitSceneFromControl(const DX::float4& repDefFrac);
+	DX::float4 ImplicitSceneToControl(ImplicitSceneType scene);
+	const char* ImplicitSceneName(ImplicitSceneType scene);
+
+	namespace Implicit
+	{
+		using DX::float2;
+		using DX::float3;
+		using DX::float4;
+
+		struct Ray
+		{
+			float3 origin;
+			float3 direction;
+		};
+
+		// CAMERA
+		static const float3 eyePos = float3(0.0f, 10.0f, 20.0f);
+		static const float nearPlane = 0.01f;
+		static const float farPlane = 1000.0f;
+		static const float zoom = 5.0f;
+
+		// RAYMARCHING
+		static const int MAX_MARCH = 255;
+		static const float EPSILON = 0.0001f;
+
+		// Folding fractal, see ImplicitPixelShader.hlsl for the reference.
+		inline float fractal(float3 pos)
+		{
+			float3 z = pos;
+			int n = 0;
+			const int Iterations = 20;
+			const float Scale = 2.0f;
+			const float3 Offset = float3(1.0f, 1.0f, 1.0f);
+			while (n < Iterations)
+			{
+				if (z.x + z.y < 0) { float t = z.x; z.x = -z.y; z.y = -t; } // fold 1
+				if (z.x + z.z < 0) { float t = z.x; z.x = -z.z; z.z = -t; } // fold 2
+				if (z.y + z.z < 0) { float t = z.z; z.z = -z.y; z.y = -t; } // fold 3
+				z = z * Scale - Offset * (Scale - 1.0f);
+				n++;
+			}
+			return length(z) * std::pow(Scale, -float(n));
+		}
+
+		// FRACTAL LOD
+		// Level n of the fold tree splits space into cells within sqrt(3) * 2^-n of their centre,
+		// so once that is below a fraction of the pixel footprint the remaining iterations only
+		// add detail no pixel shows. The estimate subtracts the cell radius, which keeps it a lower
+		// bound on the distance to the full fractal and thickens the cut-off dust to about
+		// FRACTAL_LOD_SCALE of a pixel.
+		static const float FRACTAL_LOD_SCALE = 0.5f;
+		static const float FRACTAL_BAILOUT = 16.0f;
+
+		inline int fractalIterations(float footprint)
+		{
+			const int Iterations = 20;
+			if (footprint <= 0.0f)
+			{
+				return Iterations;
+			}
+
+			float n = std::ceil(std::log2(1.7320508f / (FRACTAL_LOD_SCALE * footprint)));
+			return static_cast<int>(DX::clamp(n, 1.0f, float(Iterations)));
+		}
+
+		// fractal() with the iteration count from the footprint at pos (pixelAngle per unit of
+		// distance from eyePos) and an early exit once z escapes. A pixelAngle of 0 is fractal().
+		inline float fractalLod(const float3& pos, const float3& eye, float pixelAngle)
+		{
+			if (pixelAngle <= 0.0f)
+			{
+				return fractal(pos);
+			}
+
+			float3 z = pos;
+			int n = 0;
+			const int Iterations = fractalIterations(length(pos - eye) * pixelAngle);
+			const float Scale = 2.0f;
+			const float3 Offset = float3(1.0f, 1.0f, 1.0f);
+			while (n < Iterations)
+			{
+				if (z.x + z.y < 0) { float t = z.x; z.x = -z.y; z.y = -t; } // fold 1
+				if (z.x + z.z < 0) { float t = z.x; z.x = -z.z; z.z = -t; } // fold 2
+				if (z.y + z.z < 0) { float t = z.z; z.z = -z.y; z.y = -t; } // fold 3
+				z = z * Scale - Offset * (Scale - 1.0f);
+				n++;
+
+				if (dot(z, z) > FRACTAL_BAILOUT * FRACTAL_BAILOUT)
+				{
+					break;
+				}
+			}
+			return (length(z) - 1.7320508f) * std::pow(Scale, -float(n));
+		}
+
+		inline float sphereDistFunc(const float3& samplePoint, float radius)
+		{
+			return length(samplePoint) - radius;
+		}
+
+		inline float cubeDistFunc(const float3& samplePoint)
+		{
+			float3 dist = abs(samplePoint) - float3(1.0f, 1.0f, 1.0f);
+
+			// The shader truncates the float3 min/max to its x component.
+			float insideDist = std::min(std::max(dist.x, std::max(dist.y, dist.z)), 0.0f);
+			float outsideDist = length(max(dist, 0.0f));
+
+			return insideDist + outsideDist;
+		}
+
+		inline float torusDistFunc(const float3& pos, const float2& radii)
+		{
+			float2 q = float2(length(pos.xz()) - radii.x, pos.y);
+			return length(q) - radii.y;
+		}
+
+		inline float hexDF(float3 pos, const float2& h)
+		{
+			const float3 k = float3(-0.8660254f, 0.5f, 0.57735f);
+			pos = abs(pos);
+
+			float m = 2.0f * std::min(k.x * pos.x + k.y * pos.y, 0.0f);
+			pos.x -= m * k.x;
+			pos.y -= m * k.y;
+
+			float2 d = float2(
+				length(pos.xy() - float2(DX::clamp(pos.x, -k.z * h.x, k.z * h.x), h.x)) * DX::sign(pos.y - h.x),
+				pos.z - h.y);
+
+			return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, 0.0f));
+		}
+
+		inline float octahedronDF(float3 pos, float size)
+		{
+			pos = abs(pos);
+			float m = pos.x + pos.y + pos.z - size;
+
+			float3 q;
+			if (3.0f * pos.x < m)
+			{
+				q = pos;
+			}
+			else if (3.0f * pos.y < m)
+			{
+				q = float3(pos.y, pos.z, pos.x);
+			}
+			else if (3.0f * pos.z < m)
+			{
+				q = float3(pos.z, pos.x, pos.y);
+			}
+			else
+			{
+				return m * 0.57735027f;
+			}
+
+			float k = DX::clamp(0.5f * (q.z - q.y + size), 0.0f, size);
+
+			return length(float3(q.x, q.y - size + k, q.z - k));
+		}
+
+		inline float tetraDF(const float3& pos)
+		{
+			return (std::max(std::fabs(pos.x + pos.y) - pos.z, std::fabs(pos.x - pos.y) + pos.z) - 1.0f) / std::sqrt(3.0f);
+		}
+
+		inline float intersectDF(float distanceA, float distanceB) { return std::max(distanceA, distanceB); }
+		inline float unionDF(float distanceA, float distanceB) { return std::min(distanceA, distanceB); }
+		inline float diffDF(float distanceA, float distanceB) { return std::max(distanceA, -distanceB); }
+
+		// Scene sampling
+		float sceneDistFunc(ImplicitSceneType scene, const float3& samplePoint);
+		float3 calcNormals(ImplicitSceneType scene, const float3& pos);
+		float3 calcNormalsTetra(ImplicitSceneType scene, const float3& pos);
+		float3 sceneNormal(ImplicitSceneType scene, const float3& pos, ImplicitNormalMode mode);
+
+		// Plain sphere tracing. steps (optional) receives the number of distance evaluations.
+		float shortestDistanceToSurface(ImplicitSceneType scene, const Ray& ray, float start, float end, int* steps = nullptr);
+
+		// sceneDistFunc with the fractal at the detail pixelAngle can resolve (fractalLod), and
+		// shortestDistanceToSurface over it. The other scenes are unchanged.
+		float sceneDistFuncLod(ImplicitSceneType scene, const float3& samplePoint, float pixelAngle);
+		float shortestDistanceToSurfaceLod(ImplicitSceneType scene, const Ray& ray, float start, float end, float pixelAngle, int* steps = nullptr);
+
+		// Over-relaxed sphere tracing (steps of relaxation * dist, retaken as a plain step when
+		// one overshoots) with a hit distance of max(EPSILON, hitRadius * depth). With
+		// relaxation 1 and hitRadius 0 it is shortestDistanceToSurface.
+		float shortestDistanceToSurfaceRelaxed(ImplicitSceneType scene, const Ray& ray, float start, float end, float relaxation, float hitRadius, int* steps = nullptr);
+
+		// Angle between the primary rays of neighbouring pixel rows, i.e. the pixel footprint per
+		// unit of depth; the shader takes it from ddy of the ray direction.
+		float pixelFootprint(const float2& canvasXY, float canvasPerPixel);
+
+		float3 phongIllumination(const float3& normal, const float3& ambientFactor, const float3& diffuseFactor, const float3& specularFactor, float shininess, const float3& pos, const float3& eye);
+
+		// Primary ray for a canvas coordinate, as built by the pixel shader main. The canvas stays
+		// put when the eye moves, as the shader's does.
+		Ray eyeRayForCanvas(const float2& canvasXY);
+		Ray eyeRayForCanvas(const float2& canvasXY, const float3& eye);
+
+		// Inverse of eyeRayForCanvas: the canvas coordinate whose ray from eye passes through
+		// point. False when the point isn't in front of the canvas.
+		bool canvasForPoint(const float3& point, const float3& eye, float2& canvasXY);
+
+		// Lights the hit at the given depth along the ray, or returns transparent black on a miss.
+		// The ray origin is the eye the highlights are seen from.
+
+		float4 shadeHit(ImplicitSceneType scene, const Ray& eyeRay, float distance, ImplicitNormalMode normals = ImplicitNormalMode::Central);
+
+		// Equivalent of the pixel shader main for one canvas coordinate.
+		float4 shadePixel(ImplicitSceneType scene, const float2& canvasXY, ImplicitNormalMode normals = ImplicitNormalMode::Central);
+	}
+}
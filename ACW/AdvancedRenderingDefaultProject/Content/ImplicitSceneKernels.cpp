@@ -0,0 +1,207 @@
+#include "ImplicitSceneKernels.h"
+#include "SdfExpression.h"
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace AdvancedRenderingDefaultProject::Implicit;
+using namespace AdvancedRenderingDefaultProject::Sdf;
+
+namespace
+{
+	// SCENES
+	// Offsets are written so each lands on the same float operation as sceneDistFunc
+	// (samplePoint + 5 is samplePoint - (-5)), keeping the kernels bit exact.
+	auto DefaultScene()
+	{
+		return MakeUnion(
+			Sphere{ 1.0f },
+			MakeTranslate(Cube{}, float3(2.0f, 2.0f, 2.0f)),
+			MakeTranslate(Torus{ 1.5f, 0.5f }, float3(-5.0f, -5.0f, -5.0f)),
+			MakeTranslate(Octahedron{ 1.0f }, float3(3.0f, -3.0f, 0.0f)),
+			MakeTranslate(HexPrism{ 1.0f, 1.0f }, float3(-3.0f, 3.0f, 0.0f)));
+	}
+
+	auto RepeatingScene()
+	{
+		return MakeUnion(
+			MakeTranslate(MakeRepeat(Cube{}, float3(0.0f, 0.0f, 1.5f)), float3(4.0f, 0.0f, 0.0f)),
+			MakeUnion(
+				MakeTranslate(MakeRepeat(Sphere{ 1.0f }, float3(0.0f, 0.0f, 1.5f)), float3(-4.0f, 0.0f, 0.0f)),
+				MakeRepeat(Octahedron{ 1.0f }, float3(0.0f, 0.0f, 2.25f))));
+	}
+
+	auto DeformingScene()
+	{
+		auto cubeSphere = MakeTranslate(MakeIntersect(Cube{}, MakeScale(Sphere{ 1.0f }, 1.2f)), float3(-3.0f, 0.0f, 0.0f));
+
+		auto s2s3 = MakeIntersect(
+			MakeTranslate(MakeScale(Sphere{ 1.0f }, 1.2f), float3(3.0f, 0.0f, 0.0f)),
+			MakeTranslate(MakeScale(Sphere{ 1.0f }, 1.2f), float3(3.25f, 0.0f, 0.0f)));
+		auto s2s4 = MakeIntersect(s2s3, MakeTranslate(Cube{}, float3(3.0f, -0.3f, 0.0f)));
+		auto s2s5 = MakeDiff(s2s4, MakeTranslate(Torus{ 1.0f, 1.0f }, float3(3.0f, 0.7f, 0.0f)));
+
+		return MakeUnion(cubeSphere, s2s5);
+	}
+
+	auto FractalScene()
+	{
+		return FoldingFractal{};
+	}
+
+	auto ShinyScene()
+	{
+		const float offset = 3.0f;
+		const float step = offset / 1.25f;
+
+		return MakeUnion(
+			MakeTranslate(Tetrahedron{}, float3(-offset, 0.0f, 0.0f)),
+			MakeTranslate(Tetrahedron{}, float3(-offset, step, 0.0f)),
+			MakeTranslate(Tetrahedron{}, float3(-offset, -step, 0.0f)),
+			MakeTranslate(Sphere{ 1.0f }, float3(offset, 0.0f, 0.0f)),
+			MakeTranslate(Sphere{ 1.0f }, float3(offset, step, 0.0f)),
+			MakeTranslate(Sphere{ 1.0f }, float3(offset, -step, 0.0f)));
+	}
+
+	// KERNELS
+	// Built once; the kernels only read the parameters.
+	const auto Default = DefaultScene();
+	const auto Repeating = RepeatingScene();
+	const auto Deforming = DeformingScene();
+	const auto Fractal = FractalScene();
+	const auto Shiny = ShinyScene();
+
+	float DefaultDist(const float3& p) { return Default.Evaluate(p); }
+	float RepeatingDist(const float3& p) { return Repeating.Evaluate(p); }
+	float DeformingDist(const float3& p) { return Deforming.Evaluate(p); }
+	float FractalDist(const float3& p) { return Fractal.Evaluate(p); }
+	float ShinyDist(const float3& p) { return Shiny.Evaluate(p); }
+
+	// shortestDistanceToSurface with the scene as a template argument.
+	template <float (*Dist)(const float3&)>
+	void MarchRaysWith(const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps)
+	{
+		unsigned long long totalSteps = 0;
+
+		for (size_t r = 0; r < count; r++)
+		{
+			const Ray& ray = rays[r];
+			float depth = start;
+			float result = end;
+			int i = 0;
+
+			for (; i < MAX_MARCH; i++)
+			{
+				float dist = Dist(ray.origin + depth * ray.direction);
+				if (dist < EPSILON)
+				{
+					result = depth;
+					i++;
+					break;
+				}
+
+				depth += dist;
+				if (depth >= end)
+				{
+					i++;
+					break;
+				}
+			}
+
+			depths[r] = result;
+			totalSteps += i;
+		}
+
+		if (steps)
+		{
+			*steps += totalSteps;
+		}
+	}
+}
+
+SceneDistFunc Implicit::GetSceneDistFunc(ImplicitSceneType scene)
+{
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return &RepeatingDist;
+	case ImplicitSceneType::Deforming:	return &DeformingDist;
+	case ImplicitSceneType::Fractal:	return &FractalDist;
+	case ImplicitSceneType::Shiny:		return &ShinyDist;
+	default:							return &DefaultDist;
+	}
+}
+
+void Implicit::MarchRaysCompiled(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps)
+{
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	MarchRaysWith<&RepeatingDist>(rays, count, start, end, depths, steps); break;
+	case ImplicitSceneType::Deforming:	MarchRaysWith<&DeformingDist>(rays, count, start, end, depths, steps); break;
+	case ImplicitSceneType::Fractal:	MarchRaysWith<&FractalDist>(rays, count, start, end, depths, steps); break;
+	case ImplicitSceneType::Shiny:		MarchRaysWith<&ShinyDist>(rays, count, start, end, depths, steps); break;
+	default:							MarchRaysWith<&DefaultDist>(rays, count, start, end, depths, steps); break;
+	}
+}
+
+float3 Implicit::SceneGradient(ImplicitSceneType scene, const float3& samplePoint)
+{
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return Repeating.DistGrad(samplePoint).xyz();
+	case ImplicitSceneType::Deforming:	return Deforming.DistGrad(samplePoint).xyz();
+	case ImplicitSceneType::Fractal:	return Fractal.DistGrad(samplePoint).xyz();
+	case ImplicitSceneType::Shiny:		return Shiny.DistGrad(samplePoint).xyz();
+	default:							return Default.DistGrad(samplePoint).xyz();
+	}
+}
+
+std::string Implicit::SceneGradientHlsl(ImplicitSceneType scene)
+{
+	const std::string p = "samplePoint";
+
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return Repeating.ToHlslGradient(p);
+	case ImplicitSceneType::Deforming:	return Deforming.ToHlslGradient(p);
+	case ImplicitSceneType::Fractal:	return Fractal.ToHlslGradient(p);
+	case ImplicitSceneType::Shiny:		return Shiny.ToHlslGradient(p);
+	default:							return Default.ToHlslGradient(p);
+	}
+}
+
+std::string Implicit::SceneDistHlsl(ImplicitSceneType scene)
+{
+	const std::string p = "samplePoint";
+
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return Repeating.ToHlsl(p);
+	case ImplicitSceneType::Deforming:	return Deforming.ToHlsl(p);
+	case ImplicitSceneType::Fractal:	return Fractal.ToHlsl(p);
+	case ImplicitSceneType::Shiny:		return Shiny.ToHlsl(p);
+	default:							return Default.ToHlsl(p);
+	}
+}
+
+const char* Implicit::ScenePixelShaderName(ImplicitSceneType scene)
+{
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:	return "ImplicitPixelShaderRepeating";
+	case ImplicitSceneType::Deforming:	return "ImplicitPixelShaderDeforming";
+	case ImplicitSceneType::Fractal:	return "ImplicitPixelShaderFractal";
+	case ImplicitSceneType::Shiny:		return "ImplicitPixelShaderShiny";
+	default:							return "ImplicitPixelShaderDefault";
+	}
+}
+
+std::string Implicit::ScenePixelShaderHlsl(ImplicitSceneType scene)
+{
+	return std::string()
+		+ "// Generated by \"headless implicit-hlsl\" from the scene descriptions in\n"
+		+ "// Content/ImplicitSceneKernels.cpp; regenerate rather than editing by hand.\n"
+		+ "// ImplicitPixelShader.hlsl specialised for the " + ImplicitSceneName(scene) + " scene.\n"
+		+ "\n"
+		+ "#define IMPLICIT_SCENE_DIST(samplePoint) " + SceneDistHlsl(scene) + "\n"
+		+ "#define IMPLICIT_SCENE_GRADIENT(samplePoint) " + SceneGradientHlsl(scene) + "\n"
+		+ "\n"
+		+ "#include \"ImplicitPixelShader.hlsl\"\n";
+}
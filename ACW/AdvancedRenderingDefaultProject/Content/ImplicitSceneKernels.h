@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ImplicitScene.h"
+
+#include <string>
+
+namespace AdvancedRenderingDefaultProject
+{
+	namespace Implicit
+	{
+		typedef float (*SceneDistFunc)(const float3& samplePoint);
+
+		// Distance kernel for one scene, built from its SdfExpression description with
+		// everything inlined. Matches sceneDistFunc(scene, p) exactly.
+		SceneDistFunc GetSceneDistFunc(ImplicitSceneType scene);
+
+		// Same signature as MarchRaysFunc: picks the scene once per call, then marches with
+		// that scene's kernel inlined into the loop.
+		void MarchRaysCompiled(ImplicitSceneType scene, const Ray* rays, size_t count, float start, float end, float* depths, unsigned long long* steps);
+
+		// Unnormalised gradient from the closed-form gradients of the scene's primitives, with
+		// tetrahedral differences of single primitives where there is none.
+		float3 SceneGradient(ImplicitSceneType scene, const float3& samplePoint);
+
+		// The scene description as an HLSL expression of samplePoint, and its float4(gradient,
+		// distance) counterpart.
+		std::string SceneDistHlsl(ImplicitSceneType scene);
+		std::string SceneGradientHlsl(ImplicitSceneType scene);
+
+		// Pixel shader permutation for the scene; see ImplicitPixelShader.hlsl.
+		const char* ScenePixelShaderName(ImplicitSceneType scene);
+		std::string ScenePixelShaderHlsl(ImplicitSceneType scene);
+	}
+}
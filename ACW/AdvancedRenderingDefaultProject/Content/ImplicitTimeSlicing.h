@@ -0,0 +1,84 @@
+#pragma once
+
+// Time slicing for the implicit scenes, shared by the renderer and the CPU port. Kept free of
+// includes so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	// Every 4x4 cell of pixels is traced over 16 slices, one pixel per slice. Slices follow a
+	// Bayer matrix, so any run of consecutive slices covers each cell evenly. ImplicitPixelShader
+	// holds the same table.
+	struct ImplicitInterleave
+	{
+		static const unsigned int CellSize = 4;
+		static const unsigned int SliceCount = CellSize * CellSize;
+
+		static unsigned int SliceOfPixel(unsigned int x, unsigned int y)
+		{
+			static const unsigned int bayer[SliceCount] =
+			{
+				 0,  8,  2, 10,
+				12,  4, 14,  6,
+				 3, 11,  1,  9,
+				15,  7, 13,  5
+			};
+			return bayer[(y % CellSize) * CellSize + x % CellSize];
+		}
+
+		// Whether slice is one of the count slices from first on, wrapping after the last.
+		static bool InSlices(unsigned int slice, unsigned int first, unsigned int count)
+		{
+			return (slice + SliceCount - first % SliceCount) % SliceCount < count;
+		}
+	};
+
+	// Slices to trace per frame so that frames stay within a time budget. Over budget, the
+	// count drops in proportion to the overrun. It only grows by one slice once the frame's
+	// cost scaled to that many slices would still leave Headroom of the budget, so it settles
+	// below the budget instead of stepping over it and back. With vsync the frame time never
+	// drops below the budget and hides any headroom, so after ProbeFrames frames on budget it
+	// tries one more slice anyway, and drops back if that overruns.
+	class ImplicitFrameBudget
+	{
+	public:
+		static const unsigned int ProbeFrames = 60;
+
+		explicit ImplicitFrameBudget(double budgetSeconds = 1.0 / 60.0) :
+			m_budgetSeconds(budgetSeconds),
+			m_slicesPerFrame(ImplicitInterleave::SliceCount),
+			m_framesOnBudget(0)
+		{
+		}
+
+		// Feeds back how long the last frame that traced GetSlicesPerFrame() slices took.
+		void Update(double frameSeconds)
+		{
+			const double Headroom = 0.05;
+
+			if (frameSeconds > m_budgetSeconds)
+			{
+				unsigned int slices = static_cast<unsigned int>(m_slicesPerFrame * m_budgetSeconds / frameSeconds);
+				m_slicesPerFrame = slices > 1 ? slices : 1;
+				m_framesOnBudget = 0;
+			}
+			else if (m_slicesPerFrame < ImplicitInterleave::SliceCount)
+			{
+				double projected = frameSeconds * (m_slicesPerFrame + 1) / m_slicesPerFrame;
+				if (projected <= m_budgetSeconds * (1.0 - Headroom) || ++m_framesOnBudget >= ProbeFrames)
+				{
+					m_slicesPerFrame++;
+					m_framesOnBudget = 0;
+				}
+			}
+		}
+
+		unsigned int GetSlicesPerFrame() const { return m_slicesPerFrame; }
+
+		double GetBudgetSeconds() const { return m_budgetSeconds; }
+		void SetBudgetSeconds(double budgetSeconds) { m_budgetSeconds = budgetSeconds; }
+
+	private:
+		double			m_budgetSeconds;
+		unsigned int	m_slicesPerFrame;
+		unsigned int	m_framesOnBudget;	// since the last change, for the vsync probe
+	};
+}
@@ -0,0 +1,135 @@
+#include "ParametricEvaluator.h"
+
+#include <cmath>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace DX;
+
+namespace
+{
+	// One lane, with the same IEEE operations the vector levels use.
+	struct Scalar
+	{
+		static const int Lanes = 1;
+		typedef float F;
+		typedef bool M;
+
+		static F Set(float s) { return s; }
+		static F Load(const float* p) { return *p; }
+		static void Store(float* p, F a) { *p = a; }
+
+		static F Add(F a, F b) { return a + b; }
+		static F Sub(F a, F b) { return a - b; }
+		static F Mul(F a, F b) { return a * b; }
+		static F Div(F a, F b) { return a / b; }
+		static F Sqrt(F a) { return std::sqrt(a); }
+		static F Floor(F a) { return std::floor(a); }
+		static F Neg(F a) { return -a; }
+
+		static M Less(F a, F b) { return a < b; }
+		static M And(M a, M b) { return a && b; }
+		static M Or(M a, M b) { return a || b; }
+		static F Select(M m, F a, F b) { return m ? a : b; }
+	};
+
+#include "ParametricEvaluatorKernel.h"
+}
+
+void Parametric::Parameters::MakeGrid(unsigned int columns, unsigned int rows)
+{
+	s.resize(static_cast<size_t>(columns) * rows);
+	t.resize(s.size());
+
+	for (unsigned int y = 0; y < rows; y++)
+	{
+		float ty = rows > 1 ? -1.0f + 2.0f * y / (rows - 1) : 0.0f;
+		for (unsigned int x = 0; x < columns; x++)
+		{
+			size_t i = static_cast<size_t>(y) * columns + x;
+			s[i] = columns > 1 ? -1.0f + 2.0f * x / (columns - 1) : 0.0f;
+			t[i] = ty;
+		}
+	}
+}
+
+void Parametric::Parameters::FromDomainLocations(const float2* points, size_t count)
+{
+	// UVW.x * TriPos[0] + UVW.y * TriPos[1] + UVW.z * TriPos[2]
+	const float3 triPos[3] = { float3(-1.0f, 1.0f, 0.0f), float3(1.0f, 1.0f, 0.0f), float3(0.0f, -1.0f, 0.0f) };
+
+	s.resize(count);
+	t.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		float3 uvw(points[i].x, points[i].y, 1.0f - points[i].x - points[i].y);
+		float3 finalPos = triPos[0] * uvw.x + triPos[1] * uvw.y + triPos[2] * uvw.z;
+		s[i] = finalPos.x;
+		t[i] = finalPos.y;
+	}
+}
+
+void Parametric::Points::Resize(size_t count)
+{
+	std::vector<float>* channels[] = { &positionX, &positionY, &positionZ, &normalX, &normalY, &normalZ, &tangentX, &tangentY, &tangentZ, &u, &v };
+	for (std::vector<float>* channel : channels)
+	{
+		channel->resize(count);
+	}
+}
+
+Parametric::Streams Parametric::Points::GetStreams()
+{
+	Streams streams;
+	streams.positionX = positionX.data();
+	streams.positionY = positionY.data();
+	streams.positionZ = positionZ.data();
+	streams.normalX = normalX.data();
+	streams.normalY = normalY.data();
+	streams.normalZ = normalZ.data();
+	streams.tangentX = tangentX.data();
+	streams.tangentY = tangentY.data();
+	streams.tangentZ = tangentZ.data();
+	streams.u = u.data();
+	streams.v = v.data();
+	return streams;
+}
+
+unsigned int Parametric::EvaluateLanes(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::SSE41:	return 8;
+	case SimdLevel::AVX2:	return 8;
+	case SimdLevel::AVX512:	return 16;
+	default:				return 1;
+	}
+}
+
+Parametric::EvaluateFunc Parametric::GetEvaluateFunc(SimdLevel level)
+{
+	if (level > GetSupportedSimdLevel())
+	{
+		level = GetSupportedSimdLevel();
+	}
+
+	switch (level)
+	{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	case SimdLevel::AVX512:	return &EvaluateAVX512;
+	case SimdLevel::AVX2:	return &EvaluateAVX2;
+	case SimdLevel::SSE41:	return &EvaluateSSE41;
+#endif
+	default:				return &EvaluateScalar;
+	}
+}
+
+void Parametric::Evaluate(const ParametricShape& shape, const Parameters& parameters, Points& points, SimdLevel level)
+{
+	points.Resize(parameters.GetCount());
+	GetEvaluateFunc(level)(shape, parameters.s.data(), parameters.t.data(), parameters.GetCount(), points.GetStreams());
+}
+
+void Parametric::EvaluateScalar(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out)
+{
+	EvaluatorKernel<Scalar>::Evaluate(shape, s, t, count, out);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ParametricShapes.h"
+#include "../Common/CpuFeatures.h"
+#include "../Common/HlslMath.h"
+
+#include <stddef.h>
+#include <vector>
+
+// Batched evaluation of the ParametricShapes as ParametricDS.hlsl draws them. Points are
+// evaluated 8 (SSE4.1, AVX2) or 16 (AVX-512) at a time in SoA form, with the surfaces'
+// analytic normals and tangents alongside the positions and UVs the domain shader outputs.
+//
+// Every level runs the same operations in the same order, sin and cos included, so all of
+// them return the scalar level's results bit for bit. That makes the scalar level the
+// reference the vector levels and the domain shaders are checked against.
+namespace AdvancedRenderingDefaultProject
+{
+	namespace Parametric
+	{
+		// Surface parameters: the finalPos.xy the domain shader interpolates from TriPos, each
+		// in [-1, 1]. A shape's surface is a function of these alone.
+		struct Parameters
+		{
+			std::vector<float>	s;
+			std::vector<float>	t;
+
+			size_t GetCount() const { return s.size(); }
+
+			// columns x rows points spanning [-1, 1] in s and t, row by row.
+			void MakeGrid(unsigned int columns, unsigned int rows);
+
+			// One point per SV_DomainLocation of a tri patch, interpolated from TriPos as the
+			// domain shader does.
+			void FromDomainLocations(const DX::float2* points, size_t count);
+		};
+
+		// Where Evaluate writes, one array per component, each with room for count floats.
+		// Normals point out of the surface and tangents along increasing s; both are unit
+		// length. Shapes are evaluated without their displacement, which is sampled from a
+		// texture at the returned UVs.
+		struct Streams
+		{
+			float*	positionX;
+			float*	positionY;
+			float*	positionZ;
+			float*	normalX;
+			float*	normalY;
+			float*	normalZ;
+			float*	tangentX;
+			float*	tangentY;
+			float*	tangentZ;
+			float*	u;
+			float*	v;
+		};
+
+		// Storage for Streams.
+		struct Points
+		{
+			std::vector<float>	positionX, positionY, positionZ;
+			std::vector<float>	normalX, normalY, normalZ;
+			std::vector<float>	tangentX, tangentY, tangentZ;
+			std::vector<float>	u, v;
+
+			size_t GetCount() const { return positionX.size(); }
+			void Resize(size_t count);
+			Streams GetStreams();
+
+			DX::float3 GetPosition(size_t i) const { return DX::float3(positionX[i], positionY[i], positionZ[i]); }
+			DX::float3 GetNormal(size_t i) const { return DX::float3(normalX[i], normalY[i], normalZ[i]); }
+			DX::float3 GetTangent(size_t i) const { return DX::float3(tangentX[i], tangentY[i], tangentZ[i]); }
+			DX::float2 GetUv(size_t i) const { return DX::float2(u[i], v[i]); }
+		};
+
+		// Evaluates shape at count (s, t) pairs into out.
+		typedef void (*EvaluateFunc)(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out);
+
+		// Lane count of the batch used at a given level (1 for scalar).
+		unsigned int EvaluateLanes(DX::SimdLevel level);
+
+		// Returns the evaluator for level, falling back to the best supported one below it.
+		EvaluateFunc GetEvaluateFunc(DX::SimdLevel level);
+
+		// Resizes points to parameters and evaluates shape into it.
+		void Evaluate(const ParametricShape& shape, const Parameters& parameters, Points& points, DX::SimdLevel level = DX::GetSupportedSimdLevel());
+
+		// The reference: one point at a time.
+		void EvaluateScalar(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out);
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+		// Implemented in ParametricEvaluatorSSE41.cpp, ParametricEvaluatorAVX2.cpp and
+		// ParametricEvaluatorAVX512.cpp, each built for its own instruction set. Only call
+		// through GetEvaluateFunc.
+		void EvaluateSSE41(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out);
+		void EvaluateAVX2(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out);
+		void EvaluateAVX512(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out);
+#endif
+	}
+}
@@ -0,0 +1,59 @@
+#include "ParametricEvaluator.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+// Everything below is compiled for AVX512; callers must check the CPU first.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// Keep mul/add separate (no FMA contraction) so results match the scalar path bit for bit.
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+using namespace AdvancedRenderingDefaultProject;
+
+namespace
+{
+	struct AVX512
+	{
+		static const int Lanes = 16;
+		struct F { __m512 v; };
+		struct M { __mmask16 k; };
+
+		static F Set(float s) { return F{ _mm512_set1_ps(s) }; }
+		static F Load(const float* p) { return F{ _mm512_loadu_ps(p) }; }
+		static void Store(float* p, F a) { _mm512_storeu_ps(p, a.v); }
+
+		static F Add(F a, F b) { return F{ _mm512_add_ps(a.v, b.v) }; }
+		static F Sub(F a, F b) { return F{ _mm512_sub_ps(a.v, b.v) }; }
+		static F Mul(F a, F b) { return F{ _mm512_mul_ps(a.v, b.v) }; }
+		static F Div(F a, F b) { return F{ _mm512_div_ps(a.v, b.v) }; }
+		static F Sqrt(F a) { return F{ _mm512_sqrt_ps(a.v) }; }
+		static F Floor(F a) { return F{ _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC) }; }
+		static F Neg(F a) { return F{ _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(static_cast<int>(0x80000000u)))) }; }
+
+		static M Less(F a, F b) { return M{ _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+		static M And(M a, M b) { return M{ static_cast<__mmask16>(a.k & b.k) }; }
+		static M Or(M a, M b) { return M{ static_cast<__mmask16>(a.k | b.k) }; }
+		static F Select(M m, F a, F b) { return F{ _mm512_mask_blend_ps(m.k, b.v, a.v) }; }
+	};
+
+#include "ParametricEvaluatorKernel.h"
+}
+
+void Parametric::EvaluateAVX512(const ParametricShape& shape, const float* s, const float* t, size_t count, const Streams& out)
+{
+	EvaluatorKernel<AVX512>::Evaluate(shape, s, t, count, out);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
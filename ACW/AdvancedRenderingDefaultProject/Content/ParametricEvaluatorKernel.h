@@ -0,0 +1,227 @@
+// Lane-generic port of the ParametricDS.hlsl surfaces, with their normals and tangents.
+//
+// Only include this from the ParametricEvaluator*.cpp translation units, inside their
+// anonymous namespace and after the instruction set has been enabled. S supplies the vector
+// types: S::Lanes, S::F (float lanes), S::M (lane mask) and the static operations used below.
+// Load and Store are unaligned. Nothing from the standard library is called here, sin and cos
+// included, so every instruction set computes the same bits.
+
+template <typename S>
+struct EvaluatorKernel
+{
+	typedef typename S::F F;
+	typedef typename S::M M;
+
+	static F Set(float s) { return S::Set(s); }
+	static F Add(F a, F b) { return S::Add(a, b); }
+	static F Sub(F a, F b) { return S::Sub(a, b); }
+	static F Mul(F a, F b) { return S::Mul(a, b); }
+	static F Div(F a, F b) { return S::Div(a, b); }
+
+	// The domain shaders' mod(x, 1.0f).
+	static F Frac(F x) { return Sub(x, S::Floor(x)); }
+
+	// sin and cos of x together. x is reduced to r in [-pi/4, pi/4] around the nearest
+	// multiple q of pi/2, with pi/2 split in three so the reduction stays exact over the few
+	// turns the surfaces use, then minimax polynomials in r are swapped and negated by q mod 4.
+	static void SinCos(F x, F& sinX, F& cosX)
+	{
+		F q = S::Floor(Add(Mul(x, Set(0.636619772f)), Set(0.5f)));
+		F r = Sub(x, Mul(q, Set(1.5703125f)));
+		r = Sub(r, Mul(q, Set(4.837512969970703125e-4f)));
+		r = Sub(r, Mul(q, Set(7.54978995489188216e-8f)));
+		F r2 = Mul(r, r);
+
+		F sinR = Add(Mul(r2, Set(-1.9515295891e-4f)), Set(8.3321608736e-3f));
+		sinR = Add(Mul(r2, sinR), Set(-1.6666654611e-1f));
+		sinR = Add(Mul(Mul(r2, r), sinR), r);
+
+		F cosR = Add(Mul(r2, Set(2.443315711809948e-5f)), Set(-1.388731625493765e-3f));
+		cosR = Add(Mul(r2, cosR), Set(4.166664568298827e-2f));
+		cosR = Add(Mul(Mul(r2, r2), cosR), Sub(Set(1.0f), Mul(r2, Set(0.5f))));
+
+		// q mod 4 is 0..3 exactly; odd quadrants swap sin and cos.
+		F quadrant = Sub(q, Mul(S::Floor(Mul(q, Set(0.25f))), Set(4.0f)));
+		M odd = S::Or(S::And(S::Less(Set(0.5f), quadrant), S::Less(quadrant, Set(1.5f))), S::Less(Set(2.5f), quadrant));
+		M sinNegative = S::Less(Set(1.5f), quadrant);
+		M cosNegative = S::And(S::Less(Set(0.5f), quadrant), S::Less(quadrant, Set(2.5f)));
+
+		F sinBase = S::Select(odd, cosR, sinR);
+		F cosBase = S::Select(odd, sinR, cosR);
+		sinX = S::Select(sinNegative, S::Neg(sinBase), sinBase);
+		cosX = S::Select(cosNegative, S::Neg(cosBase), cosBase);
+	}
+
+	struct Packet
+	{
+		F positionX, positionY, positionZ;
+		F normalX, normalY, normalZ;
+		F tangentX, tangentY, tangentZ;
+		F u, v;
+	};
+
+	static void Normalize(F& x, F& y, F& z, F scale)
+	{
+		F length = S::Sqrt(Add(Add(Mul(x, x), Mul(y, y)), Mul(z, z)));
+		F factor = Div(scale, length);
+		x = Mul(x, factor);
+		y = Mul(y, factor);
+		z = Mul(z, factor);
+	}
+
+	// ParametricDS.hlsl's torus branch.
+	static void Torus(const ParametricShape& shape, F s, F t, Packet& p)
+	{
+		const float c = shape.size[0];
+		const float a = shape.size[1];
+
+		F sinPhi, cosPhi, sinTheta, cosTheta;
+		SinCos(Mul(Set(shape.sweep[0]), s), sinPhi, cosPhi);
+		SinCos(Mul(Set(shape.sweep[1]), t), sinTheta, cosTheta);
+
+		F ring = Add(Set(c), Mul(Set(a), cosTheta));
+		p.positionX = Mul(ring, cosPhi);
+		p.positionY = Mul(Set(a), sinTheta);
+		p.positionZ = Mul(ring, S::Neg(sinPhi));
+
+		// Away from the centre of the tube, and round the ring; c > a so the ring never
+		// closes up.
+		p.normalX = Mul(cosTheta, cosPhi);
+		p.normalY = sinTheta;
+		p.normalZ = S::Neg(Mul(cosTheta, sinPhi));
+		p.tangentX = S::Neg(sinPhi);
+		p.tangentY = Set(0.0f);
+		p.tangentZ = S::Neg(cosPhi);
+	}
+
+	// ParametricDS.hlsl's ellipsoid branch.
+	static void Ellipsoid(const ParametricShape& shape, F s, F t, Packet& p)
+	{
+		const float a = shape.size[0];
+		const float b = shape.size[1];
+		const float c = shape.size[2];
+
+		F sinPhi, cosPhi, sinTheta, cosTheta;
+		SinCos(Mul(Set(shape.sweep[0]), s), sinPhi, cosPhi);
+		SinCos(Mul(Set(shape.sweep[1]), t), sinTheta, cosTheta);
+
+		p.positionX = Mul(Mul(Set(a), cosPhi), sinTheta);
+		p.positionY = Mul(Mul(Set(b), sinPhi), sinTheta);
+		p.positionZ = Mul(Set(c), cosTheta);
+
+		// The gradient of (x / a)^2 + (y / b)^2 + (z / c)^2.
+		p.normalX = Div(Mul(cosPhi, sinTheta), Set(a));
+		p.normalY = Div(Mul(sinPhi, sinTheta), Set(b));
+		p.normalZ = Div(cosTheta, Set(c));
+		Normalize(p.normalX, p.normalY, p.normalZ, Set(1.0f));
+
+		// d/ds shrinks to nothing at the poles; its direction is kept, flipped with sin(theta).
+		p.tangentX = Mul(Set(-a), sinPhi);
+		p.tangentY = Mul(Set(b), cosPhi);
+		p.tangentZ = Set(0.0f);
+		Normalize(p.tangentX, p.tangentY, p.tangentZ, S::Select(S::Less(sinTheta, Set(0.0f)), Set(-1.0f), Set(1.0f)));
+	}
+
+	// ParametricDS.hlsl's sphere branch.
+	static void Sphere(const ParametricShape& shape, F s, F t, Packet& p)
+	{
+		F sinPhi, cosPhi, sinTheta, cosTheta;
+		SinCos(Mul(Set(shape.sweep[0]), s), sinPhi, cosPhi);
+		SinCos(Mul(Set(shape.sweep[1]), t), sinTheta, cosTheta);
+
+		F r = Set(shape.size[0]);
+		p.positionX = Mul(Mul(Mul(r, sinPhi), cosTheta), r);
+		p.positionY = Mul(Mul(Mul(r, sinPhi), sinTheta), r);
+		p.positionZ = Mul(Mul(r, cosPhi), r);
+
+		p.normalX = Mul(sinPhi, cosTheta);
+		p.normalY = Mul(sinPhi, sinTheta);
+		p.normalZ = cosPhi;
+		p.tangentX = Mul(cosPhi, cosTheta);
+		p.tangentY = Mul(cosPhi, sinTheta);
+		p.tangentZ = S::Neg(sinPhi);
+	}
+
+	static void Store(float* const* out, size_t i, const Packet& p)
+	{
+		S::Store(out[0] + i, p.positionX);
+		S::Store(out[1] + i, p.positionY);
+		S::Store(out[2] + i, p.positionZ);
+		S::Store(out[3] + i, p.normalX);
+		S::Store(out[4] + i, p.normalY);
+		S::Store(out[5] + i, p.normalZ);
+		S::Store(out[6] + i, p.tangentX);
+		S::Store(out[7] + i, p.tangentY);
+		S::Store(out[8] + i, p.tangentZ);
+		S::Store(out[9] + i, p.u);
+		S::Store(out[10] + i, p.v);
+	}
+
+	static void EvaluatePacket(const ParametricShape& shape, F s, F t, Packet& p)
+	{
+		switch (shape.surface)
+		{
+		case ParametricSurface::Torus:		Torus(shape, s, t, p); break;
+		case ParametricSurface::Ellipsoid:	Ellipsoid(shape, s, t, p); break;
+		default:							Sphere(shape, s, t, p); break;
+		}
+
+		p.positionX = Add(p.positionX, Set(shape.offset[0]));
+		p.positionY = Add(p.positionY, Set(shape.offset[1]));
+		p.positionZ = Add(p.positionZ, Set(shape.offset[2]));
+
+		// Displaced shapes take their UVs from the placed position's x and z.
+		if (shape.displacement != 0.0f)
+		{
+			p.u = Frac(p.positionX);
+			p.v = Frac(p.positionZ);
+		}
+		else
+		{
+			p.u = Frac(s);
+			p.v = Frac(t);
+		}
+	}
+
+	static void Evaluate(const ParametricShape& shape, const float* s, const float* t, size_t count, const Parametric::Streams& streams)
+	{
+		float* const out[11] = {
+			streams.positionX, streams.positionY, streams.positionZ,
+			streams.normalX, streams.normalY, streams.normalZ,
+			streams.tangentX, streams.tangentY, streams.tangentZ,
+			streams.u, streams.v };
+
+		Packet p;
+		size_t full = count - count % S::Lanes;
+		for (size_t i = 0; i < full; i += S::Lanes)
+		{
+			EvaluatePacket(shape, S::Load(s + i), S::Load(t + i), p);
+			Store(out, i, p);
+		}
+
+		// Pad a partial batch with its last point and keep only the real lanes.
+		size_t lanes = count - full;
+		if (lanes > 0)
+		{
+			float padS[S::Lanes], padT[S::Lanes];
+			for (size_t i = 0; i < static_cast<size_t>(S::Lanes); i++)
+			{
+				padS[i] = s[full + (i < lanes ? i : lanes - 1)];
+				padT[i] = t[full + (i < lanes ? i : lanes - 1)];
+			}
+
+			float tail[11][S::Lanes];
+			float* const tailOut[11] = { tail[0], tail[1], tail[2], tail[3], tail[4], tail[5], tail[6], tail[7], tail[8], tail[9], tail[10] };
+			EvaluatePacket(shape, S::Load(padS), S::Load(padT), p);
+			Store(tailOut, 0, p);
+
+			for (int c = 0; c < 11; c++)
+			{
+				for (size_t i = 0; i < lanes; i++)
+				{
+					out[c][full + i] = tail[c][i];
+				}
+			}
+		}
+	}
+};
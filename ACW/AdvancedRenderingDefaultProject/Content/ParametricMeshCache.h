@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ParametricShapes.h"
+
+// Cached meshes of the parametric shapes, shared by the renderer and the CPU port. Only
+// includes other include-free headers so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	// ParametricHS.hlsl's tess factor, set through ParametricTessellationBuffer. The surfaces
+	// use integer partitioning; the level of detail steps through even factors in this range.
+	static const unsigned int ParametricDefaultTessFactor = 30;
+	static const unsigned int ParametricMinTessFactor = 2;
+	static const unsigned int ParametricMaxTessFactor = 64;
+
+	// Triangles one tri patch tessellates into at integer factor n: 6k^2 triangles for even
+	// n = 2k, 6k^2 + 6k + 1 for odd n = 2k + 1.
+	inline unsigned int ParametricTriangleCount(unsigned int n)
+	{
+		unsigned int k = n / 2;
+		return (n & 1) ? 6 * k * k + 6 * k + 1 : 6 * k * k;
+	}
+
+	// What a cached mesh was tessellated with; it is rebuilt once this changes. Only shapes
+	// with a displacement weight read displacementFactor.
+	struct ParametricMeshKey
+	{
+		unsigned int	tessFactor;
+		float			displacement;
+
+		static ParametricMeshKey Make(const ParametricShape& shape, unsigned int tessFactor, float displacement)
+		{
+			ParametricMeshKey key;
+			key.tessFactor = tessFactor;
+			key.displacement = shape.displacement != 0.0f ? displacement : 0.0f;
+			return key;
+		}
+
+		bool operator==(const ParametricMeshKey& other) const
+		{
+			return tessFactor == other.tessFactor && displacement == other.displacement;
+		}
+
+		bool operator!=(const ParametricMeshKey& other) const { return !(*this == other); }
+	};
+}
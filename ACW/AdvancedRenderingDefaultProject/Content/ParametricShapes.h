@@ -0,0 +1,47 @@
+#pragma once
+
+// The parametric surface family ParametricDS.hlsl draws, shared by the renderer, the CPU port
+// and the evaluator. Kept free of includes so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	enum class ParametricSurface
+	{
+		Torus,
+		Ellipsoid,
+		Sphere
+	};
+
+	// One parametric object. The domain shader reads these from the object's instance data;
+	// s and t are the TriPos coordinates in [-1, 1].
+	struct ParametricShape
+	{
+		ParametricSurface	surface;
+		float				size[3];		// torus c, a; ellipsoid a, b, c; sphere radius (applied twice)
+		float				sweep[2];		// phi and theta per unit of s and t
+		float				offset[3];
+		float				displacement;	// weight on displacementFactor.x
+		bool				wireframe;
+	};
+
+	// The scene's objects, each drawn with its own instance. Wireframe objects come last so
+	// the solid and wireframe ones are one instanced draw each.
+	static const ParametricShape ParametricShapes[] =
+	{
+		{ ParametricSurface::Torus, { 0.25f, 0.1f, 0.0f }, { 3.1415926f * 2.0f, 2.0f * (3.1415926f * 2.0f) }, { 0.5f, 0.25f, -1.0f }, 0.0f, false },
+		{ ParametricSurface::Ellipsoid, { 0.1f, 0.3f, 0.1f }, { 3.1415926f * 1.5f, 3.1415926f * 1.5f }, { -0.5f, 0.25f, -1.0f }, 0.0f, false },
+		{ ParametricSurface::Sphere, { 0.35f, 0.0f, 0.0f }, { 3.1415926f * 1.5f, 3.1415926f * 1.5f }, { 0.0f, 0.25f, 0.0f }, 1.0f, true },
+	};
+
+	static const int ParametricShapeCount = sizeof(ParametricShapes) / sizeof(ParametricShapes[0]);
+
+	// Objects before the first wireframe one.
+	inline int ParametricSolidShapeCount()
+	{
+		int count = 0;
+		while (count < ParametricShapeCount && !ParametricShapes[count].wireframe)
+		{
+			count++;
+		}
+		return count;
+	}
+}
@@ -2,20 +2,52 @@
 #include "Sample3DSceneRenderer.h"
 #include "..\Common\DDSTextureLoader.h"
 #include "..\Common\DirectXHelper.h"
-#include <random>
 
 using namespace AdvancedRenderingDefaultProject;
 
 using namespace DirectX;
 using namespace Windows::Foundation;
 
+namespace
+{
+	// Stream output for a parametric domain shader, built from its output signature, so the
+	// tessellated surface can be captured into a ParametricMesh without rasterizing it.
+	void CreateParametricStreamOut(ID3D11Device* device, const std::vector<byte>& domainShader, ID3D11GeometryShader** streamOut)
+	{
+		static const D3D11_SO_DECLARATION_ENTRY declaration[] =
+		{
+			{ 0, "TEXCOORD", 1, 0, 3, 0 },	// modelPos
+			{ 0, "TEXCOORD", 0, 0, 2, 0 },	// uvs
+		};
+		UINT stride = sizeof(VertexPositionUv);
+
+		DX::ThrowIfFailed(
+			device->CreateGeometryShaderWithStreamOutput(
+				&domainShader[0],
+				domainShader.size(),
+				declaration,
+				ARRAYSIZE(declaration),
+				&stride,
+				1,
+				D3D11_SO_NO_RASTERIZED_STREAM,
+				nullptr,
+				streamOut
+			)
+		);
+	}
+}
+
 // Loads vertex and pixel shaders from files and instantiates the cube geometry.
 Sample3DSceneRenderer::Sample3DSceneRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
 	m_loadingComplete(false),
 	m_degreesPerSecond(45),
 	m_indexCount(0),
+	m_floorPatchIndexCount(0),
 	m_tracking(false),
-	m_deviceResources(deviceResources)
+	m_deviceResources(deviceResources),
+	m_grassRegenerating(false),
+	m_threadPool(std::make_shared<DX::ThreadPool>()),
+	m_geometryExpansion(GeometryExpansion::GeometryShader)
 {
 	CreateDeviceDependentResources();
 	CreateWindowSizeDependentResources();
@@ -80,11 +112,38 @@ void Sample3DSceneRenderer::CreateWindowSizeDependentResources()
 	m_isShiny = 0;
 
 	// Load the control CB
-	XMStoreFloat4(&m_controlBufferData.booleans, XMVECTORF32{ m_isRepeating, m_isDeforming, m_isFractal, m_isShiny });
+	UpdateControlBuffer();
 
 	XMFLOAT4 displacementFactor = XMFLOAT4(0.01f, 0.0f, 0.0f, 1.0f);
 
 	XMStoreFloat4(&m_displacementBufferData.displacementFactor, XMVECTORF32{ 0.01f, 0.0f, 0.0f, 1.0f });
+
+	// Floor tessellation factors depend on the output size.
+	UpdateFloorTessellationBuffer();
+
+	XMStoreFloat4(&m_parametricTessellationBufferData.tessFactor, XMVECTORF32{ static_cast<float>(m_parametricTessFactor), 0.0f, 0.0f, 0.0f });
+
+	// Implicit history target, matching the back buffer so it can be copied straight over.
+	m_implicitHistoryRTV.Reset();
+	m_implicitHistory.Reset();
+	if (m_deviceResources->GetBackBufferRenderTargetView())
+	{
+		Microsoft::WRL::ComPtr<ID3D11Resource> backBuffer;
+		m_deviceResources->GetBackBufferRenderTargetView()->GetResource(&backBuffer);
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> backBufferTexture;
+		DX::ThrowIfFailed(backBuffer.As(&backBufferTexture));
+
+		D3D11_TEXTURE2D_DESC historyDesc;
+		backBufferTexture->GetDesc(&historyDesc);
+		historyDesc.Usage = D3D11_USAGE_DEFAULT;
+		historyDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+		historyDesc.CPUAccessFlags = 0;
+		historyDesc.MiscFlags = 0;
+
+		DX::ThrowIfFailed(m_deviceResources->GetD3DDevice()->CreateTexture2D(&historyDesc, nullptr, &m_implicitHistory));
+		DX::ThrowIfFailed(m_deviceResources->GetD3DDevice()->CreateRenderTargetView(m_implicitHistory.Get(), nullptr, &m_implicitHistoryRTV));
+	}
+	ResetImplicitHistory();
 }
 
 // Called once per frame, rotates the cube and calculates the model and view matrices.
@@ -103,6 +162,36 @@ void Sample3DSceneRenderer::Update(DX::StepTimer const& timer)
 
 		Rotate(radians);
 	}
+
+	// The swarm is laid out by a loading task.
+	if (m_loadingComplete)
+	{
+		m_snakeSwarm.Update(static_cast<float>(timer.GetElapsedSeconds()), *m_threadPool);
+	}
+
+	// A field scattered in the background replaces the drawn one between frames.
+	if (m_loadingComplete && m_grassRegenerating && m_grassRegeneration.is_done())
+	{
+		m_grassField = std::move(*m_grassRegeneration.get());
+		m_grassRegenerating = false;
+		CreateGrassResources();
+	}
+
+	// Implicit time slicing. The time of a frame that traced the budgeted slices tells the
+	// budget how many fit; once every slice is in the history nothing is traced.
+	if (m_implicitLastFrameSlices > 0 && m_implicitLastFrameSlices == m_implicitBudget.GetSlicesPerFrame())
+	{
+		m_implicitBudget.Update(timer.GetElapsedSeconds());
+	}
+
+	m_implicitFrameSlices = ImplicitInterleave::SliceCount;
+	if (m_isProgressive && m_implicitHistoryRTV)
+	{
+		unsigned int remaining = ImplicitInterleave::SliceCount - m_implicitSlicesTraced;
+		unsigned int budgeted = m_implicitBudget.GetSlicesPerFrame();
+		m_implicitFrameSlices = budgeted < remaining ? budgeted : remaining;
+	}
+	XMStoreFloat4(&m_controlBufferData.progressive, XMVECTORF32{ static_cast<float>(m_implicitNextSlice), static_cast<float>(m_implicitFrameSlices), 0.0f, 0.0f });
 }
 
 // Rotate the 3D cube model a set amount of radians.
@@ -112,6 +201,333 @@ void Sample3DSceneRenderer::Rotate(float radians)
 	XMStoreFloat4x4(&m_constantBufferData.model, XMMatrixTranspose(XMMatrixRotationY(radians)));
 }
 
+// ImplicitSceneType of the current control booleans.
+int Sample3DSceneRenderer::ImplicitSceneIndex() const
+{
+	return m_isRepeating ? 1 : m_isDeforming ? 2 : m_isFractal ? 3 : m_isShiny ? 4 : 0;
+}
+
+void Sample3DSceneRenderer::UpdateControlBuffer()
+{
+	XMStoreFloat4(&m_controlBufferData.booleans, XMVECTORF32{ m_isRepeating, m_isDeforming, m_isFractal, m_isShiny });
+
+	// Each scene has its own relaxed marcher settings.
+	ImplicitMarchSettings march = m_isRelaxedMarch ? ImplicitRelaxedMarch(ImplicitSceneIndex()) : ImplicitPlainMarch();
+	XMStoreFloat4(&m_controlBufferData.marching, XMVECTORF32{ march.relaxation, march.hitPixels, m_isFractalLod ? 1.0f : 0.0f, 0.0f });
+}
+
+void Sample3DSceneRenderer::UpdateFloorTessellationBuffer()
+{
+	Size outputSize = m_deviceResources->GetOutputSize();
+	XMStoreFloat4(&m_floorTessellationBufferData.viewport, XMVECTORF32{ outputSize.Width, outputSize.Height,
+		m_floorTessellation.trianglesPerPixel, m_floorTessellation.adaptive ? 1.0f : 0.0f });
+	XMStoreFloat4(&m_floorTessellationBufferData.detail, XMVECTORF32{ m_floorTessellation.flatDetail, m_floorTessellation.detailDeviation, 0.0f, 0.0f });
+}
+
+// Scatters m_grassSettings' blades and creates the resources drawing them.
+void Sample3DSceneRenderer::CreateGrassField()
+{
+	m_grassField.Generate(m_grassSettings, *m_threadPool);
+	CreateGrassResources();
+}
+
+// Scatters m_grassSettings' blades on a task of their own, for Update to swap in once done.
+// The task gets its own thread pool, as ParallelFor dispatches one at a time and the frames
+// culling the current field would otherwise wait for each Poisson-disc phase.
+void Sample3DSceneRenderer::RegenerateGrassField()
+{
+	GrassFieldSettings settings = m_grassSettings;
+	m_grassRegenerating = true;
+	m_grassRegeneration = concurrency::create_task([settings]()
+	{
+		auto field = std::make_shared<GrassField>();
+		DX::ThreadPool threadPool;
+		field->Generate(settings, threadPool);
+		return field;
+	});
+}
+
+// Sizes the ring for m_grassField: every card visible in two frames running still fits
+// before it wraps, as a chunk never has more clumps than blades. The ground layer gets a
+// quad over the field and a texel per chunk.
+void Sample3DSceneRenderer::CreateGrassResources()
+{
+	auto device = m_deviceResources->GetD3DDevice();
+	m_grassRing = GrassRing(2 * m_grassField.GetBladeCount());
+
+	CD3D11_BUFFER_DESC grassBufferDesc(static_cast<UINT>(m_grassRing.GetCapacity() * sizeof(GrassCard)), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+	m_grassBuffer.Reset();
+	DX::ThrowIfFailed(
+		device->CreateBuffer(
+			&grassBufferDesc,
+			nullptr,
+			m_grassBuffer.GetAddressOf()
+		)
+	);
+
+	float extent = m_grassField.GetExtent();
+	float height = m_grassField.GetGroundHeight();
+	const VertexPositionUv groundCorners[] =
+	{
+		{ XMFLOAT3(-extent, height, -extent), XMFLOAT2(0.0f, 0.0f) },
+		{ XMFLOAT3(-extent, height, extent), XMFLOAT2(0.0f, 1.0f) },
+		{ XMFLOAT3(extent, height, -extent), XMFLOAT2(1.0f, 0.0f) },
+		{ XMFLOAT3(extent, height, extent), XMFLOAT2(1.0f, 1.0f) },
+	};
+	D3D11_SUBRESOURCE_DATA groundBufferData = { groundCorners, 0, 0 };
+	CD3D11_BUFFER_DESC groundBufferDesc(sizeof(groundCorners), D3D11_BIND_VERTEX_BUFFER);
+	m_grassGroundBuffer.Reset();
+	DX::ThrowIfFailed(device->CreateBuffer(&groundBufferDesc, &groundBufferData, m_grassGroundBuffer.GetAddressOf()));
+
+	CD3D11_TEXTURE2D_DESC groundTextureDesc(DXGI_FORMAT_R8_UNORM, m_grassField.GetGridSize(), m_grassField.GetGridSize(), 1, 1);
+	m_grassGroundSRV.Reset();
+	m_grassGroundTexture.Reset();
+	DX::ThrowIfFailed(device->CreateTexture2D(&groundTextureDesc, nullptr, m_grassGroundTexture.GetAddressOf()));
+	DX::ThrowIfFailed(device->CreateShaderResourceView(m_grassGroundTexture.Get(), nullptr, m_grassGroundSRV.GetAddressOf()));
+}
+
+// Lays out m_snakeSettings' snakes and sizes the buffer their segments are written to.
+void Sample3DSceneRenderer::CreateSnakeSwarm()
+{
+	auto device = m_deviceResources->GetD3DDevice();
+	m_snakeSwarm.Generate(m_snakeSettings);
+	UINT vertexCount = static_cast<UINT>(2 * m_snakeSwarm.GetSegmentCount());
+
+	CD3D11_BUFFER_DESC snakeBufferDesc(vertexCount * sizeof(SnakeVertex), D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_SHADER_RESOURCE, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE, D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS);
+	m_snakeBufferSRV.Reset();
+	m_snakeBuffer.Reset();
+	DX::ThrowIfFailed(device->CreateBuffer(&snakeBufferDesc, nullptr, m_snakeBuffer.GetAddressOf()));
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
+	srvDesc.BufferEx.NumElements = vertexCount * SnakeVertexFloats;
+	srvDesc.BufferEx.Flags = D3D11_BUFFEREX_SRV_FLAG_RAW;
+	DX::ThrowIfFailed(device->CreateShaderResourceView(m_snakeBuffer.Get(), &srvDesc, m_snakeBufferSRV.GetAddressOf()));
+
+	CD3D11_BUFFER_DESC tubeVertexDesc(static_cast<UINT>(SnakeTube::GetMaxVertexCount(m_snakeSwarm, m_snakeTubeSettings) * sizeof(VertexPosition)), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+	CD3D11_BUFFER_DESC tubeIndexDesc(static_cast<UINT>(SnakeTube::GetMaxIndexCount(m_snakeSwarm, m_snakeTubeSettings) * sizeof(uint32)), D3D11_BIND_INDEX_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+	m_snakeTubeVertices.Reset();
+	m_snakeTubeIndices.Reset();
+	DX::ThrowIfFailed(device->CreateBuffer(&tubeVertexDesc, nullptr, m_snakeTubeVertices.GetAddressOf()));
+	DX::ThrowIfFailed(device->CreateBuffer(&tubeIndexDesc, nullptr, m_snakeTubeIndices.GetAddressOf()));
+}
+
+// Writes this frame's snakes over the last frame's. Returns how many segments to draw.
+UINT Sample3DSceneRenderer::UploadSnakes()
+{
+	if (m_snakeSwarm.GetSegmentCount() == 0)
+	{
+		return 0;
+	}
+
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	DX::ThrowIfFailed(context->Map(m_snakeBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+	m_snakeSwarm.Write(static_cast<float*>(mapped.pData), *m_threadPool);
+	context->Unmap(m_snakeBuffer.Get(), 0);
+	return static_cast<UINT>(m_snakeSwarm.GetSegmentCount());
+}
+
+// Extrudes this frame's snakes, each at the ring resolution of its distance. Returns how many
+// indices to draw.
+UINT Sample3DSceneRenderer::UploadSnakeTubes()
+{
+	if (m_snakeSwarm.GetSegmentCount() == 0)
+	{
+		return 0;
+	}
+
+	XMMATRIX modelViewProjection = XMMatrixTranspose(XMLoadFloat4x4(&m_constantBufferData.model)) *
+		XMMatrixTranspose(XMLoadFloat4x4(&m_constantBufferData.view)) *
+		XMMatrixTranspose(XMLoadFloat4x4(&m_constantBufferData.projection));
+	XMFLOAT4X4 rows;
+	XMStoreFloat4x4(&rows, modelViewProjection);
+	m_snakeTube.Build(m_snakeSwarm, m_snakeTubeSettings, rows.m, *m_threadPool);
+
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	D3D11_MAPPED_SUBRESOURCE vertices, indices;
+	DX::ThrowIfFailed(context->Map(m_snakeTubeVertices.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &vertices));
+	DX::ThrowIfFailed(context->Map(m_snakeTubeIndices.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &indices));
+	m_snakeTube.Write(m_snakeSwarm, static_cast<float*>(vertices.pData), static_cast<uint32_t*>(indices.pData), *m_threadPool);
+	context->Unmap(m_snakeTubeIndices.Get(), 0);
+	context->Unmap(m_snakeTubeVertices.Get(), 0);
+	return static_cast<UINT>(m_snakeTube.GetIndexCount());
+}
+
+// Culls the grass field against this frame's camera, picks each chunk's LOD and appends the
+// visible cards to the ring. Returns how many to draw, starting at firstCard.
+UINT Sample3DSceneRenderer::UploadVisibleGrass(UINT& firstCard)
+{
+	XMMATRIX modelViewProjection = XMMatrixTranspose(XMLoadFloat4x4(&m_constantBufferData.model)) *
+		XMMatrixTranspose(XMLoadFloat4x4(&m_constantBufferData.view)) *
+		XMMatrixTranspose(XMLoadFloat4x4(&m_constantBufferData.projection));
+	XMFLOAT4X4 rows;
+	XMStoreFloat4x4(&rows, modelViewProjection);
+
+	GrassView view;
+	memcpy(view.modelViewProjection, rows.m, sizeof(view.modelViewProjection));
+	view.lod = m_grassLod;
+	m_grassField.Cull(view, *m_threadPool, m_grassVisible);
+	if (m_grassVisible.GetCardCount() == 0)
+	{
+		firstCard = 0;
+		return 0;
+	}
+
+	// Earlier frames may still be reading the rest of the ring; only a wrap renames it.
+	size_t count = m_grassVisible.GetCardCount();
+	bool wrapped = false;
+	size_t first = m_grassRing.Allocate(count, wrapped);
+
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	DX::ThrowIfFailed(
+		context->Map(m_grassBuffer.Get(), 0, wrapped ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped)
+	);
+	m_grassField.Write(m_grassVisible, static_cast<float*>(mapped.pData) + first * 4, *m_threadPool);
+	context->Unmap(m_grassBuffer.Get(), 0);
+
+	firstCard = static_cast<UINT>(first);
+	return static_cast<UINT>(count);
+}
+
+// The ground layer, for the chunks this frame's cull left as ground. Drawn before the cards,
+// which stand on it.
+void Sample3DSceneRenderer::DrawGrassGround()
+{
+	if (m_grassVisible.groundChunks == 0)
+	{
+		return;
+	}
+
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	context->UpdateSubresource(m_grassGroundTexture.Get(), 0, nullptr, m_grassVisible.ground.data(), m_grassField.GetGridSize(), 0);
+
+	UINT stride = sizeof(VertexPositionUv);
+	UINT offset = 0;
+	context->IASetVertexBuffers(0, 1, m_grassGroundBuffer.GetAddressOf(), &stride, &offset);
+	context->IASetInputLayout(m_grassGroundLayout.Get());
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	context->RSSetState(m_filledNoCullRasterState.Get());
+
+	context->VSSetShader(m_grassGroundVS.Get(), nullptr, 0);
+	context->VSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
+	context->HSSetShader(NULL, nullptr, 0);
+	context->DSSetShader(NULL, nullptr, 0);
+	context->GSSetShader(NULL, nullptr, 0);
+
+	ID3D11ShaderResourceView* textures[2] = { m_grassTexture.Get(), m_grassGroundSRV.Get() };
+	context->PSSetShader(m_grassGroundPS.Get(), nullptr, 0);
+	context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
+	context->PSSetShaderResources(0, 2, textures);
+	context->Draw(4, 0);
+}
+
+// Binds the parametric patch, its instances and the tessellation stages that turn each
+// instance into its surface. The caller sets the geometry and pixel stages.
+void Sample3DSceneRenderer::BindParametricPatches()
+{
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	ID3D11Buffer* buffers[2] = { m_vertexBuffer.Get(), m_parametricInstanceBuffer.Get() };
+	UINT strides[2] = { sizeof(VertexPositionColor), sizeof(ParametricInstance) };
+	UINT offsets[2] = { 0, 0 };
+	context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+	context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
+	context->IASetInputLayout(m_parametricIL.Get());
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
+	context->VSSetShader(m_parametricVS.Get(), nullptr, 0);
+
+	context->HSSetShader(m_parametricHS.Get(), nullptr, 0);
+	context->HSSetConstantBuffers(0, 1, m_parametricTessellationBuffer.GetAddressOf());
+	context->DSSetShader(m_parametricDS.Get(), nullptr, 0);
+	context->DSSetSamplers(0, 1, m_sampler.GetAddressOf());
+	context->DSSetShaderResources(0, 1, m_floorDisp.GetAddressOf());
+	context->DSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
+	context->DSSetConstantBuffers1(1, 1, m_displacementBuffer.GetAddressOf(), nullptr, nullptr);
+}
+
+// The cached mesh of a ParametricShapes entry at the current tess factor, streamed out of the
+// domain shader first if there is none or it was made with other settings.
+ID3D11Buffer* Sample3DSceneRenderer::UpdateParametricMesh(int shape)
+{
+	ParametricMeshKey key = ParametricMeshKey::Make(ParametricShapes[shape], m_parametricTessFactor, m_displacementFactor);
+	ParametricMesh& mesh = m_parametricMeshes[shape][m_parametricTessFactor / 2 - 1];
+	if (mesh.buffer && mesh.key == key)
+	{
+		return mesh.buffer.Get();
+	}
+
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	if (!mesh.buffer)
+	{
+		UINT size = ParametricTriangleCount(m_parametricTessFactor) * 3 * sizeof(VertexPositionUv);
+		CD3D11_BUFFER_DESC meshDesc(size, D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_STREAM_OUTPUT);
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateBuffer(
+				&meshDesc,
+				nullptr,
+				mesh.buffer.GetAddressOf()
+			)
+		);
+	}
+
+	// Nothing is rasterized; the domain shader's output goes straight to the buffer. The
+	// instance data follows the start instance, so this draws just the one object.
+	BindParametricPatches();
+	context->GSSetShader(m_parametricStreamOut.Get(), nullptr, 0);
+	context->PSSetShader(NULL, nullptr, 0);
+	UINT streamOffset = 0;
+	context->SOSetTargets(1, mesh.buffer.GetAddressOf(), &streamOffset);
+	context->DrawIndexedInstanced(3, 1, 0, 0, shape);
+
+	ID3D11Buffer* noTarget = nullptr;
+	context->SOSetTargets(1, &noTarget, &streamOffset);
+	context->GSSetShader(NULL, nullptr, 0);
+
+	mesh.key = key;
+	return mesh.buffer.Get();
+}
+
+// The parametric objects from their cached meshes: a plain transform per vertex instead of
+// the hull, tessellator and domain stages.
+void Sample3DSceneRenderer::DrawParametricMeshes()
+{
+	ID3D11Buffer* meshes[ParametricShapeCount];
+	for (int shape = 0; shape < ParametricShapeCount; shape++)
+	{
+		meshes[shape] = UpdateParametricMesh(shape);
+	}
+
+	auto context = m_deviceResources->GetD3DDeviceContext();
+	UINT stride = sizeof(VertexPositionUv);
+	UINT offset = 0;
+	context->IASetInputLayout(m_parametricCachedIL.Get());
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	context->VSSetShader(m_parametricCachedVS.Get(), nullptr, 0);
+	context->VSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
+	context->HSSetShader(NULL, nullptr, 0);
+	context->DSSetShader(NULL, nullptr, 0);
+	context->GSSetShader(NULL, nullptr, 0);
+	context->PSSetShader(m_parametricPS.Get(), nullptr, 0);
+	context->PSSetShaderResources(0, 1, m_metalTexture.GetAddressOf());
+	context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
+
+	for (int shape = 0; shape < ParametricShapeCount; shape++)
+	{
+		context->RSSetState(ParametricShapes[shape].wireframe ? m_wireframeRasterState.Get() : m_filledNoCullRasterState.Get());
+		context->IASetVertexBuffers(0, 1, &meshes[shape], &stride, &offset);
+		context->DrawAuto();
+	}
+}
+
+// Starts the implicit history over, e.g. after the scene changes.
+void Sample3DSceneRenderer::ResetImplicitHistory()
+{
+	m_implicitNextSlice = 0;
+	m_implicitSlicesTraced = 0;
+}
+
 void Sample3DSceneRenderer::StartTracking()
 {
 	m_tracking = true;
@@ -148,6 +564,10 @@ void Sample3DSceneRenderer::Render()
 	context->UpdateSubresource1(m_cameraBuffer.Get(), 0, NULL, &m_cameraBufferData, 0, 0, 0);
 	context->UpdateSubresource1(m_controlBuffer.Get(), 0, NULL, &m_controlBufferData, 0, 0, 0);
 	context->UpdateSubresource1(m_displacementBuffer.Get(), 0, NULL, &m_displacementBufferData, 0, 0, 0);
+	context->UpdateSubresource1(m_floorTessellationBuffer.Get(), 0, NULL, &m_floorTessellationBufferData, 0, 0, 0);
+	context->UpdateSubresource1(m_parametricTessellationBuffer.Get(), 0, NULL, &m_parametricTessellationBufferData, 0, 0, 0);
+
+	m_implicitLastFrameSlices = 0;
 
 	UINT stride;
 	UINT offset;
@@ -163,8 +583,8 @@ void Sample3DSceneRenderer::Render()
 		context->OMSetBlendState(m_blend.Get(), 0, 0xffffffff);
 		// FLOOR QUAD
 #pragma region FLOOR
-		context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
+		context->IASetVertexBuffers(0, 1, m_floorPatchBuffer.GetAddressOf(), &stride, &offset);
+		context->IASetIndexBuffer(m_floorPatchIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
 		context->IASetInputLayout(m_inputLayout.Get());
 
 		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_4_CONTROL_POINT_PATCHLIST);
@@ -178,6 +598,10 @@ void Sample3DSceneRenderer::Render()
 		context->VSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
 
 		context->HSSetShader(m_hullShader.Get(), nullptr, 0);
+		context->HSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
+		context->HSSetConstantBuffers(1, 1, m_floorTessellationBuffer.GetAddressOf());
+		context->HSSetSamplers(0, 1, m_sampler.GetAddressOf());
+		context->HSSetShaderResources(0, 1, m_floorDisp.GetAddressOf());
 		context->DSSetShader(m_domainShader.Get(), nullptr, 0);
 		context->DSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
 		context->DSSetConstantBuffers(1, 1, m_timeBuffer.GetAddressOf());
@@ -185,133 +609,138 @@ void Sample3DSceneRenderer::Render()
 		context->DSSetShaderResources(0, 1, m_floorDisp.GetAddressOf());
 
 		context->GSSetShader(NULL, nullptr, 0);
-		context->DrawIndexed(m_indexCount, 0, 0);
+		if (m_floorTessellation.adaptive)
+		{
+			context->DrawIndexed(m_floorPatchIndexCount - 4, 0, 0);
+		}
+		else
+		{
+			context->DrawIndexed(4, m_floorPatchIndexCount - 4, 0);
+		}
 #pragma endregion
 
 		// SNAKE POLYLINE
 #pragma region SNAKE
-	// ia
-		stride = sizeof(VertexPosition);
-		offset = 0;
-		context->IASetVertexBuffers(0, 1, m_snakeBuffer.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_snakeIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
-		context->IASetInputLayout(m_snakePointsLayout.Get());
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		//context->RSSetState(m_filledNoCullRasterState.Get());
 		context->RSSetState(m_filledNoCullRasterState.Get());
 
 		// vs
-		context->VSSetShader(m_snakeVS.Get(), nullptr, 0);
 		context->VSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
-		context->VSSetConstantBuffers(1, 1, m_timeBuffer.GetAddressOf());
 
 		// hs ds clear
 		context->HSSetShader(NULL, nullptr, 0);
 		context->DSSetShader(NULL, nullptr, 0);
 
-		// gs
-		context->GSSetShader(m_snakeGS.Get(), nullptr, 0);
-		context->GSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
-		context->GSSetConstantBuffers(1, 1, m_timeBuffer.GetAddressOf());
-
-		// ps
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
 		context->PSSetShader(m_snakePS.Get(), nullptr, 0);
 		context->PSSetShaderResources(0, 1, m_snakeTex.GetAddressOf());
-		context->DrawIndexed(m_snakeIndexCount, 0, 0);
 
-		context->IASetVertexBuffers(0, 1, m_snakeBuffer2.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_snakeIndexBuffer2.Get(), DXGI_FORMAT_R16_UINT, .0);
-		context->DrawIndexed(m_snakeIndexCount, 0, 0);
+		if (m_snakeTubeSettings.enabled)
+		{
+			// ia: every snake's tube, a strip per segment cut by SnakeTubeRestart
+			UINT tubeIndices = UploadSnakeTubes();
+			stride = sizeof(VertexPosition);
+			offset = 0;
+			context->IASetVertexBuffers(0, 1, m_snakeTubeVertices.GetAddressOf(), &stride, &offset);
+			context->IASetIndexBuffer(m_snakeTubeIndices.Get(), DXGI_FORMAT_R32_UINT, 0);
+			context->IASetInputLayout(m_snakeTubeLayout.Get());
+			context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+			context->VSSetShader(m_snakeTubeVS.Get(), nullptr, 0);
+			context->GSSetShader(NULL, nullptr, 0);
+			context->DrawIndexed(tubeIndices, 0, 0);
+		}
+		else if (m_geometryExpansion == GeometryExpansion::Instanced)
+		{
+			// Every snake in one draw, a strip per segment pulled from the raw view
+			UINT snakeSegments = UploadSnakes();
+			context->IASetInputLayout(nullptr);
+			context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+			context->VSSetShader(m_snakePullVS.Get(), nullptr, 0);
+			context->VSSetShaderResources(0, 1, m_snakeBufferSRV.GetAddressOf());
+			context->GSSetShader(NULL, nullptr, 0);
+			context->DrawInstanced(SnakeSegmentVertices, snakeSegments, 0, 0);
+
+			ID3D11ShaderResourceView* nullSRV = nullptr;
+			context->VSSetShaderResources(0, 1, &nullSRV);
+		}
+		else
+		{
+			// ia: every snake's segments as one line list
+			UINT snakeSegments = UploadSnakes();
+			stride = sizeof(SnakeVertex);
+			offset = 0;
+			context->IASetVertexBuffers(0, 1, m_snakeBuffer.GetAddressOf(), &stride, &offset);
+			context->IASetInputLayout(m_snakePointsLayout.Get());
+			context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+			context->VSSetShader(m_snakeVS.Get(), nullptr, 0);
+
+			// gs
+			context->GSSetShader(m_snakeGS.Get(), nullptr, 0);
+			context->GSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
+			context->Draw(2 * snakeSegments, 0);
+		}
 #pragma endregion
 
 		//		// PARTICLES
 #pragma region PARTICLES
-		stride = sizeof(VertexPosition);
+		UINT firstCard = 0;
+		UINT cardCount = UploadVisibleGrass(firstCard);
+		DrawGrassGround();
+		stride = sizeof(GrassCard);
 		offset = 0;
 		context->IASetVertexBuffers(0, 1, m_grassBuffer.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_grassIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
-		context->IASetInputLayout(m_grassPointsLayout.Get());
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 		context->RSSetState(m_filledRasterState.Get());
 
-		context->VSSetShader(m_grassVertexShader.Get(), nullptr, 0);
 		context->VSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
 		context->HSSetShader(NULL, nullptr, 0);
 		context->DSSetShader(NULL, nullptr, 0);
 
-		context->GSSetShader(NULL, nullptr, 0);
-		context->GSSetShader(m_grassGS.Get(), nullptr, 0);
-		context->GSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
-		context->GSSetConstantBuffers(1, 1, m_timeBuffer.GetAddressOf());
-
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
 		context->PSSetShader(m_grassPS.Get(), nullptr, 0);
 		context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
 		context->PSSetShaderResources(0, 1, m_grassTexture.GetAddressOf());
-		context->DrawIndexed(m_grassIndexCount, 0, 0);
+
+		if (m_geometryExpansion == GeometryExpansion::Instanced)
+		{
+			// The cards are the instance data; firstCard offsets the instances into the ring
+			context->IASetInputLayout(m_grassInstancedLayout.Get());
+			context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+			context->VSSetShader(m_grassInstancedVS.Get(), nullptr, 0);
+			context->VSSetConstantBuffers(1, 1, m_timeBuffer.GetAddressOf());
+			context->GSSetShader(NULL, nullptr, 0);
+			context->DrawInstanced(GrassCardVertices, cardCount, 0, firstCard);
+		}
+		else
+		{
+			context->IASetInputLayout(m_grassPointsLayout.Get());
+			context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+			context->VSSetShader(m_grassVertexShader.Get(), nullptr, 0);
+
+			context->GSSetShader(m_grassGS.Get(), nullptr, 0);
+			context->GSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
+			context->GSSetConstantBuffers(1, 1, m_timeBuffer.GetAddressOf());
+			context->Draw(cardCount, firstCard);
+		}
 		//context->OMSetBlendState(NULL, 0, 0);
 #pragma endregion
 
-		// PARAMETRIC TORUS
-		context->RSSetState(m_filledNoCullRasterState.Get());
-		context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
-		context->IASetInputLayout(m_parametricIL.Get());
-
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
-		context->VSSetShader(m_parametricVS.Get(), nullptr, 0);
-		context->PSSetShader(m_parametricPS.Get(), nullptr, 0);
-		context->PSSetShaderResources(0, 1, m_metalTexture.GetAddressOf());
-		context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
-
-		context->HSSetShader(m_parametricHS.Get(), nullptr, 0);
-		context->DSSetShader(m_parametricDS.Get(), nullptr, 0);
-		context->DSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
-
-		context->GSSetShader(NULL, nullptr, 0);
-		context->DrawIndexed(m_indexCount, 0, 0);
-
-		// PARAMETRIC ELLIPSOID
-		context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
-		context->IASetInputLayout(m_parametricIL.Get());
-
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
-		context->VSSetShader(m_parametricVS.Get(), nullptr, 0);
-		context->PSSetShader(m_parametricPS.Get(), nullptr, 0);
-		context->PSSetShaderResources(0, 1, m_metalTexture.GetAddressOf());
-		context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
-
-		context->HSSetShader(m_parametricEllipsoidHS.Get(), nullptr, 0);
-		context->DSSetShader(m_parametricEllipsoidDS.Get(), nullptr, 0);
-
-		context->DSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
-
-		context->GSSetShader(NULL, nullptr, 0);
-		context->DrawIndexed(m_indexCount, 0, 0);
-
-		// PARAMETRIC SPHERE
-		context->RSSetState(m_wireframeRasterState.Get());
-		context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
-		context->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, .0);
-		context->IASetInputLayout(m_parametricIL.Get());
-
-		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
-		context->VSSetShader(m_parametricVS.Get(), nullptr, 0);
-		context->PSSetShader(m_parametricSpherePS.Get(), nullptr, 0);
-		context->PSSetShaderResources(0, 1, m_metalTexture.GetAddressOf());
-		context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
-
-		context->HSSetShader(m_parametricSphereHS.Get(), nullptr, 0);
-		context->DSSetShader(m_parametricSphereDS.Get(), nullptr, 0);
-		context->DSSetSamplers(0, 1, m_sampler.GetAddressOf());
-		context->DSSetShaderResources(0, 1, m_floorDisp.GetAddressOf());
-		context->DSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
-		context->DSSetConstantBuffers1(1, 1, m_displacementBuffer.GetAddressOf(), nullptr, nullptr);
-
-		context->GSSetShader(NULL, nullptr, 0);
-		context->DrawIndexed(m_indexCount, 0, 0);
+		// PARAMETRIC SURFACES
+		if (m_isParametricCached)
+		{
+			DrawParametricMeshes();
+		}
+		else
+		{
+			// One instanced draw for the solid objects and one for the wireframe ones.
+			BindParametricPatches();
+			context->GSSetShader(NULL, nullptr, 0);
+			context->PSSetShader(m_parametricPS.Get(), nullptr, 0);
+			context->PSSetShaderResources(0, 1, m_metalTexture.GetAddressOf());
+			context->PSSetSamplers(0, 1, m_sampler.GetAddressOf());
+
+			int solidShapes = ParametricSolidShapeCount();
+			context->RSSetState(m_filledNoCullRasterState.Get());
+			context->DrawIndexedInstanced(3, solidShapes, 0, 0, 0);
+			context->RSSetState(m_wireframeRasterState.Get());
+			context->DrawIndexedInstanced(3, ParametricShapeCount - solidShapes, 0, 0, solidShapes);
+		}
 	}
 	// IMPLICIT
 	else
@@ -327,7 +756,7 @@ void Sample3DSceneRenderer::Render()
 		context->VSSetShader(m_implicitVS.Get(), nullptr, 0);
 		context->VSSetConstantBuffers1(0, 1, m_constantBuffer.GetAddressOf(), nullptr, nullptr);
 
-		context->PSSetShader(m_implicitPS.Get(), nullptr, 0);
+		context->PSSetShader(m_implicitScenePS[ImplicitSceneIndex()].Get(), nullptr, 0);
 		context->PSSetConstantBuffers(0, 1, m_timeBuffer.GetAddressOf());
 		context->PSSetConstantBuffers(1, 1, m_controlBuffer.GetAddressOf());
 
@@ -335,8 +764,38 @@ void Sample3DSceneRenderer::Render()
 		context->HSSetShader(NULL, nullptr, 0);
 		context->GSSetShader(NULL, nullptr, 0);
 
-		context->DrawIndexed(m_implicitIndexCount, 0, 0);
-
+		if (m_isProgressive && m_implicitHistoryRTV)
+		{
+			// Trace this frame's slices into the history, then show the history. Misses blend
+			// away, leaving the background the history was cleared to.
+			if (m_implicitSlicesTraced == 0)
+			{
+				context->ClearRenderTargetView(m_implicitHistoryRTV.Get(), DirectX::Colors::Gray);
+			}
+
+			if (m_implicitFrameSlices > 0)
+			{
+				ID3D11RenderTargetView* const historyTargets[1] = { m_implicitHistoryRTV.Get() };
+				context->OMSetRenderTargets(1, historyTargets, nullptr);
+				context->OMSetBlendState(m_blend.Get(), 0, 0xffffffff);
+				context->DrawIndexed(m_implicitIndexCount, 0, 0);
+
+				m_implicitNextSlice = (m_implicitNextSlice + m_implicitFrameSlices) % ImplicitInterleave::SliceCount;
+				m_implicitSlicesTraced += m_implicitFrameSlices;
+				m_implicitLastFrameSlices = m_implicitFrameSlices;
+			}
+
+			Microsoft::WRL::ComPtr<ID3D11Resource> backBuffer;
+			m_deviceResources->GetBackBufferRenderTargetView()->GetResource(&backBuffer);
+			context->CopyResource(backBuffer.Get(), m_implicitHistory.Get());
+
+			ID3D11RenderTargetView* const screenTargets[1] = { m_deviceResources->GetBackBufferRenderTargetView() };
+			context->OMSetRenderTargets(1, screenTargets, m_deviceResources->GetDepthStencilView());
+		}
+		else
+		{
+			context->DrawIndexed(m_implicitIndexCount, 0, 0);
+		}
 	}
 }
 
@@ -418,8 +877,106 @@ void Sample3DSceneRenderer::KeyDown(const int keyCode)
 		m_displacementFactor -= 0.01f;
 	}
 
-	// Load the control CB
-	XMStoreFloat4(&m_controlBufferData.booleans, XMVECTORF32{ m_isRepeating, m_isDeforming, m_isFractal, m_isShiny });
+	// Relaxed / plain ray marching
+	if (keyCode == 57) // 9
+	{
+		m_isRelaxedMarch = !m_isRelaxedMarch;
+	}
+
+	// Fractal level of detail on / off
+	if (keyCode == 48) // 0
+	{
+		m_isFractalLod = !m_isFractalLod;
+	}
+
+	// Time-sliced / full implicit frames
+	if (keyCode == 80) // P
+	{
+		m_isProgressive = !m_isProgressive;
+	}
+
+	// Adaptive / fixed floor tessellation
+	if (keyCode == 84) // T
+	{
+		m_floorTessellation.adaptive = !m_floorTessellation.adaptive;
+	}
+
+	// Denser / coarser adaptive floor
+	if (keyCode == 187) // =
+	{
+		m_floorTessellation.trianglesPerPixel *= 2.0f;
+	}
+	if (keyCode == 189) // -
+	{
+		m_floorTessellation.trianglesPerPixel *= 0.5f;
+	}
+	UpdateFloorTessellationBuffer();
+
+	// Ten times more grass, back to the scene's after two million blades. The current field
+	// is drawn until the new one is scattered, and presses in the meantime are ignored.
+	if (keyCode == 71 && !m_grassRegenerating) // G
+	{
+		m_grassSettings.bladeCount = m_grassSettings.bladeCount >= 2000000 ? GrassFieldSettings().bladeCount : m_grassSettings.bladeCount * 10;
+		RegenerateGrassField();
+	}
+
+	// Grass LOD on / off
+	if (keyCode == 76) // L
+	{
+		m_grassLod.enabled = !m_grassLod.enabled;
+	}
+
+	// Ten times more snakes, each smaller, back to the scene's two after twenty thousand
+	if (keyCode == 78) // N
+	{
+		SnakeSwarmSettings scene;
+		m_snakeSettings.snakeCount = m_snakeSettings.snakeCount >= 20000 ? scene.snakeCount : m_snakeSettings.snakeCount * 10;
+		float size = sqrtf(static_cast<float>(scene.snakeCount) / m_snakeSettings.snakeCount);
+		m_snakeSettings.segmentLength = scene.segmentLength * size;
+		m_snakeSettings.radius = scene.radius * size;
+		m_snakeSettings.speed = scene.speed * size;
+		CreateSnakeSwarm();
+	}
+
+	// Follow-the-leader / spline snakes
+	if (keyCode == 75) // K
+	{
+		m_snakeSettings.skeleton = m_snakeSettings.skeleton == SnakeSkeleton::Spline ? SnakeSkeleton::FollowTheLeader : SnakeSkeleton::Spline;
+		CreateSnakeSwarm();
+	}
+
+	// Extruded / geometry shader snakes
+	if (keyCode == 69) // E
+	{
+		m_snakeTubeSettings.enabled = !m_snakeTubeSettings.enabled;
+	}
+
+	// Geometry shader / instanced grass and snakes
+	if (keyCode == 86) // V
+	{
+		m_geometryExpansion = m_geometryExpansion == GeometryExpansion::GeometryShader ? GeometryExpansion::Instanced : GeometryExpansion::GeometryShader;
+	}
+
+	// Cached / tessellated parametric surfaces
+	if (keyCode == 67) // C
+	{
+		m_isParametricCached = !m_isParametricCached;
+	}
+
+	// Coarser / finer parametric surfaces; each level is cached separately.
+	if (keyCode == 188 && m_parametricTessFactor > ParametricMinTessFactor) // ,
+	{
+		m_parametricTessFactor -= 2;
+	}
+	if (keyCode == 190 && m_parametricTessFactor < ParametricMaxTessFactor) // .
+	{
+		m_parametricTessFactor += 2;
+	}
+	XMStoreFloat4(&m_parametricTessellationBufferData.tessFactor, XMVECTORF32{ static_cast<float>(m_parametricTessFactor), 0.0f, 0.0f, 0.0f });
+
+	// Load the control CB; any change restarts the implicit history.
+	UpdateControlBuffer();
+	ResetImplicitHistory();
 	XMStoreFloat4(&m_displacementBufferData.displacementFactor, XMVECTORF32{ m_displacementFactor, 0.0f, 0.0f, 1.0f });
 }
 
@@ -432,24 +989,24 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 	auto loadVSTask3 = DX::ReadDataAsync(L"SnakeVS.cso");
 	auto loadVSTask4 = DX::ReadDataAsync(L"ImplicitVS.cso");
 	auto loadVSTask5 = DX::ReadDataAsync(L"ParametricVS.cso");
+	auto loadVSTask6 = DX::ReadDataAsync(L"ParametricCachedVS.cso");
+	auto loadVSTask7 = DX::ReadDataAsync(L"GrassGroundVS.cso");
+	auto loadVSTask8 = DX::ReadDataAsync(L"GrassInstancedVS.cso");
+	auto loadVSTask9 = DX::ReadDataAsync(L"SnakePullVS.cso");
+	auto loadVSTask10 = DX::ReadDataAsync(L"SnakeTubeVS.cso");
 
 	// PS
 	auto loadPSTask = DX::ReadDataAsync(L"SamplePixelShader.cso");
-	auto loadPSTask2 = DX::ReadDataAsync(L"ImplicitPixelShader.cso");
 	auto loadPSTask3 = DX::ReadDataAsync(L"SnakePS.cso");
 	auto loadPSTask4 = DX::ReadDataAsync(L"ParametricPS.cso");
 	auto loadPSTask5 = DX::ReadDataAsync(L"GrassPS.cso");
-	auto loadPSTask6 = DX::ReadDataAsync(L"ParametricSpherePS.cso");
+	auto loadPSTask6 = DX::ReadDataAsync(L"GrassGroundPS.cso");
 
 	// HS & DS
 	auto loadHSTask = DX::ReadDataAsync(L"HullShader.cso");
 	auto loadDSTask = DX::ReadDataAsync(L"DomainShader.cso");
 	auto loadHSTask2 = DX::ReadDataAsync(L"ParametricHS.cso");
 	auto loadDSTask2 = DX::ReadDataAsync(L"ParametricDS.cso");
-	auto loadHSTask3 = DX::ReadDataAsync(L"ParametricSphereHS.cso");
-	auto loadDSTask3 = DX::ReadDataAsync(L"ParametricSphereDS.cso");
-	auto loadHSTask4 = DX::ReadDataAsync(L"ParametricEllipsoidHS.cso");
-	auto loadDSTask4 = DX::ReadDataAsync(L"ParametricEllipsoidDS.cso");
 
 	// GS
 	auto loadGSParticleTask = DX::ReadDataAsync(L"GrassParticleGS.cso");
@@ -496,7 +1053,8 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 
 		static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "SCALE", 0, DXGI_FORMAT_R32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 		};
 
 		DX::ThrowIfFailed(
@@ -510,6 +1068,105 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 		);
 	});
 
+	// Grass Ground Layer Vertex Shader
+	auto createVSTask7 = loadVSTask7.then([this](const std::vector<byte>& fileData)
+	{
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateVertexShader(
+				&fileData[0],
+				fileData.size(),
+				nullptr,
+				&m_grassGroundVS
+			)
+		);
+
+		static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateInputLayout(
+				vertexDesc,
+				ARRAYSIZE(vertexDesc),
+				&fileData[0],
+				fileData.size(),
+				&m_grassGroundLayout
+			)
+		);
+	});
+
+	// Instanced Grass Vertex Shader: the GrassCards are per instance
+	auto createVSTask8 = loadVSTask8.then([this](const std::vector<byte>& fileData)
+	{
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateVertexShader(
+				&fileData[0],
+				fileData.size(),
+				nullptr,
+				&m_grassInstancedVS
+			)
+		);
+
+		static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "SCALE", 0, DXGI_FORMAT_R32_FLOAT, 0, 12, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		};
+
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateInputLayout(
+				vertexDesc,
+				ARRAYSIZE(vertexDesc),
+				&fileData[0],
+				fileData.size(),
+				&m_grassInstancedLayout
+			)
+		);
+	});
+
+	// Snake Vertex Pulling Shader: no input layout, it reads the segments itself
+	auto createVSTask9 = loadVSTask9.then([this](const std::vector<byte>& fileData)
+	{
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateVertexShader(
+				&fileData[0],
+				fileData.size(),
+				nullptr,
+				&m_snakePullVS
+			)
+		);
+	});
+
+	// Snake Tube Vertex Shader
+	auto createVSTask10 = loadVSTask10.then([this](const std::vector<byte>& fileData)
+	{
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateVertexShader(
+				&fileData[0],
+				fileData.size(),
+				nullptr,
+				&m_snakeTubeVS
+			)
+		);
+
+		static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateInputLayout(
+				vertexDesc,
+				ARRAYSIZE(vertexDesc),
+				&fileData[0],
+				fileData.size(),
+				&m_snakeTubeLayout
+			)
+		);
+	});
+
 	// Snake Vertex Shader
 	auto createVSTask3 = loadVSTask3.then([this](const std::vector<byte>& fileData)
 	{
@@ -524,7 +1181,8 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 
 		static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "RADIUS", 0, DXGI_FORMAT_R32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 		};
 
 		DX::ThrowIfFailed(
@@ -583,6 +1241,9 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 		{
 			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 			{ "COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "SURFACE", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "SURFACE", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "SURFACE", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
 		};
 
 		DX::ThrowIfFailed(
@@ -596,6 +1257,35 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 		);
 	});
 
+	// Parametric Cached Mesh Vertex Shader
+	auto createVSTask6 = loadVSTask6.then([this](const std::vector<byte>& fileData)
+	{
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateVertexShader(
+				&fileData[0],
+				fileData.size(),
+				nullptr,
+				&m_parametricCachedVS
+			)
+		);
+
+		static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateInputLayout(
+				vertexDesc,
+				ARRAYSIZE(vertexDesc),
+				&fileData[0],
+				fileData.size(),
+				&m_parametricCachedIL
+			)
+		);
+	});
+
 	// Basic Pixel Shader
 	auto createPSTask = loadPSTask.then([this](const std::vector<byte>& fileData) {
 		DX::ThrowIfFailed(
@@ -613,18 +1303,32 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 		result = CreateDDSTextureFromFile(m_deviceResources->GetD3DDevice(), L"mudDisprevised.dds", nullptr, &m_floorDisp);
 	});
 
-	// Implicit Pixel Shader = loadPS
-	auto createPSTask2 = loadPSTask2.then([this](const std::vector<byte>& fileData)
+	// Implicit Pixel Shaders, one permutation per scene (ImplicitSceneKernels.cpp)
+	static const wchar_t* implicitSceneShaders[ImplicitShaderCount] =
 	{
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreatePixelShader(
-				&fileData[0],
-				fileData.size(),
-				nullptr,
-				&m_implicitPS
-			)
-		);
-	});
+		L"ImplicitPixelShaderDefault.cso",
+		L"ImplicitPixelShaderRepeating.cso",
+		L"ImplicitPixelShaderDeforming.cso",
+		L"ImplicitPixelShaderFractal.cso",
+		L"ImplicitPixelShaderShiny.cso"
+	};
+
+	std::vector<concurrency::task<void>> implicitPSTasks;
+	for (int scene = 0; scene < ImplicitShaderCount; scene++)
+	{
+		implicitPSTasks.push_back(DX::ReadDataAsync(implicitSceneShaders[scene]).then([this, scene](const std::vector<byte>& fileData)
+		{
+			DX::ThrowIfFailed(
+				m_deviceResources->GetD3DDevice()->CreatePixelShader(
+					&fileData[0],
+					fileData.size(),
+					nullptr,
+					&m_implicitScenePS[scene]
+				)
+			);
+		}));
+	}
+	auto createPSTask2 = concurrency::when_all(implicitPSTasks.begin(), implicitPSTasks.end());
 
 	// Snake
 	auto createPSTask3 = loadPSTask3.then([this](const std::vector<byte>& fileData)
@@ -665,7 +1369,7 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 		);
 	});
 
-	// Param Sphere PS
+	// Grass Ground Layer PS
 	auto createPSTask6 = loadPSTask6.then([this](std::vector<byte>& fileData)
 	{
 		DX::ThrowIfFailed(
@@ -673,7 +1377,7 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 				&fileData[0],
 				fileData.size(),
 				nullptr,
-				&m_parametricSpherePS
+				&m_grassGroundPS
 			)
 		);
 	});
@@ -704,31 +1408,6 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 		);
 	});
 
-	// Parametric Sphere HS
-	auto createHSTask3 = loadHSTask3.then([this](std::vector<byte>& fileData)
-	{
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateHullShader(
-				&fileData[0],
-				fileData.size(),
-				nullptr,
-				&m_parametricSphereHS
-			)
-		);
-	});
-
-	auto createHSTask4 = loadHSTask4.then([this](std::vector<byte>& fileData)
-	{
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateHullShader(
-				&fileData[0],
-				fileData.size(),
-				nullptr,
-				&m_parametricEllipsoidHS
-			)
-		);
-	});
-
 	// Floor Quad Domain Shader
 	auto createDSTask = loadDSTask.then([this](const std::vector<byte>& fileData)
 	{
@@ -754,33 +1433,9 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 			)
 		);
 
-		HRESULT result = CreateDDSTextureFromFile(m_deviceResources->GetD3DDevice(), L"metal.dds", nullptr, &m_metalTexture);
-	});
+		CreateParametricStreamOut(m_deviceResources->GetD3DDevice(), fileData, &m_parametricStreamOut);
 
-	// Parametric Sphere Domain Shader
-	auto createDSTask3 = loadDSTask3.then([this](const std::vector<byte>&fileData)
-	{
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateDomainShader(
-				&fileData[0],
-				fileData.size(),
-				nullptr,
-				&m_parametricSphereDS
-			)
-		);
-	});
-
-	// Parametric Sphere Domain Shader
-	auto createDSTask4 = loadDSTask4.then([this](const std::vector<byte>&fileData)
-	{
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateDomainShader(
-				&fileData[0],
-				fileData.size(),
-				nullptr,
-				&m_parametricEllipsoidDS
-			)
-		);
+		HRESULT result = CreateDDSTextureFromFile(m_deviceResources->GetD3DDevice(), L"metal.dds", nullptr, &m_metalTexture);
 	});
 
 	// Particle Geometry Shader
@@ -817,164 +1472,16 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 	// Grass Plane Points
 	auto createGrassPlaneTask = (createPSTask && createVSTask && createHSTask && createDSTask && createGSParticleTask && createVSTask2 && createVSTask3 && createSnakeGSTask).then([this]()
 	{
-		//const float minX = -0.5f;
-		//const float maxX = 0.5f;
-		const float staticY = 0.04f;
-		//const float minZ = -0.5f;
-		//const float maxZ = 0.5f;
-
-		static VertexPosition grassPointsRandom[1000];
-		static unsigned int grassPointIndices[1000];
-
-		std::random_device random;
-		std::mt19937 mt(random());
-		std::uniform_real_distribution<float> distrib(-0.95f, 0.95f);
-		for (int i = 0; i < 200; i++)
-		{
-			grassPointsRandom[i] =
-				VertexPosition{ XMFLOAT3(distrib(mt), staticY, distrib(mt)) };
-
-			grassPointIndices[i] = i;
-		}
-
-		D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
-		vertexBufferData.pSysMem = grassPointsRandom;
-		vertexBufferData.SysMemPitch = 0;
-		vertexBufferData.SysMemSlicePitch = 0;
-		CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(grassPointsRandom), D3D11_BIND_VERTEX_BUFFER);
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateBuffer(
-				&vertexBufferDesc,
-				&vertexBufferData,
-				m_grassBuffer.GetAddressOf()
-			)
-		);
-
-		m_grassIndexCount = ARRAYSIZE(grassPointIndices);
-
-		D3D11_SUBRESOURCE_DATA indexBufferData = { 0 };
-		indexBufferData.pSysMem = grassPointIndices;
-		indexBufferData.SysMemPitch = 0;
-		indexBufferData.SysMemSlicePitch = 0;
-		CD3D11_BUFFER_DESC indexBufferDesc(sizeof(grassPointIndices), D3D11_BIND_INDEX_BUFFER);
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateBuffer(
-				&indexBufferDesc,
-				&indexBufferData,
-				&m_grassIndexBuffer
-			)
-		);
-
+		CreateGrassField();
 	});
 
-	// Snake Points
-	auto createSnakeTask = (createPSTask && createVSTask && createHSTask && createDSTask && createGSParticleTask && createVSTask2 && createVSTask3 && createSnakeGSTask).then([this]()
+	// Snake Swarm
+	auto createSnakeTask = (createVSTask3 && createSnakeGSTask && createVSTask9 && createVSTask10).then([this]()
 	{
-		static const VertexPosition snakePoints[] =
-		{
-			XMFLOAT3(-0.5f, 0.05f, -0.8f),
-			XMFLOAT3(-0.5f, 0.05f, -0.6f),
-			XMFLOAT3(-0.5f, 0.05f, -0.4f),
-			XMFLOAT3(-0.5f, 0.05f, -0.2f),
-			XMFLOAT3(-0.5f, 0.05f, 0.0f),
-			XMFLOAT3(-0.5f, 0.05f, 0.2f),
-			XMFLOAT3(-0.5f, 0.05f, 0.4f),
-			XMFLOAT3(-0.5f, 0.05f, 0.6f)
-		};
-
-		D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
-		vertexBufferData.pSysMem = snakePoints;
-		vertexBufferData.SysMemPitch = 0;
-		vertexBufferData.SysMemSlicePitch = 0;
-		CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(snakePoints), D3D11_BIND_VERTEX_BUFFER);
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateBuffer(
-				&vertexBufferDesc,
-				&vertexBufferData,
-				m_snakeBuffer.GetAddressOf()
-			)
-		);
-		static const unsigned short snakePointIndices[] =
-		{
-			0, 1,
-			1, 2,
-			2, 3,
-			3, 4,
-			4, 5,
-			5, 6,
-			6, 7
-		};
-
-		m_snakeIndexCount = ARRAYSIZE(snakePointIndices);
-
-		D3D11_SUBRESOURCE_DATA indexBufferData = { 0 };
-		indexBufferData.pSysMem = snakePointIndices;
-		indexBufferData.SysMemPitch = 0;
-		indexBufferData.SysMemSlicePitch = 0;
-		CD3D11_BUFFER_DESC indexBufferDesc(sizeof(snakePointIndices), D3D11_BIND_INDEX_BUFFER);
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateBuffer(
-				&indexBufferDesc,
-				&indexBufferData,
-				&m_snakeIndexBuffer
-			)
-		);
+		CreateSnakeSwarm();
 	});
-	auto createSnakeTask2 = (createPSTask && createVSTask && createHSTask && createDSTask && createGSParticleTask && createVSTask2 && createVSTask3 && createSnakeGSTask).then([this]()
-	{
-		static const VertexPosition snakePoints[] =
-		{
-			XMFLOAT3(0.5f, 0.05f, -0.8f),
-			XMFLOAT3(0.5f, 0.05f, -0.6f),
-			XMFLOAT3(0.5f, 0.05f, -0.4f),
-			XMFLOAT3(0.5f, 0.05f, -0.2f),
-			XMFLOAT3(0.5f, 0.05f, 0.0f),
-			XMFLOAT3(0.5f, 0.05f, 0.2f),
-			XMFLOAT3(0.5f, 0.05f, 0.4f),
-			XMFLOAT3(0.5f, 0.05f, 0.6f)
-		};
 
-		D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
-		vertexBufferData.pSysMem = snakePoints;
-		vertexBufferData.SysMemPitch = 0;
-		vertexBufferData.SysMemSlicePitch = 0;
-		CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(snakePoints), D3D11_BIND_VERTEX_BUFFER);
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateBuffer(
-				&vertexBufferDesc,
-				&vertexBufferData,
-				m_snakeBuffer2.GetAddressOf()
-			)
-		);
-		static const unsigned short snakePointIndices[] =
-		{
-			0, 1,
-			1, 2,
-			2, 3,
-			3, 4,
-			4, 5,
-			5, 6,
-			6, 7
-		};
-
-		m_snakeIndexCount = ARRAYSIZE(snakePointIndices);
-
-		D3D11_SUBRESOURCE_DATA indexBufferData = { 0 };
-		indexBufferData.pSysMem = snakePointIndices;
-		indexBufferData.SysMemPitch = 0;
-		indexBufferData.SysMemSlicePitch = 0;
-		CD3D11_BUFFER_DESC indexBufferDesc(sizeof(snakePointIndices), D3D11_BIND_INDEX_BUFFER);
-		DX::ThrowIfFailed(
-			m_deviceResources->GetD3DDevice()->CreateBuffer(
-				&indexBufferDesc,
-				&indexBufferData,
-				&m_snakeIndexBuffer2
-			)
-		);
-	});
-
-	// Floor Quad Mesh
-	auto createCubeTask = (createPSTask && createVSTask && createHSTask && createDSTask && createGSParticleTask && createVSTask2 && createVSTask3 && createSnakeGSTask && createDSTask2 && createHSTask2 && createDSTask3 && createHSTask3).then([this]() {
+	auto createCubeTask = (createPSTask && createVSTask && createHSTask && createDSTask && createGSParticleTask && createVSTask2 && createVSTask3 && createSnakeGSTask && createDSTask2 && createHSTask2).then([this]() {
 
 		// Load mesh vertices. Each vertex has a position and a color.
 		static const VertexPositionColor floorQuad[] =
@@ -1042,6 +1549,82 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 				m_indexBuffer.GetAddressOf()
 			)
 		);
+
+		// Floor patch grid. Each patch's corners are in DS_QuadTess's QuadPos order, (-x, -z),
+		// (-x, +z), (+x, -z), (+x, +z); the last patch is the whole floor.
+		const unsigned int gridPoints = FloorPatchGrid + 1;
+		std::vector<VertexPositionColor> floorPatchVertices;
+		for (unsigned int z = 0; z < gridPoints; z++)
+		{
+			for (unsigned int x = 0; x < gridPoints; x++)
+			{
+				float fx = -1.0f + 2.0f * x / FloorPatchGrid;
+				float fz = -1.0f + 2.0f * z / FloorPatchGrid;
+				floorPatchVertices.push_back({ XMFLOAT3(fx, 0.0f, fz), XMFLOAT3(0.0f, 0.0f, 0.0f) });
+			}
+		}
+
+		std::vector<unsigned short> floorPatchIndices;
+		auto addPatch = [&](unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1)
+		{
+			floorPatchIndices.push_back(static_cast<unsigned short>(z0 * gridPoints + x0));
+			floorPatchIndices.push_back(static_cast<unsigned short>(z1 * gridPoints + x0));
+			floorPatchIndices.push_back(static_cast<unsigned short>(z0 * gridPoints + x1));
+			floorPatchIndices.push_back(static_cast<unsigned short>(z1 * gridPoints + x1));
+		};
+		for (unsigned int z = 0; z < FloorPatchGrid; z++)
+		{
+			for (unsigned int x = 0; x < FloorPatchGrid; x++)
+			{
+				addPatch(x, z, x + 1, z + 1);
+			}
+		}
+		addPatch(0, 0, FloorPatchGrid, FloorPatchGrid);
+
+		m_floorPatchIndexCount = static_cast<uint32>(floorPatchIndices.size());
+
+		D3D11_SUBRESOURCE_DATA floorPatchVertexData = { 0 };
+		floorPatchVertexData.pSysMem = floorPatchVertices.data();
+		CD3D11_BUFFER_DESC floorPatchVertexDesc(static_cast<UINT>(floorPatchVertices.size() * sizeof(VertexPositionColor)), D3D11_BIND_VERTEX_BUFFER);
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateBuffer(
+				&floorPatchVertexDesc,
+				&floorPatchVertexData,
+				&m_floorPatchBuffer
+			)
+		);
+
+		D3D11_SUBRESOURCE_DATA floorPatchIndexData = { 0 };
+		floorPatchIndexData.pSysMem = floorPatchIndices.data();
+		CD3D11_BUFFER_DESC floorPatchIndexDesc(static_cast<UINT>(floorPatchIndices.size() * sizeof(unsigned short)), D3D11_BIND_INDEX_BUFFER);
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateBuffer(
+				&floorPatchIndexDesc,
+				&floorPatchIndexData,
+				&m_floorPatchIndexBuffer
+			)
+		);
+
+		// One instance per parametric object.
+		ParametricInstance parametricInstances[ParametricShapeCount];
+		for (int i = 0; i < ParametricShapeCount; i++)
+		{
+			const ParametricShape& shape = ParametricShapes[i];
+			parametricInstances[i].shape = XMFLOAT4(static_cast<float>(shape.surface), shape.size[0], shape.size[1], shape.size[2]);
+			parametricInstances[i].sweep = XMFLOAT4(shape.sweep[0], shape.sweep[1], 0.0f, 0.0f);
+			parametricInstances[i].offset = XMFLOAT4(shape.offset[0], shape.offset[1], shape.offset[2], shape.displacement);
+		}
+
+		D3D11_SUBRESOURCE_DATA parametricInstanceData = { 0 };
+		parametricInstanceData.pSysMem = parametricInstances;
+		CD3D11_BUFFER_DESC parametricInstanceDesc(sizeof(parametricInstances), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_IMMUTABLE);
+		DX::ThrowIfFailed(
+			m_deviceResources->GetD3DDevice()->CreateBuffer(
+				&parametricInstanceDesc,
+				&parametricInstanceData,
+				&m_parametricInstanceBuffer
+			)
+		);
 	});
 
 	// Implicit Placeholder 'Mesh'
@@ -1175,6 +1758,24 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 			)
 		});
 
+	CD3D11_BUFFER_DESC floorTessellationBufferDesc(sizeof(FloorTessellationBuffer), D3D11_BIND_CONSTANT_BUFFER);
+	DX::ThrowIfFailed(
+		m_deviceResources->GetD3DDevice()->CreateBuffer(
+			&floorTessellationBufferDesc,
+			nullptr,
+			m_floorTessellationBuffer.GetAddressOf()
+		)
+	);
+
+	CD3D11_BUFFER_DESC parametricTessellationBufferDesc(sizeof(ParametricTessellationBuffer), D3D11_BIND_CONSTANT_BUFFER);
+	DX::ThrowIfFailed(
+		m_deviceResources->GetD3DDevice()->CreateBuffer(
+			&parametricTessellationBufferDesc,
+			nullptr,
+			m_parametricTessellationBuffer.GetAddressOf()
+		)
+	);
+
 		// Sampler
 		D3D11_SAMPLER_DESC samplerDesc = CD3D11_SAMPLER_DESC(D3D11_DEFAULT);
 	DX::ThrowIfFailed(
@@ -1204,7 +1805,7 @@ void Sample3DSceneRenderer::CreateDeviceDependentResources()
 #pragma endregion
 
 	// Join block
-	createCubeTask.then([this]() {
+	(createCubeTask && createVSTask6 && createVSTask7 && createVSTask8 && createSnakeTask && createGrassPlaneTask && createPSTask6).then([this]() {
 		m_loadingComplete = true;
 	});
 
@@ -1219,6 +1820,8 @@ void Sample3DSceneRenderer::ReleaseDeviceDependentResources()
 	m_constantBuffer.Reset();
 	m_timeBuffer.Reset();
 	m_cameraBuffer.Reset();
+	m_floorTessellationBuffer.Reset();
+	m_parametricTessellationBuffer.Reset();
 
 	// COMMON
 	m_pixelShader.Reset();
@@ -1231,6 +1834,8 @@ void Sample3DSceneRenderer::ReleaseDeviceDependentResources()
 	m_inputLayout.Reset();
 	m_vertexBuffer.Reset();
 	m_indexBuffer.Reset();
+	m_floorPatchBuffer.Reset();
+	m_floorPatchIndexBuffer.Reset();
 	m_hullShader.Reset();
 	m_domainShader.Reset();
 
@@ -1240,14 +1845,43 @@ void Sample3DSceneRenderer::ReleaseDeviceDependentResources()
 	m_grassTexture.Reset();
 	m_grassPointsLayout.Reset();
 	m_grassBuffer.Reset();
-	m_grassIndexBuffer.Reset();
+	m_grassGroundVS.Reset();
+	m_grassGroundPS.Reset();
+	m_grassGroundLayout.Reset();
+	m_grassGroundBuffer.Reset();
+	m_grassGroundSRV.Reset();
+	m_grassGroundTexture.Reset();
+	m_grassInstancedVS.Reset();
+	m_grassInstancedLayout.Reset();
+
+	// IMPLICIT
+	m_implicitHistoryRTV.Reset();
+	m_implicitHistory.Reset();
 
 	// SNAKE
 	m_snakeGS.Reset();
 	m_snakeVS.Reset();
 	m_snakeBuffer.Reset();
-	m_snakeIndexBuffer.Reset();
+	m_snakeBufferSRV.Reset();
 	m_snakePointsLayout.Reset();
+	m_snakePullVS.Reset();
+	m_snakeTubeVS.Reset();
+	m_snakeTubeLayout.Reset();
+	m_snakeTubeVertices.Reset();
+	m_snakeTubeIndices.Reset();
+
+	// PARAMETRIC
+	for (int shape = 0; shape < ParametricShapeCount; shape++)
+	{
+		for (ParametricMesh& mesh : m_parametricMeshes[shape])
+		{
+			mesh.buffer.Reset();
+		}
+	}
+	m_parametricStreamOut.Reset();
+	m_parametricInstanceBuffer.Reset();
+	m_parametricCachedVS.Reset();
+	m_parametricCachedIL.Reset();
 
 	// D3D Resources
 	m_deviceResources.reset();
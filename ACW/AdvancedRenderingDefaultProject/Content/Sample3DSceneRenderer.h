@@ -2,6 +2,14 @@
 
 #include "..\Common\DeviceResources.h"
 #include "ShaderStructures.h"
+#include "FloorTessellation.h"
+#include "GrassField.h"
+#include "GeometryExpansion.h"
+#include "SnakeSwarm.h"
+#include "SnakeTube.h"
+#include "ParametricMeshCache.h"
+#include "ImplicitMarch.h"
+#include "ImplicitTimeSlicing.h"
 #include "..\Common\StepTimer.h"
 
 namespace AdvancedRenderingDefaultProject
@@ -25,6 +33,21 @@ namespace AdvancedRenderingDefaultProject
 
 	private:
 		void Rotate(float radians);
+		int ImplicitSceneIndex() const;
+		void UpdateControlBuffer();
+		void UpdateFloorTessellationBuffer();
+		void CreateGrassField();
+		void RegenerateGrassField();
+		void CreateGrassResources();
+		UINT UploadVisibleGrass(UINT& firstCard);
+		void DrawGrassGround();
+		void CreateSnakeSwarm();
+		UINT UploadSnakes();
+		UINT UploadSnakeTubes();
+		void BindParametricPatches();
+		ID3D11Buffer* UpdateParametricMesh(int shape);
+		void DrawParametricMeshes();
+		void ResetImplicitHistory();
 
 	private:
 		// Cached pointer to device resources.
@@ -43,37 +66,86 @@ namespace AdvancedRenderingDefaultProject
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_floorDisp;
 		uint32	m_indexCount;
 
-		// Particle Grass
+		// Floor patch grid, followed by one patch over the whole floor for the fixed factor.
+		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_floorPatchBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_floorPatchIndexBuffer;
+		uint32	m_floorPatchIndexCount;
+
+		// Particle Grass: the field's visible chunks are culled and given a LOD on the thread
+		// pool every frame, and their blade and clump cards written to a dynamic ring of points,
+		// which is drawn without an index buffer. Chunks too far for either tint the ground
+		// layer, one quad over the field textured with each chunk's coverage.
 		Microsoft::WRL::ComPtr<ID3D11VertexShader>	m_grassVertexShader;
 		Microsoft::WRL::ComPtr<ID3D11GeometryShader> m_grassGS;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_grassTexture;
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_grassPointsLayout;
 		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_grassBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_grassIndexBuffer;
 		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_grassPS;
-		uint32 m_grassIndexCount;
-
-		// Snake Polyline
+		Microsoft::WRL::ComPtr<ID3D11VertexShader>	m_grassGroundVS;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_grassGroundPS;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_grassGroundLayout;
+		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_grassGroundBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Texture2D>	m_grassGroundTexture;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_grassGroundSRV;
+		GrassFieldSettings m_grassSettings;
+		GrassLodSettings m_grassLod;
+		GrassField m_grassField;
+		GrassVisibleSet m_grassVisible;
+		GrassRing m_grassRing;
+		concurrency::task<std::shared_ptr<GrassField>> m_grassRegeneration;
+		bool m_grassRegenerating;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader>	m_grassInstancedVS;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_grassInstancedLayout;
+		std::shared_ptr<DX::ThreadPool> m_threadPool;
+
+		// Snake Polyline: the swarm is simulated on the thread pool and every snake's segments
+		// are written to one dynamic buffer a frame, read as a line list by the geometry shader
+		// path and through a raw view by the instanced one.
 		Microsoft::WRL::ComPtr<ID3D11VertexShader> m_snakeVS;
 		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_snakePS;
 		Microsoft::WRL::ComPtr<ID3D11GeometryShader> m_snakeGS;
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_snakePointsLayout;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> m_snakeBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> m_snakeIndexBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> m_snakeBuffer2;
-		Microsoft::WRL::ComPtr<ID3D11Buffer> m_snakeIndexBuffer2;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_snakeBufferSRV;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_snakeTex;
-		uint32 m_snakeIndexCount;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> m_snakePullVS;
+		SnakeSwarmSettings m_snakeSettings;
+		SnakeSwarm m_snakeSwarm;
+
+		// Snake Tubes: the swarm extruded on the CPU, drawn as indexed strips instead
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> m_snakeTubeVS;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_snakeTubeLayout;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_snakeTubeVertices;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_snakeTubeIndices;
+		SnakeTubeSettings m_snakeTubeSettings;
+		SnakeTube m_snakeTube;
+
+		// Whether the grass and snakes are expanded by their geometry shaders or drawn instanced
+		GeometryExpansion m_geometryExpansion;
 
 		// Implicit Objects
 		Microsoft::WRL::ComPtr<ID3D11VertexShader> m_implicitVS;
-		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_implicitPS;
+		// One pixel shader per ImplicitSceneType (ImplicitScene.h isn't included here).
+		static const int ImplicitShaderCount = 5;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_implicitScenePS[ImplicitShaderCount];
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_implicitInput;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> m_implicitBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> m_implicitIndexBuffer;
 		uint32 m_implicitIndexCount;
 
-		// Parametric Torus Object
+		// Time-sliced implicit rendering. Each frame traces the slices the budget allows into a
+		// history target the size of the back buffer, which is then copied to the screen. The
+		// implicit eye is fixed, so once every slice has been traced the history is the frame.
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> m_implicitHistory;
+		Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_implicitHistoryRTV;
+		ImplicitFrameBudget m_implicitBudget;
+		unsigned int m_implicitNextSlice = 0;
+		unsigned int m_implicitSlicesTraced = 0;	// since the history was cleared
+		unsigned int m_implicitFrameSlices = 0;		// to trace in the coming frame
+		unsigned int m_implicitLastFrameSlices = 0;
+
+		// Parametric Objects: every ParametricShape is an instance of the same patch, drawn with
+		// one shader set.
 		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_parametricIL;
 		Microsoft::WRL::ComPtr<ID3D11VertexShader> m_parametricVS;
 		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_parametricPS;
@@ -81,17 +153,21 @@ namespace AdvancedRenderingDefaultProject
 		Microsoft::WRL::ComPtr<ID3D11DomainShader> m_parametricDS;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> m_parametricBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> m_parametricIndexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_parametricInstanceBuffer;
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_metalTexture;
 		uint32 m_parametricIndexCount;
 
-		// Parametric Sphere Object
-		Microsoft::WRL::ComPtr<ID3D11HullShader> m_parametricSphereHS;
-		Microsoft::WRL::ComPtr<ID3D11DomainShader> m_parametricSphereDS;
-		Microsoft::WRL::ComPtr<ID3D11PixelShader> m_parametricSpherePS;
-
-		// Param Ellipsoid
-		Microsoft::WRL::ComPtr<ID3D11HullShader> m_parametricEllipsoidHS;
-		Microsoft::WRL::ComPtr<ID3D11DomainShader> m_parametricEllipsoidDS;
+		// Parametric Mesh Cache: each object's domain shader output, streamed out once per
+		// even tess factor and drawn from then on with a plain vertex shader.
+		struct ParametricMesh
+		{
+			Microsoft::WRL::ComPtr<ID3D11Buffer>	buffer;
+			ParametricMeshKey						key;
+		};
+		Microsoft::WRL::ComPtr<ID3D11GeometryShader> m_parametricStreamOut;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> m_parametricCachedVS;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> m_parametricCachedIL;
+		ParametricMesh m_parametricMeshes[ParametricShapeCount][ParametricMaxTessFactor / 2];
 
 		// Constant Buffers
 		ModelViewProjectionConstantBuffer	m_constantBufferData;
@@ -99,12 +175,16 @@ namespace AdvancedRenderingDefaultProject
 		CameraBuffer m_cameraBufferData;
 		ControlBuffer m_controlBufferData;
 		DisplacementBuffer m_displacementBufferData;
+		FloorTessellationBuffer m_floorTessellationBufferData;
+		ParametricTessellationBuffer m_parametricTessellationBufferData;
 
 		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_constantBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_timeBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_cameraBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_controlBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_displacementBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_floorTessellationBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer>		m_parametricTessellationBuffer;
 		// Rasterizer States
 		Microsoft::WRL::ComPtr<ID3D11RasterizerState> m_wireframeRasterState;
 		Microsoft::WRL::ComPtr<ID3D11RasterizerState> m_filledRasterState;
@@ -126,8 +206,14 @@ namespace AdvancedRenderingDefaultProject
 		float m_isDeforming = 0;
 		float m_isFractal = 0;
 		float m_isShiny = 0;
+		bool m_isRelaxedMarch = false;
+		bool m_isFractalLod = true;
+		bool m_isProgressive = true;
 
 		float m_displacementFactor = 0.01f;
+		FloorTessellationSettings m_floorTessellation;
+		bool m_isParametricCached = true;
+		unsigned int m_parametricTessFactor = ParametricDefaultTessFactor;
 
 		// Variables used with the rendering loop.
 		bool	m_loadingComplete;
@@ -0,0 +1,319 @@
+#include "SdfBrickMap.h"
+#include "SdfScene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace AdvancedRenderingDefaultProject::Implicit;
+
+namespace
+{
+	const uint32_t EmptyBrick = 0xffffffffu;
+	const float HitVoxelFraction = 0.25f;
+
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000u;
+		int exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+		uint32_t mantissa = bits & 0x7fffffu;
+
+		if (exponent <= 0)
+		{
+			// Denormal or zero; round to nearest on the bit shifted out last.
+			if (exponent < -10)
+			{
+				return static_cast<uint16_t>(sign);
+			}
+			mantissa |= 0x800000u;
+			unsigned int shift = static_cast<unsigned int>(14 - exponent);
+			uint32_t half = mantissa >> shift;
+			if ((mantissa >> (shift - 1)) & 1u)
+			{
+				half++;
+			}
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		if (exponent >= 31)
+		{
+			return static_cast<uint16_t>(sign | 0x7c00u);
+		}
+
+		uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		if (mantissa & 0x1000u)
+		{
+			half++;
+		}
+		return static_cast<uint16_t>(half);
+	}
+
+	float HalfToFloat(uint16_t half)
+	{
+		uint32_t sign = (half & 0x8000u) << 16;
+		uint32_t exponent = (half >> 10) & 0x1fu;
+		uint32_t mantissa = half & 0x3ffu;
+
+		if (exponent == 0)
+		{
+			float value = std::ldexp(static_cast<float>(mantissa), -24);
+			return sign ? -value : value;
+		}
+
+		uint32_t bits = exponent == 31
+			? sign | 0x7f800000u | (mantissa << 13)
+			: sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+void AdvancedRenderingDefaultProject::ImplicitBakeBounds(ImplicitSceneType scene, DX::float3& boundsMin, DX::float3& boundsMax)
+{
+	if (scene == ImplicitSceneType::Fractal)
+	{
+		// The folds keep the attractor inside the tetrahedron with corners at +-1.
+		boundsMin = DX::float3(-1.0f);
+		boundsMax = DX::float3(1.0f);
+	}
+	else
+	{
+		CreateImplicitSdfScene(scene).GetBounds(boundsMin, boundsMax);
+	}
+
+	// Repetition runs forever along z; keep the part in front of the camera.
+	boundsMin.z = std::max(boundsMin.z, eyePos.z - 60.0f);
+	boundsMax.z = std::min(boundsMax.z, eyePos.z);
+
+	boundsMin = boundsMin - DX::float3(0.25f);
+	boundsMax = boundsMax + DX::float3(0.25f);
+}
+
+SdfBakeStats SdfBrickMap::Bake(const SdfBakeSettings& settings, DX::ThreadPool& threadPool)
+{
+	SdfBakeStats stats;
+	auto start = std::chrono::high_resolution_clock::now();
+
+	DX::float3 boundsMin = settings.boundsMin;
+	DX::float3 boundsMax = settings.boundsMax;
+	if (boundsMin.x == boundsMax.x && boundsMin.y == boundsMax.y && boundsMin.z == boundsMax.z)
+	{
+		ImplicitBakeBounds(settings.scene, boundsMin, boundsMax);
+	}
+
+	m_grid.clear();
+	m_coarse.clear();
+	m_samples8.clear();
+	m_samples16.clear();
+
+	// One empty brick of padding on every side, so no surface lies near the edge of the grid.
+	// The brick counts are checked in double before they are stored, as a tiny or infinite
+	// brick size would overflow them.
+	const float brickSize = settings.voxelSize * BrickCells;
+	DX::float3 extent = boundsMax - boundsMin;
+	const double dims[3] =
+	{
+		std::ceil(static_cast<double>(extent.x) / brickSize) + 2.0,
+		std::ceil(static_cast<double>(extent.y) / brickSize) + 2.0,
+		std::ceil(static_cast<double>(extent.z) / brickSize) + 2.0
+	};
+	if (!(settings.voxelSize > 0.0f) || !std::isfinite(brickSize) ||
+		!(dims[0] >= 1.0 && dims[1] >= 1.0 && dims[2] >= 1.0 && dims[0] * dims[1] * dims[2] <= MaxGridBricks))
+	{
+		m_dims[0] = m_dims[1] = m_dims[2] = 0;
+		return stats;
+	}
+
+	const float halfDiagonal = 0.5f * std::sqrt(3.0f) * brickSize;
+	const float keepDistance = halfDiagonal + 2.0f * settings.voxelSize;
+
+	m_voxelSize = settings.voxelSize;
+	m_format = settings.format;
+	m_band = keepDistance + halfDiagonal;
+	m_origin = boundsMin - DX::float3(brickSize);
+
+	m_dims[0] = static_cast<unsigned int>(dims[0]);
+	m_dims[1] = static_cast<unsigned int>(dims[1]);
+	m_dims[2] = static_cast<unsigned int>(dims[2]);
+
+	const size_t gridBricks = static_cast<size_t>(m_dims[0]) * m_dims[1] * m_dims[2];
+	m_grid.assign(gridBricks, EmptyBrick);
+	m_coarse.assign(gridBricks, 0.0f);
+
+	const ImplicitSceneType scene = settings.scene;
+	auto brickOrigin = [this, brickSize](size_t brick)
+	{
+		unsigned int x = static_cast<unsigned int>(brick % m_dims[0]);
+		unsigned int y = static_cast<unsigned int>(brick / m_dims[0] % m_dims[1]);
+		unsigned int z = static_cast<unsigned int>(brick / (static_cast<size_t>(m_dims[0]) * m_dims[1]));
+		return m_origin + DX::float3(x * brickSize, y * brickSize, z * brickSize);
+	};
+
+	// Pass 1: classify bricks by the distance at their centre.
+	threadPool.ParallelFor(gridBricks, [&](size_t brick)
+	{
+		float centre = sceneDistFunc(scene, brickOrigin(brick) + DX::float3(0.5f * brickSize));
+		m_coarse[brick] = centre < 0.0f ? centre + halfDiagonal : centre - halfDiagonal;
+		m_grid[brick] = std::fabs(centre) < keepDistance ? 0u : EmptyBrick;
+	});
+
+	std::vector<size_t> kept;
+	for (size_t brick = 0; brick < gridBricks; brick++)
+	{
+		if (m_grid[brick] != EmptyBrick)
+		{
+			m_grid[brick] = static_cast<uint32_t>(kept.size());
+			kept.push_back(brick);
+		}
+	}
+
+	// Pass 2: sample the corners of every voxel in the kept bricks.
+	const size_t samplesPerBrick = BrickSamples * BrickSamples * BrickSamples;
+	if (m_format == SdfBrickFormat::Half)
+	{
+		m_samples16.resize(kept.size() * samplesPerBrick);
+	}
+	else
+	{
+		m_samples8.resize(kept.size() * samplesPerBrick);
+	}
+
+	threadPool.ParallelFor(kept.size(), [&](size_t slot)
+	{
+		DX::float3 corner = brickOrigin(kept[slot]);
+		size_t index = slot * samplesPerBrick;
+
+		for (unsigned int z = 0; z < BrickSamples; z++)
+		{
+			for (unsigned int y = 0; y < BrickSamples; y++)
+			{
+				for (unsigned int x = 0; x < BrickSamples; x++, index++)
+				{
+					float d = sceneDistFunc(scene, corner + DX::float3(x * m_voxelSize, y * m_voxelSize, z * m_voxelSize));
+
+					if (m_format == SdfBrickFormat::Half)
+					{
+						m_samples16[index] = FloatToHalf(d);
+					}
+					else
+					{
+						float q = std::round(DX::clamp(d / m_band, -1.0f, 1.0f) * 127.0f) + 128.0f;
+						m_samples8[index] = static_cast<uint8_t>(q);
+					}
+				}
+			}
+		}
+	});
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.seconds = std::chrono::duration<double>(end - start).count();
+	stats.bricks = static_cast<unsigned int>(kept.size());
+	stats.gridBricks = static_cast<unsigned int>(gridBricks);
+	stats.bytes = GetMemoryBytes();
+	return stats;
+}
+
+float SdfBrickMap::LoadSample(size_t index) const
+{
+	if (m_format == SdfBrickFormat::Half)
+	{
+		return HalfToFloat(m_samples16[index]);
+	}
+
+	return (static_cast<float>(m_samples8[index]) - 128.0f) * (m_band / 127.0f);
+}
+
+float SdfBrickMap::Sample(const DX::float3& p) const
+{
+	const float brickSize = m_voxelSize * BrickCells;
+	DX::float3 local = (p - m_origin) / brickSize;
+	DX::float3 dims(static_cast<float>(m_dims[0]), static_cast<float>(m_dims[1]), static_cast<float>(m_dims[2]));
+
+	if (local.x < 0.0f || local.y < 0.0f || local.z < 0.0f || local.x >= dims.x || local.y >= dims.y || local.z >= dims.z)
+	{
+		// Outside the grid, the padding brick guarantees the surface is at least this far.
+		DX::float3 outside = max(max(-local, local - dims), 0.0f);
+		return length(outside) * brickSize + 0.5f * brickSize;
+	}
+
+	unsigned int bx = static_cast<unsigned int>(local.x);
+	unsigned int by = static_cast<unsigned int>(local.y);
+	unsigned int bz = static_cast<unsigned int>(local.z);
+	size_t brick = (static_cast<size_t>(bz) * m_dims[1] + by) * m_dims[0] + bx;
+
+	uint32_t slot = m_grid[brick];
+	if (slot == EmptyBrick)
+	{
+		return m_coarse[brick];
+	}
+
+	// Voxel within the brick and the position inside it.
+	DX::float3 cell = (local - DX::float3(static_cast<float>(bx), static_cast<float>(by), static_cast<float>(bz))) * static_cast<float>(BrickCells);
+	unsigned int cx = std::min(static_cast<unsigned int>(cell.x), BrickCells - 1);
+	unsigned int cy = std::min(static_cast<unsigned int>(cell.y), BrickCells - 1);
+	unsigned int cz = std::min(static_cast<unsigned int>(cell.z), BrickCells - 1);
+	DX::float3 t = cell - DX::float3(static_cast<float>(cx), static_cast<float>(cy), static_cast<float>(cz));
+
+	size_t base = static_cast<size_t>(slot) * BrickSamples * BrickSamples * BrickSamples
+		+ (static_cast<size_t>(cz) * BrickSamples + cy) * BrickSamples + cx;
+	const size_t strideY = BrickSamples;
+	const size_t strideZ = BrickSamples * BrickSamples;
+
+	float c000 = LoadSample(base), c100 = LoadSample(base + 1);
+	float c010 = LoadSample(base + strideY), c110 = LoadSample(base + strideY + 1);
+	float c001 = LoadSample(base + strideZ), c101 = LoadSample(base + strideZ + 1);
+	float c011 = LoadSample(base + strideZ + strideY), c111 = LoadSample(base + strideZ + strideY + 1);
+
+	float c00 = DX::lerp(c000, c100, t.x), c10 = DX::lerp(c010, c110, t.x);
+	float c01 = DX::lerp(c001, c101, t.x), c11 = DX::lerp(c011, c111, t.x);
+
+	return DX::lerp(DX::lerp(c00, c10, t.y), DX::lerp(c01, c11, t.y), t.z);
+}
+
+float SdfBrickMap::March(const Ray& ray, float start, float end, int* steps) const
+{
+	// Detail below a voxel is not in the field (the fractal dust never gets within EPSILON of
+	// zero once interpolated), so the surface is taken a fraction of a voxel out.
+	const float hitDistance = std::max(EPSILON, HitVoxelFraction * m_voxelSize);
+	float depth = start;
+	int i = 0;
+	float result = end;
+
+	for (; i < MAX_MARCH; i++)
+	{
+		float dist = Sample(ray.origin + depth * ray.direction);
+		if (dist < hitDistance)
+		{
+			result = depth;
+			i++;
+			break;
+		}
+
+		depth += dist;
+		if (depth >= end)
+		{
+			i++;
+			break;
+		}
+	}
+
+	if (steps)
+	{
+		*steps = i;
+	}
+
+	return result;
+}
+
+size_t SdfBrickMap::GetMemoryBytes() const
+{
+	return m_grid.size() * sizeof(uint32_t) + m_coarse.size() * sizeof(float)
+		+ m_samples8.size() * sizeof(uint8_t) + m_samples16.size() * sizeof(uint16_t);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ImplicitScene.h"
+#include "../Common/ThreadPool.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace AdvancedRenderingDefaultProject
+{
+	enum class SdfBrickFormat
+	{
+		Unorm8,		// distance / band quantised to 8 bits, 0 maps exactly to 128
+		Half		// IEEE half floats
+	};
+
+	struct SdfBakeSettings
+	{
+		ImplicitSceneType	scene = ImplicitSceneType::Default;
+		SdfBrickFormat		format = SdfBrickFormat::Unorm8;
+		float				voxelSize = 0.05f;
+
+		// World region to bake. Leave min == max to use ImplicitBakeBounds(scene).
+		DX::float3			boundsMin;
+		DX::float3			boundsMax;
+	};
+
+	struct SdfBakeStats
+	{
+		double				seconds = 0.0;
+		unsigned int		bricks = 0;			// bricks stored
+		unsigned int		gridBricks = 0;		// bricks in the dense grid
+		size_t				bytes = 0;
+	};
+
+	// Sparse signed distance field baked from sceneDistFunc. Space is cut into bricks of
+	// BrickCells^3 voxels; only bricks the surface can pass through keep their (BrickCells + 1)^3
+	// corner samples, so trilinear lookups never cross a brick. Every other brick stores one
+	// conservative distance (centre distance minus half its diagonal) that the marcher steps by.
+	class SdfBrickMap
+	{
+	public:
+		static const unsigned int BrickCells = 8;
+		static const unsigned int BrickSamples = BrickCells + 1;
+
+		// Largest dense grid Bake builds, 128 MB of grid and coarse bounds.
+		static const size_t MaxGridBricks = 1 << 24;
+
+		SdfBrickMap() : m_voxelSize(0.0f), m_band(0.0f), m_dims{ 0, 0, 0 }, m_format(SdfBrickFormat::Unorm8) {}
+
+		// Bakes nothing and leaves the map empty when the voxel size isn't positive and finite
+		// or the bounds need more than MaxGridBricks bricks at it.
+		SdfBakeStats Bake(const SdfBakeSettings& settings, DX::ThreadPool& threadPool);
+
+		// Field value at p: trilinear inside stored bricks, the brick bound elsewhere and the
+		// distance to the baked region outside it.
+		float Sample(const DX::float3& p) const;
+
+		// Sphere tracing against the baked field, as shortestDistanceToSurface.
+		float March(const Implicit::Ray& ray, float start, float end, int* steps = nullptr) const;
+
+		size_t GetMemoryBytes() const;
+		bool IsEmpty() const { return m_grid.empty(); }
+
+	private:
+		float LoadSample(size_t index) const;
+
+	private:
+		DX::float3					m_origin;
+		float						m_voxelSize;
+		float						m_band;			// Unorm8 quantisation range, +-band
+		unsigned int				m_dims[3];		// grid size in bricks
+		SdfBrickFormat				m_format;
+
+		// Per grid brick: index into the sample pool, or EmptyBrick with the bound in m_coarse.
+		std::vector<uint32_t>		m_grid;
+		std::vector<float>			m_coarse;
+		std::vector<uint8_t>		m_samples8;
+		std::vector<uint16_t>		m_samples16;
+	};
+
+	// Padded box around the visible geometry of a scene; the repeating scene is cut to the
+	// stretch of z the camera can see.
+	void ImplicitBakeBounds(ImplicitSceneType scene, DX::float3& boundsMin, DX::float3& boundsMax);
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "ImplicitScene.h"
+
+#include <cstdio>
+#include <string>
+
+// Compile-time SDF expressions. A scene is a nested type such as
+// Union<Sphere, Translate<Cube>>, so Evaluate() inlines into one straight-line kernel with no
+// per-step scene branching, and ToHlsl() prints the same tree as an HLSL expression for a
+// specialised pixel shader. DistGrad() / ToHlslGradient() do the same for float4(gradient,
+// distance), giving analytic normals wherever the leaves have them. Leaves call the
+// shader-named functions in ImplicitScene.h and the operators follow unionDF/intersectDF/diffDF,
+// so Evaluate() matches sceneDistFunc bit for bit.
+namespace AdvancedRenderingDefaultProject
+{
+	namespace Sdf
+	{
+		using DX::float2;
+		using DX::float3;
+		using DX::float4;
+
+		// Float literal that reads back as the same float in HLSL.
+		inline std::string HlslFloat(float value)
+		{
+			char text[32];
+			std::snprintf(text, sizeof(text), "%.9g", value);
+
+			std::string literal(text);
+			if (literal.find_first_of(".e") == std::string::npos)
+			{
+				literal += ".0";
+			}
+			return literal + "f";
+		}
+
+		inline std::string HlslFloat3(const float3& v)
+		{
+			return "float3(" + HlslFloat(v.x) + ", " + HlslFloat(v.y) + ", " + HlslFloat(v.z) + ")";
+		}
+
+		// Tetrahedral differences of one leaf, for the primitives without a closed-form gradient.
+		// Same offsets as TETRA_A..D in ImplicitPixelShader.hlsl.
+		template <typename Leaf>
+		float4 TetraDistGrad(const Leaf& leaf, const float3& p)
+		{
+			const float h = Implicit::EPSILON;
+			const float3 a(1.0f, -1.0f, -1.0f), b(-1.0f, -1.0f, 1.0f), c(-1.0f, 1.0f, -1.0f), d(1.0f, 1.0f, 1.0f);
+			float3 gradient = a * leaf.Evaluate(p + a * h) + b * leaf.Evaluate(p + b * h) + c * leaf.Evaluate(p + c * h) + d * leaf.Evaluate(p + d * h);
+			return float4(gradient, leaf.Evaluate(p));
+		}
+
+		// PRIMITIVES
+		struct Sphere
+		{
+			float radius;
+
+			float Evaluate(const float3& p) const { return Implicit::sphereDistFunc(p, radius); }
+			std::string ToHlsl(const std::string& p) const { return "sphereDistFunc(" + p + ", " + HlslFloat(radius) + ")"; }
+			float4 DistGrad(const float3& p) const { return float4(normalize(p), Evaluate(p)); }
+			std::string ToHlslGradient(const std::string& p) const { return "sphereDG(" + p + ", " + HlslFloat(radius) + ")"; }
+		};
+
+		struct Cube
+		{
+			float Evaluate(const float3& p) const { return Implicit::cubeDistFunc(p); }
+			std::string ToHlsl(const std::string& p) const { return "cubeDistFunc(" + p + ")"; }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float3 dist = abs(p) - float3(1.0f, 1.0f, 1.0f);
+				float3 gradient;
+				if (std::max(dist.x, std::max(dist.y, dist.z)) > 0.0f)
+				{
+					gradient = max(dist, 0.0f);
+				}
+				else
+				{
+					// Inside: the face with the largest distance.
+					gradient = dist.x > dist.y && dist.x > dist.z ? float3(1.0f, 0.0f, 0.0f) : dist.y > dist.z ? float3(0.0f, 1.0f, 0.0f) : float3(0.0f, 0.0f, 1.0f);
+				}
+				return float4(gradient * float3(DX::sign(p.x), DX::sign(p.y), DX::sign(p.z)), Evaluate(p));
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "cubeDG(" + p + ")"; }
+		};
+
+		struct Torus
+		{
+			float radiusX;
+			float radiusY;
+
+			float Evaluate(const float3& p) const { return Implicit::torusDistFunc(p, float2(radiusX, radiusY)); }
+			std::string ToHlsl(const std::string& p) const { return "torusDistFunc(" + p + ", float2(" + HlslFloat(radiusX) + ", " + HlslFloat(radiusY) + "))"; }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float ring = length(p.xz());
+				float2 q = float2(ring - radiusX, p.y);
+				return float4(float3(q.x * p.x / ring, q.y, q.x * p.z / ring), Evaluate(p));
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "torusDG(" + p + ", float2(" + HlslFloat(radiusX) + ", " + HlslFloat(radiusY) + "))"; }
+		};
+
+		struct HexPrism
+		{
+			float hx;
+			float hy;
+
+			float Evaluate(const float3& p) const { return Implicit::hexDF(p, float2(hx, hy)); }
+			std::string ToHlsl(const std::string& p) const { return "hexDF(" + p + ", float2(" + HlslFloat(hx) + ", " + HlslFloat(hy) + "))"; }
+			float4 DistGrad(const float3& p) const { return TetraDistGrad(*this, p); }
+			std::string ToHlslGradient(const std::string& p) const { return "hexDG(" + p + ", float2(" + HlslFloat(hx) + ", " + HlslFloat(hy) + "))"; }
+		};
+
+		struct Octahedron
+		{
+			float size;
+
+			float Evaluate(const float3& p) const { return Implicit::octahedronDF(p, size); }
+			std::string ToHlsl(const std::string& p) const { return "octahedronDF(" + p + ", " + HlslFloat(size) + ")"; }
+			float4 DistGrad(const float3& p) const { return TetraDistGrad(*this, p); }
+			std::string ToHlslGradient(const std::string& p) const { return "octahedronDG(" + p + ", " + HlslFloat(size) + ")"; }
+		};
+
+		struct Tetrahedron
+		{
+			float Evaluate(const float3& p) const { return Implicit::tetraDF(p); }
+			std::string ToHlsl(const std::string& p) const { return "tetraDF(" + p + ")"; }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float a = std::fabs(p.x + p.y) - p.z;
+				float b = std::fabs(p.x - p.y) + p.z;
+				float3 gradient = a > b
+					? float3(DX::sign(p.x + p.y), DX::sign(p.x + p.y), -1.0f)
+					: float3(DX::sign(p.x - p.y), -DX::sign(p.x - p.y), 1.0f);
+				return float4(gradient, Evaluate(p));
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "tetraDG(" + p + ")"; }
+		};
+
+		struct FoldingFractal
+		{
+			float Evaluate(const float3& p) const { return Implicit::fractal(p); }
+			// The shader's march may swap in fractalLod; gradients always see the full fractal.
+			std::string ToHlsl(const std::string& p) const { return "fractalMarch(" + p + ")"; }
+			float4 DistGrad(const float3& p) const { return TetraDistGrad(*this, p); }
+			std::string ToHlslGradient(const std::string& p) const { return "fractalDG(" + p + ")"; }
+		};
+
+		// OPERATORS
+		template <typename A, typename B>
+		struct Union
+		{
+			A a;
+			B b;
+
+			float Evaluate(const float3& p) const { return Implicit::unionDF(a.Evaluate(p), b.Evaluate(p)); }
+			std::string ToHlsl(const std::string& p) const { return "unionDF(" + a.ToHlsl(p) + ", " + b.ToHlsl(p) + ")"; }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float4 da = a.DistGrad(p), db = b.DistGrad(p);
+				return da.w < db.w ? da : db;
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "unionDG(" + a.ToHlslGradient(p) + ", " + b.ToHlslGradient(p) + ")"; }
+		};
+
+		template <typename A, typename B>
+		struct Intersect
+		{
+			A a;
+			B b;
+
+			float Evaluate(const float3& p) const { return Implicit::intersectDF(a.Evaluate(p), b.Evaluate(p)); }
+			std::string ToHlsl(const std::string& p) const { return "intersectDF(" + a.ToHlsl(p) + ", " + b.ToHlsl(p) + ")"; }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float4 da = a.DistGrad(p), db = b.DistGrad(p);
+				return da.w > db.w ? da : db;
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "intersectDG(" + a.ToHlslGradient(p) + ", " + b.ToHlslGradient(p) + ")"; }
+		};
+
+		// a with b carved out.
+		template <typename A, typename B>
+		struct Diff
+		{
+			A a;
+			B b;
+
+			float Evaluate(const float3& p) const { return Implicit::diffDF(a.Evaluate(p), b.Evaluate(p)); }
+			std::string ToHlsl(const std::string& p) const { return "diffDF(" + a.ToHlsl(p) + ", " + b.ToHlsl(p) + ")"; }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float4 da = a.DistGrad(p), db = b.DistGrad(p);
+				return da.w > -db.w ? da : float4(-db.xyz(), -db.w);
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "diffDG(" + a.ToHlslGradient(p) + ", " + b.ToHlslGradient(p) + ")"; }
+		};
+
+		// DOMAIN TRANSFORMS
+		// Moves the child to offset (samples it at p - offset).
+		template <typename A>
+		struct Translate
+		{
+			A a;
+			float3 offset;
+
+			float Evaluate(const float3& p) const { return a.Evaluate(p - offset); }
+			std::string ToHlsl(const std::string& p) const { return a.ToHlsl("(" + p + " - " + HlslFloat3(offset) + ")"); }
+			float4 DistGrad(const float3& p) const { return a.DistGrad(p - offset); }
+			std::string ToHlslGradient(const std::string& p) const { return a.ToHlslGradient("(" + p + " - " + HlslFloat3(offset) + ")"); }
+		};
+
+		// Uniform scale, keeping the result a distance.
+		template <typename A>
+		struct Scale
+		{
+			A a;
+			float factor;
+
+			float Evaluate(const float3& p) const { return a.Evaluate(p / factor) * factor; }
+			std::string ToHlsl(const std::string& p) const { return a.ToHlsl("(" + p + " / " + HlslFloat(factor) + ")") + " * " + HlslFloat(factor); }
+
+			float4 DistGrad(const float3& p) const
+			{
+				float4 d = a.DistGrad(p / factor);
+				return float4(d.xyz(), d.w * factor);
+			}
+
+			std::string ToHlslGradient(const std::string& p) const { return "scaleDG(" + a.ToHlslGradient("(" + p + " / " + HlslFloat(factor) + ")") + ", " + HlslFloat(factor) + ")"; }
+		};
+
+		// mod() of each axis with a non-zero period, as the shader's repetition.
+		template <typename A>
+		struct Repeat
+		{
+			A a;
+			float3 period;
+
+			float Evaluate(const float3& p) const { return a.Evaluate(Wrap(p)); }
+			std::string ToHlsl(const std::string& p) const { return a.ToHlsl(WrapHlsl(p)); }
+
+			float4 DistGrad(const float3& p) const { return a.DistGrad(Wrap(p)); }
+			std::string ToHlslGradient(const std::string& p) const { return a.ToHlslGradient(WrapHlsl(p)); }
+
+			float3 Wrap(const float3& p) const
+			{
+				return float3(
+					period.x != 0.0f ? DX::mod(p.x, period.x) : p.x,
+					period.y != 0.0f ? DX::mod(p.y, period.y) : p.y,
+					period.z != 0.0f ? DX::mod(p.z, period.z) : p.z);
+			}
+
+			std::string WrapHlsl(const std::string& p) const
+			{
+				auto axis = [&p](const char* component, float axisPeriod)
+				{
+					std::string value = p + "." + component;
+					return axisPeriod != 0.0f ? "mod(" + value + ", " + HlslFloat(axisPeriod) + ")" : value;
+				};
+				return "float3(" + axis("x", period.x) + ", " + axis("y", period.y) + ", " + axis("z", period.z) + ")";
+			}
+		};
+
+		// Builders, so scenes can be written without spelling out the nested types. MakeUnion folds
+		// left, unionDF(unionDF(a, b), c), like the shader's running final value.
+		template <typename A, typename B>
+		Union<A, B> MakeUnion(const A& a, const B& b) { return Union<A, B>{ a, b }; }
+
+		template <typename A, typename B, typename C, typename... Rest>
+		auto MakeUnion(const A& a, const B& b, const C& c, const Rest&... rest)
+		{
+			return MakeUnion(MakeUnion(a, b), c, rest...);
+		}
+
+		template <typename A, typename B>
+		Intersect<A, B> MakeIntersect(const A& a, const B& b) { return Intersect<A, B>{ a, b }; }
+
+		template <typename A, typename B>
+		Diff<A, B> MakeDiff(const A& a, const B& b) { return Diff<A, B>{ a, b }; }
+
+		template <typename A>
+		Translate<A> MakeTranslate(const A& a, const float3& offset) { return Translate<A>{ a, offset }; }
+
+		template <typename A>
+		Scale<A> MakeScale(const A& a, float factor) { return Scale<A>{ a, factor }; }
+
+		template <typename A>
+		Repeat<A> MakeRepeat(const A& a, const float3& period) { return Repeat<A>{ a, period }; }
+	}
+}
@@ -0,0 +1,514 @@
+#include "SdfScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace AdvancedRenderingDefaultProject::Implicit;
+
+namespace
+{
+	const unsigned int MaxLeafPrimitives = 2;
+	const unsigned int MaxTraversalDepth = 64;
+	const float Unbounded = std::numeric_limits<float>::infinity();
+
+	float Component(const float3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+}
+
+void SdfScene::LocalBounds(const SdfPrimitive& primitive, float3& boundsMin, float3& boundsMax)
+{
+	float3 extent;
+
+	switch (primitive.shape)
+	{
+	case SdfShape::Sphere:
+		extent = float3(primitive.params.x * primitive.params.y);
+		break;
+	case SdfShape::Torus:
+		extent = float3(primitive.params.x + primitive.params.y, primitive.params.y, primitive.params.x + primitive.params.y);
+		break;
+	case SdfShape::Hex:
+		// h.x is the apothem of the hexagon; its corners reach h.x / cos(30).
+		extent = float3(primitive.params.x * 1.1547005f, primitive.params.x * 1.1547005f, primitive.params.y);
+		break;
+	case SdfShape::Octahedron:
+		extent = float3(primitive.params.x);
+		break;
+	case SdfShape::Cube:
+	case SdfShape::Tetra:
+	case SdfShape::DeformCubeSphere:
+		extent = float3(1.0f);
+		break;
+	case SdfShape::DeformCutSphere:
+		// Inside both the 1.2 sphere and the cube lifted by 0.3.
+		boundsMin = float3(-1.0f, -1.2f, -1.0f);
+		boundsMax = float3(1.0f, 0.7f, 1.0f);
+		return;
+	default:
+		// The fractal estimate is not bounded by its box far away; always evaluate it.
+		boundsMin = float3(-Unbounded);
+		boundsMax = float3(Unbounded);
+		return;
+	}
+
+	boundsMin = -extent;
+	boundsMax = extent;
+}
+
+float SdfScene::EvaluatePrimitive(const SdfPrimitive& primitive, const float3& samplePoint)
+{
+	float3 p = samplePoint - primitive.position;
+	if (primitive.repeatZ > 0.0f)
+	{
+		p.z = DX::mod(p.z, primitive.repeatZ);
+	}
+
+	switch (primitive.shape)
+	{
+	case SdfShape::Sphere:
+		return primitive.params.y == 1.0f ? sphereDistFunc(p, primitive.params.x) : sphereDistFunc(p / primitive.params.y, primitive.params.x) * primitive.params.y;
+	case SdfShape::Cube:
+		return cubeDistFunc(p);
+	case SdfShape::Torus:
+		return torusDistFunc(p, float2(primitive.params.x, primitive.params.y));
+	case SdfShape::Hex:
+		return hexDF(p, float2(primitive.params.x, primitive.params.y));
+	case SdfShape::Octahedron:
+		return octahedronDF(p, primitive.params.x);
+	case SdfShape::Tetra:
+		return tetraDF(p);
+	case SdfShape::Fractal:
+		return fractal(p);
+	case SdfShape::DeformCubeSphere:
+		return intersectDF(cubeDistFunc(p), sphereDistFunc(p / 1.2f, 1.0f) * 1.2f);
+	case SdfShape::DeformCutSphere:
+	{
+		float s2 = sphereDistFunc(p / 1.2f, 1.0f) * 1.2f;
+		float s3 = sphereDistFunc(float3(p.x - 0.25f, p.y, p.z) / 1.2f, 1.0f) * 1.2f;
+		float s4 = cubeDistFunc(float3(p.x, p.y + 0.3f, p.z));
+		float s5 = torusDistFunc(float3(p.x, p.y - 0.7f, p.z), float2(1.0f, 1.0f));
+		return diffDF(intersectDF(intersectDF(s2, s3), s4), s5);
+	}
+	default:
+		return std::numeric_limits<float>::max();
+	}
+}
+
+float SdfScene::BoxDistance(const float3& p, const float3& boundsMin, const float3& boundsMax)
+{
+	return length(max(max(boundsMin - p, p - boundsMax), 0.0f));
+}
+
+void SdfScene::Build()
+{
+	m_nodes.clear();
+	m_primitiveMin.clear();
+	m_primitiveMax.clear();
+
+	if (m_primitives.empty())
+	{
+		return;
+	}
+
+	m_nodes.push_back(Node());
+	BuildNode(0, 0, static_cast<unsigned int>(m_primitives.size()));
+
+	// World bounds per primitive, in the final (sorted) order.
+	for (const SdfPrimitive& primitive : m_primitives)
+	{
+		float3 boundsMin, boundsMax;
+		LocalBounds(primitive, boundsMin, boundsMax);
+		boundsMin = boundsMin + primitive.position;
+		boundsMax = boundsMax + primitive.position;
+
+		if (primitive.repeatZ > 0.0f)
+		{
+			boundsMin.z = -Unbounded;
+			boundsMax.z = Unbounded;
+		}
+
+		m_primitiveMin.push_back(boundsMin);
+		m_primitiveMax.push_back(boundsMax);
+	}
+}
+
+void SdfScene::BuildNode(unsigned int node, unsigned int first, unsigned int count)
+{
+	float3 boundsMin(Unbounded), boundsMax(-Unbounded);
+	float3 centreMin(Unbounded), centreMax(-Unbounded);
+
+	for (unsigned int i = first; i < first + count; i++)
+	{
+		const SdfPrimitive& primitive = m_primitives[i];
+		float3 localMin, localMax;
+		LocalBounds(primitive, localMin, localMax);
+
+		if (primitive.repeatZ > 0.0f)
+		{
+			localMin.z = -Unbounded;
+			localMax.z = Unbounded;
+		}
+
+		boundsMin = min(boundsMin, localMin + primitive.position);
+		boundsMax = max(boundsMax, localMax + primitive.position);
+		centreMin = min(centreMin, primitive.position);
+		centreMax = max(centreMax, primitive.position);
+	}
+
+	m_nodes[node].boundsMin = boundsMin;
+	m_nodes[node].boundsMax = boundsMax;
+
+	if (count <= MaxLeafPrimitives)
+	{
+		m_nodes[node].first = first;
+		m_nodes[node].count = count;
+		return;
+	}
+
+	// Median split along the widest spread of primitive positions.
+	float3 spread = centreMax - centreMin;
+	int axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : (spread.y >= spread.z ? 1 : 2);
+	unsigned int half = count / 2;
+
+	std::nth_element(m_primitives.begin() + first, m_primitives.begin() + first + half, m_primitives.begin() + first + count,
+		[axis](const SdfPrimitive& a, const SdfPrimitive& b) { return Component(a.position, axis) < Component(b.position, axis); });
+
+	unsigned int left = static_cast<unsigned int>(m_nodes.size());
+	m_nodes.push_back(Node());
+	m_nodes.push_back(Node());
+
+	m_nodes[node].first = left;
+	m_nodes[node].count = 0;
+
+	BuildNode(left, first, half);
+	BuildNode(left + 1, first + half, count - half);
+}
+
+void SdfScene::GetBounds(float3& boundsMin, float3& boundsMax) const
+{
+	if (m_nodes.empty())
+	{
+		boundsMin = boundsMax = float3();
+		return;
+	}
+
+	boundsMin = m_nodes[0].boundsMin;
+	boundsMax = m_nodes[0].boundsMax;
+}
+
+float SdfScene::Distance(const float3& samplePoint, unsigned int* evaluations) const
+{
+	float best = std::numeric_limits<float>::max();
+	unsigned int evaluated = 0;
+
+	if (m_nodes.empty())
+	{
+		return best;
+	}
+
+	struct Entry { unsigned int node; float distance; };
+	Entry stack[MaxTraversalDepth];
+	int top = 0;
+	stack[top++] = { 0, BoxDistance(samplePoint, m_nodes[0].boundsMin, m_nodes[0].boundsMax) };
+
+	while (top > 0)
+	{
+		Entry entry = stack[--top];
+		if (entry.distance >= best)
+		{
+			continue;
+		}
+
+		const Node& node = m_nodes[entry.node];
+
+		if (node.count > 0)
+		{
+			for (unsigned int i = node.first; i < node.first + node.count; i++)
+			{
+				float bound = node.count == 1 ? entry.distance : BoxDistance(samplePoint, m_primitiveMin[i], m_primitiveMax[i]);
+				if (bound >= best)
+				{
+					continue;
+				}
+
+				if (m_boundThreshold > 0.0f && bound > m_boundThreshold)
+				{
+					best = bound;
+					continue;
+				}
+
+				best = unionDF(best, EvaluatePrimitive(m_primitives[i], samplePoint));
+				evaluated++;
+			}
+			continue;
+		}
+
+		// Push the far child first so the near one is searched first and tightens best.
+		float leftDistance = BoxDistance(samplePoint, m_nodes[node.first].boundsMin, m_nodes[node.first].boundsMax);
+		float rightDistance = BoxDistance(samplePoint, m_nodes[node.first + 1].boundsMin, m_nodes[node.first + 1].boundsMax);
+
+		if (leftDistance < rightDistance)
+		{
+			stack[top++] = { node.first + 1, rightDistance };
+			stack[top++] = { node.first, leftDistance };
+		}
+		else
+		{
+			stack[top++] = { node.first, leftDistance };
+			stack[top++] = { node.first + 1, rightDistance };
+		}
+	}
+
+	if (evaluations)
+	{
+		*evaluations += evaluated;
+	}
+
+	return best;
+}
+
+float SdfScene::DistanceLinear(const float3& samplePoint, unsigned int* evaluations) const
+{
+	float best = std::numeric_limits<float>::max();
+
+	for (const SdfPrimitive& primitive : m_primitives)
+	{
+		best = unionDF(best, EvaluatePrimitive(primitive, samplePoint));
+	}
+
+	if (evaluations)
+	{
+		*evaluations += static_cast<unsigned int>(m_primitives.size());
+	}
+
+	return best;
+}
+
+float SdfScene::March(const Ray& ray, float start, float end, int* steps, unsigned int* evaluations) const
+{
+	float depth = start;
+	int i = 0;
+	float result = end;
+
+	for (; i < MAX_MARCH; i++)
+	{
+		float dist = Distance(ray.origin + depth * ray.direction, evaluations);
+		if (dist < EPSILON)
+		{
+			result = depth;
+			i++;
+			break;
+		}
+
+		depth += dist;
+		if (depth >= end)
+		{
+			i++;
+			break;
+		}
+	}
+
+	if (steps)
+	{
+		*steps = i;
+	}
+
+	return result;
+}
+
+std::string SdfScene::GenerateHlsl(const std::string& functionName) const
+{
+	// Infinite bounds are written as a large finite value, HLSL has no infinity literal.
+	auto number = [](float value)
+	{
+		char text[32];
+		std::snprintf(text, sizeof(text), "%.9g", std::max(-1e30f, std::min(value, 1e30f)));
+		return std::string(text);
+	};
+	auto vector3 = [&number](const float3& v)
+	{
+		return "float3(" + number(v.x) + ", " + number(v.y) + ", " + number(v.z) + ")";
+	};
+	auto vector4 = [&number](const float3& v, unsigned int w)
+	{
+		return "float4(" + number(v.x) + ", " + number(v.y) + ", " + number(v.z) + ", " + std::to_string(w) + ")";
+	};
+
+	const std::string prefix = functionName + "_";
+	std::string hlsl;
+
+	hlsl += "// Generated by SdfScene::GenerateHlsl: " + std::to_string(m_primitives.size()) + " primitives, " + std::to_string(m_nodes.size()) + " BVH nodes.\n";
+	hlsl += "// Needs the distance functions and mod() from ImplicitPixelShader.hlsl.\n\n";
+
+	if (m_nodes.empty())
+	{
+		return hlsl + "float " + functionName + "(float3 samplePoint)\n{\n\treturn farPlane;\n}\n";
+	}
+
+	// Nodes: bounds plus (first, count) packed in w as in SdfScene::Node.
+	hlsl += "static const float4 " + prefix + "nodeMin[" + std::to_string(m_nodes.size()) + "] =\n{\n";
+	for (const Node& node : m_nodes)
+	{
+		hlsl += "\t" + vector4(node.boundsMin, node.first) + ",\n";
+	}
+	hlsl += "};\n\n";
+
+	hlsl += "static const float4 " + prefix + "nodeMax[" + std::to_string(m_nodes.size()) + "] =\n{\n";
+	for (const Node& node : m_nodes)
+	{
+		hlsl += "\t" + vector4(node.boundsMax, node.count) + ",\n";
+	}
+	hlsl += "};\n\n";
+
+	// Primitives are unrolled into a switch so each one keeps its literal parameters.
+	hlsl += "float " + prefix + "primitive(int index, float3 samplePoint)\n{\n\tswitch (index)\n\t{\n";
+	for (size_t i = 0; i < m_primitives.size(); i++)
+	{
+		const SdfPrimitive& primitive = m_primitives[i];
+		std::string p = "(samplePoint - " + vector3(primitive.position) + ")";
+		if (primitive.repeatZ > 0.0f)
+		{
+			p = "float3(" + p + ".xy, mod(" + p + ".z, " + number(primitive.repeatZ) + "))";
+		}
+
+		const float4& k = primitive.params;
+		std::string body;
+
+		switch (primitive.shape)
+		{
+		case SdfShape::Sphere:
+			body = k.y == 1.0f ? "sphereDistFunc(" + p + ", " + number(k.x) + ")"
+				: "sphereDistFunc(" + p + " / " + number(k.y) + ", " + number(k.x) + ") * " + number(k.y);
+			break;
+		case SdfShape::Cube:				body = "cubeDistFunc(" + p + ")"; break;
+		case SdfShape::Torus:				body = "torusDistFunc(" + p + ", float2(" + number(k.x) + ", " + number(k.y) + "))"; break;
+		case SdfShape::Hex:					body = "hexDF(" + p + ", float2(" + number(k.x) + ", " + number(k.y) + "))"; break;
+		case SdfShape::Octahedron:			body = "octahedronDF(" + p + ", " + number(k.x) + ")"; break;
+		case SdfShape::Tetra:				body = "tetraDF(" + p + ")"; break;
+		case SdfShape::Fractal:				body = "fractal(" + p + ")"; break;
+		case SdfShape::DeformCubeSphere:
+			body = "intersectDF(cubeDistFunc(" + p + "), sphereDistFunc(" + p + " / 1.2f, 1.0f) * 1.2f)";
+			break;
+		case SdfShape::DeformCutSphere:
+			body = "diffDF(intersectDF(intersectDF(sphereDistFunc(" + p + " / 1.2f, 1.0f) * 1.2f, sphereDistFunc((" + p + " - float3(0.25f, 0.0f, 0.0f)) / 1.2f, 1.0f) * 1.2f), "
+				"cubeDistFunc(" + p + " + float3(0.0f, 0.3f, 0.0f))), torusDistFunc(" + p + " - float3(0.0f, 0.7f, 0.0f), float2(1.0f, 1.0f)))";
+			break;
+		}
+
+		hlsl += "\tcase " + std::to_string(i) + ": return " + body + ";\n";
+	}
+	hlsl += "\tdefault: return farPlane;\n\t}\n}\n\n";
+
+	hlsl += "float " + prefix + "boxDistance(float3 p, float3 boundsMin, float3 boundsMax)\n{\n";
+	hlsl += "\treturn length(max(max(boundsMin - p, p - boundsMax), 0.0f));\n}\n\n";
+
+	hlsl += "float " + functionName + "(float3 samplePoint)\n{\n";
+	hlsl += "\tfloat best = farPlane;\n";
+	hlsl += "\tint stack[" + std::to_string(MaxTraversalDepth) + "];\n";
+	hlsl += "\tint top = 0;\n";
+	hlsl += "\tstack[top++] = 0;\n\n";
+	hlsl += "\t[loop]\n\twhile (top > 0)\n\t{\n";
+	hlsl += "\t\tint node = stack[--top];\n";
+	hlsl += "\t\tfloat4 boundsMin = " + prefix + "nodeMin[node];\n";
+	hlsl += "\t\tfloat4 boundsMax = " + prefix + "nodeMax[node];\n\n";
+	hlsl += "\t\tif (" + prefix + "boxDistance(samplePoint, boundsMin.xyz, boundsMax.xyz) >= best)\n\t\t\tcontinue;\n\n";
+	hlsl += "\t\tint first = (int)boundsMin.w;\n";
+	hlsl += "\t\tint count = (int)boundsMax.w;\n\n";
+	hlsl += "\t\tif (count > 0)\n\t\t{\n";
+	hlsl += "\t\t\tfor (int i = 0; i < count; i++)\n";
+	hlsl += "\t\t\t\tbest = unionDF(best, " + prefix + "primitive(first + i, samplePoint));\n";
+	hlsl += "\t\t}\n\t\telse\n\t\t{\n";
+	hlsl += "\t\t\t// Near child last so it is popped first.\n";
+	hlsl += "\t\t\tfloat leftDistance = " + prefix + "boxDistance(samplePoint, " + prefix + "nodeMin[first].xyz, " + prefix + "nodeMax[first].xyz);\n";
+	hlsl += "\t\t\tfloat rightDistance = " + prefix + "boxDistance(samplePoint, " + prefix + "nodeMin[first + 1].xyz, " + prefix + "nodeMax[first + 1].xyz);\n";
+	hlsl += "\t\t\tbool leftFirst = leftDistance < rightDistance;\n";
+	hlsl += "\t\t\tstack[top++] = leftFirst ? first + 1 : first;\n";
+	hlsl += "\t\t\tstack[top++] = leftFirst ? first : first + 1;\n";
+	hlsl += "\t\t}\n\t}\n\n";
+	hlsl += "\treturn best;\n}\n";
+
+	return hlsl;
+}
+
+SdfScene AdvancedRenderingDefaultProject::CreateImplicitSdfScene(ImplicitSceneType scene)
+{
+	SdfScene sdf;
+
+	// Positions are the negated offsets the shader adds to samplePoint.
+	switch (scene)
+	{
+	case ImplicitSceneType::Repeating:
+		sdf.Add(SdfPrimitive(SdfShape::Sphere, float3(-4.0f, 0.0f, 0.0f), float4(1.0f, 1.0f, 0.0f, 0.0f), 1.5f));
+		sdf.Add(SdfPrimitive(SdfShape::Cube, float3(4.0f, 0.0f, 0.0f), float4(), 1.5f));
+		sdf.Add(SdfPrimitive(SdfShape::Octahedron, float3(0.0f, 0.0f, 0.0f), float4(1.0f, 0.0f, 0.0f, 0.0f), 2.25f));
+		break;
+	case ImplicitSceneType::Deforming:
+		sdf.Add(SdfPrimitive(SdfShape::DeformCubeSphere, float3(-3.0f, 0.0f, 0.0f)));
+		sdf.Add(SdfPrimitive(SdfShape::DeformCutSphere, float3(3.0f, 0.0f, 0.0f)));
+		break;
+	case ImplicitSceneType::Fractal:
+		sdf.Add(SdfPrimitive(SdfShape::Fractal, float3(0.0f, 0.0f, 0.0f)));
+		break;
+	case ImplicitSceneType::Shiny:
+	{
+		const float offset = 3.0f;
+		for (float y : { 0.0f, offset / 1.25f, -(offset / 1.25f) })
+		{
+			sdf.Add(SdfPrimitive(SdfShape::Tetra, float3(-offset, y, 0.0f)));
+			sdf.Add(SdfPrimitive(SdfShape::Sphere, float3(offset, y, 0.0f), float4(1.0f, 1.0f, 0.0f, 0.0f)));
+		}
+		break;
+	}
+	default:
+		sdf.Add(SdfPrimitive(SdfShape::Sphere, float3(0.0f, 0.0f, 0.0f), float4(1.0f, 1.0f, 0.0f, 0.0f)));
+		sdf.Add(SdfPrimitive(SdfShape::Cube, float3(2.0f, 2.0f, 2.0f)));
+		sdf.Add(SdfPrimitive(SdfShape::Torus, float3(-5.0f, -5.0f, -5.0f), float4(1.5f, 0.5f, 0.0f, 0.0f)));
+		sdf.Add(SdfPrimitive(SdfShape::Octahedron, float3(3.0f, -3.0f, 0.0f), float4(1.0f, 0.0f, 0.0f, 0.0f)));
+		sdf.Add(SdfPrimitive(SdfShape::Hex, float3(-3.0f, 3.0f, 0.0f), float4(1.0f, 1.0f, 0.0f, 0.0f)));
+		break;
+	}
+
+	sdf.Build();
+	return sdf;
+}
+
+SdfScene AdvancedRenderingDefaultProject::CreateSdfStressScene(unsigned int count, unsigned int seed)
+{
+	// Small LCG so the layout is the same on every platform.
+	unsigned int state = seed * 747796405u + 2891336453u;
+	auto next = [&state]()
+	{
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) * (1.0f / 16777216.0f);
+	};
+
+	SdfScene sdf;
+	const unsigned int side = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(count))));
+	const float spacing = 3.0f;
+	const float half = 0.5f * spacing * (side - 1);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		float3 position(
+			(i % side) * spacing - half + (next() - 0.5f),
+			next() * 2.0f - 1.0f,
+			(i / side) * spacing - half + (next() - 0.5f));
+
+		switch (i % 5)
+		{
+		case 0: sdf.Add(SdfPrimitive(SdfShape::Sphere, position, float4(0.5f + next(), 1.0f, 0.0f, 0.0f))); break;
+		case 1: sdf.Add(SdfPrimitive(SdfShape::Cube, position)); break;
+		case 2: sdf.Add(SdfPrimitive(SdfShape::Torus, position, float4(0.8f + 0.4f * next(), 0.3f, 0.0f, 0.0f))); break;
+		case 3: sdf.Add(SdfPrimitive(SdfShape::Octahedron, position, float4(0.7f + 0.5f * next(), 0.0f, 0.0f, 0.0f))); break;
+		default: sdf.Add(SdfPrimitive(SdfShape::Hex, position, float4(0.6f + 0.4f * next(), 0.5f, 0.0f, 0.0f))); break;
+		}
+	}
+
+	sdf.Build();
+	return sdf;
+}
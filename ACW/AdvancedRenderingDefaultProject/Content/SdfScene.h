@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ImplicitScene.h"
+
+#include <string>
+#include <vector>
+
+namespace AdvancedRenderingDefaultProject
+{
+	// Shapes an SdfScene leaf can hold. The Deform* shapes are the two CSG groups of the
+	// "Deforming" scene, kept whole because intersections cannot be split across the BVH.
+	enum class SdfShape
+	{
+		Sphere,				// params.x = radius, params.y = uniform scale
+		Cube,				// unit half extents
+		Torus,				// params.xy = radii
+		Hex,				// params.xy = h
+		Octahedron,			// params.x = size
+		Tetra,
+		Fractal,
+		DeformCubeSphere,	// intersectDF(cube, sphere / 1.2)
+		DeformCutSphere		// diffDF(intersect(sphere, sphere, cube), torus)
+	};
+
+	struct SdfPrimitive
+	{
+		SdfShape		shape;
+		DX::float3		position;	// the primitive is evaluated at samplePoint - position
+		DX::float4		params;
+		float			repeatZ;	// period of mod() on the local z axis, 0 for none
+
+		SdfPrimitive(SdfShape shape, const DX::float3& position, const DX::float4& params = DX::float4(), float repeatZ = 0.0f) :
+			shape(shape), position(position), params(params), repeatZ(repeatZ) {}
+	};
+
+	// Union of bounded primitives held in a small BVH. A query walks the tree nearest child
+	// first and skips every node whose box is further away than the closest surface found so
+	// far, so only the primitives near the sample point are evaluated. Optionally a primitive
+	// whose box is beyond the bound threshold is not evaluated at all and contributes its box
+	// distance instead; box distances never exceed the primitive distance, so marching stays
+	// conservative either way.
+	class SdfScene
+	{
+	public:
+		SdfScene() : m_boundThreshold(0.0f) {}
+
+		void Add(const SdfPrimitive& primitive) { m_primitives.push_back(primitive); m_nodes.clear(); }
+		void Build();
+
+		// Zero (the default) always evaluates primitives exactly.
+		void SetBoundThreshold(float threshold) { m_boundThreshold = threshold; }
+
+		size_t GetPrimitiveCount() const { return m_primitives.size(); }
+		size_t GetNodeCount() const { return m_nodes.size(); }
+
+		// Box around every primitive (components are infinite for repeated or unbounded ones).
+		void GetBounds(DX::float3& boundsMin, DX::float3& boundsMax) const;
+
+		// evaluations (optional) is incremented by the number of primitives evaluated exactly.
+		float Distance(const DX::float3& samplePoint, unsigned int* evaluations = nullptr) const;
+
+		// Reference: every primitive, every time.
+		float DistanceLinear(const DX::float3& samplePoint, unsigned int* evaluations = nullptr) const;
+
+		// HLSL for the same scene and tree, as a float functionName(float3 samplePoint) to drop
+		// into ImplicitPixelShader.hlsl next to the primitive functions it calls.
+		std::string GenerateHlsl(const std::string& functionName) const;
+
+		// Plain sphere tracing against the tree, as shortestDistanceToSurface.
+		float March(const Implicit::Ray& ray, float start, float end, int* steps = nullptr, unsigned int* evaluations = nullptr) const;
+
+	private:
+		struct Node
+		{
+			DX::float3		boundsMin;
+			DX::float3		boundsMax;
+			unsigned int	first;		// first child (interior) or first primitive (leaf)
+			unsigned int	count;		// primitive count, 0 for interior nodes
+		};
+
+		static void LocalBounds(const SdfPrimitive& primitive, DX::float3& boundsMin, DX::float3& boundsMax);
+		static float EvaluatePrimitive(const SdfPrimitive& primitive, const DX::float3& samplePoint);
+		static float BoxDistance(const DX::float3& p, const DX::float3& boundsMin, const DX::float3& boundsMax);
+
+		void BuildNode(unsigned int node, unsigned int first, unsigned int count);
+
+	private:
+		std::vector<SdfPrimitive>	m_primitives;
+		std::vector<DX::float3>		m_primitiveMin;
+		std::vector<DX::float3>		m_primitiveMax;
+		std::vector<Node>			m_nodes;
+		float						m_boundThreshold;
+	};
+
+	// The shipped scenes of ImplicitPixelShader.hlsl as SdfScenes (already built).
+	SdfScene CreateImplicitSdfScene(ImplicitSceneType scene);
+
+	// count primitives of mixed shapes scattered over a grid in front of the camera, for
+	// measuring how the per-step cost grows with object count.
+	SdfScene CreateSdfStressScene(unsigned int count, unsigned int seed);
+}
@@ -19,6 +19,8 @@ namespace AdvancedRenderingDefaultProject
 	struct ControlBuffer
 	{
 		DirectX::XMFLOAT4 booleans;
+		DirectX::XMFLOAT4 marching;	// ImplicitMarchSettings: relaxation, hitPixels; fractal LOD
+		DirectX::XMFLOAT4 progressive;	// first slice, slice count (ImplicitInterleave)
 	};
 
 	struct DisplacementBuffer
@@ -26,6 +28,17 @@ namespace AdvancedRenderingDefaultProject
 		DirectX::XMFLOAT4 displacementFactor;
 	};
 
+	struct FloorTessellationBuffer
+	{
+		DirectX::XMFLOAT4 viewport;	// width, height, FloorTessellationSettings: trianglesPerPixel, adaptive
+		DirectX::XMFLOAT4 detail;	// flatDetail, detailDeviation
+	};
+
+	struct ParametricTessellationBuffer
+	{
+		DirectX::XMFLOAT4 tessFactor;
+	};
+
 	struct CameraBuffer
 	{
 		DirectX::XMFLOAT4 eyePos;
@@ -38,10 +51,40 @@ namespace AdvancedRenderingDefaultProject
 		DirectX::XMFLOAT3 pos;
 	};
 
+	// A grass blade or clump card as GrassField::Write uploads it.
+	struct GrassCard
+	{
+		DirectX::XMFLOAT3 pos;
+		float scale;
+	};
+
+	// A point of a snake's skeleton and the body's radius there, as SnakeSwarm::Write writes
+	// them in tail and head pairs.
+	struct SnakeVertex
+	{
+		DirectX::XMFLOAT3 pos;
+		float radius;
+	};
+
+	// Per-instance data of a parametric object: a ParametricShape as ParametricDS.hlsl reads it.
+	struct ParametricInstance
+	{
+		DirectX::XMFLOAT4 shape;	// surface, size
+		DirectX::XMFLOAT4 sweep;
+		DirectX::XMFLOAT4 offset;	// offset, displacement
+	};
+
 	// Used to send per-vertex data to the vertex shader.
 	struct VertexPositionColor
 	{
 		DirectX::XMFLOAT3 pos;
 		DirectX::XMFLOAT3 color;
 	};
+
+	// A cached parametric surface vertex, as the domain shaders stream it out.
+	struct VertexPositionUv
+	{
+		DirectX::XMFLOAT3 pos;
+		DirectX::XMFLOAT2 uvs;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "SnakeSwarm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace AdvancedRenderingDefaultProject;
+
+namespace
+{
+	// Snakes per ParallelFor item when updating or writing.
+	const size_t UpdateBatch = 256;
+
+	const float TwoPi = 6.28318531f;
+
+	// Follow-the-leader heads swing SlitherAmplitude radians either side of their heading,
+	// once per SlitherWavelength segments travelled, and turn back towards home at TurnRate
+	// radians per second once they roam too far.
+	const float SlitherAmplitude = 0.5f;
+	const float SlitherWavelength = 3.5f;
+	const float TurnRate = 2.0f;
+
+	// Control points around each spline snake's closed track.
+	const unsigned int SnakeTrackPoints = 6;
+
+	float CatmullRom(float p0, float p1, float p2, float p3, float t)
+	{
+		return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t + (3.0f * (p1 - p2) + p3 - p0) * t * t * t);
+	}
+}
+
+void SnakeSwarm::Generate(const SnakeSwarmSettings& settings)
+{
+	m_settings = settings;
+	m_snakeCount = settings.snakeCount;
+	m_pointCount = std::max(3u, settings.pointsPerSnake);
+	m_time = 0.0f;
+
+	// The scene's taper: thin tips, and the point behind the nose widest.
+	m_radius.assign(m_pointCount, settings.radius);
+	m_radius[0] = m_radius[m_pointCount - 1] = settings.radius * 0.02f;
+	m_radius[m_pointCount - 2] = settings.radius * 1.5f;
+
+	unsigned int columns = std::max(1u, static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(m_snakeCount)))));
+	unsigned int rows = std::max(1u, static_cast<unsigned int>((m_snakeCount + columns - 1) / columns));
+	float cellWidth = 2.0f * settings.extent / columns;
+	float cellHeight = 2.0f * settings.extent / rows;
+	m_roamRadius = 0.5f * std::min(cellWidth, cellHeight);
+
+	size_t pointTotal = m_snakeCount * m_pointCount;
+	m_x.resize(pointTotal);
+	m_z.resize(pointTotal);
+	m_homeX.resize(m_snakeCount);
+	m_homeZ.resize(m_snakeCount);
+	m_heading.assign(m_snakeCount, 0.0f);
+	m_phase.resize(m_snakeCount);
+	m_trackX.resize(m_snakeCount * SnakeTrackPoints);
+	m_trackZ.resize(m_snakeCount * SnakeTrackPoints);
+	m_trackPosition.resize(m_snakeCount);
+	m_trackSpacing.resize(m_snakeCount);
+
+	std::mt19937 random(settings.seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	for (size_t s = 0; s < m_snakeCount; s++)
+	{
+		unsigned int column = static_cast<unsigned int>(s % columns);
+		unsigned int row = static_cast<unsigned int>(s / columns);
+		m_homeX[s] = -settings.extent + (column + 0.5f) * cellWidth;
+		m_homeZ[s] = -settings.extent + (row + 0.5f) * cellHeight;
+		m_phase[s] = TwoPi * unit(random);
+
+		float tailZ = -settings.extent + (row + 0.1f) * cellHeight;
+		for (unsigned int i = 0; i < m_pointCount; i++)
+		{
+			m_x[i * m_snakeCount + s] = m_homeX[s];
+			m_z[i * m_snakeCount + s] = tailZ + i * settings.segmentLength;
+		}
+
+		// A lumpy loop around home, walked a segment length per skeleton point.
+		float trackLength = 0.0f;
+		for (unsigned int k = 0; k < SnakeTrackPoints; k++)
+		{
+			float angle = TwoPi * k / SnakeTrackPoints;
+			float radius = m_roamRadius * (0.6f + 0.4f * unit(random));
+			m_trackX[k * m_snakeCount + s] = m_homeX[s] + radius * std::sin(angle);
+			m_trackZ[k * m_snakeCount + s] = m_homeZ[s] + radius * std::cos(angle);
+		}
+		for (unsigned int k = 0; k < SnakeTrackPoints; k++)
+		{
+			unsigned int next = (k + 1) % SnakeTrackPoints;
+			float dx = m_trackX[next * m_snakeCount + s] - m_trackX[k * m_snakeCount + s];
+			float dz = m_trackZ[next * m_snakeCount + s] - m_trackZ[k * m_snakeCount + s];
+			trackLength += std::sqrt(dx * dx + dz * dz);
+		}
+		m_trackSpacing[s] = settings.segmentLength * SnakeTrackPoints / std::max(trackLength, 1e-6f);
+		m_trackPosition[s] = (m_pointCount - 1) * m_trackSpacing[s];
+	}
+
+	if (settings.skeleton == SnakeSkeleton::Spline)
+	{
+		UpdateSpline(0, m_snakeCount, 0.0f);
+	}
+}
+
+void SnakeSwarm::Update(float seconds, DX::ThreadPool& threadPool)
+{
+	m_time += seconds;
+	threadPool.ParallelFor((m_snakeCount + UpdateBatch - 1) / UpdateBatch, [&](size_t batch)
+	{
+		size_t begin = batch * UpdateBatch;
+		size_t end = std::min(m_snakeCount, begin + UpdateBatch);
+		if (m_settings.skeleton == SnakeSkeleton::Spline)
+		{
+			UpdateSpline(begin, end, seconds);
+		}
+		else
+		{
+			UpdateFollowTheLeader(begin, end, seconds);
+		}
+	});
+}
+
+void SnakeSwarm::UpdateFollowTheLeader(size_t begin, size_t end, float seconds)
+{
+	const size_t n = m_snakeCount;
+	const float segmentLength = m_settings.segmentLength;
+	const float step = m_settings.speed * seconds;
+	const float slitherFrequency = TwoPi * m_settings.speed / (SlitherWavelength * segmentLength);
+	const float maxTurn = TurnRate * seconds;
+
+	// Heads first: steer home when out of range, then move along the slithering heading.
+	float* headX = &m_x[(m_pointCount - 1) * n];
+	float* headZ = &m_z[(m_pointCount - 1) * n];
+	for (size_t s = begin; s < end; s++)
+	{
+		float dx = m_homeX[s] - headX[s];
+		float dz = m_homeZ[s] - headZ[s];
+		if (dx * dx + dz * dz > m_roamRadius * m_roamRadius)
+		{
+			float turn = std::remainder(std::atan2(dx, dz) - m_heading[s], TwoPi);
+			m_heading[s] = std::remainder(m_heading[s] + std::min(maxTurn, std::max(-maxTurn, turn)), TwoPi);
+		}
+
+		float heading = m_heading[s] + SlitherAmplitude * std::sin(slitherFrequency * m_time + m_phase[s]);
+		headX[s] += std::sin(heading) * step;
+		headZ[s] += std::cos(heading) * step;
+	}
+
+	// Then each point, a row at a time from the neck back, is pulled to a segment length
+	// behind the one ahead of it.
+	for (unsigned int i = m_pointCount - 1; i-- > 0;)
+	{
+		float* x = &m_x[i * n];
+		float* z = &m_z[i * n];
+		const float* leadX = &m_x[(i + 1) * n];
+		const float* leadZ = &m_z[(i + 1) * n];
+		for (size_t s = begin; s < end; s++)
+		{
+			float dx = x[s] - leadX[s];
+			float dz = z[s] - leadZ[s];
+			float scale = segmentLength / std::max(std::sqrt(dx * dx + dz * dz), 1e-6f);
+			x[s] = leadX[s] + dx * scale;
+			z[s] = leadZ[s] + dz * scale;
+		}
+	}
+}
+
+void SnakeSwarm::UpdateSpline(size_t begin, size_t end, float seconds)
+{
+	const size_t n = m_snakeCount;
+	const float trackPoints = static_cast<float>(SnakeTrackPoints);
+	for (size_t s = begin; s < end; s++)
+	{
+		float position = m_trackPosition[s] + m_settings.speed * seconds / m_settings.segmentLength * m_trackSpacing[s];
+		m_trackPosition[s] = position - trackPoints * std::floor(position / trackPoints);
+	}
+
+	// Every point is evaluated on its own, head last, so nothing carries between rows.
+	for (unsigned int i = 0; i < m_pointCount; i++)
+	{
+		float behind = static_cast<float>(m_pointCount - 1 - i);
+		for (size_t s = begin; s < end; s++)
+		{
+			float u = m_trackPosition[s] - behind * m_trackSpacing[s];
+			u -= trackPoints * std::floor(u / trackPoints);
+			unsigned int k = std::min(SnakeTrackPoints - 1, static_cast<unsigned int>(u));
+			float t = u - k;
+
+			size_t p0 = ((k + SnakeTrackPoints - 1) % SnakeTrackPoints) * n + s;
+			size_t p1 = k * n + s;
+			size_t p2 = ((k + 1) % SnakeTrackPoints) * n + s;
+			size_t p3 = ((k + 2) % SnakeTrackPoints) * n + s;
+			m_x[i * n + s] = CatmullRom(m_trackX[p0], m_trackX[p1], m_trackX[p2], m_trackX[p3], t);
+			m_z[i * n + s] = CatmullRom(m_trackZ[p0], m_trackZ[p1], m_trackZ[p2], m_trackZ[p3], t);
+		}
+	}
+}
+
+void SnakeSwarm::Write(float* destination, DX::ThreadPool& threadPool) const
+{
+	const size_t n = m_snakeCount;
+	const unsigned int segments = m_pointCount - 1;
+	threadPool.ParallelFor((n + UpdateBatch - 1) / UpdateBatch, [&](size_t batch)
+	{
+		size_t end = std::min(n, (batch + 1) * UpdateBatch);
+		for (size_t s = batch * UpdateBatch; s < end; s++)
+		{
+			float* out = destination + s * segments * 2 * SnakeVertexFloats;
+			for (unsigned int j = 0; j < segments; j++)
+			{
+				for (unsigned int i = j; i <= j + 1; i++)
+				{
+					out[0] = m_x[i * n + s];
+					out[1] = m_settings.height;
+					out[2] = m_z[i * n + s];
+					out[3] = m_radius[i];
+					out += SnakeVertexFloats;
+				}
+			}
+		}
+	});
+}
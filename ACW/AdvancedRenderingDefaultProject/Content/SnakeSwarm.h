@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../Common/ThreadPool.h"
+
+#include <stddef.h>
+#include <vector>
+
+// Snake skeletons for SnakeGS.hlsl and SnakePullVS.hlsl, simulated on the CPU and written to
+// one buffer per frame. Only depends on the standard library and the thread pool, so
+// Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	// Floats each skeleton point is written as: a position and the body's radius there
+	// (SnakeVertex).
+	static const unsigned int SnakeVertexFloats = 4;
+
+	enum class SnakeSkeleton
+	{
+		FollowTheLeader,	// the head steers and every point is dragged after the one ahead
+		Spline				// every point rides a closed Catmull-Rom track, a fixed distance apart
+	};
+
+	struct SnakeSwarmSettings
+	{
+		unsigned int	snakeCount = 2;
+		unsigned int	pointsPerSnake = 8;		// tail first, at least 3
+		float			segmentLength = 0.2f;
+		float			radius = 0.05f;			// of the body; the tips taper and the head is wider
+		float			extent = 1.0f;			// snakes start in lanes over [-extent, extent] in x and z
+		float			height = 0.05f;			// the y every point stays at
+		float			speed = 0.15f;			// of the head, per second
+		unsigned int	seed = 1;
+		SnakeSkeleton	skeleton = SnakeSkeleton::FollowTheLeader;
+	};
+
+	// Skeleton points in structure-of-arrays form, point-major: point i of snake s is at
+	// i * snakeCount + s, so each step of the update runs along contiguous rows of snakes.
+	// Snakes are independent and updated in batches across the thread pool.
+	class SnakeSwarm
+	{
+	public:
+		SnakeSwarm() : m_snakeCount(0), m_pointCount(0), m_time(0.0f), m_roamRadius(0.0f) {}
+
+		// Lays the snakes out straight, heading along +z, one per cell of a grid over the
+		// field; two snakes on the default extent are the scene's.
+		void Generate(const SnakeSwarmSettings& settings);
+
+		// Advances the simulation by seconds.
+		void Update(float seconds, DX::ThreadPool& threadPool);
+
+		size_t GetSnakeCount() const { return m_snakeCount; }
+		unsigned int GetPointCount() const { return m_pointCount; }
+		size_t GetSegmentCount() const { return m_snakeCount * (m_pointCount - 1); }
+		float GetHeight() const { return m_settings.height; }
+
+		// Point i of snake s, and the body's radius at point i of every snake.
+		float GetX(size_t s, unsigned int i) const { return m_x[i * m_snakeCount + s]; }
+		float GetZ(size_t s, unsigned int i) const { return m_z[i * m_snakeCount + s]; }
+		float GetRadius(unsigned int i) const { return m_radius[i]; }
+
+		// Writes every segment to destination as its tail and head SnakeVertex, snake by snake
+		// from the tail. destination holds 2 * GetSegmentCount() vertices.
+		void Write(float* destination, DX::ThreadPool& threadPool) const;
+
+	private:
+		void UpdateFollowTheLeader(size_t begin, size_t end, float seconds);
+		void UpdateSpline(size_t begin, size_t end, float seconds);
+
+		SnakeSwarmSettings	m_settings;
+		size_t				m_snakeCount;
+		unsigned int		m_pointCount;
+		float				m_time;
+
+		std::vector<float>	m_x;
+		std::vector<float>	m_z;
+		std::vector<float>	m_radius;		// per point along a snake, the same for every snake
+
+		// Per snake: where it roams, and for follow-the-leader its heading and the phase of its
+		// slither.
+		std::vector<float>	m_homeX;
+		std::vector<float>	m_homeZ;
+		std::vector<float>	m_heading;
+		std::vector<float>	m_phase;
+		float				m_roamRadius;
+
+		// Spline tracks, SnakeTrackPoints control points per snake stored point-major like the
+		// skeleton, the head's position along the track in control points, and how far apart
+		// the skeleton points are along it.
+		std::vector<float>	m_trackX;
+		std::vector<float>	m_trackZ;
+		std::vector<float>	m_trackPosition;
+		std::vector<float>	m_trackSpacing;
+	};
+}
@@ -0,0 +1,168 @@
+#include "SnakeTube.h"
+
+#include "../Common/HlslMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace DX;
+
+namespace
+{
+	// Snakes per ParallelFor item when picking levels or extruding.
+	const size_t TubeBatch = 256;
+
+	const float TwoPi = 6.28318531f;
+
+	size_t VerticesPerSnake(unsigned int points, unsigned int ringVertices)
+	{
+		return static_cast<size_t>(points) * ringVertices;
+	}
+
+	// A strip around the tube per segment, closed back to its first pair, then a cut.
+	size_t IndicesPerSnake(unsigned int points, unsigned int ringVertices)
+	{
+		return static_cast<size_t>(points - 1) * (2 * (ringVertices + 1) + 1);
+	}
+
+	// Carries the normal r from the frame at a (tangent ta) to the point b (tangent tb) by the
+	// double reflection method (Wang et al., "Computation of Rotation Minimizing Frames"):
+	// reflect across the plane bisecting a and b, then across the one taking the reflected
+	// tangent onto tb. The frame turns as little as possible about the tangent.
+	float3 TransportNormal(const float3& a, const float3& ta, const float3& r, const float3& b, const float3& tb)
+	{
+		float3 v1 = b - a;
+		float c1 = dot(v1, v1);
+		if (c1 < 1e-12f)
+		{
+			return r;
+		}
+		float3 rL = r - (2.0f / c1) * dot(v1, r) * v1;
+		float3 tL = ta - (2.0f / c1) * dot(v1, ta) * v1;
+
+		float3 v2 = tb - tL;
+		float c2 = dot(v2, v2);
+		return c2 < 1e-12f ? rL : rL - (2.0f / c2) * dot(v2, rL) * v2;
+	}
+}
+
+size_t SnakeTube::GetMaxVertexCount(const SnakeSwarm& swarm, const SnakeTubeSettings& settings)
+{
+	return swarm.GetSnakeCount() * VerticesPerSnake(swarm.GetPointCount(), std::max(3u, settings.ringVertices));
+}
+
+size_t SnakeTube::GetMaxIndexCount(const SnakeSwarm& swarm, const SnakeTubeSettings& settings)
+{
+	return swarm.GetSnakeCount() * IndicesPerSnake(swarm.GetPointCount(), std::max(3u, settings.ringVertices));
+}
+
+void SnakeTube::Build(const SnakeSwarm& swarm, const SnakeTubeSettings& settings, const float (&modelViewProjection)[4][4], ThreadPool& threadPool)
+{
+	size_t snakeCount = swarm.GetSnakeCount();
+	unsigned int points = swarm.GetPointCount();
+	unsigned int lastLevel = std::max(1u, settings.lodLevels) - 1;
+	float height = swarm.GetHeight();
+	const float (&m)[4][4] = modelViewProjection;
+
+	m_ringVertices.resize(snakeCount);
+	threadPool.ParallelFor((snakeCount + TubeBatch - 1) / TubeBatch, [&](size_t batch)
+	{
+		size_t end = std::min(snakeCount, (batch + 1) * TubeBatch);
+		for (size_t s = batch * TubeBatch; s < end; s++)
+		{
+			float x = swarm.GetX(s, points - 1);
+			float z = swarm.GetZ(s, points - 1);
+			float depth = std::max(0.0f, x * m[0][3] + height * m[1][3] + z * m[2][3] + m[3][3]);
+			unsigned int level = static_cast<unsigned int>(std::min(static_cast<float>(lastLevel), depth / settings.lodDistance));
+			m_ringVertices[s] = std::max(3u, settings.ringVertices >> level);
+		}
+	});
+
+	m_vertexStart.resize(snakeCount + 1);
+	m_indexStart.resize(snakeCount + 1);
+	m_vertexStart[0] = m_indexStart[0] = 0;
+	for (size_t s = 0; s < snakeCount; s++)
+	{
+		m_vertexStart[s + 1] = m_vertexStart[s] + VerticesPerSnake(points, m_ringVertices[s]);
+		m_indexStart[s + 1] = m_indexStart[s] + IndicesPerSnake(points, m_ringVertices[s]);
+	}
+	m_vertexCount = m_vertexStart[snakeCount];
+	m_indexCount = m_indexStart[snakeCount];
+}
+
+void SnakeTube::Write(const SnakeSwarm& swarm, float* vertices, uint32_t* indices, ThreadPool& threadPool) const
+{
+	size_t snakeCount = m_ringVertices.size();
+	unsigned int points = swarm.GetPointCount();
+	float height = swarm.GetHeight();
+
+	threadPool.ParallelFor((snakeCount + TubeBatch - 1) / TubeBatch, [&](size_t batch)
+	{
+		std::vector<float> ringCos, ringSin;
+		std::vector<float3> skeleton(points);
+		size_t end = std::min(snakeCount, (batch + 1) * TubeBatch);
+		for (size_t s = batch * TubeBatch; s < end; s++)
+		{
+			unsigned int ringVertices = m_ringVertices[s];
+			if (ringCos.size() != ringVertices)
+			{
+				ringCos.resize(ringVertices);
+				ringSin.resize(ringVertices);
+				for (unsigned int k = 0; k < ringVertices; k++)
+				{
+					ringCos[k] = std::cos(TwoPi * k / ringVertices);
+					ringSin[k] = std::sin(TwoPi * k / ringVertices);
+				}
+			}
+
+			for (unsigned int i = 0; i < points; i++)
+			{
+				skeleton[i] = float3(swarm.GetX(s, i), height, swarm.GetZ(s, i));
+			}
+
+			// Tangents by central differences; the first normal is the up vector made
+			// perpendicular to the tail's tangent, and every later one is transported from it.
+			float* out = vertices + m_vertexStart[s] * 3;
+			float3 previousTangent, normal;
+			for (unsigned int i = 0; i < points; i++)
+			{
+				float3 forward = skeleton[std::min(i + 1, points - 1)] - skeleton[i > 0 ? i - 1 : 0];
+				float3 tangent = dot(forward, forward) > 1e-12f ? normalize(forward) : float3(0.0f, 0.0f, 1.0f);
+				if (i == 0)
+				{
+					float3 up = std::fabs(tangent.y) < 0.9f ? float3(0.0f, 1.0f, 0.0f) : float3(1.0f, 0.0f, 0.0f);
+					normal = normalize(up - dot(up, tangent) * tangent);
+				}
+				else
+				{
+					normal = normalize(TransportNormal(skeleton[i - 1], previousTangent, normal, skeleton[i], tangent));
+				}
+				float3 binormal = cross(tangent, normal);
+				previousTangent = tangent;
+
+				float radius = swarm.GetRadius(i);
+				for (unsigned int k = 0; k < ringVertices; k++)
+				{
+					float3 position = skeleton[i] + (ringCos[k] * radius) * normal + (ringSin[k] * radius) * binormal;
+					out[0] = position.x;
+					out[1] = position.y;
+					out[2] = position.z;
+					out += 3;
+				}
+			}
+
+			uint32_t* index = indices + m_indexStart[s];
+			uint32_t base = static_cast<uint32_t>(m_vertexStart[s]);
+			for (unsigned int i = 0; i + 1 < points; i++)
+			{
+				for (unsigned int k = 0; k <= ringVertices; k++)
+				{
+					*index++ = base + i * ringVertices + k % ringVertices;
+					*index++ = base + (i + 1) * ringVertices + k % ringVertices;
+				}
+				*index++ = SnakeTubeRestart;
+			}
+		}
+	});
+}
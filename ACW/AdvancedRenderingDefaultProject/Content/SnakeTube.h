@@ -0,0 +1,57 @@
+#pragma once
+
+#include "SnakeSwarm.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Tube meshes around the SnakeSwarm skeletons, extruded on the CPU for SnakeTubeVS.hlsl. Each
+// skeleton point gets one ring, oriented by a rotation-minimizing frame along the snake and
+// shared by the segments either side of it. Only depends on the standard library and the
+// thread pool, so Sample3DSceneRenderer can use it directly.
+namespace AdvancedRenderingDefaultProject
+{
+	// Ends a strip in SnakeTube's index buffer (the strip cut value for 32-bit indices).
+	static const uint32_t SnakeTubeRestart = 0xffffffff;
+
+	// How finely the tubes are extruded. A snake's LOD level is its head's view depth (clip w)
+	// divided by lodDistance, up to lodLevels - 1, and each level halves the vertices around
+	// its rings, down to three.
+	struct SnakeTubeSettings
+	{
+		bool			enabled = true;			// false draws the snakes with SnakeGS.hlsl or SnakePullVS.hlsl
+		unsigned int	ringVertices = 10;		// at level 0
+		unsigned int	lodLevels = 3;			// 1 keeps every snake at level 0
+		float			lodDistance = 2.5f;
+	};
+
+	// Where each snake's vertices and indices go this frame, given its ring resolution.
+	class SnakeTube
+	{
+	public:
+		SnakeTube() : m_vertexCount(0), m_indexCount(0) {}
+
+		// Largest buffers Build can ask for, with every snake at level 0.
+		static size_t GetMaxVertexCount(const SnakeSwarm& swarm, const SnakeTubeSettings& settings);
+		static size_t GetMaxIndexCount(const SnakeSwarm& swarm, const SnakeTubeSettings& settings);
+
+		// Picks each snake's ring resolution for the row-vector modelViewProjection and lays
+		// out the mesh, split across threadPool.
+		void Build(const SnakeSwarm& swarm, const SnakeTubeSettings& settings, const float (&modelViewProjection)[4][4], DX::ThreadPool& threadPool);
+
+		size_t GetVertexCount() const { return m_vertexCount; }
+		size_t GetIndexCount() const { return m_indexCount; }
+
+		// Writes the rings to vertices as positions (float3) and, per snake, one triangle strip
+		// per segment to indices, each ended by SnakeTubeRestart.
+		void Write(const SnakeSwarm& swarm, float* vertices, uint32_t* indices, DX::ThreadPool& threadPool) const;
+
+	private:
+		std::vector<unsigned int>	m_ringVertices;		// per snake
+		std::vector<size_t>			m_vertexStart;		// per snake, then the total
+		std::vector<size_t>			m_indexStart;
+		size_t						m_vertexCount;
+		size_t						m_indexCount;
+	};
+}
@@ -0,0 +1,683 @@
+#include "SoftwareSceneRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace AdvancedRenderingDefaultProject;
+using namespace DX;
+
+namespace
+{
+	const float Pi = 3.14159265f;
+
+	// Sample3DSceneRenderer's camera and model rotation.
+	const float FieldOfViewY = 70.0f * Pi / 180.0f;
+	const float NearZ = 0.01f;
+	const float FarZ = 1000.0f;
+	const float3 Eye = float3(0.0f, 0.7f, 1.5f);
+	const float3 At = float3(0.0f, -0.1f, 0.0f);
+	const float3 Up = float3(0.0f, 1.0f, 0.0f);
+	const float DegreesPerSecond = 45.0f;
+
+	// DomainShader.hlsl's displacement scale.
+	const float FloorDisplacementScale = 0.1f;
+
+	float4x4 PerspectiveFovRH(float fovAngleY, float aspectRatio, float nearZ, float farZ)
+	{
+		float height = 1.0f / std::tan(fovAngleY * 0.5f);
+		float range = farZ / (nearZ - farZ);
+
+		float4x4 m;
+		m.m[0][0] = height / aspectRatio;
+		m.m[1][1] = height;
+		m.m[2][2] = range;
+		m.m[2][3] = -1.0f;
+		m.m[3][2] = range * nearZ;
+		m.m[3][3] = 0.0f;
+		return m;
+	}
+
+	float4x4 LookAtRH(const float3& eye, const float3& at, const float3& up)
+	{
+		float3 r2 = normalize(eye - at);
+		float3 r0 = normalize(cross(up, r2));
+		float3 r1 = cross(r2, r0);
+
+		float4x4 m;
+		const float3 axes[3] = { r0, r1, r2 };
+		for (int c = 0; c < 3; c++)
+		{
+			m.m[0][c] = axes[c].x;
+			m.m[1][c] = axes[c].y;
+			m.m[2][c] = axes[c].z;
+			m.m[3][c] = -dot(axes[c], eye);
+		}
+		return m;
+	}
+
+	float4x4 RotationY(float radians)
+	{
+		float c = std::cos(radians);
+		float s = std::sin(radians);
+
+		float4x4 m;
+		m.m[0][0] = c;
+		m.m[0][2] = -s;
+		m.m[2][0] = s;
+		m.m[2][2] = c;
+		return m;
+	}
+
+	RasterVertex MakeVertex(const float4& position, const float2& uv)
+	{
+		RasterVertex v;
+		v.position = position;
+		v.varying = float4(uv.x, uv.y, 0.0f, 0.0f);
+		return v;
+	}
+
+	float2 VaryingUv(const float4& varying)
+	{
+		return float2(varying.x, varying.y);
+	}
+
+	// Triangle strip to list; culling is off where strips are drawn, so the alternating winding
+	// doesn't matter.
+	void AppendStrip(const RasterVertex* strip, unsigned int count, std::vector<RasterVertex>& vertices)
+	{
+		for (unsigned int v = 0; v + 2 < count; v++)
+		{
+			vertices.push_back(strip[v]);
+			vertices.push_back(strip[v + 1]);
+			vertices.push_back(strip[v + 2]);
+		}
+	}
+
+	// SnakePS.hlsl, blended and without culling.
+	RasterState SnakeRasterState(const SoftwareTexture* snakeTex)
+	{
+		RasterState state;
+		state.cull = RasterCullMode::None;
+		state.alphaBlend = true;
+		state.pixelShader = [snakeTex](const float4& varying, float4& color)
+		{
+			color = snakeTex->Sample(VaryingUv(varying));
+			return true;
+		};
+		return state;
+	}
+
+	// HullShader.hlsl's fixed-function stage for a patch with every factor set to factor.
+	TessellatorPattern TessellatePatch(TessellatorDomain domain, TessellatorPartitioning partitioning, float factor)
+	{
+		TessellatorPattern pattern;
+		Tessellator(partitioning, TessellatorOutput::TriangleCW).Tessellate(domain, TessellatorFactors::Uniform(factor), pattern);
+		return pattern;
+	}
+
+	// One domain shader output per point, then the pattern's triangles over them.
+	void AppendPatch(const TessellatorPattern& pattern, const std::vector<RasterVertex>& points, std::vector<RasterVertex>& vertices)
+	{
+		for (unsigned int index : pattern.indices)
+		{
+			vertices.push_back(points[index]);
+		}
+	}
+
+	double SecondsSince(const std::chrono::high_resolution_clock::time_point& start)
+	{
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+}
+
+const char* AdvancedRenderingDefaultProject::SoftwarePassName(SoftwarePass pass)
+{
+	switch (pass)
+	{
+	case SoftwarePass::Floor: return "floor";
+	case SoftwarePass::Snake: return "snake";
+	case SoftwarePass::Grass: return "grass";
+	case SoftwarePass::Torus: return "torus";
+	case SoftwarePass::Ellipsoid: return "ellipsoid";
+	case SoftwarePass::Sphere: return "sphere";
+	}
+	return "unknown";
+}
+
+SoftwareSceneRenderer::SoftwareSceneRenderer(const std::shared_ptr<SoftwareDeviceResources>& deviceResources) :
+	m_deviceResources(deviceResources),
+	m_geometryExpansion(GeometryExpansion::GeometryShader),
+	m_time(0.0f),
+	m_displacementFactor(0.01f),
+	m_parametricCached(true),
+	m_parametricTessFactor(ParametricDefaultTessFactor)
+{
+	CreateTextures();
+
+	SetGrassField(GrassFieldSettings());
+	SetSnakeSwarm(SnakeSwarmSettings());
+	Update(0.0);
+}
+
+void SoftwareSceneRenderer::SetGrassField(const GrassFieldSettings& settings)
+{
+	m_grassField.Generate(settings, m_deviceResources->GetThreadPool());
+}
+
+void SoftwareSceneRenderer::Update(double totalSeconds)
+{
+	// CreateWindowSizeDependentResources: portrait views get twice the field of view.
+	float aspectRatio = m_deviceResources->GetAspectRatio();
+	float fovAngleY = aspectRatio < 1.0f ? FieldOfViewY * 2.0f : FieldOfViewY;
+	m_projection = PerspectiveFovRH(fovAngleY, aspectRatio, NearZ, FarZ);
+	m_view = LookAtRH(Eye, At, Up);
+
+	double totalRotation = totalSeconds * (DegreesPerSecond * Pi / 180.0f);
+	m_model = RotationY(static_cast<float>(std::fmod(totalRotation * 0.5, 2.0 * Pi)));
+	float seconds = static_cast<float>(totalSeconds);
+	if (seconds > m_time)
+	{
+		m_snakeSwarm.Update(seconds - m_time, m_deviceResources->GetThreadPool());
+	}
+	m_time = seconds;
+}
+
+void SoftwareSceneRenderer::Render()
+{
+	SoftwareRasterizer& rasterizer = m_deviceResources->GetRasterizer();
+	rasterizer.Clear(float4(0.5f, 0.5f, 0.5f, 1.0f), 1.0f);
+
+	for (auto& stats : m_passStats)
+	{
+		stats = SoftwarePassStats();
+	}
+
+	DrawFloor();
+	DrawSnakes();
+	DrawGrass();
+	DrawParametric(SoftwarePass::Torus);
+	DrawParametric(SoftwarePass::Ellipsoid);
+	DrawParametric(SoftwarePass::Sphere);
+}
+
+float4 SoftwareSceneRenderer::Project(const float4& position) const
+{
+	return mul(mul(mul(position, m_model), m_view), m_projection);
+}
+
+void SoftwareSceneRenderer::Draw(SoftwarePass pass, const RasterState& state)
+{
+	m_deviceResources->GetRasterizer().DrawTriangles(m_vertices.data(), m_vertices.size(), state);
+	m_passStats[static_cast<int>(pass)].triangles += m_vertices.size() / 3;
+	m_vertices.clear();
+}
+
+float SoftwareSceneRenderer::FloorEdgeTessFactor(float3 a, float3 b) const
+{
+	// HullShader.hlsl FloorEdgeTessFactor. Both patches sharing an edge see it the same way
+	// round, so they agree on its factor.
+	if (a.x > b.x || (a.x == b.x && a.z > b.z))
+	{
+		std::swap(a, b);
+	}
+
+	float mean = 0.0f;
+	float meanSquare = 0.0f;
+	for (unsigned int i = 0; i < FloorEdgeSamples; i++)
+	{
+		float t = (i + 0.5f) / FloorEdgeSamples;
+		float3 p = a + (b - a) * t;
+		float disp = m_textures.floorDisplacement.Sample(float2(mod(p.x, 1.0f), mod(p.z, 1.0f))).x;
+		mean += disp;
+		meanSquare += disp * disp;
+	}
+	mean /= FloorEdgeSamples;
+	meanSquare /= FloorEdgeSamples;
+	float deviation = std::sqrt(std::max(meanSquare - mean * mean, 0.0f));
+
+	a.y += mean * FloorDisplacementScale;
+	b.y += mean * FloorDisplacementScale;
+	float4 clipA = Project(float4(a.x, a.y, a.z, 1.0f));
+	float4 clipB = Project(float4(b.x, b.y, b.z, 1.0f));
+	float halfWidth = 0.5f * m_deviceResources->GetOutputWidth();
+	float halfHeight = 0.5f * m_deviceResources->GetOutputHeight();
+	float wA = std::max(clipA.w, 0.01f);
+	float wB = std::max(clipB.w, 0.01f);
+	float dx = (clipA.x / wA - clipB.x / wB) * halfWidth;
+	float dy = (clipA.y / wA - clipB.y / wB) * halfHeight;
+	float pixels = std::sqrt(dx * dx + dy * dy);
+
+	float detail = lerp(m_floorTessellation.flatDetail, 1.0f, saturate(deviation / m_floorTessellation.detailDeviation));
+	return clamp(pixels * std::sqrt(m_floorTessellation.trianglesPerPixel * 0.5f) * detail, 1.0f, 63.0f);
+}
+
+void SoftwareSceneRenderer::DrawFloorPatch(const TessellatorPattern& pattern, const float3 corners[4])
+{
+	// DomainShader.hlsl DS_QuadTess.
+	m_floorPatch.clear();
+	for (const float2& uv : pattern.points)
+	{
+		float3 vPos1 = corners[0] * (1.0f - uv.y) + corners[1] * uv.y;
+		float3 vPos2 = corners[2] * (1.0f - uv.y) + corners[3] * uv.y;
+		float3 position = vPos1 * (1.0f - uv.x) + vPos2 * uv.x;
+		float2 uvs(mod(position.x, 1.0f), mod(position.z, 1.0f));
+		position.y += m_textures.floorDisplacement.Sample(uvs).x * FloorDisplacementScale;
+		m_floorPatch.push_back(MakeVertex(Project(float4(position.x, position.y, position.z, 1.0f)), uvs));
+	}
+	AppendPatch(pattern, m_floorPatch, m_vertices);
+	m_passStats[static_cast<int>(SoftwarePass::Floor)].domainPoints += pattern.points.size();
+}
+
+void SoftwareSceneRenderer::DrawFloor()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (!m_floorTessellation.adaptive)
+	{
+		static const TessellatorPattern pattern = TessellatePatch(TessellatorDomain::Quad, TessellatorPartitioning::FractionalOdd, FloorFixedTessFactor);
+		const float3 corners[4] = { float3(-1.0f, 0.0f, -1.0f), float3(-1.0f, 0.0f, 1.0f), float3(1.0f, 0.0f, -1.0f), float3(1.0f, 0.0f, 1.0f) };
+		DrawFloorPatch(pattern, corners);
+	}
+	else
+	{
+		// HullShader.hlsl ConstantHS over the patch grid.
+		Tessellator tessellator(TessellatorPartitioning::FractionalOdd, TessellatorOutput::TriangleCW);
+		TessellatorPattern pattern;
+		for (unsigned int z = 0; z < FloorPatchGrid; z++)
+		{
+			for (unsigned int x = 0; x < FloorPatchGrid; x++)
+			{
+				float x0 = -1.0f + 2.0f * x / FloorPatchGrid;
+				float x1 = -1.0f + 2.0f * (x + 1) / FloorPatchGrid;
+				float z0 = -1.0f + 2.0f * z / FloorPatchGrid;
+				float z1 = -1.0f + 2.0f * (z + 1) / FloorPatchGrid;
+				const float3 corners[4] = { float3(x0, 0.0f, z0), float3(x0, 0.0f, z1), float3(x1, 0.0f, z0), float3(x1, 0.0f, z1) };
+
+				TessellatorFactors factors;
+				factors.edges[0] = FloorEdgeTessFactor(corners[0], corners[1]);
+				factors.edges[1] = FloorEdgeTessFactor(corners[0], corners[2]);
+				factors.edges[2] = FloorEdgeTessFactor(corners[2], corners[3]);
+				factors.edges[3] = FloorEdgeTessFactor(corners[1], corners[3]);
+				factors.inside[0] = std::max(factors.edges[1], factors.edges[3]);
+				factors.inside[1] = std::max(factors.edges[0], factors.edges[2]);
+
+				tessellator.Tessellate(TessellatorDomain::Quad, factors, pattern);
+				DrawFloorPatch(pattern, corners);
+			}
+		}
+	}
+
+	// SamplePixelShader.hlsl; the specular term never reaches the output.
+	const SoftwareTexture* floorTex = &m_textures.floor;
+	const SoftwareTexture* floorNorm = &m_textures.floorNormal;
+	RasterState state;
+	state.alphaBlend = true;
+	state.pixelShader = [floorTex, floorNorm](const float4& varying, float4& color)
+	{
+		float2 uvs = VaryingUv(varying);
+		float4 finalColor = floorTex->Sample(uvs);
+		float4 normal = floorNorm->Sample(uvs);
+		finalColor.x = 0.5f;
+		finalColor.z = 0.5f;
+
+		float4 lit(0.2f, 0.2f, 0.2f, 1.0f);
+		float lightIntensity = saturate(normal.y);
+		if (lightIntensity > 0.0f)
+		{
+			lit = lit + finalColor * lightIntensity;
+			lit = float4(saturate(lit.x), saturate(lit.y), saturate(lit.z), saturate(lit.w));
+		}
+
+		color = lit * finalColor;
+		return true;
+	};
+
+	m_passStats[static_cast<int>(SoftwarePass::Floor)].seconds += SecondsSince(start);
+	Draw(SoftwarePass::Floor, state);
+}
+
+RasterVertex SoftwareSceneRenderer::SnakeVertex(const float* segment, unsigned int vertex) const
+{
+	// SnakePullVS.hlsl: ring step vertex / 2, on the tail for even vertices and the head for odd.
+	const float* end = segment + (vertex & 1) * SnakeVertexFloats;
+	float angle = 3.14f * 2.0f / 5.0f * (vertex / 2);
+	float4 ring(std::cos(angle), -std::sin(angle), 0.0f, 0.0f);
+
+	float4 position = float4(end[0], end[1], end[2], 1.0f) + ring * end[3];
+	float2 uv(mod(position.x, 1.0f), mod(position.z, 1.0f));
+	return MakeVertex(Project(position), uv);
+}
+
+void SoftwareSceneRenderer::DrawSnakes()
+{
+	if (m_snakeTubeSettings.enabled)
+	{
+		DrawSnakeTubes();
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// Sample3DSceneRenderer::UploadSnakes
+	size_t segmentCount = m_snakeSwarm.GetSegmentCount();
+	m_snakeUpload.resize(segmentCount * 2 * SnakeVertexFloats);
+	m_snakeSwarm.Write(m_snakeUpload.data(), m_deviceResources->GetThreadPool());
+
+	for (size_t s = 0; s < segmentCount; s++)
+	{
+		const float* segment = &m_snakeUpload[s * 2 * SnakeVertexFloats];
+		RasterVertex strip[SnakeSegmentVertices];
+		if (m_geometryExpansion == GeometryExpansion::Instanced)
+		{
+			for (unsigned int vertex = 0; vertex < SnakeSegmentVertices; vertex++)
+			{
+				strip[vertex] = SnakeVertex(segment, vertex);
+			}
+		}
+		else
+		{
+			// SnakeGS.hlsl: an 11 step ring strip from tail to head, each ring step shared by
+			// both ends.
+			for (unsigned int i = 0; i < SnakeSegmentVertices / 2; i++)
+			{
+				float angle = 3.14f * 2.0f / 5.0f * i;
+				float4 ring(std::cos(angle), -std::sin(angle), 0.0f, 0.0f);
+				for (unsigned int end = 0; end < 2; end++)
+				{
+					const float* point = segment + end * SnakeVertexFloats;
+					float4 position = float4(point[0], point[1], point[2], 1.0f) + ring * point[3];
+					float2 uv(mod(position.x, 1.0f), mod(position.z, 1.0f));
+					strip[i * 2 + end] = MakeVertex(Project(position), uv);
+				}
+			}
+		}
+		AppendStrip(strip, SnakeSegmentVertices, m_vertices);
+	}
+
+	m_passStats[static_cast<int>(SoftwarePass::Snake)].seconds += SecondsSince(start);
+	Draw(SoftwarePass::Snake, SnakeRasterState(&m_textures.snake));
+}
+
+void SoftwareSceneRenderer::DrawSnakeTubes()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// Sample3DSceneRenderer::UploadSnakeTubes
+	float4x4 modelViewProjection = mul(mul(m_model, m_view), m_projection);
+	m_snakeTube.Build(m_snakeSwarm, m_snakeTubeSettings, modelViewProjection.m, m_deviceResources->GetThreadPool());
+	m_snakeTubeVertices.resize(m_snakeTube.GetVertexCount() * 3);
+	m_snakeTubeIndices.resize(m_snakeTube.GetIndexCount());
+	m_snakeTube.Write(m_snakeSwarm, m_snakeTubeVertices.data(), m_snakeTubeIndices.data(), m_deviceResources->GetThreadPool());
+
+	// SnakeTubeVS.hlsl, once per vertex however many strips share it.
+	m_snakeTubeShaded.resize(m_snakeTube.GetVertexCount());
+	for (size_t v = 0; v < m_snakeTubeShaded.size(); v++)
+	{
+		const float* p = &m_snakeTubeVertices[v * 3];
+		m_snakeTubeShaded[v] = MakeVertex(Project(float4(p[0], p[1], p[2], 1.0f)), float2(mod(p[0], 1.0f), mod(p[2], 1.0f)));
+	}
+
+	// The strips, cut at each SnakeTubeRestart.
+	size_t stripStart = 0;
+	for (size_t i = 0; i < m_snakeTubeIndices.size(); i++)
+	{
+		if (m_snakeTubeIndices[i] == SnakeTubeRestart)
+		{
+			stripStart = i + 1;
+		}
+		else if (i >= stripStart + 2)
+		{
+			m_vertices.push_back(m_snakeTubeShaded[m_snakeTubeIndices[i - 2]]);
+			m_vertices.push_back(m_snakeTubeShaded[m_snakeTubeIndices[i - 1]]);
+			m_vertices.push_back(m_snakeTubeShaded[m_snakeTubeIndices[i]]);
+		}
+	}
+
+	m_passStats[static_cast<int>(SoftwarePass::Snake)].seconds += SecondsSince(start);
+	Draw(SoftwarePass::Snake, SnakeRasterState(&m_textures.snake));
+}
+
+void SoftwareSceneRenderer::DrawGrass()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// GrassParticleGS.hlsl: a view-aligned quad per point, its top corners swaying with time.
+	static const float2 corners[4] = { float2(-1.0f, -1.0f), float2(-1.0f, 1.0f), float2(1.0f, -1.0f), float2(1.0f, 1.0f) };
+	static const float2 uvs[4] = { float2(0.0f, 1.0f), float2(0.0f, 0.0f), float2(1.0f, 1.0f), float2(1.0f, 0.0f) };
+	const float windSpeed = 1.0f;
+	const float waveAmplitude = 0.1f;
+	const float dampening = 0.25f;
+
+	float swayX = std::cos(windSpeed * m_time) * waveAmplitude * dampening;
+	float swayZ = std::sin(windSpeed * m_time) * waveAmplitude * dampening;
+
+	// Sample3DSceneRenderer::UploadVisibleGrass
+	GrassView view;
+	float4x4 modelViewProjection = mul(mul(m_model, m_view), m_projection);
+	std::copy(&modelViewProjection.m[0][0], &modelViewProjection.m[0][0] + 16, &view.modelViewProjection[0][0]);
+	view.lod = m_grassLod;
+	m_grassField.Cull(view, m_deviceResources->GetThreadPool(), m_grassVisible);
+	m_grassUpload.resize(m_grassVisible.GetCardCount() * 4);
+	m_grassField.Write(m_grassVisible, m_grassUpload.data(), m_deviceResources->GetThreadPool());
+
+	if (m_grassVisible.groundChunks > 0)
+	{
+		DrawGrassGround();
+		start = std::chrono::high_resolution_clock::now();
+	}
+
+	auto corner = [&](const float4& viewPosition, float scale, unsigned int c)
+	{
+		float4 position = viewPosition + float4(corners[c].x * GrassBladeSize * scale, corners[c].y * GrassBladeSize, 0.0f, 0.0f);
+		if (c % 2 == 1)
+		{
+			position.z += swayZ;
+			position.x += swayX;
+		}
+		return MakeVertex(mul(position, m_projection), float2(uvs[c].x * scale, uvs[c].y));
+	};
+
+	bool instanced = m_geometryExpansion == GeometryExpansion::Instanced;
+	for (size_t card = 0; card < m_grassVisible.GetCardCount(); card++)
+	{
+		const float* p = &m_grassUpload[card * 4];
+		float scale = p[3];
+
+		RasterVertex quad[GrassCardVertices];
+		if (instanced)
+		{
+			// GrassInstancedVS.hlsl: every corner reads the card and moves it into view space.
+			for (unsigned int c = 0; c < GrassCardVertices; c++)
+			{
+				quad[c] = corner(mul(mul(float4(p[0], p[1], p[2], 1.0f), m_model), m_view), scale, c);
+			}
+		}
+		else
+		{
+			float4 viewPosition = mul(mul(float4(p[0], p[1], p[2], 1.0f), m_model), m_view);
+			for (unsigned int c = 0; c < GrassCardVertices; c++)
+			{
+				quad[c] = corner(viewPosition, scale, c);
+			}
+		}
+
+		m_vertices.push_back(quad[0]); m_vertices.push_back(quad[1]); m_vertices.push_back(quad[2]);
+		m_vertices.push_back(quad[2]); m_vertices.push_back(quad[1]); m_vertices.push_back(quad[3]);
+	}
+
+	// GrassPS.hlsl
+	const SoftwareTexture* grassTex = &m_textures.grass;
+	RasterState state;
+	state.alphaBlend = true;
+	state.pixelShader = [grassTex](const float4& varying, float4& color)
+	{
+		color = grassTex->Sample(float2(frac(varying.x), varying.y));
+		color.x = 0.7f;
+		color.z = 0.7f;
+		return color.w >= 0.1f;
+	};
+
+	m_passStats[static_cast<int>(SoftwarePass::Grass)].seconds += SecondsSince(start);
+	Draw(SoftwarePass::Grass, state);
+}
+
+void SoftwareSceneRenderer::DrawGrassGround()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// Sample3DSceneRenderer::DrawGrassGround's coverage texture.
+	unsigned int gridSize = m_grassField.GetGridSize();
+	m_grassGround.Resize(gridSize, gridSize, float4());
+	for (unsigned int z = 0; z < gridSize; z++)
+	{
+		for (unsigned int x = 0; x < gridSize; x++)
+		{
+			float coverage = m_grassVisible.ground[z * gridSize + x] / 255.0f;
+			m_grassGround.At(x, z) = float4(coverage, 0.0f, 0.0f, 1.0f);
+		}
+	}
+
+	// GrassGroundVS.hlsl over the quad at the blade tips; the field position rides in the
+	// varying's zw.
+	float extent = m_grassField.GetExtent();
+	float height = m_grassField.GetGroundHeight();
+	RasterVertex quad[4];
+	for (unsigned int c = 0; c < 4; c++)
+	{
+		float u = static_cast<float>(c / 2), v = static_cast<float>(c % 2);
+		float3 p(extent * (2.0f * u - 1.0f), height, extent * (2.0f * v - 1.0f));
+		quad[c].position = Project(float4(p.x, p.y, p.z, 1.0f));
+		quad[c].varying = float4(p.x / (2.0f * GrassBladeSize), p.z / (2.0f * GrassBladeSize), u, v);
+	}
+	m_vertices.push_back(quad[0]); m_vertices.push_back(quad[1]); m_vertices.push_back(quad[2]);
+	m_vertices.push_back(quad[2]); m_vertices.push_back(quad[1]); m_vertices.push_back(quad[3]);
+
+	// GrassGroundPS.hlsl
+	const SoftwareTexture* grassTex = &m_textures.grass;
+	const SoftwareTexture* groundTex = &m_grassGround;
+	RasterState state;
+	state.cull = RasterCullMode::None;
+	state.alphaBlend = true;
+	state.pixelShader = [grassTex, groundTex](const float4& varying, float4& color)
+	{
+		color = grassTex->Sample(float2(frac(varying.x), 0.25f * frac(varying.y)));
+		color.x = 0.7f;
+		color.z = 0.7f;
+		color.w = groundTex->Sample(float2(varying.z, varying.w)).x;
+		return color.w > 0.0f;
+	};
+
+	m_passStats[static_cast<int>(SoftwarePass::Grass)].seconds += SecondsSince(start);
+	Draw(SoftwarePass::Grass, state);
+}
+
+void SoftwareSceneRenderer::BuildParametricMesh(int shape, const ParametricMeshKey& key)
+{
+	// ParametricDS.hlsl, over the TriPos triangle.
+	ParametricMesh& mesh = m_parametricMeshes[shape];
+	mesh.key = key;
+	mesh.pattern = m_tessellatorCache.Get(TessellatorDomain::Tri, TessellatorPartitioning::Integer, TessellatorOutput::TriangleCW,
+		TessellatorFactors::Uniform(static_cast<float>(key.tessFactor)));
+	mesh.positions.clear();
+	mesh.uvs.clear();
+
+	Parametric::Parameters parameters;
+	parameters.FromDomainLocations(mesh.pattern->points.data(), mesh.pattern->points.size());
+	Parametric::Evaluate(ParametricShapes[shape], parameters, m_parametricPoints);
+
+	for (size_t i = 0; i < m_parametricPoints.GetCount(); i++)
+	{
+		float3 finalPos = m_parametricPoints.GetPosition(i);
+		float2 uvs = m_parametricPoints.GetUv(i);
+		if (key.displacement != 0.0f)
+		{
+			finalPos = finalPos + m_textures.floorDisplacement.Sample(uvs).x * (key.displacement * ParametricShapes[shape].displacement);
+		}
+
+		mesh.positions.push_back(finalPos);
+		mesh.uvs.push_back(uvs);
+	}
+}
+
+void SoftwareSceneRenderer::DrawParametric(SoftwarePass pass)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	int shape = static_cast<int>(pass) - static_cast<int>(SoftwarePass::Torus);
+	ParametricMeshKey key = ParametricMeshKey::Make(ParametricShapes[shape], m_parametricTessFactor, m_displacementFactor);
+	const ParametricMesh& mesh = m_parametricMeshes[shape];
+	if (!m_parametricCached || !mesh.pattern || mesh.key != key)
+	{
+		BuildParametricMesh(shape, key);
+		m_passStats[static_cast<int>(pass)].domainPoints += mesh.positions.size();
+	}
+
+	// ParametricCachedVS.hlsl, or the rest of the domain shader.
+	std::vector<RasterVertex> patch;
+	patch.reserve(mesh.positions.size());
+	for (size_t i = 0; i < mesh.positions.size(); i++)
+	{
+		const float3& p = mesh.positions[i];
+		patch.push_back(MakeVertex(Project(float4(p.x, p.y, p.z, 1.0f)), mesh.uvs[i]));
+	}
+
+	AppendPatch(*mesh.pattern, patch, m_vertices);
+
+	// ParametricPS.hlsl, in the shape's fill mode.
+	const SoftwareTexture* metalTex = &m_textures.metal;
+	RasterState state;
+	state.cull = RasterCullMode::None;
+	state.fill = ParametricShapes[shape].wireframe ? RasterFillMode::Wireframe : RasterFillMode::Solid;
+	state.alphaBlend = true;
+	state.pixelShader = [metalTex](const float4& varying, float4& color)
+	{
+		color = metalTex->Sample(VaryingUv(varying));
+		return true;
+	};
+
+	m_passStats[static_cast<int>(pass)].seconds += SecondsSince(start);
+	Draw(pass, state);
+}
+
+void SoftwareSceneRenderer::CreateTextures()
+{
+	const unsigned int size = 64;
+
+	m_textures.floor.Resize(size, size, float4());
+	m_textures.floorNormal.Resize(size, size, float4());
+	m_textures.floorDisplacement.Resize(size, size, float4());
+	m_textures.grass.Resize(size, size, float4());
+	m_textures.snake.Resize(size, size, float4());
+	m_textures.metal.Resize(size, size, float4());
+
+	for (unsigned int y = 0; y < size; y++)
+	{
+		for (unsigned int x = 0; x < size; x++)
+		{
+			float u = (x + 0.5f) / size;
+			float v = (y + 0.5f) / size;
+			float wave = std::sin(u * 2.0f * Pi) * std::sin(v * 2.0f * Pi);
+			float ripple = std::sin(u * 14.0f * Pi) * std::sin(v * 10.0f * Pi);
+
+			// Mottled ground; the shader replaces red and blue.
+			m_textures.floor.At(x, y) = float4(0.5f, 0.45f + 0.1f * ripple, 0.5f, 1.0f);
+
+			// Tangent-space normal map, stored unsigned as in the .dds.
+			m_textures.floorNormal.At(x, y) = float4(0.5f + 0.1f * ripple, 0.55f + 0.1f * wave, 1.0f, 1.0f);
+
+			float height = 0.5f + 0.5f * wave;
+			m_textures.floorDisplacement.At(x, y) = float4(height, height, height, 1.0f);
+
+			// A blade tapering from the bottom edge (v = 1) to a point at the top.
+			bool blade = std::fabs(u - 0.5f) < 0.35f * v;
+			m_textures.grass.At(x, y) = float4(0.7f, 0.35f + 0.5f * (1.0f - v), 0.7f, blade ? 1.0f : 0.0f);
+
+			bool stripe = mod(v * 8.0f, 1.0f) < 0.5f;
+			m_textures.snake.At(x, y) = stripe ? float4(0.55f, 0.4f, 0.15f, 1.0f) : float4(0.2f, 0.3f, 0.1f, 1.0f);
+
+			float brushed = 0.6f + 0.1f * std::sin(v * 40.0f * Pi) + 0.2f * u;
+			m_textures.metal.At(x, y) = float4(brushed, brushed, brushed * 1.05f, 1.0f);
+		}
+	}
+}
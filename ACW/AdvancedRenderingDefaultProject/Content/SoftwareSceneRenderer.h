@@ -0,0 +1,158 @@
+#pragma once
+
+#include "../Common/HlslMath.h"
+#include "../Common/SoftwareDeviceResources.h"
+#include "../Common/SoftwareTexture.h"
+#include "../Common/Tessellator.h"
+#include "FloorTessellation.h"
+#include "GeometryExpansion.h"
+#include "GrassField.h"
+#include "ParametricEvaluator.h"
+#include "ParametricMeshCache.h"
+#include "SnakeSwarm.h"
+#include "SnakeTube.h"
+
+#include <memory>
+#include <vector>
+
+namespace AdvancedRenderingDefaultProject
+{
+	// The explicit passes, in the order Sample3DSceneRenderer::Render draws them.
+	enum class SoftwarePass
+	{
+		Floor,
+		Snake,
+		Grass,
+		Torus,
+		Ellipsoid,
+		Sphere
+	};
+
+	static const int SoftwarePassCount = 6;
+
+	const char* SoftwarePassName(SoftwarePass pass);
+
+	struct SoftwarePassStats
+	{
+		unsigned long long	triangles = 0;		// triangles handed to the rasterizer
+		unsigned long long	domainPoints = 0;	// domain shader invocations
+		double				seconds = 0.0;		// shading the vertices and queuing the triangles
+	};
+
+	// Textures the passes sample. They start out as procedural stand-ins for the .dds files
+	// the app loads and can be replaced before rendering.
+	struct SoftwareSceneTextures
+	{
+		DX::SoftwareTexture	floor;
+		DX::SoftwareTexture	floorNormal;
+		DX::SoftwareTexture	floorDisplacement;
+		DX::SoftwareTexture	grass;
+		DX::SoftwareTexture	snake;
+		DX::SoftwareTexture	metal;
+	};
+
+	// CPU port of the non-implicit half of Sample3DSceneRenderer: the tessellated floor, the
+	// snakes, the grass billboards and the parametric shapes, each stage running the same maths
+	// as its shader and drawn with the same raster, depth and blend state. Draw calls are
+	// reproduced as issued, the grass as the chunks Sample3DSceneRenderer culls and uploads.
+	class SoftwareSceneRenderer
+	{
+	public:
+		SoftwareSceneRenderer(const std::shared_ptr<DX::SoftwareDeviceResources>& deviceResources);
+
+		// Same camera and animation as Sample3DSceneRenderer::Update at totalSeconds. The snakes
+		// are simulated forward from the previous call's time.
+		void Update(double totalSeconds);
+
+		// Clears the target and draws every pass; the frame is finished by Present.
+		void Render();
+
+		SoftwareSceneTextures& GetTextures() { return m_textures; }
+		const SoftwarePassStats& GetPassStats(SoftwarePass pass) const { return m_passStats[static_cast<int>(pass)]; }
+
+		// Sphere displacement scale, displacementFactor.x in the shaders.
+		void SetDisplacementFactor(float factor) { m_displacementFactor = factor; }
+
+		// FloorTessellationBuffer.
+		void SetFloorTessellation(const FloorTessellationSettings& settings) { m_floorTessellation = settings; }
+
+		// Sample3DSceneRenderer's parametric mesh cache and ParametricTessellationBuffer. Cached
+		// shapes are evaluated once per key; uncached ones run the domain shader every frame.
+		void SetParametricCaching(bool cached) { m_parametricCached = cached; }
+		void SetParametricTessFactor(unsigned int factor) { m_parametricTessFactor = factor; }
+
+		// Sample3DSceneRenderer's grass field and LOD, the scene's by default.
+		void SetGrassField(const GrassFieldSettings& settings);
+		void SetGrassLod(const GrassLodSettings& lod) { m_grassLod = lod; }
+
+		// Sample3DSceneRenderer's snakes, the scene's two by default.
+		void SetSnakeSwarm(const SnakeSwarmSettings& settings) { m_snakeSwarm.Generate(settings); }
+		void SetSnakeTube(const SnakeTubeSettings& settings) { m_snakeTubeSettings = settings; }
+
+		// Sample3DSceneRenderer's grass and snake path. Both give the same triangles; the
+		// instanced one does each primitive's work again for every vertex, as its shaders do.
+		void SetGeometryExpansion(GeometryExpansion expansion) { m_geometryExpansion = expansion; }
+
+	private:
+		void CreateTextures();
+
+		DX::float4 Project(const DX::float4& position) const;
+		void Draw(SoftwarePass pass, const DX::RasterState& state);
+
+		float FloorEdgeTessFactor(DX::float3 a, DX::float3 b) const;
+		void DrawFloorPatch(const DX::TessellatorPattern& pattern, const DX::float3 corners[4]);
+		void DrawFloor();
+		DX::RasterVertex SnakeVertex(const float* segment, unsigned int vertex) const;
+		void DrawSnakes();
+		void DrawSnakeTubes();
+		void DrawGrass();
+		void DrawGrassGround();
+		void BuildParametricMesh(int shape, const ParametricMeshKey& key);
+		void DrawParametric(SoftwarePass pass);
+
+	private:
+		std::shared_ptr<DX::SoftwareDeviceResources>	m_deviceResources;
+
+		SoftwareSceneTextures							m_textures;
+		GrassField										m_grassField;
+		GrassLodSettings								m_grassLod;
+		GrassVisibleSet									m_grassVisible;
+		std::vector<float>								m_grassUpload;
+		DX::SoftwareTexture								m_grassGround;
+		GeometryExpansion								m_geometryExpansion;
+		SnakeSwarm										m_snakeSwarm;
+		std::vector<float>								m_snakeUpload;
+		SnakeTubeSettings								m_snakeTubeSettings;
+		SnakeTube										m_snakeTube;
+		std::vector<float>								m_snakeTubeVertices;
+		std::vector<uint32_t>							m_snakeTubeIndices;
+		std::vector<DX::RasterVertex>					m_snakeTubeShaded;
+
+		// ModelViewProjectionConstantBuffer, TimeBuffer and DisplacementBuffer.
+		DX::float4x4									m_model;
+		DX::float4x4									m_view;
+		DX::float4x4									m_projection;
+		float											m_time;
+		float											m_displacementFactor;
+		FloorTessellationSettings						m_floorTessellation;
+
+		// A parametric shape in model space, as the domain shader leaves it.
+		struct ParametricMesh
+		{
+			ParametricMeshKey							key;
+			std::shared_ptr<const DX::TessellatorPattern>	pattern;
+			std::vector<DX::float3>						positions;
+			std::vector<DX::float2>						uvs;
+		};
+		DX::TessellatorCache							m_tessellatorCache;
+		ParametricMesh									m_parametricMeshes[ParametricShapeCount];
+		Parametric::Points								m_parametricPoints;
+		bool											m_parametricCached;
+		unsigned int									m_parametricTessFactor;
+
+		// Vertices of the draw being built, three per triangle.
+		std::vector<DX::RasterVertex>					m_vertices;
+		std::vector<DX::RasterVertex>					m_floorPatch;
+		SoftwarePassStats								m_passStats[SoftwarePassCount];
+	};
+}
@@ -47,13 +47,19 @@ cbuffer TimeBuffer : register (b1)
 	float3 padding;
 }
 
+struct HS_OUTPUT
+{
+	float4 pos : SV_POSITION;
+};
+
+// One patch of the floor grid, corners in QuadPos order.
 [domain("quad")]
-VS_OUTPUT DS_QuadTess(HS_Quad_Tess_Param input, float2 uv : SV_DomainLocation)
+VS_OUTPUT DS_QuadTess(HS_Quad_Tess_Param input, float2 uv : SV_DomainLocation, const OutputPatch<HS_OUTPUT, 4> patch)
 {
 	VS_OUTPUT output;
 
-	float3 vPos1 = (1.0f - uv.y) * QuadPos[0] + uv.y * QuadPos[1].xyz;
-	float3 vPos2 = (1.0f - uv.y) * QuadPos[2] + uv.y * QuadPos[3].xyz;
+	float3 vPos1 = (1.0f - uv.y) * patch[0].pos.xyz + uv.y * patch[1].pos.xyz;
+	float3 vPos2 = (1.0f - uv.y) * patch[2].pos.xyz + uv.y * patch[3].pos.xyz;
 	float3 uvPos = (1.0f - uv.x) * vPos1 + uv.x * vPos2;
 
 	output.pos = float4(uvPos.x, uvPos.y, uvPos.z, 1);
@@ -0,0 +1,27 @@
+Texture2D grass : register (t0);
+Texture2D coverage : register (t1);
+SamplerState Sampler;
+
+struct PixelShaderInput
+{
+	float4 pos : SV_POSITION;
+	float2 uvs : TEXCOORD0;
+	float2 blades : TEXCOORD1;
+};
+
+// Far grass: the top quarter of the blade texture, what shows of the blades from a distance,
+// repeated over the ground and tinted as GrassPS.hlsl tints it. It is as opaque as the blades
+// of the chunks drawn as ground cover it; other chunks' texels are zero.
+float4 main(PixelShaderInput input) : SV_TARGET
+{
+	float4 finalColor = grass.Sample(Sampler, float2(frac(input.blades.x), 0.25f * frac(input.blades.y)));
+	finalColor.r = 0.7f;
+	finalColor.b = 0.7f;
+	finalColor.a = coverage.Sample(Sampler, input.uvs).r;
+
+	if (finalColor.a <= 0.0f)
+	{
+		discard;
+	}
+	return finalColor;
+}
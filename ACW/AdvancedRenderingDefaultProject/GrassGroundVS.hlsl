@@ -0,0 +1,37 @@
+// A constant buffer that stores the three basic column-major matrices for composing geometry.
+cbuffer ModelViewProjectionConstantBuffer : register(b0)
+{
+	matrix model;
+	matrix view;
+	matrix projection;
+};
+
+// A corner of the grass field's ground layer, with its place on the field from 0 to 1.
+struct VertexShaderInput
+{
+	float3 pos : POSITION;
+	float2 uvs : TEXCOORD0;
+};
+
+struct VS_OUTPUT
+{
+	float4 pos : SV_POSITION;
+	float2 uvs : TEXCOORD0;
+	float2 blades : TEXCOORD1;
+};
+
+VS_OUTPUT main(VertexShaderInput input)
+{
+	VS_OUTPUT output;
+
+	output.pos = float4(input.pos, 1.0f);
+	output.pos = mul(output.pos, model);
+	output.pos = mul(output.pos, view);
+	output.pos = mul(output.pos, projection);
+	output.uvs = input.uvs;
+
+	// One repeat of the blade texture per blade width (GrassParticleGS.hlsl's quad).
+	output.blades = input.pos.xz / 0.1f;
+
+	return output;
+}
@@ -0,0 +1,74 @@
+// A constant buffer that stores the three basic column-major matrices for composing geometry.
+cbuffer ModelViewProjectionConstantBuffer : register(b0)
+{
+	matrix model;
+	matrix view;
+	matrix projection;
+};
+
+cbuffer TimeBuffer : register(b1)
+{
+	float deltaTime;
+	float3 padding;
+};
+
+// A GrassCard, per instance, and the corner of its quad.
+struct VertexShaderInput
+{
+	float3 pos : POSITION;
+	float scale : SCALE;
+	uint vertexID : SV_VertexID;
+};
+
+struct PixelShaderInput
+{
+	float4 pos : SV_POSITION;
+	float2 uv : TEXCOORD0;
+};
+
+// GrassParticleGS.hlsl without the geometry shader: each card is an instance of a four-vertex
+// strip, and each vertex builds its own corner in the order the geometry shader appends them.
+PixelShaderInput main(VertexShaderInput input)
+{
+	PixelShaderInput output;
+
+	static const float3 g_positions[4] =
+	{
+	float3(-1, -1, 0),
+	float3(-1, 1, 0),
+	float3(1, -1, 0),
+	float3(1, 1, 0)
+	};
+
+	static const float2 g_uvs[4] =
+	{
+	float2(0.0f, 1.0f),
+	float2(0.0f, 0.0f),
+	float2(1.0f, 1.0f),
+	float2(1.0f, 0.0f)
+	};
+
+	float size = 0.05f;
+	float windSpeed = 1.0f;
+	float waveAmplitude = 0.1f;
+	float dampening = 0.25f;
+
+	float4 vPos = float4(input.pos, 1.0f);
+	vPos = mul(vPos, model);
+	vPos = mul(vPos, view);
+
+	float3 corner = float3(size * input.scale, size, 0.0f);
+	output.pos = vPos + float4(corner * g_positions[input.vertexID], 0.0f);
+
+	// Apply animation to the top corners
+	if (input.vertexID & 1)
+	{
+		output.pos.z += sin(windSpeed * deltaTime) * waveAmplitude * dampening;
+		output.pos.x += cos(windSpeed * deltaTime) * waveAmplitude * dampening;
+	}
+	output.pos = mul(output.pos, projection);
+
+	output.uv = g_uvs[input.vertexID] * float2(input.scale, 1.0f);
+
+	return output;
+}
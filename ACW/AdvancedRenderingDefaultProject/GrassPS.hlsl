@@ -12,7 +12,8 @@ struct PixelShaderInput
 float4 main(PixelShaderInput input) : SV_TARGET
 {
 	float threshold = 0.1f;
-	float4 finalColor = grass.Sample(Sampler, input.uvs);
+	// Clump cards repeat the blade across their width.
+	float4 finalColor = grass.Sample(Sampler, float2(frac(input.uvs.x), input.uvs.y));
 	finalColor.r = 0.7f;
 	finalColor.b = 0.7f;
 
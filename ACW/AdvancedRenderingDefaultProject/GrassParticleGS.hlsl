@@ -12,9 +12,11 @@ cbuffer TimeBuffer : register(b1)
 	float3 padding;
 };
 
+// A blade, or a clump card scale blades wide.
 struct GeometryShaderInput
 {
 	float4 pos : SV_POSITION;
+	float scale : TEXCOORD0;
 };
 
 struct PixelShaderInput
@@ -43,11 +45,12 @@ void GS_main(point GeometryShaderInput input[1], inout TriangleStream<PixelShade
 
 	// Tri1
 	float size = 0.05f;
+	float3 corner = float3(size * input[0].scale, size, 0.0f);
 	float windSpeed = 1.0f;
 	float waveAmplitude = 0.1f;
 	float dampening = 0.25f;
 	// V1
-	output.pos = vPos + float4(size * g_positions[0], 0.0f);
+	output.pos = vPos + float4(corner * g_positions[0], 0.0f);
 	output.pos = mul(output.pos, projection);
 
 	output.uv = float2(0.0f, 1.0f);
@@ -55,7 +58,7 @@ void GS_main(point GeometryShaderInput input[1], inout TriangleStream<PixelShade
 	OutputStream.Append(output);
 
 	// V2
-	output.pos = vPos + float4(size * g_positions[1], 0.0f);
+	output.pos = vPos + float4(corner * g_positions[1], 0.0f);
 
 	// Apply animation
 	output.pos.z += sin(windSpeed * deltaTime)  * waveAmplitude * dampening;
@@ -67,22 +70,22 @@ void GS_main(point GeometryShaderInput input[1], inout TriangleStream<PixelShade
 	OutputStream.Append(output);
 
 	// V3
-	output.pos = vPos + float4(size * g_positions[2], 0.0f);
+	output.pos = vPos + float4(corner * g_positions[2], 0.0f);
 	output.pos = mul(output.pos, projection);
 
-	output.uv = float2(1.0f, 1.0f);
+	output.uv = float2(input[0].scale, 1.0f);
 
 	OutputStream.Append(output);
 
 	// V2
-	output.pos = vPos + float4(size * g_positions[3], 0.0f);
+	output.pos = vPos + float4(corner * g_positions[3], 0.0f);
 
 	// Apply animation
 	output.pos.z += sin(windSpeed * deltaTime)  * waveAmplitude * dampening;
 	output.pos.x += cos(windSpeed * deltaTime) * waveAmplitude * dampening;
 	output.pos = mul(output.pos, projection);
 
-	output.uv = float2(1.0f, 0.0f);
+	output.uv = float2(input[0].scale, 0.0f);
 
 	OutputStream.Append(output);
 }
\ No newline at end of file
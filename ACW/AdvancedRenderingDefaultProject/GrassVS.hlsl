@@ -10,12 +10,14 @@ cbuffer ModelViewProjectionConstantBuffer : register(b0)
 struct VertexShaderInput
 {
 	float3 pos : POSITION;
+	float scale : SCALE;
 };
 
 // Per-pixel color data passed through the pixel shader.
 struct VS_OUTPUT
 {
 	float4 pos : SV_POSITION;
+	float scale : TEXCOORD0;
 };
 
 // Simple shader to do vertex processing on the GPU.
@@ -23,6 +25,7 @@ VS_OUTPUT main(VertexShaderInput input)
 {
 	VS_OUTPUT output;
 	output.pos = float4(input.pos.x, input.pos.y, input.pos.z, 1.0f);
+	output.scale = input.scale;
 
 	return output;
 }
@@ -27,19 +27,94 @@ HS_TRI_Tess_Param ConstantHS_Tri(InputPatch<VS_OUTPUT, 3> ip)
 	return output;
 }
 
-HS_Quad_Tess_Factors ConstantHS(InputPatch <VS_OUTPUT, 4> ip)
+Texture2D dispMap : register(t0);
+SamplerState Sampler;
+
+cbuffer ModelViewProjectionConstantBuffer : register(b0)
 {
-	HS_Quad_Tess_Factors output;
+	matrix model;
+	matrix view;
+	matrix projection;
+};
+
+// FloorTessellationBuffer: viewport size, triangles per pixel, adaptive; flat detail scale and
+// the deviation that gets full detail.
+cbuffer FloorTessellationBuffer : register(b1)
+{
+	float4 tessViewport;
+	float4 tessDetail;
+};
+
+// FloorTessellation.h.
+static const float FloorFixedTessFactor = 31.0f;
+static const int FloorEdgeSamples = 8;
+static const float DispScale = 0.1f;
 
-	float TessAmount = 31.0f;
+float mod(float x, float y)
+{
+	return x - y * floor(x / y);
+}
+
+// Factor for the floor edge from a to b, from its length on screen and how much the
+// displacement varies along it.
+float FloorEdgeTessFactor(float3 a, float3 b)
+{
+	// Both patches sharing an edge see it the same way round, so they agree on its factor and
+	// the floor has no cracks.
+	if (a.x > b.x || (a.x == b.x && a.z > b.z))
+	{
+		float3 t = a;
+		a = b;
+		b = t;
+	}
+
+	float mean = 0.0f;
+	float meanSquare = 0.0f;
+	[unroll]
+	for (int i = 0; i < FloorEdgeSamples; i++)
+	{
+		float3 p = lerp(a, b, (i + 0.5f) / FloorEdgeSamples);
+		float disp = dispMap.SampleLevel(Sampler, float2(mod(p.x, 1.0f), mod(p.z, 1.0f)), 0).x;
+		mean += disp;
+		meanSquare += disp * disp;
+	}
+	mean /= FloorEdgeSamples;
+	meanSquare /= FloorEdgeSamples;
+	float deviation = sqrt(max(meanSquare - mean * mean, 0.0f));
+
+	// Measured at the edge's mean displaced height.
+	a.y += mean * DispScale;
+	b.y += mean * DispScale;
+	float4 clipA = mul(mul(mul(float4(a, 1.0f), model), view), projection);
+	float4 clipB = mul(mul(mul(float4(b, 1.0f), model), view), projection);
+	float2 screenA = clipA.xy / max(clipA.w, 0.01f) * 0.5f * tessViewport.xy;
+	float2 screenB = clipB.xy / max(clipB.w, 0.01f) * 0.5f * tessViewport.xy;
+	float pixels = length(screenA - screenB);
+
+	float detail = lerp(tessDetail.x, 1.0f, saturate(deviation / tessDetail.y));
+	return clamp(pixels * sqrt(tessViewport.z * 0.5f) * detail, 1.0f, 63.0f);
+}
 
-	output.Edges[0] = TessAmount;
-	output.Edges[1] = TessAmount;
-	output.Edges[2] = TessAmount;
-	output.Edges[3] = TessAmount;
+// Control points are the patch corners at (u, v) = (0, 0), (0, 1), (1, 0) and (1, 1).
+HS_Quad_Tess_Factors ConstantHS(InputPatch <VS_OUTPUT, 4> ip)
+{
+	HS_Quad_Tess_Factors output;
 
-	output.Inside[0] = TessAmount;
-	output.Inside[1] = TessAmount;
+	if (tessViewport.w == 0.0f)
+	{
+		output.Edges[0] = output.Edges[1] = output.Edges[2] = output.Edges[3] = FloorFixedTessFactor;
+		output.Inside[0] = output.Inside[1] = FloorFixedTessFactor;
+		return output;
+	}
+
+	output.Edges[0] = FloorEdgeTessFactor(ip[0].pos.xyz, ip[1].pos.xyz);	// u == 0
+	output.Edges[1] = FloorEdgeTessFactor(ip[0].pos.xyz, ip[2].pos.xyz);	// v == 0
+	output.Edges[2] = FloorEdgeTessFactor(ip[2].pos.xyz, ip[3].pos.xyz);	// u == 1
+	output.Edges[3] = FloorEdgeTessFactor(ip[1].pos.xyz, ip[3].pos.xyz);	// v == 1
+
+	// Inside[0] cuts along u, like the v == 0 and v == 1 edges.
+	output.Inside[0] = max(output.Edges[1], output.Edges[3]);
+	output.Inside[1] = max(output.Edges[0], output.Edges[2]);
 
 	return output;
 }
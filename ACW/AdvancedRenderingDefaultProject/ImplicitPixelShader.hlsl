@@ -18,11 +18,13 @@ cbuffer TimeBuffer : register(b0)
 cbuffer ControlBuffer : register(b1)
 {
 	float4 repDefFrac;
+	float4 marching;	// x: over-relaxation factor (1 = plain), y: hit distance in pixels (0 = EPSILON), z: fractal LOD (0 = off)
+	float4 progressive;	// x: first slice traced this frame, y: slices traced (16 = every pixel)
 }
 
 struct PixelShaderInput
 {
-	float4 pos : POSITION;
+	float4 pos : SV_POSITION;
 	float2 canvasXY : TEXCOORD0;
 };
 
@@ -41,6 +43,23 @@ static const float farPlane = 1000.0f;
 static const int MAX_MARCH = 255;
 static const float EPSILON = 0.0001f;
 
+// TIME SLICING
+// Slice of each pixel of a 4x4 cell, as ImplicitInterleave in ImplicitTimeSlicing.h.
+static const uint SLICE_BAYER[16] =
+{
+	0, 8, 2, 10,
+	12, 4, 14, 6,
+	3, 11, 1, 9,
+	15, 7, 13, 5
+};
+
+bool inFrameSlices(float2 pixel)
+{
+	uint2 cell = uint2(pixel) & 3;
+	uint slice = SLICE_BAYER[cell.y * 4 + cell.x];
+	return (slice + 16 - (uint)progressive.x) % 16 < (uint)progressive.y;
+}
+
 float mod(float x, float y)
 {
 	return x - y * floor(x / y);
@@ -67,6 +86,41 @@ float fractal(float3 pos)
 	return (length(z)) * pow(Scale, -float(n));
 }
 
+// FRACTAL LOD
+// Level n of the fold tree splits space into cells within sqrt(3) * 2^-n of their centre, so once
+// that is below a fraction of the pixel footprint the remaining iterations add detail no pixel
+// shows. Subtracting the cell radius keeps the estimate a lower bound on the full fractal.
+static const float FRACTAL_LOD_SCALE = 0.5f;
+static const float FRACTAL_BAILOUT = 16.0f;
+
+// Footprint per unit of distance from the eye for the march; 0 runs the full fractal, which
+// the normals keep using.
+static float fractalPixelAngle = 0.0f;
+
+float fractalLod(float3 pos, float pixelAngle)
+{
+	float footprint = length(pos - eyePos) * pixelAngle;
+	int Iterations = (int)clamp(ceil(log2(1.7320508f / (FRACTAL_LOD_SCALE * footprint))), 1.0f, 20.0f);
+	float Scale = 2.0f;
+	float3 Offset = float3(1.0f, 1.0f, 1.0f);
+	float3 z = pos;
+	int n = 0;
+	while (n < Iterations) {
+		if (z.x + z.y < 0) z.xy = -z.yx; // fold 1
+		if (z.x + z.z < 0) z.xz = -z.zx; // fold 2
+		if (z.y + z.z < 0) z.zy = -z.yz; // fold 3
+		z = z * Scale - Offset * (Scale - 1.0);
+		n++;
+		if (dot(z, z) > FRACTAL_BAILOUT * FRACTAL_BAILOUT) break;
+	}
+	return (length(z) - 1.7320508f) * pow(Scale, -float(n));
+}
+
+float fractalMarch(float3 pos)
+{
+	return fractalPixelAngle > 0.0f ? fractalLod(pos, fractalPixelAngle) : fractal(pos);
+}
+
 // Distance Func for Sphere
 float sphereDistFunc(float3 samplePoint, float radius)
 {
@@ -162,9 +216,101 @@ float diffDF(float distanceA, float distanceB)
 	return max(distanceA, -distanceB);
 }
 
+// DISTANCE + GRADIENT
+// float4(gradient, distance) versions of the primitives and ops, used by the per-scene shaders
+// for analytic normals. Primitives without a closed-form gradient take tetrahedral differences
+// of that primitive alone.
+static const float3 TETRA_A = float3(1.0f, -1.0f, -1.0f);
+static const float3 TETRA_B = float3(-1.0f, -1.0f, 1.0f);
+static const float3 TETRA_C = float3(-1.0f, 1.0f, -1.0f);
+static const float3 TETRA_D = float3(1.0f, 1.0f, 1.0f);
+
+float4 sphereDG(float3 samplePoint, float radius)
+{
+	return float4(normalize(samplePoint), sphereDistFunc(samplePoint, radius));
+}
+
+float4 cubeDG(float3 samplePoint)
+{
+	float3 dist = abs(samplePoint) - float3(1.0f, 1.0f, 1.0f);
+	float3 gradient;
+
+	if (max(dist.x, max(dist.y, dist.z)) > 0.0f)
+	{
+		gradient = max(dist, 0.0f);
+	}
+	else
+	{
+		// Inside: the face with the largest distance.
+		gradient = dist.x > dist.y && dist.x > dist.z ? float3(1.0f, 0.0f, 0.0f) : dist.y > dist.z ? float3(0.0f, 1.0f, 0.0f) : float3(0.0f, 0.0f, 1.0f);
+	}
+
+	return float4(gradient * sign(samplePoint), cubeDistFunc(samplePoint));
+}
+
+float4 torusDG(float3 pos, float2 radii)
+{
+	float ring = length(pos.xz);
+	float2 q = float2(ring - radii.x, pos.y);
+	return float4(q.x * pos.x / ring, q.y, q.x * pos.z / ring, torusDistFunc(pos, radii));
+}
+
+float4 tetraDG(float3 pos)
+{
+	float a = abs(pos.x + pos.y) - pos.z;
+	float b = abs(pos.x - pos.y) + pos.z;
+	float3 gradient = a > b ? float3(sign(pos.x + pos.y), sign(pos.x + pos.y), -1.0f) : float3(sign(pos.x - pos.y), -sign(pos.x - pos.y), 1.0f);
+	return float4(gradient, tetraDF(pos));
+}
+
+float4 hexDG(float3 pos, float2 h)
+{
+	float3 gradient = TETRA_A * hexDF(pos + TETRA_A * EPSILON, h) + TETRA_B * hexDF(pos + TETRA_B * EPSILON, h)
+		+ TETRA_C * hexDF(pos + TETRA_C * EPSILON, h) + TETRA_D * hexDF(pos + TETRA_D * EPSILON, h);
+	return float4(gradient, hexDF(pos, h));
+}
+
+float4 octahedronDG(float3 pos, float size)
+{
+	float3 gradient = TETRA_A * octahedronDF(pos + TETRA_A * EPSILON, size) + TETRA_B * octahedronDF(pos + TETRA_B * EPSILON, size)
+		+ TETRA_C * octahedronDF(pos + TETRA_C * EPSILON, size) + TETRA_D * octahedronDF(pos + TETRA_D * EPSILON, size);
+	return float4(gradient, octahedronDF(pos, size));
+}
+
+float4 fractalDG(float3 pos)
+{
+	float3 gradient = TETRA_A * fractal(pos + TETRA_A * EPSILON) + TETRA_B * fractal(pos + TETRA_B * EPSILON)
+		+ TETRA_C * fractal(pos + TETRA_C * EPSILON) + TETRA_D * fractal(pos + TETRA_D * EPSILON);
+	return float4(gradient, fractal(pos));
+}
+
+float4 scaleDG(float4 a, float factor)
+{
+	return float4(a.xyz, a.w * factor);
+}
+
+float4 intersectDG(float4 a, float4 b)
+{
+	return a.w > b.w ? a : b;
+}
+
+float4 unionDG(float4 a, float4 b)
+{
+	return a.w < b.w ? a : b;
+}
+
+float4 diffDG(float4 a, float4 b)
+{
+	return a.w > -b.w ? a : -b;
+}
+
 // Scene Sampling
 float sceneDistFunc(float3 samplePoint)
 {
+#ifdef IMPLICIT_SCENE_DIST
+	// Per-scene permutation (ImplicitPixelShader<Scene>.hlsl) with the scene compiled in.
+	return IMPLICIT_SCENE_DIST(samplePoint);
+#else
 	// NOTE: Multiplying values by sin or cos will result in a wavey masking
 	float final;
 
@@ -220,7 +366,7 @@ float sceneDistFunc(float3 samplePoint)
 	// Fractal
 	else if (repDefFrac.z == 1)
 	{
-		final = fractal(samplePoint);
+		final = fractalMarch(samplePoint);
 	}
 	// Shiny
 	else if (repDefFrac.w == 1)
@@ -283,9 +429,11 @@ float sceneDistFunc(float3 samplePoint)
 
 	return sphereDistFunc(samplePoint, 1.0f);
 	return cubeDistFunc(samplePoint);*/
+#endif
 }
 
 // Calculate Normals
+// Central differences, six scene samples.
 float3 calcNormals(float3 pos)
 {
 	return normalize(float3
@@ -295,6 +443,28 @@ float3 calcNormals(float3 pos)
 			sceneDistFunc(float3(pos.x, pos.y, pos.z + EPSILON)) - sceneDistFunc(float3(pos.x, pos.y, pos.z - EPSILON))
 			));
 }
+
+// Tetrahedral differences, four scene samples.
+float3 calcNormalsTetra(float3 pos)
+{
+	return normalize(
+		TETRA_A * sceneDistFunc(pos + TETRA_A * EPSILON) + TETRA_B * sceneDistFunc(pos + TETRA_B * EPSILON) +
+		TETRA_C * sceneDistFunc(pos + TETRA_C * EPSILON) + TETRA_D * sceneDistFunc(pos + TETRA_D * EPSILON));
+}
+
+// Normal at a hit, worked out once and shared by every light. Central differences unless
+// IMPLICIT_TETRAHEDRAL_NORMALS asks for tetrahedral ones, or IMPLICIT_ANALYTIC_NORMALS for the
+// per-scene shaders' IMPLICIT_SCENE_GRADIENT.
+float3 sceneNormal(float3 pos)
+{
+#if defined(IMPLICIT_ANALYTIC_NORMALS) && defined(IMPLICIT_SCENE_GRADIENT)
+	return normalize(IMPLICIT_SCENE_GRADIENT(pos).xyz);
+#elif defined(IMPLICIT_TETRAHEDRAL_NORMALS)
+	return calcNormalsTetra(pos);
+#else
+	return calcNormals(pos);
+#endif
+}
 // RAY MARCH
 float shortestDistanceToSurface(Ray ray, float start, float end)
 {
@@ -320,10 +490,47 @@ float shortestDistanceToSurface(Ray ray, float start, float end)
 	return end;
 }
 
+// Over-relaxed sphere tracing: steps of relaxation * dist, retaken as a plain step when one
+// overshoots, hitting within max(EPSILON, hitRadius * depth). See the CPU port in ImplicitScene.cpp.
+float shortestDistanceToSurfaceRelaxed(Ray ray, float start, float end, float relaxation, float hitRadius)
+{
+	float omega = relaxation;
+	float depth = start;
+	float previousDepth = start;
+	float previousDist = 0.0f;
+
+	for (int i = 0; i < MAX_MARCH; i++)
+	{
+		float dist = sceneDistFunc(ray.origin + depth * ray.direction);
+
+		if (omega > 1.0f && i > 0 && (dist < 0.0f || dist + previousDist < depth - previousDepth))
+		{
+			depth = previousDepth + previousDist;
+			omega = 1.0f;
+		}
+		else if (dist < max(EPSILON, hitRadius * depth))
+		{
+			return depth;
+		}
+		else
+		{
+			previousDepth = depth;
+			previousDist = dist;
+			depth += omega * dist;
+			omega = relaxation;
+			if (depth >= end)
+			{
+				return end;
+			}
+		}
+	}
+
+	return end;
+}
+
 // PHONG SHADING
-float3 phongLightObstruction(float3 diffuseFactor, float3 specularFactor, float shininess, float3 pos, float3 eyePos, float3 lightPos, float3 lightIntensity)
+float3 phongLightObstruction(float3 normal, float3 diffuseFactor, float3 specularFactor, float shininess, float3 pos, float3 eyePos, float3 lightPos, float3 lightIntensity)
 {
-	float3 normal = calcNormals(pos);
 	float3 lightDir = normalize(lightPos - pos);
 	float3 viewDir = normalize(eyePos - pos);
 	float3 reflectVector = normalize(reflect(-lightDir, normal));
@@ -347,7 +554,7 @@ float3 phongLightObstruction(float3 diffuseFactor, float3 specularFactor, float
 }
 
 // ILLUMINATION
-float3 phongIllumination(float3 ambientFactor, float3 diffuseFactor, float3 specularFactor, float shininess, float3 pos, float3 eyePos)
+float3 phongIllumination(float3 normal, float3 ambientFactor, float3 diffuseFactor, float3 specularFactor, float shininess, float3 pos, float3 eyePos)
 {
 	float3 ambientLight = 0.5f * float3(1.0f, 1.0f, 1.0f);
 	float3 color = ambientLight * ambientFactor;
@@ -355,12 +562,12 @@ float3 phongIllumination(float3 ambientFactor, float3 diffuseFactor, float3 spec
 	float3 light1Pos = float3(4.0f, 2.0f, 4.0f);
 	float3 light1Intensity = float3(0.4, 0.4f, 0.4f);
 
-	color += phongLightObstruction(diffuseFactor, specularFactor, shininess, pos, eyePos, light1Pos, light1Intensity);
+	color += phongLightObstruction(normal, diffuseFactor, specularFactor, shininess, pos, eyePos, light1Pos, light1Intensity);
 
 	float3 light2Pos = float3(2.0, 2.0f, 2.0f);
 	float3 light2Intensity = float3(0.4f, 0.4f, 0.4f);
 
-	color += phongLightObstruction(diffuseFactor, specularFactor, shininess, pos, eyePos, light2Pos, light2Intensity);
+	color += phongLightObstruction(normal, diffuseFactor, specularFactor, shininess, pos, eyePos, light2Pos, light2Intensity);
 
 	return color;
 }
@@ -378,7 +585,27 @@ float4 main(PixelShaderInput input) : SV_Target
 	eyeRay.origin = eyePos;
 	eyeRay.direction = normalize(pixelPos - eyePos);
 
-	float distance = shortestDistanceToSurface(eyeRay, nearPlane, farPlane);
+	// Pixel footprint per unit of depth, taken before any divergent flow.
+	float pixelFootprint = length(ddy(eyeRay.direction));
+
+	// Pixels outside this frame's slices keep what the history target holds.
+	if (!inFrameSlices(input.pos.xy))
+	{
+		discard;
+	}
+
+	// The fractal marches at the detail the pixel can show, then shades at full detail.
+	fractalPixelAngle = marching.z > 0.0f ? pixelFootprint : 0.0f;
+
+	float distance;
+	if (marching.x > 1.0f || marching.y > 0.0f)
+	{
+		distance = shortestDistanceToSurfaceRelaxed(eyeRay, nearPlane, farPlane, marching.x, marching.y * pixelFootprint);
+	}
+	else
+	{
+		distance = shortestDistanceToSurface(eyeRay, nearPlane, farPlane);
+	}
 
 	if (distance > farPlane - EPSILON)
 	{
@@ -387,6 +614,7 @@ float4 main(PixelShaderInput input) : SV_Target
 	}
 
 	float3 pos = eyeRay.origin + distance * eyeRay.direction;
+	fractalPixelAngle = 0.0f;
 
 	//float3 ambientFactor = (calcNormals(pos) + (float3)1.0f) / 2.0f;
 	//float3 diffuseFactor = ambientFactor;
@@ -404,7 +632,7 @@ float4 main(PixelShaderInput input) : SV_Target
 		shininess = 10.0f;
 	}
 
-	float3 color = phongIllumination(ambientFactor, diffuseFactor, specularFactor, shininess, pos, eyePos);
+	float3 color = phongIllumination(sceneNormal(pos), ambientFactor, diffuseFactor, specularFactor, shininess, pos, eyePos);
 	output = float4(color, 1.0f);
 	return output;
 }
\ No newline at end of file
@@ -0,0 +1,8 @@
+// Generated by "headless implicit-hlsl" from the scene descriptions in
+// Content/ImplicitSceneKernels.cpp; regenerate rather than editing by hand.
+// ImplicitPixelShader.hlsl specialised for the default scene.
+
+#define IMPLICIT_SCENE_DIST(samplePoint) unionDF(unionDF(unionDF(unionDF(sphereDistFunc(samplePoint, 1.0f), cubeDistFunc((samplePoint - float3(2.0f, 2.0f, 2.0f)))), torusDistFunc((samplePoint - float3(-5.0f, -5.0f, -5.0f)), float2(1.5f, 0.5f))), octahedronDF((samplePoint - float3(3.0f, -3.0f, 0.0f)), 1.0f)), hexDF((samplePoint - float3(-3.0f, 3.0f, 0.0f)), float2(1.0f, 1.0f)))
+#define IMPLICIT_SCENE_GRADIENT(samplePoint) unionDG(unionDG(unionDG(unionDG(sphereDG(samplePoint, 1.0f), cubeDG((samplePoint - float3(2.0f, 2.0f, 2.0f)))), torusDG((samplePoint - float3(-5.0f, -5.0f, -5.0f)), float2(1.5f, 0.5f))), octahedronDG((samplePoint - float3(3.0f, -3.0f, 0.0f)), 1.0f)), hexDG((samplePoint - float3(-3.0f, 3.0f, 0.0f)), float2(1.0f, 1.0f)))
+
+#include "ImplicitPixelShader.hlsl"
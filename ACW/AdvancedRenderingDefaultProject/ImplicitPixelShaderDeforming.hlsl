@@ -0,0 +1,8 @@
+// Generated by "headless implicit-hlsl" from the scene descriptions in
+// Content/ImplicitSceneKernels.cpp; regenerate rather than editing by hand.
+// ImplicitPixelShader.hlsl specialised for the deforming scene.
+
+#define IMPLICIT_SCENE_DIST(samplePoint) unionDF(intersectDF(cubeDistFunc((samplePoint - float3(-3.0f, 0.0f, 0.0f))), sphereDistFunc(((samplePoint - float3(-3.0f, 0.0f, 0.0f)) / 1.20000005f), 1.0f) * 1.20000005f), diffDF(intersectDF(intersectDF(sphereDistFunc(((samplePoint - float3(3.0f, 0.0f, 0.0f)) / 1.20000005f), 1.0f) * 1.20000005f, sphereDistFunc(((samplePoint - float3(3.25f, 0.0f, 0.0f)) / 1.20000005f), 1.0f) * 1.20000005f), cubeDistFunc((samplePoint - float3(3.0f, -0.300000012f, 0.0f)))), torusDistFunc((samplePoint - float3(3.0f, 0.699999988f, 0.0f)), float2(1.0f, 1.0f))))
+#define IMPLICIT_SCENE_GRADIENT(samplePoint) unionDG(intersectDG(cubeDG((samplePoint - float3(-3.0f, 0.0f, 0.0f))), scaleDG(sphereDG(((samplePoint - float3(-3.0f, 0.0f, 0.0f)) / 1.20000005f), 1.0f), 1.20000005f)), diffDG(intersectDG(intersectDG(scaleDG(sphereDG(((samplePoint - float3(3.0f, 0.0f, 0.0f)) / 1.20000005f), 1.0f), 1.20000005f), scaleDG(sphereDG(((samplePoint - float3(3.25f, 0.0f, 0.0f)) / 1.20000005f), 1.0f), 1.20000005f)), cubeDG((samplePoint - float3(3.0f, -0.300000012f, 0.0f)))), torusDG((samplePoint - float3(3.0f, 0.699999988f, 0.0f)), float2(1.0f, 1.0f))))
+
+#include "ImplicitPixelShader.hlsl"
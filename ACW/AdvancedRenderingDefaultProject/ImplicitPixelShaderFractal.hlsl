@@ -0,0 +1,8 @@
+// Generated by "headless implicit-hlsl" from the scene descriptions in
+// Content/ImplicitSceneKernels.cpp; regenerate rather than editing by hand.
+// ImplicitPixelShader.hlsl specialised for the fractal scene.
+
+#define IMPLICIT_SCENE_DIST(samplePoint) fractalMarch(samplePoint)
+#define IMPLICIT_SCENE_GRADIENT(samplePoint) fractalDG(samplePoint)
+
+#include "ImplicitPixelShader.hlsl"
@@ -0,0 +1,8 @@
+// Generated by "headless implicit-hlsl" from the scene descriptions in
+// Content/ImplicitSceneKernels.cpp; regenerate rather than editing by hand.
+// ImplicitPixelShader.hlsl specialised for the repeating scene.
+
+#define IMPLICIT_SCENE_DIST(samplePoint) unionDF(cubeDistFunc(float3((samplePoint - float3(4.0f, 0.0f, 0.0f)).x, (samplePoint - float3(4.0f, 0.0f, 0.0f)).y, mod((samplePoint - float3(4.0f, 0.0f, 0.0f)).z, 1.5f))), unionDF(sphereDistFunc(float3((samplePoint - float3(-4.0f, 0.0f, 0.0f)).x, (samplePoint - float3(-4.0f, 0.0f, 0.0f)).y, mod((samplePoint - float3(-4.0f, 0.0f, 0.0f)).z, 1.5f)), 1.0f), octahedronDF(float3(samplePoint.x, samplePoint.y, mod(samplePoint.z, 2.25f)), 1.0f)))
+#define IMPLICIT_SCENE_GRADIENT(samplePoint) unionDG(cubeDG(float3((samplePoint - float3(4.0f, 0.0f, 0.0f)).x, (samplePoint - float3(4.0f, 0.0f, 0.0f)).y, mod((samplePoint - float3(4.0f, 0.0f, 0.0f)).z, 1.5f))), unionDG(sphereDG(float3((samplePoint - float3(-4.0f, 0.0f, 0.0f)).x, (samplePoint - float3(-4.0f, 0.0f, 0.0f)).y, mod((samplePoint - float3(-4.0f, 0.0f, 0.0f)).z, 1.5f)), 1.0f), octahedronDG(float3(samplePoint.x, samplePoint.y, mod(samplePoint.z, 2.25f)), 1.0f)))
+
+#include "ImplicitPixelShader.hlsl"
@@ -0,0 +1,8 @@
+// Generated by "headless implicit-hlsl" from the scene descriptions in
+// Content/ImplicitSceneKernels.cpp; regenerate rather than editing by hand.
+// ImplicitPixelShader.hlsl specialised for the shiny scene.
+
+#define IMPLICIT_SCENE_DIST(samplePoint) unionDF(unionDF(unionDF(unionDF(unionDF(tetraDF((samplePoint - float3(-3.0f, 0.0f, 0.0f))), tetraDF((samplePoint - float3(-3.0f, 2.4000001f, 0.0f)))), tetraDF((samplePoint - float3(-3.0f, -2.4000001f, 0.0f)))), sphereDistFunc((samplePoint - float3(3.0f, 0.0f, 0.0f)), 1.0f)), sphereDistFunc((samplePoint - float3(3.0f, 2.4000001f, 0.0f)), 1.0f)), sphereDistFunc((samplePoint - float3(3.0f, -2.4000001f, 0.0f)), 1.0f))
+#define IMPLICIT_SCENE_GRADIENT(samplePoint) unionDG(unionDG(unionDG(unionDG(unionDG(tetraDG((samplePoint - float3(-3.0f, 0.0f, 0.0f))), tetraDG((samplePoint - float3(-3.0f, 2.4000001f, 0.0f)))), tetraDG((samplePoint - float3(-3.0f, -2.4000001f, 0.0f)))), sphereDG((samplePoint - float3(3.0f, 0.0f, 0.0f)), 1.0f)), sphereDG((samplePoint - float3(3.0f, 2.4000001f, 0.0f)), 1.0f)), sphereDG((samplePoint - float3(3.0f, -2.4000001f, 0.0f)), 1.0f))
+
+#include "ImplicitPixelShader.hlsl"
@@ -0,0 +1,34 @@
+// A constant buffer that stores the three basic column-major matrices for composing geometry.
+cbuffer ModelViewProjectionConstantBuffer : register(b0)
+{
+	matrix model;
+	matrix view;
+	matrix projection;
+};
+
+// A parametric surface vertex streamed out of its domain shader, before the projection.
+struct VertexShaderInput
+{
+	float3 pos : POSITION;
+	float2 uvs : TEXCOORD0;
+};
+
+struct VS_OUTPUT
+{
+	float4 pos : SV_POSITION;
+	float2 uvs : TEXCOORD0;
+};
+
+// Finishes what the parametric domain shaders do per frame.
+VS_OUTPUT main(VertexShaderInput input)
+{
+	VS_OUTPUT output;
+
+	output.pos = float4(input.pos, 1.0f);
+	output.pos = mul(output.pos, model);
+	output.pos = mul(output.pos, view);
+	output.pos = mul(output.pos, projection);
+	output.uvs = input.uvs;
+
+	return output;
+}
@@ -1,3 +1,6 @@
+Texture2D dispMap : register (t0);
+SamplerState Sampler;
+
 // A constant buffer that stores the three basic column-major matrices for composing geometry.
 cbuffer ModelViewProjectionConstantBuffer : register(b0)
 {
@@ -6,29 +9,42 @@ cbuffer ModelViewProjectionConstantBuffer : register(b0)
 	matrix projection;
 };
 
+cbuffer DisplacementBuffer : register(b1)
+{
+	float4 displacementFactor;
+};
+
 struct HS_TRI_Tess_Param
 {
 	float Edges[3] : SV_TessFactor;
 	float Inside : SV_InsideTessFactor;
 };
 
-//static float3 QuadPos[4] = {
-//	float3(-1, 1, 0),
-//	float3(-1, -1, 0),
-//	float3(1, 1, 0),
-//	float3(1, -1, 0)
-//};
-
 static float3 TriPos[3] = 
 {
 	float3(-1, 1, 0),
 	float3(1, 1, 0),
 	float3(0, -1, 0)
 };
+
+// ParametricSurface
+static const float TORUS = 0.0f;
+static const float ELLIPSOID = 1.0f;
+
+// The patch's ParametricInstance, passed through by the hull shader.
+struct HS_OUTPUT
+{
+	float4 pos : SV_POSITION;
+	float4 shape : SURFACE0;	// surface, then torus c, a; ellipsoid a, b, c; sphere radius
+	float4 sweep : SURFACE1;	// phi and theta per unit of TriPos
+	float4 offset : SURFACE2;	// translation, displacement weight
+};
+
 struct VS_OUTPUT
 {
 	float4 pos : SV_POSITION;
 	float2 uvs : TEXCOORD0;
+	float3 modelPos : TEXCOORD1;	// streamed out to the cached mesh
 };
 
 float mod(float x, float y)
@@ -38,9 +54,11 @@ float mod(float x, float y)
 }
 
 [domain("tri")]
-VS_OUTPUT main(HS_TRI_Tess_Param input, float3 UVW : SV_DomainLocation)
+VS_OUTPUT main(HS_TRI_Tess_Param input, float3 UVW : SV_DomainLocation, const OutputPatch<HS_OUTPUT, 3> patch)
 {
 	VS_OUTPUT output;
+	float4 shape = patch[0].shape;
+	float4 offset = patch[0].offset;
 
 	float3 finalPos = UVW.x * TriPos[0] +
 		UVW.y * TriPos[1] +
@@ -48,25 +66,55 @@ VS_OUTPUT main(HS_TRI_Tess_Param input, float3 UVW : SV_DomainLocation)
 	float3 uvPos = (1.0f - UVW.x) * finalPos + UVW.x * finalPos;
 	output.uvs = float2(mod(uvPos.x, 1.0f), mod(uvPos.y, 1.0f));
 
-	float c = 0.25f;
-	float a = 0.1f;
+	float phi = patch[0].sweep.x * finalPos.x;
+	float theta = patch[0].sweep.y * finalPos.y;
+
+	float x, y, z;
+	[branch] if (shape.x == TORUS)
+	{
+		float c = shape.y;
+		float a = shape.z;
 
-	float pi = 3.1415926f * 2.0f;
-	float pi2 = 2.0f * pi;
+		x = (c + a * cos(theta)) * cos(phi);
+		z = (c + a * cos(theta)) * -sin(phi);
+		y = a * sin(theta);
+	}
+	else if (shape.x == ELLIPSOID)
+	{
+		float a = shape.y;
+		float b = shape.z;
+		float c = shape.w;
 
-	float phi = pi * finalPos.x;
-	float theta = pi2 * finalPos.y;
+		x = a * cos(phi) * sin(theta);
+		y = b * sin(phi) * sin(theta);
+		z = c * cos(theta);
+	}
+	else
+	{
+		float radius = shape.y;
 
-	float x = (c + a * cos(theta)) * cos(phi);
-	float z = (c + a * cos(theta)) * -sin(phi);
-	float y = a * sin(theta);
+		x = radius * sin(phi) * cos(theta) * radius;
+		y = radius * sin(phi) * sin(theta) * radius;
+		z = radius * cos(phi) * radius;
+	}
 
-	finalPos = float3(x + 0.5f, y + 0.25, z - 1.0f);
+	finalPos = float3(x, y, z) + offset.xyz;
 
+	// The sphere's UVs follow its position, and it is pushed out along them.
+	[branch] if (offset.w != 0.0f)
+	{
+		output.uvs = float2(mod(finalPos.x, 1.0f), mod(finalPos.z, 1.0f));
+
+		float disp = dispMap.SampleLevel(Sampler, output.uvs, 0, 0);
+		float dispScale = displacementFactor.x * offset.w;
+		finalPos += (disp * dispScale);
+	}
+
+	output.modelPos = finalPos;
 	output.pos = float4(finalPos, 1.0f);
 	output.pos = mul(output.pos, model);
 	output.pos = mul(output.pos, view);
 	output.pos = mul(output.pos, projection);
 
 	return output;
-}
\ No newline at end of file
+}
@@ -7,13 +7,22 @@ struct HS_TRI_Tess_Param
 struct VS_OUTPUT
 {
 	float4 pos : SV_POSITION;
+	float4 shape : SURFACE0;
+	float4 sweep : SURFACE1;
+	float4 offset : SURFACE2;
+};
+
+// ParametricTessellationBuffer: the factor every surface is tessellated at.
+cbuffer ParametricTessellationBuffer : register(b0)
+{
+	float4 tessFactor;
 };
 
 HS_TRI_Tess_Param ConstantHS_TRI(InputPatch<VS_OUTPUT, 3> ip)
 {
 	HS_TRI_Tess_Param output;
 	
-	float TessAmount = 30.0f;
+	float TessAmount = tessFactor.x;
 
 	output.Edges[0] = TessAmount;
 	output.Edges[1] = TessAmount;
@@ -32,6 +41,9 @@ VS_OUTPUT main(InputPatch<VS_OUTPUT, 3> patch, uint id : SV_OutputControlPointID
 {
 	VS_OUTPUT output;
 	output.pos = patch[id].pos;
+	output.shape = patch[id].shape;
+	output.sweep = patch[id].sweep;
+	output.offset = patch[id].offset;
 
 	return output;
-}
\ No newline at end of file
+}
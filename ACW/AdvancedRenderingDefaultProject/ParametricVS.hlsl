@@ -6,17 +6,23 @@ cbuffer ModelViewProjectionConstantBuffer : register(b0)
 	matrix projection;
 };
 
-// Per-vertex data used as input to the vertex shader.
+// Per-vertex data used as input to the vertex shader, then the object's ParametricInstance.
 struct VertexShaderInput
 {
 	float3 pos : POSITION;
 	float3 color : COLOR0;
+	float4 shape : SURFACE0;
+	float4 sweep : SURFACE1;
+	float4 offset : SURFACE2;
 };
 
 // Per-pixel color data passed through the pixel shader.
 struct VS_OUTPUT
 {
 	float4 pos : SV_POSITION;
+	float4 shape : SURFACE0;
+	float4 sweep : SURFACE1;
+	float4 offset : SURFACE2;
 };
 
 // Simple shader to do vertex processing on the GPU.
@@ -25,6 +31,9 @@ VS_OUTPUT main(VertexShaderInput input)
 	VS_OUTPUT output;
 	//output.pos = float4(input.pos, 1.0f);
 	output.pos = float4(1.0f, 1.0f, 1.0f, 1.0f);
+	output.shape = input.shape;
+	output.sweep = input.sweep;
+	output.offset = input.offset;
 
 	return output;
 }
@@ -0,0 +1,41 @@
+// A constant buffer that stores the three basic column-major matrices for composing geometry.
+cbuffer ModelViewProjectionConstantBuffer : register(b0)
+{
+	matrix model;
+	matrix view;
+	matrix projection;
+};
+
+// The SnakeSwarm's segments, each its tail then its head SnakeVertex: a position and a radius.
+ByteAddressBuffer segments : register(t0);
+
+struct PixelShaderInput
+{
+	float4 pos : SV_POSITION;
+	float2 uv : TEXCOORD0;
+};
+
+float mod(float x, float y)
+{
+	return x - y * floor(x / y);
+}
+
+// SnakeGS.hlsl without the geometry shader: each segment is an instance of a 22-vertex strip.
+// Even vertices are on the tail's ring and odd ones on the head's, one ring step per pair.
+PixelShaderInput main(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
+{
+	PixelShaderInput output;
+
+	float4 end = asfloat(segments.Load4(instanceID * 32 + (vertexID & 1) * 16));
+	float angle = 3.14f * 2.0f / 5.0f * (vertexID / 2);
+	float4 ring = float4(cos(angle), -sin(angle), 0.0f, 0.0f);
+
+	output.pos = float4(end.xyz, 1.0f) + ring * end.w;
+	output.uv = float2(mod(output.pos.x, 1.0), mod(output.pos.z, 1.0));
+
+	output.pos = mul(output.pos, model);
+	output.pos = mul(output.pos, view);
+	output.pos = mul(output.pos, projection);
+
+	return output;
+}
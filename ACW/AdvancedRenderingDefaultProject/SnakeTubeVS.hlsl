@@ -0,0 +1,39 @@
+// A constant buffer that stores the three basic column-major matrices for composing geometry.
+cbuffer ModelViewProjectionConstantBuffer : register(b0)
+{
+	matrix model;
+	matrix view;
+	matrix projection;
+};
+
+// A vertex of a SnakeTube ring.
+struct VertexShaderInput
+{
+	float3 pos : POSITION;
+};
+
+struct PixelShaderInput
+{
+	float4 pos : SV_POSITION;
+	float2 uv : TEXCOORD0;
+};
+
+float mod(float x, float y)
+{
+	return x - y * floor(x / y);
+}
+
+// The snake tubes extruded on the CPU: only the transform and SnakeGS.hlsl's planar uvs are left.
+PixelShaderInput main(VertexShaderInput input)
+{
+	PixelShaderInput output;
+
+	output.pos = float4(input.pos, 1.0f);
+	output.uv = float2(mod(output.pos.x, 1.0), mod(output.pos.z, 1.0));
+
+	output.pos = mul(output.pos, model);
+	output.pos = mul(output.pos, view);
+	output.pos = mul(output.pos, projection);
+
+	return output;
+}
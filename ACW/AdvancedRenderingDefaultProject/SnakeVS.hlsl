@@ -6,22 +6,18 @@ cbuffer ModelViewProjectionConstantBuffer : register(b0)
 	matrix projection;
 };
 
-cbuffer TimeBuffer : register(b1)
-{
-	float deltaTime;
-	float3 padding;
-};
-
 // Per-vertex data used as input to the vertex shader.
 struct VertexShaderInput
 {
 	float3 pos : POSITION;
+	float radius : RADIUS;
 };
 
 // Per-pixel color data passed through the pixel shader.
 struct VS_OUTPUT
 {
 	float4 pos : SV_POSITION;
+	float radius : RADIUS;
 };
 
 // Simple shader to do vertex processing on the GPU.
@@ -29,6 +25,7 @@ VS_OUTPUT main(VertexShaderInput input)
 {
 	VS_OUTPUT output;
 	output.pos = float4(input.pos.x, input.pos.y, input.pos.z, 1.0f);
+	output.radius = input.radius;
 
 	return output;
 }
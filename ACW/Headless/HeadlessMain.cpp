@@ -0,0 +1,2569 @@
+// Headless driver for the portable CPU code in AdvancedRenderingDefaultProject.
+// It has no Windows dependency and is not part of the UWP project. Build on Linux from this
+// directory with:
+//
+//   P=../AdvancedRenderingDefaultProject
+//   g++ -std=c++14 -O2 -pthread -I$P HeadlessMain.cpp $(sed "s|^|$P/|" HeadlessSources.txt) -o headless
+//
+// Usage:
+//   headless implicit [scene|all] [width] [height] [threads]   render implicit scenes to PPM
+//   headless implicit-scaling [scene] [width] [height]        time 1..N threads
+//   headless implicit-simd [scene] [width] [height] [threads] rays/s of each packet width vs. scalar
+//   headless implicit-bvh [width] [height] [threads]           BVH-culled scenes vs. linear union
+//   headless implicit-bvh-hlsl [scene|stress] [count]          print the generated HLSL
+//   headless implicit-bake [scene|all] [voxel] [8|16] [w] [h]  bake a brick map, render from it
+//   headless implicit-compiled [width] [height]                compiled scene kernels vs. sceneDistFunc
+//   headless implicit-hlsl [directory]                         write the per-scene pixel shaders
+//   headless implicit-relaxed [scene|all] [width] [height]     relaxed / adaptive-epsilon marcher vs. plain
+//   headless implicit-cone [scene|all] [width] [height]        cone-march prepass, steps per pass
+//   headless implicit-normals [scene|all] [width] [height]     tetrahedral / analytic normals vs. central
+//   headless implicit-fractal-lod [width] [height]             fractal level of detail vs. 20 iterations
+//   headless implicit-progressive [scene|all] [width] [height] time-sliced frames, reprojection, budget
+//   headless raster [width] [height] [frames] [threads]        explicit passes on the software rasterizer
+//   headless tessellate                                        validate the tessellator, time the cache
+//   headless floor-tess [width] [height] [frames] [threads]    adaptive floor factors vs. the fixed 31
+//   headless parametric-cache [width] [height] [frames]        cached parametric meshes vs. tessellating
+//   headless parametric-eval [columns] [rows]                  batched surface evaluation per SIMD level
+//   headless grass-cull [frames] [threads]                     chunk culling and upload at 10^5..10^7 blades
+//   headless grass-scatter [threads]                           Poisson-disc vs. uniform blades, masked field
+//   headless grass-lod [frames] [threads]                      grass cost with and without LOD as the field grows
+//   headless geometry-expansion [width] [height] [frames]      geometry shader vs. instanced grass and snakes
+//   headless snake-swarm [frames] [threads]                    snake update and upload cost per 1,000 snakes
+//   headless snake-tube [width] [height] [frames]              CPU-extruded snake tubes vs. SnakeGS rings
+//   headless dds file.dds...                                   validate DDS files, print their layout
+//   headless dds-load [repeats] file.dds...                    read-into-a-copy vs. memory-mapped loading
+//   headless bc-decode [threads] [size|file.dds...]            BC1-BC7 decode rate per format and SIMD level
+
+#include "Content/GrassField.h"
+#include "Content/ImplicitConePrepass.h"
+#include "Content/ImplicitCpuRenderer.h"
+#include "Content/ImplicitProgressive.h"
+#include "Content/ImplicitSceneKernels.h"
+#include "Content/ParametricEvaluator.h"
+#include "Content/SdfScene.h"
+#include "Content/SnakeSwarm.h"
+#include "Content/SnakeTube.h"
+#include "Content/SoftwareSceneRenderer.h"
+#include "Common/BlockDecoder.h"
+#include "Common/DDSFile.h"
+#include "Common/MappedFile.h"
+#include "Common/Tessellator.h"
+#include "TessellatorReference.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace AdvancedRenderingDefaultProject;
+
+namespace
+{
+	unsigned int ArgOr(int argc, char** argv, int index, unsigned int fallback)
+	{
+		return argc > index ? static_cast<unsigned int>(std::atoi(argv[index])) : fallback;
+	}
+
+	std::vector<ImplicitSceneType> ParseScenes(int argc, char** argv, int index)
+	{
+		std::vector<ImplicitSceneType> scenes;
+		const char* name = argc > index ? argv[index] : "all";
+
+		for (int i = 0; i < ImplicitSceneCount; i++)
+		{
+			ImplicitSceneType scene = static_cast<ImplicitSceneType>(i);
+			if (std::strcmp(name, "all") == 0 || std::strcmp(name, ImplicitSceneName(scene)) == 0)
+			{
+				scenes.push_back(scene);
+			}
+		}
+
+		return scenes;
+	}
+
+	int RunImplicit(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+		unsigned int threads = ArgOr(argc, argv, 5, 0);
+
+		auto pool = std::make_shared<DX::ThreadPool>(threads);
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer image(width, height);
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+
+			ImplicitRenderStats stats = renderer.Render(settings, image);
+
+			std::string path = std::string("implicit_") + ImplicitSceneName(scene) + ".ppm";
+			image.SavePPM(path);
+
+			std::printf("%-10s %ux%u  %u threads  %8.2f ms  %6.1f steps/px  -> %s\n",
+				ImplicitSceneName(scene), width, height, pool->GetThreadCount(), stats.seconds * 1000.0,
+				double(stats.marchSteps) / (double(width) * height), path.c_str());
+		}
+
+		return 0;
+	}
+
+	// Largest per-channel difference between two images of the same size.
+	float MaxImageDifference(const DX::ImageBuffer& a, const DX::ImageBuffer& b)
+	{
+		float maxDiff = 0.0f;
+		size_t count = static_cast<size_t>(a.GetWidth()) * a.GetHeight();
+		for (size_t i = 0; i < count; i++)
+		{
+			DX::float4 d = a.GetData()[i] - b.GetData()[i];
+			maxDiff = std::max(maxDiff, std::max(std::max(std::fabs(d.x), std::fabs(d.y)), std::max(std::fabs(d.z), std::fabs(d.w))));
+		}
+		return maxDiff;
+	}
+
+	int RunImplicitSimd(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+		unsigned int threads = ArgOr(argc, argv, 5, 0);
+
+		auto pool = std::make_shared<DX::ThreadPool>(threads);
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer reference(width, height);
+		DX::ImageBuffer image(width, height);
+		double rays = double(width) * height;
+
+		std::printf("cpu supports %s, %u threads\n", DX::SimdLevelName(DX::GetSupportedSimdLevel()), pool->GetThreadCount());
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			double scalarSeconds = renderer.Render(settings, reference).seconds;
+
+			std::printf("%-10s %-7s %2u lanes  %8.2f Mrays/s\n", ImplicitSceneName(scene), "scalar", 1u, rays / scalarSeconds * 1e-6);
+
+			for (DX::SimdLevel level : { DX::SimdLevel::SSE41, DX::SimdLevel::AVX2, DX::SimdLevel::AVX512 })
+			{
+				if (!DX::IsSimdLevelSupported(level))
+				{
+					continue;
+				}
+
+				settings.simd = level;
+				double seconds = renderer.Render(settings, image).seconds;
+
+				std::printf("%-10s %-7s %2u lanes  %8.2f Mrays/s  %5.2fx  max diff %g\n",
+					ImplicitSceneName(scene), DX::SimdLevelName(level), Implicit::PacketLanes(level),
+					rays / seconds * 1e-6, scalarSeconds / seconds, MaxImageDifference(reference, image));
+			}
+		}
+
+		return 0;
+	}
+
+	struct SdfMarchResult
+	{
+		double				seconds = 0.0;
+		unsigned long long	steps = 0;
+		unsigned long long	evaluations = 0;
+		std::vector<float>	depths;
+	};
+
+	// Sphere traces every pixel of a width x height frame through distance(p, evaluations).
+	template <typename DistanceFunc>
+	SdfMarchResult MarchFrame(DX::ThreadPool& pool, unsigned int width, unsigned int height, DistanceFunc distance)
+	{
+		SdfMarchResult result;
+		result.depths.resize(static_cast<size_t>(width) * height);
+		std::atomic<unsigned long long> steps(0), evaluations(0);
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		pool.ParallelFor(height, [&](size_t y)
+		{
+			unsigned long long rowSteps = 0;
+			unsigned int rowEvaluations = 0;
+
+			for (unsigned int x = 0; x < width; x++)
+			{
+				Implicit::Ray ray = Implicit::eyeRayForCanvas(ImplicitCpuRenderer::PixelToCanvas(x, static_cast<unsigned int>(y), width, height));
+				float depth = Implicit::nearPlane;
+				float hit = Implicit::farPlane;
+
+				for (int i = 0; i < Implicit::MAX_MARCH; i++)
+				{
+					rowSteps++;
+					float dist = distance(ray.origin + depth * ray.direction, &rowEvaluations);
+					if (dist < Implicit::EPSILON)
+					{
+						hit = depth;
+						break;
+					}
+
+					depth += dist;
+					if (depth >= Implicit::farPlane)
+					{
+						break;
+					}
+				}
+
+				result.depths[y * width + x] = hit;
+			}
+
+			steps += rowSteps;
+			evaluations += rowEvaluations;
+		});
+
+		auto end = std::chrono::high_resolution_clock::now();
+		result.seconds = std::chrono::duration<double>(end - start).count();
+		result.steps = steps.load();
+		result.evaluations = evaluations.load();
+		return result;
+	}
+
+	// Pixels whose hit/miss or depth (beyond tolerance) differ between two marches.
+	unsigned int DepthMismatches(const SdfMarchResult& a, const SdfMarchResult& b, float tolerance)
+	{
+		unsigned int mismatches = 0;
+		for (size_t i = 0; i < a.depths.size(); i++)
+		{
+			if (std::fabs(a.depths[i] - b.depths[i]) > tolerance)
+			{
+				mismatches++;
+			}
+		}
+		return mismatches;
+	}
+
+	void PrintSdfComparison(const char* name, size_t primitives, const SdfMarchResult& linear, const SdfMarchResult& bvh, double pixels)
+	{
+		std::printf("%-14s %6zu prims  linear %9.2f ms %8.1f evals/step  bvh %9.2f ms %6.2f evals/step  %5.2fx  %u/%.0f px differ\n",
+			name, primitives,
+			linear.seconds * 1000.0, double(linear.evaluations) / linear.steps,
+			bvh.seconds * 1000.0, double(bvh.evaluations) / bvh.steps,
+			linear.seconds / bvh.seconds, DepthMismatches(linear, bvh, 1e-3f), pixels);
+	}
+
+	int RunImplicitBvh(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 320);
+		unsigned int height = ArgOr(argc, argv, 3, 180);
+		unsigned int threads = ArgOr(argc, argv, 4, 0);
+		DX::ThreadPool pool(threads);
+		double pixels = double(width) * height;
+
+		std::printf("%ux%u, %u threads\n", width, height, pool.GetThreadCount());
+
+		// The shipped scenes: same picture as sceneDistFunc, whichever way the union is evaluated.
+		for (int i = 0; i < ImplicitSceneCount; i++)
+		{
+			ImplicitSceneType scene = static_cast<ImplicitSceneType>(i);
+			SdfScene sdf = CreateImplicitSdfScene(scene);
+
+			SdfMarchResult shader = MarchFrame(pool, width, height, [scene](const DX::float3& p, unsigned int*)
+			{
+				return Implicit::sceneDistFunc(scene, p);
+			});
+			SdfMarchResult linear = MarchFrame(pool, width, height, [&sdf](const DX::float3& p, unsigned int* evaluations)
+			{
+				return sdf.DistanceLinear(p, evaluations);
+			});
+			SdfMarchResult bvh = MarchFrame(pool, width, height, [&sdf](const DX::float3& p, unsigned int* evaluations)
+			{
+				return sdf.Distance(p, evaluations);
+			});
+
+			PrintSdfComparison(ImplicitSceneName(scene), sdf.GetPrimitiveCount(), linear, bvh, pixels);
+			std::printf("%-14s %u px differ from sceneDistFunc\n", "", DepthMismatches(shader, bvh, 1e-3f));
+		}
+
+		// Synthetic scenes to show how the per-step cost grows with object count. The linear
+		// union is skipped once it gets too slow to be worth waiting for.
+		for (unsigned int count : { 16u, 64u, 256u, 1024u, 4096u, 16384u })
+		{
+			SdfScene sdf = CreateSdfStressScene(count, 1);
+
+			SdfMarchResult bvh = MarchFrame(pool, width, height, [&sdf](const DX::float3& p, unsigned int* evaluations)
+			{
+				return sdf.Distance(p, evaluations);
+			});
+
+			if (count <= 1024)
+			{
+				SdfMarchResult linear = MarchFrame(pool, width, height, [&sdf](const DX::float3& p, unsigned int* evaluations)
+				{
+					return sdf.DistanceLinear(p, evaluations);
+				});
+				PrintSdfComparison("stress", count, linear, bvh, pixels);
+			}
+			else
+			{
+				std::printf("%-14s %6u prims  %49s bvh %9.2f ms %6.2f evals/step\n",
+					"stress", count, "", bvh.seconds * 1000.0, double(bvh.evaluations) / bvh.steps);
+			}
+		}
+
+		return 0;
+	}
+
+	int RunImplicitBvhHlsl(int argc, char** argv)
+	{
+		const char* name = argc > 2 ? argv[2] : "default";
+
+		if (std::strcmp(name, "stress") == 0)
+		{
+			std::fputs(CreateSdfStressScene(ArgOr(argc, argv, 3, 64), 1).GenerateHlsl("sceneDistFuncBVH").c_str(), stdout);
+			return 0;
+		}
+
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		for (ImplicitSceneType scene : scenes)
+		{
+			std::fputs(CreateImplicitSdfScene(scene).GenerateHlsl(std::string("sceneDistFuncBVH_") + ImplicitSceneName(scene)).c_str(), stdout);
+		}
+
+		return 0;
+	}
+
+	// Pixels where any channel differs by more than threshold.
+	unsigned int CountImageDifferences(const DX::ImageBuffer& a, const DX::ImageBuffer& b, float threshold)
+	{
+		unsigned int count = 0;
+		size_t pixels = static_cast<size_t>(a.GetWidth()) * a.GetHeight();
+		for (size_t i = 0; i < pixels; i++)
+		{
+			DX::float4 d = a.GetData()[i] - b.GetData()[i];
+			if (std::max(std::max(std::fabs(d.x), std::fabs(d.y)), std::max(std::fabs(d.z), std::fabs(d.w))) > threshold)
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+
+	int RunImplicitBake(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		float voxelSize = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 0.05f;
+		if (!(voxelSize > 0.0f) || !std::isfinite(voxelSize))
+		{
+			std::fprintf(stderr, "voxel size must be positive and finite\n");
+			return 1;
+		}
+		SdfBrickFormat format = ArgOr(argc, argv, 4, 8) == 16 ? SdfBrickFormat::Half : SdfBrickFormat::Unorm8;
+		unsigned int width = ArgOr(argc, argv, 5, 640);
+		unsigned int height = ArgOr(argc, argv, 6, 360);
+
+		auto pool = std::make_shared<DX::ThreadPool>();
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer reference(width, height);
+		DX::ImageBuffer image(width, height);
+		double pixels = double(width) * height;
+
+		std::printf("voxel %g, %s, %ux%u, %u threads\n", voxelSize, format == SdfBrickFormat::Half ? "half" : "unorm8", width, height, pool->GetThreadCount());
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			SdfBakeSettings bake;
+			bake.scene = scene;
+			bake.format = format;
+			bake.voxelSize = voxelSize;
+
+			SdfBrickMap brickMap;
+			SdfBakeStats bakeStats = brickMap.Bake(bake, *pool);
+			if (brickMap.IsEmpty())
+			{
+				std::fprintf(stderr, "%s: voxel %g needs more than %zu bricks\n", ImplicitSceneName(scene), voxelSize, SdfBrickMap::MaxGridBricks);
+				return 1;
+			}
+
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			ImplicitRenderStats analytic = renderer.Render(settings, reference);
+
+			settings.brickMap = &brickMap;
+			ImplicitRenderStats baked = renderer.Render(settings, image);
+
+			std::string path = std::string("implicit_") + ImplicitSceneName(scene) + "_baked.ppm";
+			image.SavePPM(path);
+
+			std::printf("%-10s bake %8.2f ms  %6u/%-7u bricks %7.2f MB  render %8.2f -> %8.2f ms (%5.2fx)  steps/px %5.1f -> %5.1f  %.2f%% px differ\n",
+				ImplicitSceneName(scene), bakeStats.seconds * 1000.0, bakeStats.bricks, bakeStats.gridBricks, bakeStats.bytes / (1024.0 * 1024.0),
+				analytic.seconds * 1000.0, baked.seconds * 1000.0, analytic.seconds / baked.seconds,
+				analytic.marchSteps / pixels, baked.marchSteps / pixels,
+				100.0 * CountImageDifferences(reference, image, 0.1f) / pixels);
+		}
+
+		return 0;
+	}
+
+	int RunImplicitRelaxed(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+
+		auto pool = std::make_shared<DX::ThreadPool>();
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer reference(width, height);
+		DX::ImageBuffer image(width, height);
+		double pixels = double(width) * height;
+
+		const float relaxations[] = { 1.0f, 1.2f, 1.4f, 1.6f, 1.8f };
+		const float hitPixels[] = { 0.0f, 0.25f, 0.5f, 1.0f };
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			ImplicitRenderStats plain = renderer.Render(settings, reference);
+
+			std::printf("%-10s plain                %8.2f ms  %6.1f steps/px\n",
+				ImplicitSceneName(scene), plain.seconds * 1000.0, plain.marchSteps / pixels);
+
+			for (float relaxation : relaxations)
+			{
+				for (float hit : hitPixels)
+				{
+					if (relaxation == 1.0f && hit == 0.0f)
+					{
+						continue;
+					}
+
+					settings.march = ImplicitMarchSettings{ relaxation, hit };
+					ImplicitRenderStats stats = renderer.Render(settings, image);
+
+					std::printf("%-10s relax %.1f hit %.2f px %8.2f ms  %6.1f steps/px (%5.2fx)  %.2f%% px differ  max diff %.3f\n",
+						ImplicitSceneName(scene), relaxation, hit, stats.seconds * 1000.0, stats.marchSteps / pixels,
+						double(plain.marchSteps) / stats.marchSteps, 100.0 * CountImageDifferences(reference, image, 0.1f) / pixels,
+						MaxImageDifference(reference, image));
+				}
+			}
+
+			// The shipped per-scene choice, saved for a visual check.
+			settings.march = ImplicitRelaxedMarch(static_cast<int>(scene));
+			renderer.Render(settings, image);
+			image.SavePPM(std::string("implicit_") + ImplicitSceneName(scene) + "_relaxed.ppm");
+		}
+
+		return 0;
+	}
+
+	int RunImplicitCone(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+
+		auto pool = std::make_shared<DX::ThreadPool>();
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer reference(width, height);
+		DX::ImageBuffer image(width, height);
+		double pixels = double(width) * height;
+
+		const std::vector<std::vector<unsigned int>> passSetups = { { 8 }, { 8, 2 }, { 16, 4 }, { 16, 4, 1 } };
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			ImplicitRenderStats plain = renderer.Render(settings, reference);
+
+			std::printf("%-10s no prepass %8.2f ms  %6.2f evals/px\n", ImplicitSceneName(scene), plain.seconds * 1000.0, plain.marchSteps / pixels);
+
+			for (const std::vector<unsigned int>& blockSizes : passSetups)
+			{
+				ImplicitConePrepass prepass;
+				prepass.Run(scene, width, height, blockSizes, *pool);
+
+				settings.conePrepass = &prepass;
+				ImplicitRenderStats stats = renderer.Render(settings, image);
+
+				std::string name;
+				for (unsigned int blockSize : blockSizes)
+				{
+					name += (name.empty() ? "" : ",") + std::to_string(blockSize);
+				}
+
+				std::string passes;
+				double seconds = stats.seconds;
+				unsigned long long steps = stats.marchSteps;
+				for (const ImplicitConePassStats& pass : prepass.GetPassStats())
+				{
+					char text[64];
+					std::snprintf(text, sizeof(text), "%ux%u %.2f + ", pass.blockSize, pass.blockSize, pass.steps / pixels);
+					passes += text;
+					seconds += pass.seconds;
+					steps += pass.steps;
+				}
+
+				std::printf("%-10s cone %-6s %8.2f ms  %6.2f evals/px = %srays %.2f  (%5.2fx fewer)  %.2f%% px differ\n",
+					ImplicitSceneName(scene), name.c_str(),
+					seconds * 1000.0, steps / pixels, passes.c_str(), stats.marchSteps / pixels,
+					double(plain.marchSteps) / steps, 100.0 * CountImageDifferences(reference, image, 0.1f) / pixels);
+			}
+		}
+
+		return 0;
+	}
+
+	int RunImplicitNormals(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+
+		auto pool = std::make_shared<DX::ThreadPool>();
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer reference(width, height);
+		DX::ImageBuffer image(width, height);
+		double pixels = double(width) * height;
+
+		const ImplicitNormalMode modes[] = { ImplicitNormalMode::Tetrahedral, ImplicitNormalMode::Analytic };
+		const char* modeNames[] = { "tetrahedral", "analytic" };
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			// Hit points of the frame.
+			std::vector<DX::float3> hits;
+			for (unsigned int y = 0; y < height; y++)
+			{
+				for (unsigned int x = 0; x < width; x++)
+				{
+					Implicit::Ray ray = Implicit::eyeRayForCanvas(ImplicitCpuRenderer::PixelToCanvas(x, y, width, height));
+					float depth = Implicit::shortestDistanceToSurface(scene, ray, Implicit::nearPlane, Implicit::farPlane);
+					if (depth <= Implicit::farPlane - Implicit::EPSILON)
+					{
+						hits.push_back(ray.origin + depth * ray.direction);
+					}
+				}
+			}
+
+			auto time = [&hits, scene](ImplicitNormalMode mode, std::vector<DX::float3>& normals)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+				for (size_t i = 0; i < hits.size(); i++)
+				{
+					normals[i] = Implicit::sceneNormal(scene, hits[i], mode);
+				}
+				return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+			};
+
+			std::vector<DX::float3> central(hits.size()), normals(hits.size());
+			double centralSeconds = time(ImplicitNormalMode::Central, central);
+
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			settings.normals = ImplicitNormalMode::Central;
+			renderer.Render(settings, reference);
+
+			// Before the normal was shared, each of the two lights worked it out again.
+			std::printf("%-10s central      %8.2f ms for %zu hits (%.2f ms once per light)\n",
+				ImplicitSceneName(scene), centralSeconds * 1000.0, hits.size(), 2.0 * centralSeconds * 1000.0);
+
+			for (int m = 0; m < 2; m++)
+			{
+				double seconds = time(modes[m], normals);
+
+				double sumAngle = 0.0, maxAngle = 0.0;
+				size_t overOneDegree = 0;
+				for (size_t i = 0; i < hits.size(); i++)
+				{
+					double angle = std::acos(std::min(1.0f, std::max(-1.0f, dot(central[i], normals[i])))) * 180.0 / 3.14159265358979;
+					sumAngle += angle;
+					maxAngle = std::max(maxAngle, angle);
+					overOneDegree += angle > 1.0 ? 1 : 0;
+				}
+
+				settings.normals = modes[m];
+				renderer.Render(settings, image);
+
+				std::printf("%-10s %-12s %8.2f ms (%5.2fx)  angle to central mean %.4f max %.3f deg, %.2f%% > 1 deg  %.2f%% px differ\n",
+					ImplicitSceneName(scene), modeNames[m], seconds * 1000.0, centralSeconds / seconds,
+					hits.empty() ? 0.0 : sumAngle / hits.size(), maxAngle, hits.empty() ? 0.0 : 100.0 * overOneDegree / hits.size(),
+					100.0 * CountImageDifferences(reference, image, 0.1f) / pixels);
+			}
+		}
+
+		return 0;
+	}
+
+	int RunImplicitFractalLod(int argc, char** argv)
+	{
+		auto pool = std::make_shared<DX::ThreadPool>();
+		ImplicitCpuRenderer renderer(pool);
+		ImplicitSceneType scene = ImplicitSceneType::Fractal;
+
+		// The frame size sets the footprint, so check the range the app runs at.
+		std::vector<std::pair<unsigned int, unsigned int>> sizes = { { 640, 360 }, { 1280, 720 }, { 1920, 1080 } };
+		if (argc > 3)
+		{
+			sizes = { { ArgOr(argc, argv, 2, 640), ArgOr(argc, argv, 3, 360) } };
+		}
+
+		for (const auto& size : sizes)
+		{
+			unsigned int width = size.first;
+			unsigned int height = size.second;
+			DX::ImageBuffer reference(width, height);
+			DX::ImageBuffer image(width, height);
+			double pixels = double(width) * height;
+
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			ImplicitRenderStats full = renderer.Render(settings, reference);
+
+			settings.fractalLod = true;
+			ImplicitRenderStats lod = renderer.Render(settings, image);
+
+			image.SavePPM("implicit_fractal_lod_" + std::to_string(height) + ".ppm");
+
+			float pixelAngle = Implicit::pixelFootprint(DX::float2(0.0f, 0.0f), 2.0f / height);
+			std::printf("%4ux%-4u  iterations %d..%d  20 iterations %8.2f ms %5.1f steps/px  lod %8.2f ms %5.1f steps/px (%5.2fx)  %.2f%% px differ  max diff %.3f\n",
+				width, height,
+				Implicit::fractalIterations((length(Implicit::eyePos) + 2.0f) * pixelAngle), Implicit::fractalIterations((length(Implicit::eyePos) - 2.0f) * pixelAngle),
+				full.seconds * 1000.0, full.marchSteps / pixels, lod.seconds * 1000.0, lod.marchSteps / pixels, full.seconds / lod.seconds,
+				100.0 * CountImageDifferences(reference, image, 0.1f) / pixels, MaxImageDifference(reference, image));
+		}
+
+		return 0;
+	}
+
+	int RunImplicitProgressive(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+
+		auto pool = std::make_shared<DX::ThreadPool>();
+		ImplicitCpuRenderer renderer(pool);
+		DX::ImageBuffer reference(width, height);
+		DX::ImageBuffer image(width, height);
+		double pixels = double(width) * height;
+		unsigned int failures = 0;
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			ImplicitRenderSettings settings;
+			settings.scene = scene;
+			ImplicitRenderStats full = renderer.Render(settings, reference);
+			std::printf("%-10s full frame %8.2f ms\n", ImplicitSceneName(scene), full.seconds * 1000.0);
+
+			// Still eye: how long a frame takes and whether the image converges to the full render.
+			for (unsigned int slices : { 1u, 2u, 4u, 8u })
+			{
+				ImplicitProgressiveRenderer progressive(pool);
+				unsigned int frames = ImplicitInterleave::SliceCount / slices;
+				double seconds = 0.0;
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					seconds += progressive.Render(settings, slices, image).seconds;
+				}
+
+				std::printf("%-10s still    %2u slices  %8.2f ms/frame (%5.2fx)  %2u frames  %.2f%% px differ  max diff %.3f\n",
+					ImplicitSceneName(scene), slices, seconds / frames * 1000.0, full.seconds * frames / seconds, frames,
+					100.0 * CountImageDifferences(reference, image, 0.1f) / pixels, MaxImageDifference(reference, image));
+			}
+
+			// Moving eye: error against a full render from the same eye, with the history
+			// reprojected and with it dropped every frame (trace and fill only).
+			{
+				const unsigned int frames = 32;
+				const unsigned int slices = 4;
+				ImplicitProgressiveRenderer reprojected(pool);
+				ImplicitProgressiveRenderer filled(pool);
+				DX::ImageBuffer moving(width, height);
+				double reprojectedDiffer = 0.0, filledDiffer = 0.0, seconds = 0.0;
+				unsigned long long carried = 0;
+
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					float t = float(frame) / frames;
+					settings.eye = Implicit::eyePos + DX::float3(2.0f * std::sin(6.2831853f * t), 0.5f * t, -2.0f * t);
+
+					renderer.Render(settings, moving);
+
+					ImplicitProgressiveStats stats = reprojected.Render(settings, slices, image);
+					seconds += stats.seconds;
+					carried += stats.reprojectedPixels;
+					reprojectedDiffer += CountImageDifferences(moving, image, 0.1f) / pixels;
+
+					filled.Reset();
+					filled.Render(settings, slices, image);
+					filledDiffer += CountImageDifferences(moving, image, 0.1f) / pixels;
+				}
+				settings.eye = Implicit::eyePos;
+
+				std::printf("%-10s moving   %2u slices  %8.2f ms/frame  %5.1f%% px reprojected  %.2f%% px differ (%.2f%% without reprojection)\n",
+					ImplicitSceneName(scene), slices, seconds / frames * 1000.0, 100.0 * carried / (pixels * frames),
+					100.0 * reprojectedDiffer / frames, 100.0 * filledDiffer / frames);
+			}
+
+			// Budget of a quarter of a full frame, fed back the measured frame times. The first
+			// frames find the count from the full 16 slices; the rest have to average within it.
+			{
+				ImplicitFrameBudget budget(full.seconds / 4.0);
+				ImplicitProgressiveRenderer progressive(pool);
+				std::string sliceTrace;
+				double seconds = 0.0;
+				const unsigned int settleFrames = 4;
+				const unsigned int frames = 32;
+
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					ImplicitProgressiveStats stats = progressive.Render(settings, budget.GetSlicesPerFrame(), image);
+					budget.Update(stats.seconds);
+					seconds += frame < settleFrames ? 0.0 : stats.seconds;
+					sliceTrace += std::to_string(stats.slices) + (frame + 1 < frames ? "," : "");
+				}
+
+				double mean = seconds / (frames - settleFrames);
+				bool withinBudget = mean <= budget.GetBudgetSeconds();
+				std::printf("%s%-10s budget   %8.2f ms  %8.2f ms/frame  slices %s\n", withinBudget ? "" : "FAIL ",
+					ImplicitSceneName(scene), budget.GetBudgetSeconds() * 1000.0, mean * 1000.0, sliceTrace.c_str());
+				failures += !withinBudget;
+			}
+
+			image.SavePPM(std::string("implicit_") + ImplicitSceneName(scene) + "_progressive.ppm");
+		}
+
+		return failures == 0 ? 0 : 1;
+	}
+
+	int RunImplicitCompiled(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 320);
+		unsigned int height = ArgOr(argc, argv, 3, 180);
+
+		std::vector<Implicit::Ray> rays;
+		for (unsigned int y = 0; y < height; y++)
+		{
+			for (unsigned int x = 0; x < width; x++)
+			{
+				rays.push_back(Implicit::eyeRayForCanvas(ImplicitCpuRenderer::PixelToCanvas(x, y, width, height)));
+			}
+		}
+
+		std::vector<float> reference(rays.size()), compiled(rays.size());
+
+		for (int i = 0; i < ImplicitSceneCount; i++)
+		{
+			ImplicitSceneType scene = static_cast<ImplicitSceneType>(i);
+
+			// Distances at scattered points around the scene must match exactly.
+			Implicit::SceneDistFunc dist = Implicit::GetSceneDistFunc(scene);
+			unsigned int state = 12345u;
+			unsigned int pointMismatches = 0;
+			const unsigned int pointCount = 200000;
+			for (unsigned int n = 0; n < pointCount; n++)
+			{
+				float c[3];
+				for (float& v : c)
+				{
+					state = state * 1664525u + 1013904223u;
+					v = ((state >> 8) * (1.0f / 16777216.0f)) * 20.0f - 10.0f;
+				}
+				DX::float3 p(c[0], c[1], c[2]);
+				if (dist(p) != Implicit::sceneDistFunc(scene, p))
+				{
+					pointMismatches++;
+				}
+			}
+
+			unsigned long long steps = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			Implicit::MarchRaysScalar(scene, rays.data(), rays.size(), Implicit::nearPlane, Implicit::farPlane, reference.data(), &steps);
+			auto middle = std::chrono::high_resolution_clock::now();
+			Implicit::MarchRaysCompiled(scene, rays.data(), rays.size(), Implicit::nearPlane, Implicit::farPlane, compiled.data(), &steps);
+			auto end = std::chrono::high_resolution_clock::now();
+
+			double referenceSeconds = std::chrono::duration<double>(middle - start).count();
+			double compiledSeconds = std::chrono::duration<double>(end - middle).count();
+
+			unsigned int depthMismatches = 0;
+			for (size_t r = 0; r < rays.size(); r++)
+			{
+				depthMismatches += reference[r] != compiled[r];
+			}
+
+			std::printf("%-10s sceneDistFunc %8.2f ms  compiled %8.2f ms  %5.2fx  %u/%u points, %u/%zu depths differ\n",
+				ImplicitSceneName(scene), referenceSeconds * 1000.0, compiledSeconds * 1000.0, referenceSeconds / compiledSeconds,
+				pointMismatches, pointCount, depthMismatches, rays.size());
+		}
+
+		return 0;
+	}
+
+	int RunImplicitHlsl(int argc, char** argv)
+	{
+		std::string directory = argc > 2 ? argv[2] : ".";
+
+		for (int i = 0; i < ImplicitSceneCount; i++)
+		{
+			ImplicitSceneType scene = static_cast<ImplicitSceneType>(i);
+			std::string path = directory + "/" + Implicit::ScenePixelShaderName(scene) + ".hlsl";
+
+			std::ofstream file(path, std::ios::binary);
+			file << Implicit::ScenePixelShaderHlsl(scene);
+			if (!file)
+			{
+				std::fprintf(stderr, "could not write %s\n", path.c_str());
+				return 1;
+			}
+
+			std::printf("%s\n", path.c_str());
+		}
+
+		return 0;
+	}
+
+	int RunImplicitScaling(int argc, char** argv)
+	{
+		std::vector<ImplicitSceneType> scenes = ParseScenes(argc, argv, 2);
+		unsigned int width = ArgOr(argc, argv, 3, 640);
+		unsigned int height = ArgOr(argc, argv, 4, 360);
+		unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		DX::ImageBuffer image(width, height);
+
+		for (ImplicitSceneType scene : scenes)
+		{
+			double baseline = 0.0;
+			for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+			{
+				auto pool = std::make_shared<DX::ThreadPool>(threads);
+				ImplicitCpuRenderer renderer(pool);
+
+				ImplicitRenderSettings settings;
+				settings.scene = scene;
+				double seconds = renderer.Render(settings, image).seconds;
+
+				if (threads == 1)
+				{
+					baseline = seconds;
+				}
+
+				std::printf("%-10s %2u threads  %8.2f ms  speedup %5.2fx\n",
+					ImplicitSceneName(scene), threads, seconds * 1000.0, baseline / seconds);
+			}
+		}
+
+		return 0;
+	}
+
+	int RunRaster(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 1280);
+		unsigned int height = ArgOr(argc, argv, 3, 720);
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 4, 10));
+		unsigned int threads = ArgOr(argc, argv, 5, 0);
+
+		auto pool = std::make_shared<DX::ThreadPool>(threads);
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+		DX::SoftwareRasterizer& rasterizer = deviceResources->GetRasterizer();
+
+		double passSeconds[SoftwarePassCount] = {};
+		double frameSeconds = 0.0;
+		rasterizer.ResetStats();
+
+		for (unsigned int frame = 0; frame < frames; frame++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			renderer.Update(frame / 60.0);
+			renderer.Render();
+			deviceResources->Present();
+			frameSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			for (int pass = 0; pass < SoftwarePassCount; pass++)
+			{
+				passSeconds[pass] += renderer.GetPassStats(static_cast<SoftwarePass>(pass)).seconds;
+			}
+		}
+
+		std::printf("%ux%u, %u threads, %u frames\n", width, height, pool->GetThreadCount(), frames);
+		for (int pass = 0; pass < SoftwarePassCount; pass++)
+		{
+			SoftwarePass p = static_cast<SoftwarePass>(pass);
+			std::printf("%-10s %8llu triangles  %8.2f ms vertex work\n",
+				SoftwarePassName(p), renderer.GetPassStats(p).triangles, passSeconds[pass] / frames * 1000.0);
+		}
+
+		const DX::RasterStats& stats = rasterizer.GetStats();
+		std::printf("setup      %8.2f ms  %llu triangles in, %llu binned, %llu tile pairs\n",
+			stats.setupSeconds / frames * 1000.0, stats.trianglesIn / frames, stats.trianglesBinned / frames, stats.tileTriangles / frames);
+		std::printf("raster     %8.2f ms  %llu pixels shaded\n", stats.rasterSeconds / frames * 1000.0, stats.pixelsShaded / frames);
+		std::printf("frame      %8.2f ms\n", frameSeconds / frames * 1000.0);
+
+		const char* path = "raster.ppm";
+		if (!deviceResources->GetBackBuffer().SavePPM(path))
+		{
+			std::fprintf(stderr, "could not write %s\n", path);
+			return 1;
+		}
+		std::printf("%s\n", path);
+
+		return 0;
+	}
+
+	// Checks a pattern is a proper triangulation of its domain: every index in range, every
+	// point used, every triangle wound the same way, and the areas summing to the domain's.
+	bool ValidatePattern(const DX::TessellatorPattern& pattern, DX::TessellatorDomain domain, bool clockwise, std::string& error)
+	{
+		if (pattern.indices.size() % 3 != 0)
+		{
+			error = "index count not a multiple of 3";
+			return false;
+		}
+
+		std::vector<bool> used(pattern.points.size(), false);
+		double area = 0.0;
+		for (size_t i = 0; i < pattern.indices.size(); i += 3)
+		{
+			unsigned int index[3] = { pattern.indices[i], pattern.indices[i + 1], pattern.indices[i + 2] };
+			for (unsigned int j : index)
+			{
+				if (j >= pattern.points.size())
+				{
+					error = "index out of range";
+					return false;
+				}
+				used[j] = true;
+			}
+
+			const DX::float2& a = pattern.points[index[0]];
+			const DX::float2& b = pattern.points[index[1]];
+			const DX::float2& c = pattern.points[index[2]];
+			double signedArea = 0.5 * ((double(b.x) - a.x) * (double(c.y) - a.y) - (double(c.x) - a.x) * (double(b.y) - a.y));
+
+			// "Clockwise" is counter-clockwise with v up, the way the domain shaders map it.
+			if (clockwise ? signedArea < 0.0 : signedArea > 0.0)
+			{
+				error = "triangle wound the wrong way";
+				return false;
+			}
+			area += std::fabs(signedArea);
+		}
+
+		for (size_t i = 0; i < used.size(); i++)
+		{
+			if (!used[i])
+			{
+				error = "unreferenced point";
+				return false;
+			}
+		}
+
+		double expected = domain == DX::TessellatorDomain::Tri ? 0.5 : 1.0;
+		if (std::fabs(area - expected) > 1e-3)
+		{
+			error = "areas sum to " + std::to_string(area);
+			return false;
+		}
+		return true;
+	}
+
+	int RunTessellate(int argc, char** argv)
+	{
+		const DX::TessellatorPartitioning partitionings[] =
+		{
+			DX::TessellatorPartitioning::Integer,
+			DX::TessellatorPartitioning::Pow2,
+			DX::TessellatorPartitioning::FractionalOdd,
+			DX::TessellatorPartitioning::FractionalEven
+		};
+		const char* partitioningNames[] = { "integer", "pow2", "fractional_odd", "fractional_even" };
+		const DX::TessellatorDomain domains[] = { DX::TessellatorDomain::Tri, DX::TessellatorDomain::Quad };
+		const char* domainNames[] = { "tri", "quad" };
+
+		int failures = 0;
+		unsigned long long patterns = 0;
+		DX::TessellatorPattern pattern;
+
+		auto check = [&](DX::TessellatorDomain domain, int p, DX::TessellatorOutput output, const DX::TessellatorFactors& factors)
+		{
+			DX::Tessellator(partitionings[p], output).Tessellate(domain, factors, pattern);
+			patterns++;
+
+			std::string error;
+			if (!ValidatePattern(pattern, domain, output == DX::TessellatorOutput::TriangleCW, error))
+			{
+				if (failures++ < 10)
+				{
+					std::printf("FAIL %s %s edges %g %g %g %g inside %g %g: %s\n",
+						domainNames[domain == DX::TessellatorDomain::Quad], partitioningNames[p],
+						factors.edges[0], factors.edges[1], factors.edges[2], factors.edges[3],
+						factors.inside[0], factors.inside[1], error.c_str());
+				}
+			}
+		};
+
+		// Uniform factors over the whole range, in both windings.
+		for (DX::TessellatorDomain domain : domains)
+		{
+			for (int p = 0; p < 4; p++)
+			{
+				for (float factor = 0.25f; factor <= 66.0f; factor += 0.25f)
+				{
+					check(domain, p, DX::TessellatorOutput::TriangleCW, DX::TessellatorFactors::Uniform(factor));
+					check(domain, p, DX::TessellatorOutput::TriangleCCW, DX::TessellatorFactors::Uniform(factor));
+				}
+			}
+		}
+
+		// Independent edge and inside factors, as adaptive tessellation produces.
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> factorDistribution(0.5f, 64.0f);
+		for (int i = 0; i < 4000; i++)
+		{
+			DX::TessellatorFactors factors;
+			for (float& edge : factors.edges)
+			{
+				edge = factorDistribution(random);
+			}
+			factors.inside[0] = factorDistribution(random);
+			factors.inside[1] = factorDistribution(random);
+			check(domains[i & 1], (i >> 1) & 3, DX::TessellatorOutput::TriangleCW, factors);
+		}
+
+		// Integer partitioning has known sizes: an n x n grid of quads, and for triangles
+		// 6k^2 triangles over 1 + 3k(k + 1) points for even n = 2k, or 6k^2 + 6k + 1 triangles
+		// over 3(k + 1)^2 points for odd n = 2k + 1.
+		for (unsigned int n = 1; n <= 64; n++)
+		{
+			DX::Tessellator tessellator(DX::TessellatorPartitioning::Integer, DX::TessellatorOutput::TriangleCW);
+			DX::TessellatorFactors factors = DX::TessellatorFactors::Uniform(static_cast<float>(n));
+
+			tessellator.Tessellate(DX::TessellatorDomain::Quad, factors, pattern);
+			if (pattern.points.size() != (n + 1) * (n + 1) || pattern.indices.size() != 6 * n * n)
+			{
+				std::printf("FAIL quad integer %u: %zu points, %zu triangles\n", n, pattern.points.size(), pattern.indices.size() / 3);
+				failures++;
+			}
+
+			unsigned int k = n / 2;
+			size_t triPoints = (n & 1) ? 3 * (k + 1) * (k + 1) : 1 + 3 * k * (k + 1);
+			size_t triTriangles = (n & 1) ? 6 * k * k + 6 * k + 1 : 6 * k * k;
+			tessellator.Tessellate(DX::TessellatorDomain::Tri, factors, pattern);
+			if (pattern.points.size() != triPoints || pattern.indices.size() != 3 * triTriangles)
+			{
+				std::printf("FAIL tri integer %u: %zu points, %zu triangles\n", n, pattern.points.size(), pattern.indices.size() / 3);
+				failures++;
+			}
+		}
+
+		// Zero and NaN cull the patch.
+		DX::TessellatorFactors culled = DX::TessellatorFactors::Uniform(8.0f);
+		culled.edges[1] = 0.0f;
+		DX::Tessellator(DX::TessellatorPartitioning::Integer, DX::TessellatorOutput::TriangleCW).Tessellate(DX::TessellatorDomain::Quad, culled, pattern);
+		if (!pattern.points.empty() || !pattern.indices.empty())
+		{
+			std::printf("FAIL zero edge factor not culled\n");
+			failures++;
+		}
+
+		// Fractional patterns point for point and index for index against the reference
+		// tessellator's.
+		for (const TessellatorReference::Pattern& reference : TessellatorReference::Patterns)
+		{
+			DX::TessellatorFactors factors;
+			std::copy(reference.edges, reference.edges + 4, factors.edges);
+			std::copy(reference.inside, reference.inside + 2, factors.inside);
+			DX::Tessellator(reference.partitioning, DX::TessellatorOutput::TriangleCW).Tessellate(reference.domain, factors, pattern);
+			patterns++;
+
+			bool same = pattern.points.size() == reference.pointCount && pattern.indices.size() == reference.indexCount;
+			for (size_t i = 0; same && i < reference.pointCount; i++)
+			{
+				same = pattern.points[i].x == reference.points[2 * i] / 65536.0f && pattern.points[i].y == reference.points[2 * i + 1] / 65536.0f;
+			}
+			for (size_t i = 0; same && i < reference.indexCount; i++)
+			{
+				same = pattern.indices[i] == reference.indices[i];
+			}
+			if (!same)
+			{
+				std::printf("FAIL %s %s edges %g %g %g %g inside %g %g differs from the reference\n",
+					domainNames[reference.domain == DX::TessellatorDomain::Quad],
+					partitioningNames[reference.partitioning == DX::TessellatorPartitioning::FractionalOdd ? 2 : 3],
+					factors.edges[0], factors.edges[1], factors.edges[2], factors.edges[3], factors.inside[0], factors.inside[1]);
+				failures++;
+			}
+		}
+
+		std::printf("%llu patterns checked, %d failures\n", patterns, failures);
+
+		// What a draw of many patches costs with and without the cache.
+		const int patches = argc > 2 ? std::atoi(argv[2]) : 10000;
+		DX::TessellatorFactors factors = DX::TessellatorFactors::Uniform(31.0f);
+		DX::Tessellator tessellator(DX::TessellatorPartitioning::FractionalOdd, DX::TessellatorOutput::TriangleCW);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		size_t triangles = 0;
+		for (int i = 0; i < patches; i++)
+		{
+			tessellator.Tessellate(DX::TessellatorDomain::Quad, factors, pattern);
+			triangles += pattern.indices.size() / 3;
+		}
+		double uncached = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		DX::TessellatorCache cache;
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < patches; i++)
+		{
+			triangles += cache.Get(DX::TessellatorDomain::Quad, DX::TessellatorPartitioning::FractionalOdd,
+				DX::TessellatorOutput::TriangleCW, factors)->indices.size() / 3;
+		}
+		double cached = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		std::printf("%d quad patches at 31: %8.3f us/patch tessellated, %8.3f us/patch cached (%zu patterns, %zu triangles/patch)\n",
+			patches, uncached / patches * 1e6, cached / patches * 1e6, cache.GetSize(), triangles / 2 / patches);
+
+		return failures == 0 ? 0 : 1;
+	}
+
+	int RunFloorTess(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 1280);
+		unsigned int height = ArgOr(argc, argv, 3, 720);
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 4, 10));
+		unsigned int threads = ArgOr(argc, argv, 5, 0);
+
+		auto pool = std::make_shared<DX::ThreadPool>(threads);
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+		DX::SoftwareRasterizer& rasterizer = deviceResources->GetRasterizer();
+
+		std::printf("%ux%u, %u threads, %u frames, %ux%u floor patches\n", width, height, pool->GetThreadCount(), frames, FloorPatchGrid, FloorPatchGrid);
+
+		// The fixed factor, then the adaptive factors at a range of densities.
+		const float targets[] = { 0.0f, 1.0f / 64.0f, 1.0f / 32.0f, 1.0f / 16.0f, 1.0f / 8.0f, 1.0f / 4.0f };
+		for (float target : targets)
+		{
+			FloorTessellationSettings settings;
+			settings.adaptive = target > 0.0f;
+			if (settings.adaptive)
+			{
+				settings.trianglesPerPixel = target;
+			}
+			renderer.SetFloorTessellation(settings);
+
+			unsigned long long floorTriangles = 0;
+			double floorSeconds = 0.0;
+			double frameSeconds = 0.0;
+			rasterizer.ResetStats();
+			for (unsigned int frame = 0; frame < frames; frame++)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+				renderer.Update(frame / 60.0);
+				renderer.Render();
+				deviceResources->Present();
+				frameSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+				floorTriangles += renderer.GetPassStats(SoftwarePass::Floor).triangles;
+				floorSeconds += renderer.GetPassStats(SoftwarePass::Floor).seconds;
+			}
+
+			char label[32];
+			if (settings.adaptive)
+			{
+				std::snprintf(label, sizeof(label), "1/%.0f tri/px", 1.0f / target);
+			}
+			else
+			{
+				std::snprintf(label, sizeof(label), "fixed %.0f", FloorFixedTessFactor);
+			}
+
+			const DX::RasterStats& stats = rasterizer.GetStats();
+			std::printf("%-14s floor %8llu triangles %8.2f ms   raster %8.2f ms   frame %8.2f ms\n",
+				label, floorTriangles / frames, floorSeconds / frames * 1000.0,
+				(stats.setupSeconds + stats.rasterSeconds) / frames * 1000.0, frameSeconds / frames * 1000.0);
+
+			std::string path = settings.adaptive ? "floor-" + std::to_string(static_cast<int>(1.0f / target)) + ".ppm" : "floor-fixed.ppm";
+			if (!deviceResources->GetBackBuffer().SavePPM(path.c_str()))
+			{
+				std::fprintf(stderr, "could not write %s\n", path.c_str());
+				return 1;
+			}
+		}
+
+		return 0;
+	}
+
+	int RunParametricCache(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 1280);
+		unsigned int height = ArgOr(argc, argv, 3, 720);
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 4, 10));
+
+		auto pool = std::make_shared<DX::ThreadPool>(1);
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+
+		std::printf("%ux%u, %u frames\n", width, height, frames);
+
+		// Per tess factor: the tessellated draw, then the cache, warmed by one frame first the
+		// way the app builds a mesh on the first frame at a new factor.
+		const SoftwarePass passes[] = { SoftwarePass::Torus, SoftwarePass::Ellipsoid, SoftwarePass::Sphere };
+		const unsigned int factors[] = { 8, 16, ParametricDefaultTessFactor, 48, ParametricMaxTessFactor };
+		for (unsigned int factor : factors)
+		{
+			renderer.SetParametricTessFactor(factor);
+
+			double seconds[2] = {};
+			unsigned long long points[2] = {};
+			unsigned long long triangles[2] = {};
+			for (int cached = 0; cached < 2; cached++)
+			{
+				renderer.SetParametricCaching(cached != 0);
+				renderer.Render();
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					renderer.Update(frame / 60.0);
+					renderer.Render();
+					for (SoftwarePass pass : passes)
+					{
+						seconds[cached] += renderer.GetPassStats(pass).seconds;
+						points[cached] += renderer.GetPassStats(pass).domainPoints;
+						triangles[cached] += renderer.GetPassStats(pass).triangles;
+					}
+				}
+			}
+
+			if (factor == ParametricDefaultTessFactor)
+			{
+				deviceResources->Present();
+				if (!deviceResources->GetBackBuffer().SavePPM("parametric-cached.ppm"))
+				{
+					std::fprintf(stderr, "could not write parametric-cached.ppm\n");
+					return 1;
+				}
+			}
+
+			// On the GPU the cached draw runs ParametricCachedVS once per streamed-out vertex in
+			// place of every domain shader invocation.
+			unsigned long long cachedVertices = 3ull * ParametricShapeCount * ParametricTriangleCount(factor);
+			std::printf("factor %2u  tessellated %7llu DS/frame %8.3f ms   cached %5llu DS/frame %8.3f ms (%.1fx)   GPU %7llu DS -> %6llu VS, %7llu -> %6llu triangles\n",
+				factor, points[0] / frames, seconds[0] / frames * 1000.0, points[1] / frames, seconds[1] / frames * 1000.0,
+				seconds[0] / std::max(seconds[1], 1e-9), points[0] / frames, cachedVertices, triangles[0] / frames, triangles[1] / frames);
+		}
+
+		return 0;
+	}
+	// A view that puts every point at the centre of the screen, so nothing is culled, with
+	// every blade drawn.
+	GrassView GrassViewOfEverything()
+	{
+		GrassView everywhere;
+		everywhere.lod.enabled = false;
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				everywhere.modelViewProjection[r][c] = r == 3 && c == 3 ? 1.0f : 0.0f;
+			}
+		}
+		return everywhere;
+	}
+
+	// Row-vector look-at and right-handed perspective, as DirectXMath builds them, for a camera
+	// standing in a grass field.
+	GrassView MakeGrassView(const DX::float3& eye, float yaw, float aspectRatio, float maxDistance)
+	{
+		DX::float3 at = eye + DX::float3(std::sin(yaw), -0.3f, -std::cos(yaw));
+		DX::float3 r2 = normalize(eye - at);
+		DX::float3 r0 = normalize(cross(DX::float3(0.0f, 1.0f, 0.0f), r2));
+		DX::float3 r1 = cross(r2, r0);
+
+		DX::float4x4 view;
+		const DX::float3 axes[3] = { r0, r1, r2 };
+		for (int c = 0; c < 3; c++)
+		{
+			view.m[0][c] = axes[c].x;
+			view.m[1][c] = axes[c].y;
+			view.m[2][c] = axes[c].z;
+			view.m[3][c] = -dot(axes[c], eye);
+		}
+
+		const float nearZ = 0.01f, farZ = 1000.0f;
+		float height = 1.0f / std::tan(70.0f * 3.14159265f / 180.0f * 0.5f);
+		DX::float4x4 projection;
+		projection.m[0][0] = height / aspectRatio;
+		projection.m[1][1] = height;
+		projection.m[2][2] = farZ / (nearZ - farZ);
+		projection.m[2][3] = -1.0f;
+		projection.m[3][2] = nearZ * farZ / (nearZ - farZ);
+		projection.m[3][3] = 0.0f;
+
+		GrassView grassView;
+		DX::float4x4 viewProjection = mul(view, projection);
+		std::memcpy(grassView.modelViewProjection, viewProjection.m, sizeof(grassView.modelViewProjection));
+		grassView.maxDistance = maxDistance;
+		return grassView;
+	}
+
+	int RunGrassCull(int argc, char** argv)
+	{
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 2, 16));
+		unsigned int threads = ArgOr(argc, argv, 3, 0);
+		const float maxDistance = 30.0f;
+
+		DX::ThreadPool pool(threads);
+		std::printf("%u frames, %u threads, camera 1.5 above the field turning full circle, draw distance %.0f, no LOD\n", frames, pool.GetThreadCount(), maxDistance);
+
+		// The scene's density (200 blades over 1.9 x 1.9), on fields big enough to hold them.
+		for (unsigned int bladeCount : { 100000u, 1000000u, 10000000u })
+		{
+			GrassFieldSettings settings;
+			settings.bladeCount = bladeCount;
+			settings.extent = 0.95f * std::sqrt(bladeCount / 200.0f);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			GrassField field;
+			field.Generate(settings, pool);
+			double generateSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			GrassVisibleSet visible;
+			std::vector<float> upload(field.GetBladeCount() * 4);
+			double cullSeconds = 0.0, writeSeconds = 0.0, visibleBlades = 0.0, visibleChunks = 0.0;
+			unsigned int chunks = 0;
+			for (unsigned int frame = 0; frame < frames; frame++)
+			{
+				GrassView view = MakeGrassView(DX::float3(0.0f, 1.5f, 0.0f), 2.0f * 3.14159265f * frame / frames, 16.0f / 9.0f, maxDistance);
+				view.lod.enabled = false;
+				GrassCullStats stats = field.Cull(view, pool, visible);
+
+				start = std::chrono::high_resolution_clock::now();
+				field.Write(visible, upload.data(), pool);
+				writeSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+				cullSeconds += stats.seconds;
+				visibleBlades += static_cast<double>(stats.visibleBlades);
+				visibleChunks += stats.visibleChunks;
+				chunks = stats.chunks;
+			}
+
+			// Without culling every blade is uploaded every frame.
+			GrassVisibleSet all;
+			field.Cull(GrassViewOfEverything(), pool, all);
+			start = std::chrono::high_resolution_clock::now();
+			for (unsigned int frame = 0; frame < frames; frame++)
+			{
+				field.Write(all, upload.data(), pool);
+			}
+			double allSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			double frameSeconds = (cullSeconds + writeSeconds) / frames;
+			std::printf("%8u blades  %5u chunks  generate %7.1f ms   cull %6.3f ms  write %7.3f ms  %5.0f of %5u chunks, %9.0f blades visible  %7.1f Mblades/s   upload all %7.3f ms (%.1fx)\n",
+				bladeCount, field.GetChunkCount(), generateSeconds * 1000.0, cullSeconds / frames * 1000.0, writeSeconds / frames * 1000.0,
+				visibleChunks / frames, chunks, visibleBlades / frames, visibleBlades / frames / frameSeconds * 1e-6,
+				allSeconds / frames * 1000.0, allSeconds / frames / frameSeconds);
+		}
+
+		return 0;
+	}
+
+	// Per-frame grass cost with and without LOD as the field grows: first the cull and upload of
+	// fields of growing size at the scene's density, then the software scene with the app's
+	// densest field.
+	int RunGrassLod(int argc, char** argv)
+	{
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 2, 16));
+		unsigned int threads = ArgOr(argc, argv, 3, 0);
+		const float maxDistance = 30.0f;
+
+		auto pool = std::make_shared<DX::ThreadPool>(threads);
+		GrassLodSettings lod;
+		std::printf("%u frames, %u threads, camera 1.5 above the field turning full circle, draw distance %.0f\n", frames, pool->GetThreadCount(), maxDistance);
+		std::printf("LOD: blades to %.1f (at most %zu), clumps to %.1f (at most %zu), ground beyond\n", lod.clumpDistance, lod.bladeBudget, lod.groundDistance, lod.clumpBudget);
+
+		for (unsigned int bladeCount : { 100000u, 1000000u, 10000000u })
+		{
+			// Uniform placement: the costs only depend on how many blades each chunk holds.
+			GrassFieldSettings settings;
+			settings.bladeCount = bladeCount;
+			settings.extent = 0.95f * std::sqrt(bladeCount / 200.0f);
+			settings.distribution = GrassDistribution::Uniform;
+			GrassField field;
+			field.Generate(settings, *pool);
+
+			GrassVisibleSet visible;
+			std::vector<float> upload(field.GetBladeCount() * 4);
+			for (bool enabled : { false, true })
+			{
+				double cullSeconds = 0.0, writeSeconds = 0.0, blades = 0.0, clumps = 0.0, ground = 0.0;
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					GrassView view = MakeGrassView(DX::float3(0.0f, 1.5f, 0.0f), 2.0f * 3.14159265f * frame / frames, 16.0f / 9.0f, maxDistance);
+					view.lod.enabled = enabled;
+					GrassCullStats stats = field.Cull(view, *pool, visible);
+
+					auto start = std::chrono::high_resolution_clock::now();
+					field.Write(visible, upload.data(), *pool);
+					writeSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+					cullSeconds += stats.seconds;
+					blades += static_cast<double>(stats.visibleBlades);
+					clumps += static_cast<double>(stats.visibleClumps);
+					ground += stats.groundChunks;
+				}
+
+				std::printf("%8u blades  %-6s cull %6.3f ms  write %7.3f ms   %9.0f blades  %7.0f clumps  %6.0f ground chunks  %9.0f cards\n",
+					bladeCount, enabled ? "LOD" : "no LOD", cullSeconds / frames * 1000.0, writeSeconds / frames * 1000.0,
+					blades / frames, clumps / frames, ground / frames, (blades + clumps) / frames);
+			}
+		}
+
+		// The scene at the G key's densest field, one frame each way.
+		const unsigned int width = 1280, height = 720;
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+		GrassFieldSettings dense;
+		dense.bladeCount = 2000000;
+		renderer.SetGrassField(dense);
+		renderer.Update(0.0);
+
+		std::printf("scene, %u blades, %ux%u\n", dense.bladeCount, width, height);
+		for (bool enabled : { false, true })
+		{
+			GrassLodSettings sceneLod;
+			sceneLod.enabled = enabled;
+			renderer.SetGrassLod(sceneLod);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			renderer.Render();
+			deviceResources->Present();
+			double frameSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			const SoftwarePassStats& grass = renderer.GetPassStats(SoftwarePass::Grass);
+			std::printf("%-6s  grass %8llu triangles  %8.2f ms vertex work   frame %8.2f ms\n",
+				enabled ? "LOD" : "no LOD", grass.triangles, grass.seconds * 1000.0, frameSeconds * 1000.0);
+		}
+
+		const char* path = "grass-lod.ppm";
+		if (!deviceResources->GetBackBuffer().SavePPM(path))
+		{
+			std::fprintf(stderr, "could not write %s\n", path);
+			return 1;
+		}
+		std::printf("%s: with LOD\n", path);
+		return 0;
+	}
+
+	int RunGeometryExpansion(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 1280);
+		unsigned int height = ArgOr(argc, argv, 3, 720);
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 4, 10));
+
+		// Every blade drawn, so the grass is bound by its vertices rather than the LOD budgets.
+		auto pool = std::make_shared<DX::ThreadPool>(1);
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+		GrassFieldSettings dense;
+		dense.bladeCount = 200000;
+		renderer.SetGrassField(dense);
+		GrassLodSettings noLod;
+		noLod.enabled = false;
+		renderer.SetGrassLod(noLod);
+
+		std::printf("%ux%u, %u frames, %u blades without LOD\n", width, height, frames, dense.bladeCount);
+		SnakeTubeSettings noTubes;
+		noTubes.enabled = false;
+
+		// Both paths emit GrassCardVertices per card (two triangles) and SnakeSegmentVertices
+		// per segment (a strip of SnakeSegmentVertices - 2 triangles).
+		const GeometryExpansion paths[] = { GeometryExpansion::GeometryShader, GeometryExpansion::Instanced };
+		std::vector<DX::float4> images[2];
+		for (int path = 0; path < 2; path++)
+		{
+			renderer.SetGeometryExpansion(paths[path]);
+			renderer.SetSnakeSwarm(SnakeSwarmSettings());
+			renderer.SetSnakeTube(noTubes);
+			renderer.Update(0.0);
+			renderer.Render();
+
+			double grassSeconds = 0.0, snakeSeconds = 0.0;
+			unsigned long long grassVertices = 0, snakeVertices = 0;
+			for (unsigned int frame = 0; frame < frames; frame++)
+			{
+				renderer.Update(frame / 60.0);
+				renderer.Render();
+				const SoftwarePassStats& grass = renderer.GetPassStats(SoftwarePass::Grass);
+				const SoftwarePassStats& snake = renderer.GetPassStats(SoftwarePass::Snake);
+				grassSeconds += grass.seconds;
+				snakeSeconds += snake.seconds;
+				grassVertices += grass.triangles / 2 * GrassCardVertices;
+				snakeVertices += snake.triangles / (SnakeSegmentVertices - 2) * SnakeSegmentVertices;
+			}
+
+			deviceResources->Present();
+			const DX::ImageBuffer& image = deviceResources->GetBackBuffer();
+			images[path].assign(image.GetData(), image.GetData() + static_cast<size_t>(width) * height);
+
+			std::printf("%-15s  grass %9llu vertices/frame %8.3f ms %7.1f Mverts/s   snake %4llu vertices/frame %7.3f ms %6.1f Mverts/s\n",
+				path == 0 ? "geometry shader" : "instanced",
+				grassVertices / frames, grassSeconds / frames * 1000.0, grassVertices / std::max(grassSeconds, 1e-9) / 1e6,
+				snakeVertices / frames, snakeSeconds / frames * 1000.0, snakeVertices / std::max(snakeSeconds, 1e-9) / 1e6);
+		}
+
+		bool identical = std::memcmp(images[0].data(), images[1].data(), images[0].size() * sizeof(DX::float4)) == 0;
+		std::printf("last frame %s\n", identical ? "identical" : "DIFFERS");
+
+		const char* path = "geometry-expansion.ppm";
+		if (!deviceResources->GetBackBuffer().SavePPM(path))
+		{
+			std::fprintf(stderr, "could not write %s\n", path);
+			return 1;
+		}
+		std::printf("%s: instanced\n", path);
+		return identical ? 0 : 1;
+	}
+
+	int RunSnakeSwarm(int argc, char** argv)
+	{
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 2, 60));
+		unsigned int threads = ArgOr(argc, argv, 3, 0);
+
+		auto pool = std::make_shared<DX::ThreadPool>(threads);
+		std::printf("%u frames at 60 Hz, %u threads, %u points per snake\n", frames, pool->GetThreadCount(), SnakeSwarmSettings().pointsPerSnake);
+
+		for (SnakeSkeleton skeleton : { SnakeSkeleton::FollowTheLeader, SnakeSkeleton::Spline })
+		{
+			for (unsigned int snakeCount : { 1000u, 10000u, 100000u })
+			{
+				// The scene's snakes, given the same room each.
+				SnakeSwarmSettings settings;
+				settings.snakeCount = snakeCount;
+				settings.extent = std::sqrt(snakeCount / 2.0f);
+				settings.skeleton = skeleton;
+				SnakeSwarm swarm;
+				swarm.Generate(settings);
+				std::vector<float> upload(swarm.GetSegmentCount() * 2 * SnakeVertexFloats);
+
+				double updateSeconds = 0.0, writeSeconds = 0.0;
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					auto start = std::chrono::high_resolution_clock::now();
+					swarm.Update(1.0f / 60.0f, *pool);
+					auto updated = std::chrono::high_resolution_clock::now();
+					swarm.Write(upload.data(), *pool);
+					updateSeconds += std::chrono::duration<double>(updated - start).count();
+					writeSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - updated).count();
+				}
+
+				double perThousand = 1000.0 / snakeCount / frames * 1e6;
+				std::printf("%-17s %6u snakes  update %7.3f ms  write %7.3f ms   per 1,000 snakes: update %6.1f us  write %6.1f us   %5.1f MB/frame\n",
+					skeleton == SnakeSkeleton::Spline ? "spline" : "follow-the-leader", snakeCount,
+					updateSeconds / frames * 1000.0, writeSeconds / frames * 1000.0, updateSeconds * perThousand, writeSeconds * perThousand,
+					upload.size() * sizeof(float) / 1e6);
+			}
+		}
+
+		// The scene after pressing N three times: 2,000 smaller snakes, drawn in one pass.
+		const unsigned int width = 1280, height = 720;
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+		SnakeSwarmSettings scene, crowd;
+		crowd.snakeCount = 2000;
+		float size = std::sqrt(static_cast<float>(scene.snakeCount) / crowd.snakeCount);
+		crowd.segmentLength = scene.segmentLength * size;
+		crowd.radius = scene.radius * size;
+		crowd.speed = scene.speed * size;
+		renderer.SetSnakeSwarm(crowd);
+		for (unsigned int frame = 0; frame <= 120; frame++)
+		{
+			renderer.Update(frame / 60.0);
+		}
+		renderer.Render();
+		deviceResources->Present();
+
+		const SoftwarePassStats& snakes = renderer.GetPassStats(SoftwarePass::Snake);
+		std::printf("scene, %u snakes after 2 s: %llu triangles, %.2f ms vertex work\n", crowd.snakeCount, snakes.triangles, snakes.seconds * 1000.0);
+
+		const char* path = "snake-swarm.ppm";
+		if (!deviceResources->GetBackBuffer().SavePPM(path))
+		{
+			std::fprintf(stderr, "could not write %s\n", path);
+			return 1;
+		}
+		std::printf("%s\n", path);
+		return 0;
+	}
+
+	int RunSnakeTube(int argc, char** argv)
+	{
+		unsigned int width = ArgOr(argc, argv, 2, 1280);
+		unsigned int height = ArgOr(argc, argv, 3, 720);
+		unsigned int frames = std::max(1u, ArgOr(argc, argv, 4, 10));
+
+		// Mesh size and extrusion cost per ring resolution, every snake at full detail.
+		auto pool = std::make_shared<DX::ThreadPool>(1);
+		SnakeSwarmSettings settings;
+		settings.snakeCount = 10000;
+		settings.extent = std::sqrt(settings.snakeCount / 2.0f);
+		settings.skeleton = SnakeSkeleton::Spline;
+		SnakeSwarm swarm;
+		swarm.Generate(settings);
+		swarm.Update(1.0f, *pool);
+
+		size_t segments = swarm.GetSegmentCount();
+		std::printf("%zu snakes, %zu segments; SnakeGS.hlsl emits %u vertices per segment\n", swarm.GetSnakeCount(), segments, SnakeSegmentVertices);
+		const float identity[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+		for (unsigned int ringVertices : { 5u, 10u, 16u })
+		{
+			SnakeTubeSettings tubeSettings;
+			tubeSettings.ringVertices = ringVertices;
+			tubeSettings.lodLevels = 1;
+			SnakeTube tube;
+			std::vector<float> vertices(SnakeTube::GetMaxVertexCount(swarm, tubeSettings) * 3);
+			std::vector<uint32_t> indices(SnakeTube::GetMaxIndexCount(swarm, tubeSettings));
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (unsigned int frame = 0; frame < frames; frame++)
+			{
+				tube.Build(swarm, tubeSettings, identity, *pool);
+				tube.Write(swarm, vertices.data(), indices.data(), *pool);
+			}
+			double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / frames;
+
+			std::printf("ring %2u  %5.2f vertices/segment  %5.2f indices/segment   extrude %7.3f ms (%5.1f us per 1,000 snakes)\n",
+				ringVertices, static_cast<double>(tube.GetVertexCount()) / segments, static_cast<double>(tube.GetIndexCount()) / segments,
+				seconds * 1000.0, seconds * 1e6 * 1000.0 / swarm.GetSnakeCount());
+		}
+
+		// Ring resolution per LOD level, for a snake held at known view depths: a projection
+		// whose clip w is the depth alone.
+		SnakeSwarm single;
+		single.Generate(SnakeSwarmSettings());
+		SnakeTubeSettings lodSettings;
+		unsigned int failures = 0;
+		for (float depth : { 1.0f, 2.0f, 3.0f, 6.0f, 100.0f })
+		{
+			const float projection[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, depth } };
+			SnakeTube tube;
+			tube.Build(single, lodSettings, projection, *pool);
+			unsigned int level = std::min(lodSettings.lodLevels - 1, static_cast<unsigned int>(depth / lodSettings.lodDistance));
+			unsigned int expected = std::max(3u, lodSettings.ringVertices >> level);
+			size_t ring = tube.GetVertexCount() / (single.GetSnakeCount() * single.GetPointCount());
+			std::printf("%sdepth %5.1f  level %u  ring %zu\n", ring == expected ? "" : "FAIL ", depth, level, ring);
+			failures += ring != expected;
+		}
+
+		// The scene's snakes, and the N key's 2,000, through each path of the software renderer.
+		// The 2,000 are spread over a wider field than the N key's, so the far ones reach LOD
+		// levels 1 and 2; the scene's are all within lodDistance and stay at level 0.
+		auto deviceResources = std::make_shared<DX::SoftwareDeviceResources>(width, height, pool);
+		SoftwareSceneRenderer renderer(deviceResources);
+		SnakeSwarmSettings scene, crowd;
+		crowd.snakeCount = 2000;
+		float size = std::sqrt(static_cast<float>(scene.snakeCount) / crowd.snakeCount);
+		crowd.segmentLength = scene.segmentLength * size;
+		crowd.radius = scene.radius * size;
+		crowd.speed = scene.speed * size;
+		crowd.extent = 10.0f;
+
+		SnakeTubeSettings geometryShader, tubes, tubesLod;
+		geometryShader.enabled = false;
+		tubes.lodLevels = 1;
+		std::printf("%ux%u, %u frames\n", width, height, frames);
+		for (const SnakeSwarmSettings* swarmSettings : { &scene, &crowd })
+		{
+			for (const SnakeTubeSettings* tubeSettings : { &geometryShader, &tubes, &tubesLod })
+			{
+				renderer.SetSnakeSwarm(*swarmSettings);
+				renderer.SetSnakeTube(*tubeSettings);
+				renderer.Update(0.0);
+
+				double seconds = 0.0;
+				unsigned long long triangles = 0;
+				for (unsigned int frame = 0; frame < frames; frame++)
+				{
+					renderer.Update(frame / 60.0);
+					renderer.Render();
+					seconds += renderer.GetPassStats(SoftwarePass::Snake).seconds;
+					triangles += renderer.GetPassStats(SoftwarePass::Snake).triangles;
+				}
+				std::printf("%5u snakes  %-15s %8llu triangles/frame  %8.3f ms\n", swarmSettings->snakeCount,
+					!tubeSettings->enabled ? "SnakeGS rings" : tubeSettings->lodLevels > 1 ? "tubes, LOD" : "tubes", triangles / frames, seconds / frames * 1000.0);
+
+				if (swarmSettings == &scene && tubeSettings == &tubesLod)
+				{
+					deviceResources->Present();
+					if (!deviceResources->GetBackBuffer().SavePPM("snake-tube.ppm"))
+					{
+						std::fprintf(stderr, "could not write snake-tube.ppm\n");
+						return 1;
+					}
+				}
+			}
+		}
+		std::printf("snake-tube.ppm: the scene's snakes as tubes\n");
+		return failures == 0 ? 0 : 1;
+	}
+
+	bool ReadFileBytes(const char* path, std::vector<uint8_t>& bytes)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return false;
+		}
+		bytes.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), bytes.size()));
+	}
+
+	int RunDds(int argc, char** argv)
+	{
+		if (argc < 3)
+		{
+			std::fprintf(stderr, "usage: headless dds file.dds...\n");
+			return 1;
+		}
+
+		int failures = 0;
+		for (int arg = 2; arg < argc; arg++)
+		{
+			const char* path = argv[arg];
+			std::vector<uint8_t> bytes;
+			if (!ReadFileBytes(path, bytes))
+			{
+				std::printf("%s: could not read\n", path);
+				failures++;
+				continue;
+			}
+
+			// Parse and lay out the file repeatedly for a stable time.
+			const int repeats = 1000;
+			DX::DDSFile file;
+			std::vector<DX::DDSSubresource> subresources;
+			size_t skipMip = 0;
+			DX::DDSStatus status = DX::DDSStatus::Ok;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int repeat = 0; repeat < repeats && status == DX::DDSStatus::Ok; repeat++)
+			{
+				status = DX::ParseDDS(bytes.data(), bytes.size(), file);
+				if (status == DX::DDSStatus::Ok)
+				{
+					status = DX::GetDDSSubresources(file, 0, subresources, skipMip);
+				}
+			}
+			double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+			if (status != DX::DDSStatus::Ok)
+			{
+				std::printf("%s: %s\n", path, DX::GetDDSStatusName(status));
+				failures++;
+				continue;
+			}
+
+			const DX::DDSTextureDesc& desc = file.desc;
+			size_t used = 0;
+			for (const DX::DDSSubresource& subresource : subresources)
+			{
+				used += subresource.slicePitch * subresource.depth;
+			}
+			std::printf("%s: %s%s %zux%zux%zu, %zu mips, %zu array items%s, %zu subresources, %zu of %zu data bytes, %.2f us\n",
+				path, DX::GetDXGIFormatName(desc.format), file.headerDX10 ? " (DX10)" : "", desc.width, desc.height, desc.depth,
+				desc.mipCount, desc.arraySize, desc.isCubeMap ? " (cube)" : "", subresources.size(), used, file.bitSize, seconds * 1e6);
+			for (size_t i = 0; i < subresources.size() && i < desc.mipCount; i++)
+			{
+				const DX::DDSSubresource& subresource = subresources[i];
+				std::printf("  mip %2zu  %5zux%-5zu  pitch %7zu  rows %5zu  offset %9zu\n", i, subresource.width, subresource.height,
+					subresource.rowPitch, subresource.rowCount, static_cast<size_t>(subresource.data - file.bitData));
+			}
+
+			// A copy cut short by a byte must be refused rather than read past its end.
+			if (used == file.bitSize)
+			{
+				DX::DDSFile truncated;
+				status = DX::ParseDDS(bytes.data(), bytes.size() - 1, truncated);
+				if (status == DX::DDSStatus::Ok)
+				{
+					status = DX::GetDDSSubresources(truncated, 0, subresources, skipMip);
+				}
+				if (status != DX::DDSStatus::EndOfFile)
+				{
+					std::printf("  truncated copy: %s, expected %s\n", DX::GetDDSStatusName(status), DX::GetDDSStatusName(DX::DDSStatus::EndOfFile));
+					failures++;
+				}
+			}
+		}
+
+		std::printf("%d of %d files failed\n", failures, argc - 2);
+		return failures == 0 ? 0 : 1;
+	}
+
+	// Peak resident set so far, in KB.
+	long PeakRssKB()
+	{
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+	}
+
+	// Loads each file the way CreateDDSTextureFromFile does, into a stand-in for the
+	// texture: parse, lay out, then copy every subresource as CreateTexture2D's initial data
+	// would be. Returns false when a file fails to load.
+	bool LoadDdsFiles(const std::vector<const char*>& paths, bool mapped, size_t& bytesUploaded)
+	{
+		for (const char* path : paths)
+		{
+			DX::MappedFile mapping;
+			std::unique_ptr<uint8_t[]> copy;
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			if (mapped)
+			{
+				if (!mapping.Open(path))
+				{
+					return false;
+				}
+				mapping.Prefetch();
+				data = mapping.GetData();
+				size = mapping.GetSize();
+			}
+			else
+			{
+				// The old LoadTextureDataFromFile: allocate the whole file and read it in.
+				FILE* file = std::fopen(path, "rb");
+				if (!file)
+				{
+					return false;
+				}
+				std::fseek(file, 0, SEEK_END);
+				size = static_cast<size_t>(std::ftell(file));
+				std::fseek(file, 0, SEEK_SET);
+				copy.reset(new uint8_t[size]);
+				size_t read = std::fread(copy.get(), 1, size, file);
+				std::fclose(file);
+				if (read != size)
+				{
+					return false;
+				}
+				data = copy.get();
+			}
+
+			DX::DDSFile file;
+			std::vector<DX::DDSSubresource> subresources;
+			size_t skipMip = 0;
+			if (DX::ParseDDS(data, size, file) != DX::DDSStatus::Ok ||
+				DX::GetDDSSubresources(file, 0, subresources, skipMip) != DX::DDSStatus::Ok)
+			{
+				return false;
+			}
+
+			size_t textureBytes = 0;
+			for (const DX::DDSSubresource& subresource : subresources)
+			{
+				textureBytes += subresource.slicePitch * subresource.depth;
+			}
+			std::unique_ptr<uint8_t[]> texture(new uint8_t[textureBytes]);
+			uint8_t* out = texture.get();
+			for (const DX::DDSSubresource& subresource : subresources)
+			{
+				std::memcpy(out, subresource.data, subresource.slicePitch * subresource.depth);
+				out += subresource.slicePitch * subresource.depth;
+			}
+			bytesUploaded += textureBytes;
+		}
+		return true;
+	}
+
+	int RunDdsLoad(int argc, char** argv)
+	{
+		unsigned int repeats = std::max(1u, ArgOr(argc, argv, 2, 20));
+		std::vector<const char*> paths(argv + std::min(argc, 3), argv + argc);
+		if (paths.empty())
+		{
+			std::fprintf(stderr, "usage: headless dds-load [repeats] file.dds...\n");
+			return 1;
+		}
+
+		// Both paths read from the page cache, not the disk.
+		size_t warmBytes = 0;
+		if (!LoadDdsFiles(paths, false, warmBytes))
+		{
+			std::fprintf(stderr, "could not load every file\n");
+			return 1;
+		}
+		std::printf("%zu files, %.2f MB of texture data, %u repeats\n", paths.size(), warmBytes / 1048576.0, repeats);
+
+		// Each path runs in its own process so its peak RSS is its own.
+		for (bool mapped : { false, true })
+		{
+			std::fflush(stdout);
+			pid_t child = fork();
+			if (child == 0)
+			{
+				long baseRss = PeakRssKB();
+				size_t bytesUploaded = 0;
+				auto start = std::chrono::high_resolution_clock::now();
+				for (unsigned int repeat = 0; repeat < repeats; repeat++)
+				{
+					LoadDdsFiles(paths, mapped, bytesUploaded);
+				}
+				double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+				std::printf("%-28s %8.3f ms per load of every file  %7.2f GB/s  peak RSS +%6.2f MB\n",
+					mapped ? "mmap + madvise (MappedFile)" : "read into a copy", seconds * 1000.0,
+					bytesUploaded / repeats / seconds / 1e9, (PeakRssKB() - baseRss) / 1024.0);
+				std::fflush(stdout);
+				_exit(0);
+			}
+			int status = 0;
+			waitpid(child, &status, 0);
+		}
+		return 0;
+	}
+
+	// A DX10 DDS file of random blocks of fmt, with a full mip chain.
+	std::vector<uint8_t> MakeRandomBlockDds(DXGI_FORMAT fmt, uint32_t width, uint32_t height, std::mt19937& rng)
+	{
+		uint32_t mips = 1;
+		while ((width >> mips) || (height >> mips))
+		{
+			mips++;
+		}
+
+		DDS_HEADER header = {};
+		header.size = sizeof(DDS_HEADER);
+		header.flags = 0x1 | DDS_HEIGHT | DDS_WIDTH | 0x1000 | 0x20000;	// caps, pixel format, mip count
+		header.height = height;
+		header.width = width;
+		header.mipMapCount = mips;
+		header.ddspf.size = sizeof(DDS_PIXELFORMAT);
+		header.ddspf.flags = DDS_FOURCC;
+		header.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+		header.caps = 0x401008;		// texture, complex, mipmap
+		DDS_HEADER_DXT10 header10 = {};
+		header10.dxgiFormat = fmt;
+		header10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+		header10.arraySize = 1;
+
+		size_t dataBytes = 0;
+		for (uint32_t mip = 0; mip < mips; mip++)
+		{
+			size_t bytes = 0;
+			DX::GetSurfaceInfo(std::max(1u, width >> mip), std::max(1u, height >> mip), fmt, &bytes, nullptr, nullptr);
+			dataBytes += bytes;
+		}
+
+		std::vector<uint8_t> dds(sizeof(uint32_t) + sizeof(header) + sizeof(header10) + dataBytes);
+		uint32_t magic = DDS_MAGIC;
+		std::memcpy(dds.data(), &magic, sizeof(magic));
+		std::memcpy(dds.data() + sizeof(magic), &header, sizeof(header));
+		std::memcpy(dds.data() + sizeof(magic) + sizeof(header), &header10, sizeof(header10));
+		for (size_t i = sizeof(magic) + sizeof(header) + sizeof(header10); i < dds.size(); i++)
+		{
+			dds[i] = static_cast<uint8_t>(rng());
+		}
+		return dds;
+	}
+
+	// Times DecodeDDS of file at each SIMD level and both outputs, checking each level
+	// against the scalar reference. Returns false if any level differs.
+	bool TimeBlockDecode(const char* name, const DX::DDSFile& file, DX::ThreadPool& pool, std::vector<DX::DecodedImage>& topImages)
+	{
+		const DX::DecodedFormat outputs[] = { DX::DecodedFormat::RGBA8, DX::DecodedFormat::RGBA16F };
+		bool identical = true;
+		for (DX::DecodedFormat output : outputs)
+		{
+			std::vector<DX::DecodedImage> reference;
+			std::printf("%-16s %-7s", name, output == DX::DecodedFormat::RGBA8 ? "RGBA8" : "RGBA16F");
+			double scalarSeconds = 0.0;
+			for (DX::SimdLevel level : { DX::SimdLevel::Scalar, DX::SimdLevel::SSE41, DX::SimdLevel::AVX2 })
+			{
+				if (!DX::IsSimdLevelSupported(level))
+				{
+					continue;
+				}
+
+				std::vector<DX::DecodedImage> images;
+				double best = 1e30;
+				size_t texels = 0;
+				for (int run = 0; run < 3; run++)
+				{
+					auto start = std::chrono::high_resolution_clock::now();
+					DX::DecodeDDS(file, output, images, pool, level);
+					best = std::min(best, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+				}
+				for (const DX::DecodedImage& image : images)
+				{
+					texels += image.width * image.height * image.depth;
+				}
+
+				const char* match = "";
+				if (level == DX::SimdLevel::Scalar)
+				{
+					scalarSeconds = best;
+					reference = std::move(images);
+				}
+				else
+				{
+					bool same = images.size() == reference.size();
+					for (size_t i = 0; same && i < images.size(); i++)
+					{
+						same = images[i].texels == reference[i].texels;
+					}
+					identical = identical && same;
+					match = same ? "" : " DIFFERS";
+				}
+				std::printf("  %s %8.1f MP/s %5.2fx%s", DX::SimdLevelName(level), texels / best * 1e-6, scalarSeconds / best, match);
+			}
+			std::printf("\n");
+
+			if (output == DX::DecodedFormat::RGBA8 && !reference.empty())
+			{
+				topImages.push_back(std::move(reference[0]));
+			}
+		}
+		return identical;
+	}
+
+	int RunBlockDecode(int argc, char** argv)
+	{
+		DX::ThreadPool pool(ArgOr(argc, argv, 2, 0));
+		bool synthetic = argc <= 3 || std::atoi(argv[3]) > 0;
+		std::printf("cpu supports %s, %u threads\n", DX::SimdLevelName(DX::GetSupportedSimdLevel()), pool.GetThreadCount());
+
+		bool identical = true;
+		if (synthetic)
+		{
+			// Random blocks at the given size, and at an odd size whose edge blocks are cut
+			// short, in every decodable format.
+			uint32_t size = std::max(4u, ArgOr(argc, argv, 3, 2048));
+			const DXGI_FORMAT formats[] =
+			{
+				DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC2_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC4_UNORM, DXGI_FORMAT_BC4_SNORM,
+				DXGI_FORMAT_BC5_UNORM, DXGI_FORMAT_BC5_SNORM, DXGI_FORMAT_BC6H_UF16, DXGI_FORMAT_BC6H_SF16, DXGI_FORMAT_BC7_UNORM
+			};
+			std::mt19937 rng(1);
+			std::printf("%ux%u random blocks with full mip chains; rates count every mip's texels\n", size, size);
+			for (uint32_t side : { size, size - 3 })
+			{
+				if (side != size)
+				{
+					std::printf("%ux%u\n", side, side - 2);
+				}
+				for (DXGI_FORMAT fmt : formats)
+				{
+					std::vector<uint8_t> bytes = MakeRandomBlockDds(fmt, side, side == size ? side : side - 2, rng);
+					DX::DDSFile file;
+					DX::ParseDDS(bytes.data(), bytes.size(), file);
+					std::vector<DX::DecodedImage> topImages;
+					identical = TimeBlockDecode(DX::GetDXGIFormatName(fmt), file, pool, topImages) && identical;
+				}
+			}
+		}
+		else
+		{
+			// Shipped textures, with each top mip written out for a look.
+			for (int arg = 3; arg < argc; arg++)
+			{
+				const char* path = argv[arg];
+				DX::MappedFile mapping;
+				DX::DDSFile file;
+				if (!mapping.Open(path) || DX::ParseDDS(mapping.GetData(), mapping.GetSize(), file) != DX::DDSStatus::Ok)
+				{
+					std::printf("%s: could not load\n", path);
+					identical = false;
+					continue;
+				}
+				if (!DX::IsBlockDecodable(file.desc.format))
+				{
+					std::printf("%s: %s is not block compressed\n", path, DX::GetDXGIFormatName(file.desc.format));
+					continue;
+				}
+
+				std::string name = path;
+				name = name.substr(name.find_last_of('/') + 1);
+				name = name.substr(0, name.find_last_of('.'));
+				std::printf("%s: %s %zux%zu, %zu mips\n", path, DX::GetDXGIFormatName(file.desc.format), file.desc.width, file.desc.height, file.desc.mipCount);
+				std::vector<DX::DecodedImage> topImages;
+				identical = TimeBlockDecode(name.c_str(), file, pool, topImages) && identical;
+
+				const DX::DecodedImage& top = topImages[0];
+				DX::ImageBuffer image(static_cast<unsigned int>(top.width), static_cast<unsigned int>(top.height));
+				for (size_t y = 0; y < top.height; y++)
+				{
+					for (size_t x = 0; x < top.width; x++)
+					{
+						const uint8_t* texel = &top.texels[(y * top.width + x) * 4];
+						image.At(static_cast<unsigned int>(x), static_cast<unsigned int>(y)) = DX::float4(texel[0] / 255.0f, texel[1] / 255.0f, texel[2] / 255.0f, texel[3] / 255.0f);
+					}
+				}
+				image.SavePPM("bc-decode-" + name + ".ppm");
+			}
+		}
+
+		std::printf("%s\n", identical ? "every level matches scalar" : "SOME LEVELS DIFFER FROM SCALAR");
+		return identical ? 0 : 1;
+	}
+
+	// Every blade of a field, as x, y, z triples.
+	std::vector<float> GrassBlades(const GrassField& field, DX::ThreadPool& pool)
+	{
+		GrassVisibleSet all;
+		field.Cull(GrassViewOfEverything(), pool, all);
+		std::vector<float> cards(all.bladeCount * 4);
+		field.Write(all, cards.data(), pool);
+
+		std::vector<float> blades(all.bladeCount * 3);
+		for (size_t i = 0; i < all.bladeCount; i++)
+		{
+			std::copy(&cards[i * 4], &cards[i * 4] + 3, &blades[i * 3]);
+		}
+		return blades;
+	}
+
+	// Nearest blade distances over a field: between blades, and from a grid of probe points to
+	// the closest blade (the gaps), both in units of the mean spacing sqrt(area / blades).
+	struct GrassSpacing
+	{
+		float	minimum = 0.0f;		// closest pair
+		float	gap99 = 0.0f;		// 99th percentile probe distance
+		float	gapMax = 0.0f;
+	};
+
+	GrassSpacing MeasureGrassSpacing(const std::vector<float>& blades, float extent)
+	{
+		size_t count = blades.size() / 3;
+		float spacing = std::sqrt(4.0f * extent * extent / std::max<size_t>(1, count));
+		int cells = std::max(1, static_cast<int>(2.0f * extent / spacing));
+		float cellSize = 2.0f * extent / cells;
+		auto cellOf = [&](float p) { return std::min(cells - 1, std::max(0, static_cast<int>((p + extent) / cellSize))); };
+
+		std::vector<std::vector<unsigned int>> grid(static_cast<size_t>(cells) * cells);
+		for (size_t i = 0; i < count; i++)
+		{
+			grid[static_cast<size_t>(cellOf(blades[i * 3 + 2])) * cells + cellOf(blades[i * 3])].push_back(static_cast<unsigned int>(i));
+		}
+
+		// Searches rings of cells until the nearest blade found is closer than the next ring.
+		auto nearest = [&](float x, float z, size_t skip)
+		{
+			int cx = cellOf(x), cz = cellOf(z);
+			float best = 1e30f;
+			for (int ring = 0; ring < cells; ring++)
+			{
+				for (int j = cz - ring; j <= cz + ring; j++)
+				{
+					for (int i = cx - ring; i <= cx + ring; i++)
+					{
+						if (i < 0 || j < 0 || i >= cells || j >= cells || (std::abs(i - cx) != ring && std::abs(j - cz) != ring))
+						{
+							continue;
+						}
+						for (unsigned int b : grid[static_cast<size_t>(j) * cells + i])
+						{
+							float dx = blades[b * 3] - x, dz = blades[b * 3 + 2] - z;
+							if (b != skip)
+							{
+								best = std::min(best, dx * dx + dz * dz);
+							}
+						}
+					}
+				}
+				if (best < (ring * cellSize) * (ring * cellSize))
+				{
+					break;
+				}
+			}
+			return std::sqrt(best);
+		};
+
+		GrassSpacing result;
+		result.minimum = 1e30f;
+		for (size_t i = 0; i < count; i += std::max<size_t>(1, count / 100000))
+		{
+			result.minimum = std::min(result.minimum, nearest(blades[i * 3], blades[i * 3 + 2], i) / spacing);
+		}
+
+		const int probes = 256;
+		std::vector<float> gaps;
+		for (int j = 0; j < probes; j++)
+		{
+			for (int i = 0; i < probes; i++)
+			{
+				float x = -extent + 2.0f * extent * (i + 0.5f) / probes;
+				float z = -extent + 2.0f * extent * (j + 0.5f) / probes;
+				gaps.push_back(nearest(x, z, count) / spacing);
+			}
+		}
+		std::sort(gaps.begin(), gaps.end());
+		result.gap99 = gaps[gaps.size() * 99 / 100];
+		result.gapMax = gaps.back();
+		return result;
+	}
+
+	int RunGrassScatter(int argc, char** argv)
+	{
+		unsigned int threads = ArgOr(argc, argv, 2, 0);
+		DX::ThreadPool pool(threads);
+		DX::ThreadPool single(1);
+		std::printf("%u threads\n", pool.GetThreadCount());
+
+		const GrassDistribution distributions[] = { GrassDistribution::Uniform, GrassDistribution::PoissonDisc };
+		const char* names[] = { "uniform", "poisson" };
+		for (unsigned int bladeCount : { 100000u, 1000000u, 10000000u })
+		{
+			GrassFieldSettings settings;
+			settings.bladeCount = bladeCount;
+			settings.extent = 0.95f * std::sqrt(bladeCount / 200.0f);
+
+			for (int d = 0; d < 2; d++)
+			{
+				settings.distribution = distributions[d];
+				GrassField field;
+				auto start = std::chrono::high_resolution_clock::now();
+				field.Generate(settings, pool);
+				double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+				std::vector<float> blades = GrassBlades(field, pool);
+
+				// The same seed on one thread has to give the same field.
+				GrassField again;
+				again.Generate(settings, single);
+				bool deterministic = GrassBlades(again, single) == blades;
+
+				GrassSpacing spacing = MeasureGrassSpacing(blades, settings.extent);
+				std::printf("%8u blades  %-8s %9zu placed  %8.1f ms  %6.2f Mblades/s  closest %.2f  gap p99 %.2f max %.2f  %s\n",
+					bladeCount, names[d], field.GetBladeCount(), seconds * 1000.0, field.GetBladeCount() / seconds * 1e-6,
+					spacing.minimum, spacing.gap99, spacing.gapMax, deterministic ? "deterministic" : "DIFFERS ON ONE THREAD");
+			}
+		}
+
+		// A masked field: dense in the middle, thinning to nothing at the corners.
+		GrassFieldSettings masked;
+		masked.bladeCount = 20000;
+		masked.density.width = 64;
+		masked.density.height = 64;
+		for (unsigned int y = 0; y < 64; y++)
+		{
+			for (unsigned int x = 0; x < 64; x++)
+			{
+				float u = x / 63.0f - 0.5f, v = y / 63.0f - 0.5f;
+				masked.density.values.push_back(std::max(0.0f, 1.0f - 1.5f * std::sqrt(u * u + v * v)));
+			}
+		}
+
+		const unsigned int size = 512;
+		DX::ImageBuffer image(size, size);
+		image.Clear(DX::float4(1.0f, 1.0f, 1.0f, 1.0f));
+		for (int d = 0; d < 2; d++)
+		{
+			masked.distribution = distributions[d];
+			GrassField field;
+			field.Generate(masked, pool);
+			std::vector<float> blades = GrassBlades(field, pool);
+			for (size_t i = 0; i < blades.size(); i += 3)
+			{
+				unsigned int x = std::min(size / 2 - 1, static_cast<unsigned int>((blades[i] / masked.extent * 0.5f + 0.5f) * (size / 2)));
+				unsigned int y = std::min(size - 1, static_cast<unsigned int>((blades[i + 2] / masked.extent * 0.5f + 0.5f) * size));
+				image.At(x + d * (size / 2), y) = DX::float4(0.1f, 0.4f, 0.1f, 1.0f);
+			}
+			std::printf("masked %-8s %zu of %u blades\n", names[d], field.GetBladeCount(), masked.bladeCount);
+		}
+
+		const char* path = "grass-scatter.ppm";
+		if (!image.SavePPM(path))
+		{
+			std::fprintf(stderr, "could not write %s\n", path);
+			return 1;
+		}
+		std::printf("%s: uniform left, Poisson-disc right, both masked\n", path);
+		return 0;
+	}
+
+	// ParametricDS.hlsl with the library sin and cos, in double precision for the reference or
+	// in float as the domain shader runs it, from the same float constants.
+	template <typename T>
+	void ShapeSurface(const ParametricShape& shape, T s, T t, T p[3])
+	{
+		T phi = static_cast<T>(shape.sweep[0]) * s;
+		T theta = static_cast<T>(shape.sweep[1]) * t;
+		if (shape.surface == ParametricSurface::Torus)
+		{
+			T c = shape.size[0], a = shape.size[1];
+			T ring = c + a * std::cos(theta);
+			p[0] = ring * std::cos(phi);
+			p[1] = a * std::sin(theta);
+			p[2] = ring * -std::sin(phi);
+		}
+		else if (shape.surface == ParametricSurface::Ellipsoid)
+		{
+			T a = shape.size[0], b = shape.size[1], c = shape.size[2];
+			p[0] = a * std::cos(phi) * std::sin(theta);
+			p[1] = b * std::sin(phi) * std::sin(theta);
+			p[2] = c * std::cos(theta);
+		}
+		else
+		{
+			T r = shape.size[0];
+			p[0] = r * std::sin(phi) * std::cos(theta) * r;
+			p[1] = r * std::sin(phi) * std::sin(theta) * r;
+			p[2] = r * std::cos(phi) * r;
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			p[i] += static_cast<T>(shape.offset[i]);
+		}
+	}
+
+	void ReferenceSurface(const ParametricShape& shape, double s, double t, double p[3])
+	{
+		ShapeSurface(shape, s, t, p);
+	}
+
+	// Central difference of ReferenceSurface along s (ds = 1) or t (ds = 0).
+	DX::float3 ReferenceDerivative(const ParametricShape& shape, double s, double t, bool alongS)
+	{
+		const double h = 1e-5;
+		double a[3], b[3];
+		ReferenceSurface(shape, alongS ? s + h : s, alongS ? t : t + h, a);
+		ReferenceSurface(shape, alongS ? s - h : s, alongS ? t : t - h, b);
+		return DX::float3(static_cast<float>((a[0] - b[0]) / (2.0 * h)), static_cast<float>((a[1] - b[1]) / (2.0 * h)), static_cast<float>((a[2] - b[2]) / (2.0 * h)));
+	}
+
+	int RunParametricEval(int argc, char** argv)
+	{
+		unsigned int columns = std::max(2u, ArgOr(argc, argv, 2, 1024));
+		unsigned int rows = std::max(2u, ArgOr(argc, argv, 3, 1024));
+		const char* surfaceNames[] = { "torus", "ellipsoid", "sphere" };
+
+		Parametric::Parameters grid;
+		grid.MakeGrid(columns, rows);
+		double count = static_cast<double>(grid.GetCount());
+
+		// The domain points of one patch at the default factor, as the domain shader sees them.
+		DX::TessellatorPattern pattern;
+		DX::Tessellator(DX::TessellatorPartitioning::Integer, DX::TessellatorOutput::TriangleCW).Tessellate(DX::TessellatorDomain::Tri,
+			DX::TessellatorFactors::Uniform(static_cast<float>(ParametricDefaultTessFactor)), pattern);
+		Parametric::Parameters patch;
+		patch.FromDomainLocations(pattern.points.data(), pattern.points.size());
+
+		std::printf("%ux%u grid, cpu supports %s\n", columns, rows, DX::SimdLevelName(DX::GetSupportedSimdLevel()));
+
+		for (int shapeIndex = 0; shapeIndex < ParametricShapeCount; shapeIndex++)
+		{
+			const ParametricShape& shape = ParametricShapes[shapeIndex];
+			const char* name = surfaceNames[static_cast<int>(shape.surface)];
+
+			auto time = [&](DX::SimdLevel level, Parametric::Points& points)
+			{
+				double best = 1e30;
+				for (int run = 0; run < 3; run++)
+				{
+					auto start = std::chrono::high_resolution_clock::now();
+					Parametric::Evaluate(shape, grid, points, level);
+					best = std::min(best, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+				}
+				return best;
+			};
+
+			Parametric::Points reference;
+			double scalarSeconds = time(DX::SimdLevel::Scalar, reference);
+			std::printf("%-10s %-7s %2u lanes  %8.2f Mpoints/s\n", name, "scalar", 1u, count / scalarSeconds * 1e-6);
+
+			for (DX::SimdLevel level : { DX::SimdLevel::SSE41, DX::SimdLevel::AVX2, DX::SimdLevel::AVX512 })
+			{
+				if (!DX::IsSimdLevelSupported(level))
+				{
+					continue;
+				}
+
+				Parametric::Points points;
+				double seconds = time(level, points);
+				const std::vector<float>* a[] = { &reference.positionX, &reference.positionY, &reference.positionZ, &reference.normalX, &reference.normalY, &reference.normalZ, &reference.tangentX, &reference.tangentY, &reference.tangentZ, &reference.u, &reference.v };
+				const std::vector<float>* b[] = { &points.positionX, &points.positionY, &points.positionZ, &points.normalX, &points.normalY, &points.normalZ, &points.tangentX, &points.tangentY, &points.tangentZ, &points.u, &points.v };
+				bool identical = true;
+				for (int c = 0; c < 11; c++)
+				{
+					identical = identical && std::memcmp(a[c]->data(), b[c]->data(), a[c]->size() * sizeof(float)) == 0;
+				}
+
+				std::printf("%-10s %-7s %2u lanes  %8.2f Mpoints/s  %5.2fx  %s\n", name, DX::SimdLevelName(level), Parametric::EvaluateLanes(level),
+					count / seconds * 1e-6, scalarSeconds / seconds, identical ? "bit-identical" : "DIFFERS FROM SCALAR");
+			}
+
+			// Positions against double precision; normals and tangents against central differences
+			// of the double precision surface, away from the poles where they are degenerate.
+			float positionError = 0.0f;
+			float normalError = 0.0f;
+			float tangentError = 0.0f;
+			for (size_t i = 0; i < reference.GetCount(); i++)
+			{
+				double s = grid.s[i], t = grid.t[i];
+				double p[3];
+				ReferenceSurface(shape, s, t, p);
+				DX::float3 position = reference.GetPosition(i);
+				positionError = std::max(positionError, static_cast<float>(std::sqrt((position.x - p[0]) * (position.x - p[0]) + (position.y - p[1]) * (position.y - p[1]) + (position.z - p[2]) * (position.z - p[2]))));
+
+				DX::float3 ds = ReferenceDerivative(shape, s, t, true);
+				DX::float3 dt = ReferenceDerivative(shape, s, t, false);
+				DX::float3 n = cross(ds, dt);
+				if (length(n) > 1e-3f && length(ds) > 1e-3f)
+				{
+					// Angles from the cross product, which resolves them better than acos near 1.
+					DX::float3 normal = reference.GetNormal(i);
+					DX::float3 tangent = reference.GetTangent(i);
+					normalError = std::max(normalError, std::asin(std::min(length(cross(normalize(n), normal)), 1.0f)));
+					float tangentAngle = std::asin(std::min(length(cross(normalize(ds), tangent)), 1.0f));
+					tangentError = std::max(tangentError, dot(ds, tangent) < 0.0f ? 3.14159265f - tangentAngle : tangentAngle);
+				}
+			}
+
+			// The domain shader's own float evaluation with the library sin and cos, over a patch.
+			Parametric::Points patchPoints;
+			Parametric::Evaluate(shape, patch, patchPoints);
+			float shaderError = 0.0f;
+			for (size_t i = 0; i < patchPoints.GetCount(); i++)
+			{
+				float s = patch.s[i], t = patch.t[i];
+				float p[3];
+				ShapeSurface(shape, s, t, p);
+				shaderError = std::max(shaderError, length(patchPoints.GetPosition(i) - DX::float3(p[0], p[1], p[2])));
+			}
+
+			const float degrees = 180.0f / 3.14159265f;
+			std::printf("%-10s position error %.2e   normal %.2e deg   tangent %.2e deg   vs float libm over a %zu point patch %.2e\n",
+				name, positionError, normalError * degrees, tangentError * degrees, patch.GetCount(), shaderError);
+		}
+
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* mode = argc > 1 ? argv[1] : "implicit";
+
+	if (std::strcmp(mode, "implicit") == 0)
+	{
+		return RunImplicit(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-scaling") == 0)
+	{
+		return RunImplicitScaling(argc, argv);
+	}
+
+	if (std::strcmp(mode, "implicit-simd") == 0)
+	{
+		return RunImplicitSimd(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-bvh") == 0)
+	{
+		return RunImplicitBvh(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-bvh-hlsl") == 0)
+	{
+		return RunImplicitBvhHlsl(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-bake") == 0)
+	{
+		return RunImplicitBake(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-compiled") == 0)
+	{
+		return RunImplicitCompiled(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-hlsl") == 0)
+	{
+		return RunImplicitHlsl(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-relaxed") == 0)
+	{
+		return RunImplicitRelaxed(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-cone") == 0)
+	{
+		return RunImplicitCone(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-normals") == 0)
+	{
+		return RunImplicitNormals(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-fractal-lod") == 0)
+	{
+		return RunImplicitFractalLod(argc, argv);
+	}
+	if (std::strcmp(mode, "implicit-progressive") == 0)
+	{
+		return RunImplicitProgressive(argc, argv);
+	}
+	if (std::strcmp(mode, "raster") == 0)
+	{
+		return RunRaster(argc, argv);
+	}
+	if (std::strcmp(mode, "tessellate") == 0)
+	{
+		return RunTessellate(argc, argv);
+	}
+	if (std::strcmp(mode, "floor-tess") == 0)
+	{
+		return RunFloorTess(argc, argv);
+	}
+	if (std::strcmp(mode, "parametric-cache") == 0)
+	{
+		return RunParametricCache(argc, argv);
+	}
+	if (std::strcmp(mode, "parametric-eval") == 0)
+	{
+		return RunParametricEval(argc, argv);
+	}
+	if (std::strcmp(mode, "grass-cull") == 0)
+	{
+		return RunGrassCull(argc, argv);
+	}
+	if (std::strcmp(mode, "grass-scatter") == 0)
+	{
+		return RunGrassScatter(argc, argv);
+	}
+	if (std::strcmp(mode, "grass-lod") == 0)
+	{
+		return RunGrassLod(argc, argv);
+	}
+	if (std::strcmp(mode, "geometry-expansion") == 0)
+	{
+		return RunGeometryExpansion(argc, argv);
+	}
+	if (std::strcmp(mode, "snake-swarm") == 0)
+	{
+		return RunSnakeSwarm(argc, argv);
+	}
+	if (std::strcmp(mode, "snake-tube") == 0)
+	{
+		return RunSnakeTube(argc, argv);
+	}
+	if (std::strcmp(mode, "dds") == 0)
+	{
+		return RunDds(argc, argv);
+	}
+	if (std::strcmp(mode, "dds-load") == 0)
+	{
+		return RunDdsLoad(argc, argv);
+	}
+	if (std::strcmp(mode, "bc-decode") == 0)
+	{
+		return RunBlockDecode(argc, argv);
+	}
+
+	std::fprintf(stderr, "unknown mode '%s'\n", mode);
+	return 1;
+}
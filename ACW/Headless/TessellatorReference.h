@@ -0,0 +1,236 @@
+// Reference patterns for "headless tessellate": the domain points and triangle lists the
+// Direct3D 11 reference tessellator (CHWTessellator) produces for a few fractional_odd and
+// fractional_even tri and quad factor sets, in TriangleCW order. They were captured from
+// Mesa's llvmpipe, whose tessellator is a port of CHWTessellator, with transform feedback of
+// gl_TessCoord (point_mode for the points, triangles for the lists, ccw in GL's winding).
+// Points are in 16.16 fixed point, (u, v) pairs; tri points leave out w = 1 - u - v.
+// Two sets sit on a factor halfway between fixed point values, where the rounding matters.
+
+#pragma once
+
+#include "Common/Tessellator.h"
+
+#include <stddef.h>
+
+namespace TessellatorReference
+{
+	struct Pattern
+	{
+		DX::TessellatorDomain		domain;
+		DX::TessellatorPartitioning	partitioning;
+		float						edges[4];
+		float						inside[2];
+		const unsigned int*			points;
+		size_t						pointCount;
+		const unsigned short*		indices;
+		size_t						indexCount;
+	};
+
+	// tri fractional_odd, edges 2.5, 2.5, 2.5, 1.0, inside 2.5, 1.0
+	const unsigned int GoldenPoints0[] =
+	{
+		0, 65536, 0, 49152, 0, 16384, 0, 0, 16384, 0, 49152, 0, 65536, 0, 49152, 16384,
+		16384, 49152, 10923, 43690, 10922, 10923, 43690, 10923
+	};
+	const unsigned short GoldenIndices0[] =
+	{
+		0, 1, 9, 9, 1, 10, 10, 1, 2, 2, 3, 10, 3, 4, 10, 10, 4, 11, 11, 4, 5, 5, 6, 11,
+		6, 7, 11, 11, 7, 9, 9, 7, 8, 8, 0, 9, 9, 10, 11
+	};
+
+	// tri fractional_even, edges 3.7, 3.7, 3.7, 1.0, inside 3.7, 1.0
+	const unsigned int GoldenPoints1[] =
+	{
+		0, 65536, 0, 46694, 0, 32768, 0, 18842, 0, 0, 18842, 0, 32768, 0, 46694, 0,
+		65536, 0, 46694, 18842, 32768, 32768, 18842, 46694, 12561, 40413, 12561, 26487, 12561, 12561, 26487, 12561,
+		40413, 12562, 26487, 26488, 21845, 21845
+	};
+	const unsigned short GoldenIndices1[] =
+	{
+		0, 1, 12, 12, 1, 13, 1, 2, 13, 2, 3, 13, 13, 3, 14, 3, 4, 14, 4, 5, 14, 14, 5, 15,
+		5, 6, 15, 6, 7, 15, 15, 7, 16, 7, 8, 16, 8, 9, 16, 16, 9, 17, 9, 10, 17, 10, 11, 17,
+		17, 11, 12, 11, 0, 12, 12, 13, 18, 13, 14, 18, 14, 15, 18, 15, 16, 18, 16, 17, 18, 17, 12, 18
+	};
+
+	// tri fractional_odd, edges 1.5, 4.2, 9.9, 1.0, inside 3.3, 1.0
+	const unsigned int GoldenPoints2[] =
+	{
+		0, 65536, 0, 60075, 0, 5461, 0, 0, 16602, 0, 24466, 0, 41070, 0, 48934, 0,
+		65536, 0, 58850, 6686, 56169, 9367, 49483, 16053, 42796, 22740, 36110, 29426, 29426, 36110, 22740, 42796,
+		16053, 49483, 9367, 56169, 6686, 58850, 13689, 38157, 13689, 36191, 13689, 15655, 13689, 13689, 15655, 13689,
+		36191, 13689, 38157, 13690, 36191, 15656, 15655, 36192, 15000, 35536, 15000, 15000, 35536, 15000
+	};
+	const unsigned short GoldenIndices2[] =
+	{
+		0, 1, 19, 19, 1, 20, 20, 1, 21, 21, 1, 2, 21, 2, 22, 2, 3, 22, 3, 4, 22, 22, 4, 23,
+		4, 5, 23, 23, 5, 24, 24, 5, 6, 6, 7, 24, 24, 7, 25, 7, 8, 25, 8, 9, 25, 9, 10, 25,
+		10, 11, 25, 25, 11, 26, 11, 12, 26, 12, 13, 26, 26, 13, 27, 27, 13, 14, 14, 15, 27, 15, 16, 27,
+		27, 16, 19, 16, 17, 19, 17, 18, 19, 18, 0, 19, 19, 20, 28, 20, 29, 28, 20, 21, 29, 21, 22, 29,
+		22, 23, 29, 23, 30, 29, 23, 24, 30, 24, 25, 30, 25, 26, 30, 26, 28, 30, 26, 27, 28, 27, 19, 28,
+		28, 29, 30
+	};
+
+	// tri fractional_even, edges 7.3, 2.5, 3.7, 1.0, inside 5.5, 1.0
+	const unsigned int GoldenPoints3[] =
+	{
+		0, 65536, 0, 56388, 0, 47240, 0, 38093, 0, 32768, 0, 27443, 0, 18296, 0, 9148,
+		0, 0, 28672, 0, 32768, 0, 36864, 0, 65536, 0, 46694, 18842, 32768, 32768, 18842, 46694,
+		8192, 49152, 8192, 40959, 8192, 28672, 8192, 16385, 8192, 8192, 16385, 8192, 28672, 8192, 40959, 8192,
+		49152, 8192, 40959, 16385, 28672, 28672, 16385, 40959, 13654, 38228, 13654, 25941, 13654, 13654, 25941, 13654,
+		38228, 13654, 25941, 25941, 21845, 21845
+	};
+	const unsigned short GoldenIndices3[] =
+	{
+		0, 1, 16, 16, 1, 17, 1, 2, 17, 17, 2, 18, 2, 3, 18, 3, 4, 18, 4, 5, 18, 5, 6, 18,
+		18, 6, 19, 6, 7, 19, 19, 7, 20, 7, 8, 20, 8, 9, 20, 20, 9, 21, 21, 9, 22, 9, 10, 22,
+		10, 11, 22, 22, 11, 23, 23, 11, 24, 11, 12, 24, 12, 13, 24, 24, 13, 25, 25, 13, 26, 13, 14, 26,
+		14, 15, 26, 26, 15, 27, 27, 15, 16, 15, 0, 16, 16, 17, 28, 17, 29, 28, 17, 18, 29, 29, 18, 19,
+		29, 19, 30, 19, 20, 30, 20, 21, 30, 21, 31, 30, 21, 22, 31, 31, 22, 23, 31, 23, 32, 23, 24, 32,
+		24, 25, 32, 25, 33, 32, 25, 26, 33, 33, 26, 27, 33, 27, 28, 27, 16, 28, 28, 29, 34, 29, 30, 34,
+		30, 31, 34, 31, 32, 34, 32, 33, 34, 33, 28, 34
+	};
+
+	// tri fractional_odd, edges 2.0028457641601562, 2.0028457641601562, 2.0028457641601562, 1.0, inside 2.0028457641601562, 1.0
+	const unsigned int GoldenPoints4[] =
+	{
+		0, 65536, 0, 54583, 0, 10953, 0, 0, 10953, 0, 54583, 0, 65536, 0, 54583, 10953,
+		10953, 54583, 7302, 50932, 7302, 7302, 50932, 7302
+	};
+	const unsigned short GoldenIndices4[] =
+	{
+		0, 1, 9, 9, 1, 10, 10, 1, 2, 2, 3, 10, 3, 4, 10, 10, 4, 11, 11, 4, 5, 5, 6, 11,
+		6, 7, 11, 11, 7, 9, 9, 7, 8, 8, 0, 9, 9, 10, 11
+	};
+
+	// quad fractional_odd, edges 3.7, 3.7, 3.7, 3.7, inside 3.7, 3.7
+	const unsigned int GoldenPoints5[] =
+	{
+		0, 65536, 0, 46749, 0, 42162, 0, 23374, 0, 18787, 0, 0, 18787, 0, 23374, 0,
+		42162, 0, 46749, 0, 65536, 0, 65536, 18787, 65536, 23374, 65536, 42162, 65536, 46749, 65536, 65536,
+		46749, 65536, 42162, 65536, 23374, 65536, 18787, 65536, 18787, 46749, 18787, 42162, 18787, 23374, 18787, 18787,
+		23374, 18787, 42162, 18787, 46749, 18787, 46749, 23374, 46749, 42162, 46749, 46749, 42162, 46749, 23374, 46749,
+		23374, 42162, 23374, 23374, 42162, 23374, 42162, 42162
+	};
+	const unsigned short GoldenIndices5[] =
+	{
+		0, 1, 20, 20, 1, 21, 1, 2, 21, 21, 2, 22, 22, 2, 3, 3, 4, 22, 22, 4, 23, 4, 5, 23,
+		5, 6, 23, 23, 6, 24, 6, 7, 24, 24, 7, 25, 25, 7, 8, 8, 9, 25, 25, 9, 26, 9, 10, 26,
+		10, 11, 26, 26, 11, 27, 11, 12, 27, 27, 12, 28, 28, 12, 13, 13, 14, 28, 28, 14, 29, 14, 15, 29,
+		15, 16, 29, 29, 16, 30, 16, 17, 30, 30, 17, 31, 31, 17, 18, 18, 19, 31, 31, 19, 20, 19, 0, 20,
+		20, 21, 32, 21, 33, 32, 21, 22, 33, 22, 23, 33, 23, 24, 33, 24, 34, 33, 24, 25, 34, 25, 26, 34,
+		26, 27, 34, 27, 35, 34, 27, 28, 35, 28, 29, 35, 29, 30, 35, 30, 32, 35, 30, 31, 32, 31, 20, 32,
+		32, 34, 35, 32, 33, 34
+	};
+
+	// quad fractional_odd, edges 7.3, 2.5, 3.7, 11.1, inside 5.5, 8.8
+	const unsigned int GoldenPoints6[] =
+	{
+		0, 65536, 0, 56486, 0, 47436, 0, 38386, 0, 37294, 0, 28242, 0, 27150, 0, 18100,
+		0, 9050, 0, 0, 16384, 0, 49152, 0, 65536, 0, 65536, 18787, 65536, 23374, 65536, 42162,
+		65536, 46749, 65536, 65536, 59624, 65536, 53712, 65536, 47800, 65536, 47547, 65536, 41635, 65536, 35723, 65536,
+		29813, 65536, 23901, 65536, 17989, 65536, 17736, 65536, 11824, 65536, 5912, 65536, 12171, 58046, 12171, 50556,
+		12171, 43066, 12171, 36512, 12171, 29024, 12171, 22470, 12171, 14980, 12171, 7490, 14511, 7490, 26682, 7490,
+		38854, 7490, 51025, 7490, 53365, 7490, 53365, 14980, 53365, 22470, 53365, 29024, 53365, 36512, 53365, 43066,
+		53365, 50556, 53365, 58046, 51025, 58046, 38854, 58046, 26682, 58046, 14511, 58046, 14511, 50556, 14511, 43066,
+		14511, 36512, 14511, 29024, 14511, 22470, 14511, 14980, 26682, 14980, 38854, 14980, 51025, 14980, 51025, 22470,
+		51025, 29024, 51025, 36512, 51025, 43066, 51025, 50556, 38854, 50556, 26682, 50556, 26682, 43066, 26682, 36512,
+		26682, 29024, 26682, 22470, 38854, 22470, 38854, 29024, 38854, 36512, 38854, 43066
+	};
+	const unsigned short GoldenIndices6[] =
+	{
+		0, 1, 30, 30, 1, 31, 1, 2, 31, 31, 2, 32, 2, 3, 32, 32, 3, 33, 3, 4, 33, 33, 4, 34,
+		34, 4, 5, 5, 6, 34, 34, 6, 35, 6, 7, 35, 35, 7, 36, 7, 8, 36, 36, 8, 37, 8, 9, 37,
+		9, 10, 37, 37, 10, 38, 38, 10, 39, 39, 10, 40, 40, 10, 11, 40, 11, 41, 41, 11, 42, 11, 12, 42,
+		12, 13, 42, 42, 13, 43, 43, 13, 44, 13, 14, 44, 44, 14, 45, 45, 14, 46, 46, 14, 15, 46, 15, 47,
+		15, 16, 47, 47, 16, 48, 48, 16, 49, 16, 17, 49, 17, 18, 49, 18, 19, 49, 49, 19, 50, 19, 20, 50,
+		20, 21, 50, 50, 21, 51, 21, 22, 51, 22, 23, 51, 51, 23, 52, 52, 23, 24, 24, 25, 52, 25, 26, 52,
+		52, 26, 53, 26, 27, 53, 27, 28, 53, 53, 28, 30, 28, 29, 30, 29, 0, 30, 30, 31, 54, 31, 55, 54,
+		31, 32, 55, 32, 56, 55, 32, 33, 56, 33, 57, 56, 33, 34, 57, 57, 34, 35, 57, 35, 58, 58, 35, 36,
+		58, 36, 59, 36, 37, 59, 37, 38, 59, 38, 60, 59, 38, 39, 60, 39, 61, 60, 39, 40, 61, 61, 40, 41,
+		61, 41, 62, 41, 42, 62, 42, 43, 62, 43, 63, 62, 43, 44, 63, 44, 64, 63, 44, 45, 64, 45, 65, 64,
+		45, 46, 65, 65, 46, 47, 65, 47, 66, 66, 47, 48, 66, 48, 67, 48, 49, 67, 49, 50, 67, 50, 68, 67,
+		50, 51, 68, 51, 69, 68, 51, 52, 69, 69, 52, 53, 69, 53, 54, 53, 30, 54, 54, 55, 70, 55, 71, 70,
+		55, 56, 71, 56, 72, 71, 56, 57, 72, 72, 57, 58, 72, 58, 73, 58, 59, 73, 59, 60, 73, 60, 74, 73,
+		60, 61, 74, 61, 62, 74, 62, 63, 74, 63, 75, 74, 63, 64, 75, 64, 76, 75, 64, 65, 76, 76, 65, 66,
+		76, 66, 77, 66, 67, 77, 67, 68, 77, 68, 70, 77, 68, 69, 70, 69, 54, 70, 70, 71, 77, 77, 71, 76,
+		71, 75, 76, 71, 72, 75, 72, 73, 75, 75, 73, 74
+	};
+
+	// quad fractional_even, edges 2.5, 2.5, 2.5, 2.5, inside 2.5, 2.5
+	const unsigned int GoldenPoints7[] =
+	{
+		0, 65536, 0, 36864, 0, 32768, 0, 28672, 0, 0, 28672, 0, 32768, 0, 36864, 0,
+		65536, 0, 65536, 28672, 65536, 32768, 65536, 36864, 65536, 65536, 36864, 65536, 32768, 65536, 28672, 65536,
+		28672, 36864, 28672, 32768, 28672, 28672, 32768, 28672, 36864, 28672, 36864, 32768, 36864, 36864, 32768, 36864,
+		32768, 32768
+	};
+	const unsigned short GoldenIndices7[] =
+	{
+		0, 1, 16, 16, 1, 17, 1, 2, 17, 2, 3, 17, 17, 3, 18, 3, 4, 18, 4, 5, 18, 18, 5, 19,
+		5, 6, 19, 6, 7, 19, 19, 7, 20, 7, 8, 20, 8, 9, 20, 20, 9, 21, 9, 10, 21, 10, 11, 21,
+		21, 11, 22, 11, 12, 22, 12, 13, 22, 22, 13, 23, 13, 14, 23, 14, 15, 23, 23, 15, 16, 15, 0, 16,
+		16, 17, 24, 17, 18, 24, 18, 19, 24, 19, 20, 24, 20, 21, 24, 21, 22, 24, 22, 23, 24, 23, 16, 24
+	};
+
+	// quad fractional_even, edges 1.5, 4.2, 9.9, 3.3, inside 6.1, 2.7
+	const unsigned int GoldenPoints8[] =
+	{
+		0, 65536, 0, 32768, 0, 0, 15838, 0, 16930, 0, 32768, 0, 48606, 0, 49698, 0,
+		65536, 0, 65536, 6636, 65536, 12862, 65536, 19498, 65536, 26134, 65536, 32768, 65536, 39402, 65536, 46038,
+		65536, 52674, 65536, 58900, 65536, 65536, 43418, 65536, 32768, 65536, 22118, 65536, 10786, 38502, 10786, 32768,
+		10786, 27034, 21573, 27034, 32359, 27034, 32768, 27034, 33177, 27034, 43963, 27034, 54750, 27034, 54750, 32768,
+		54750, 38502, 43963, 38502, 33177, 38502, 32768, 38502, 32359, 38502, 21573, 38502, 21573, 32768, 32359, 32768,
+		32768, 32768, 33177, 32768, 43963, 32768
+	};
+	const unsigned short GoldenIndices8[] =
+	{
+		0, 1, 22, 22, 1, 23, 23, 1, 24, 1, 2, 24, 2, 3, 24, 24, 3, 25, 3, 4, 25, 25, 4, 26,
+		4, 5, 26, 26, 5, 27, 27, 5, 28, 5, 6, 28, 28, 6, 29, 6, 7, 29, 29, 7, 30, 7, 8, 30,
+		8, 9, 30, 9, 10, 30, 10, 11, 30, 30, 11, 31, 11, 12, 31, 12, 13, 31, 13, 14, 31, 14, 15, 31,
+		31, 15, 32, 15, 16, 32, 16, 17, 32, 17, 18, 32, 18, 19, 32, 32, 19, 33, 33, 19, 34, 19, 20, 34,
+		34, 20, 35, 35, 20, 36, 20, 21, 36, 36, 21, 37, 37, 21, 22, 21, 0, 22, 22, 23, 38, 23, 24, 38,
+		24, 25, 38, 25, 39, 38, 25, 26, 39, 26, 40, 39, 26, 27, 40, 40, 27, 28, 40, 28, 41, 41, 28, 29,
+		41, 29, 42, 29, 30, 42, 30, 31, 42, 31, 32, 42, 32, 33, 42, 33, 41, 42, 33, 34, 41, 34, 40, 41,
+		34, 35, 40, 40, 35, 36, 40, 36, 39, 39, 36, 37, 39, 37, 38, 37, 22, 38
+	};
+
+	// quad fractional_even, edges 2.0039749145507812, 2.0039749145507812, 2.0039749145507812, 2.0039749145507812, inside 2.0039749145507812, 2.0039749145507812
+	const unsigned int GoldenPoints9[] =
+	{
+		0, 65536, 0, 32800, 0, 32768, 0, 32736, 0, 0, 32736, 0, 32768, 0, 32800, 0,
+		65536, 0, 65536, 32736, 65536, 32768, 65536, 32800, 65536, 65536, 32800, 65536, 32768, 65536, 32736, 65536,
+		32736, 32800, 32736, 32768, 32736, 32736, 32768, 32736, 32800, 32736, 32800, 32768, 32800, 32800, 32768, 32800,
+		32768, 32768
+	};
+	const unsigned short GoldenIndices9[] =
+	{
+		0, 1, 16, 16, 1, 17, 1, 2, 17, 2, 3, 17, 17, 3, 18, 3, 4, 18, 4, 5, 18, 18, 5, 19,
+		5, 6, 19, 6, 7, 19, 19, 7, 20, 7, 8, 20, 8, 9, 20, 20, 9, 21, 9, 10, 21, 10, 11, 21,
+		21, 11, 22, 11, 12, 22, 12, 13, 22, 22, 13, 23, 13, 14, 23, 14, 15, 23, 23, 15, 16, 15, 0, 16,
+		16, 17, 24, 17, 18, 24, 18, 19, 24, 19, 20, 24, 20, 21, 24, 21, 22, 24, 22, 23, 24, 23, 16, 24
+	};
+
+	const Pattern Patterns[] =
+	{
+		{ DX::TessellatorDomain::Tri, DX::TessellatorPartitioning::FractionalOdd, { 2.5f, 2.5f, 2.5f, 1.0f }, { 2.5f, 1.0f },
+			GoldenPoints0, sizeof(GoldenPoints0) / sizeof(GoldenPoints0[0]) / 2, GoldenIndices0, sizeof(GoldenIndices0) / sizeof(GoldenIndices0[0]) },
+		{ DX::TessellatorDomain::Tri, DX::TessellatorPartitioning::FractionalEven, { 3.7f, 3.7f, 3.7f, 1.0f }, { 3.7f, 1.0f },
+			GoldenPoints1, sizeof(GoldenPoints1) / sizeof(GoldenPoints1[0]) / 2, GoldenIndices1, sizeof(GoldenIndices1) / sizeof(GoldenIndices1[0]) },
+		{ DX::TessellatorDomain::Tri, DX::TessellatorPartitioning::FractionalOdd, { 1.5f, 4.2f, 9.9f, 1.0f }, { 3.3f, 1.0f },
+			GoldenPoints2, sizeof(GoldenPoints2) / sizeof(GoldenPoints2[0]) / 2, GoldenIndices2, sizeof(GoldenIndices2) / sizeof(GoldenIndices2[0]) },
+		{ DX::TessellatorDomain::Tri, DX::TessellatorPartitioning::FractionalEven, { 7.3f, 2.5f, 3.7f, 1.0f }, { 5.5f, 1.0f },
+			GoldenPoints3, sizeof(GoldenPoints3) / sizeof(GoldenPoints3[0]) / 2, GoldenIndices3, sizeof(GoldenIndices3) / sizeof(GoldenIndices3[0]) },
+		{ DX::TessellatorDomain::Tri, DX::TessellatorPartitioning::FractionalOdd, { 2.0028457641601562f, 2.0028457641601562f, 2.0028457641601562f, 1.0f }, { 2.0028457641601562f, 1.0f },
+			GoldenPoints4, sizeof(GoldenPoints4) / sizeof(GoldenPoints4[0]) / 2, GoldenIndices4, sizeof(GoldenIndices4) / sizeof(GoldenIndices4[0]) },
+		{ DX::TessellatorDomain::Quad, DX::TessellatorPartitioning::FractionalOdd, { 3.7f, 3.7f, 3.7f, 3.7f }, { 3.7f, 3.7f },
+			GoldenPoints5, sizeof(GoldenPoints5) / sizeof(GoldenPoints5[0]) / 2, GoldenIndices5, sizeof(GoldenIndices5) / sizeof(GoldenIndices5[0]) },
+		{ DX::TessellatorDomain::Quad, DX::TessellatorPartitioning::FractionalOdd, { 7.3f, 2.5f, 3.7f, 11.1f }, { 5.5f, 8.8f },
+			GoldenPoints6, sizeof(GoldenPoints6) / sizeof(GoldenPoints6[0]) / 2, GoldenIndices6, sizeof(GoldenIndices6) / sizeof(GoldenIndices6[0]) },
+		{ DX::TessellatorDomain::Quad, DX::TessellatorPartitioning::FractionalEven, { 2.5f, 2.5f, 2.5f, 2.5f }, { 2.5f, 2.5f },
+			GoldenPoints7, sizeof(GoldenPoints7) / sizeof(GoldenPoints7[0]) / 2, GoldenIndices7, sizeof(GoldenIndices7) / sizeof(GoldenIndices7[0]) },
+		{ DX::TessellatorDomain::Quad, DX::TessellatorPartitioning::FractionalEven, { 1.5f, 4.2f, 9.9f, 3.3f }, { 6.1f, 2.7f },
+			GoldenPoints8, sizeof(GoldenPoints8) / sizeof(GoldenPoints8[0]) / 2, GoldenIndices8, sizeof(GoldenIndices8) / sizeof(GoldenIndices8[0]) },
+		{ DX::TessellatorDomain::Quad, DX::TessellatorPartitioning::FractionalEven, { 2.0039749145507812f, 2.0039749145507812f, 2.0039749145507812f, 2.0039749145507812f }, { 2.0039749145507812f, 2.0039749145507812f },
+			GoldenPoints9, sizeof(GoldenPoints9) / sizeof(GoldenPoints9[0]) / 2, GoldenIndices9, sizeof(GoldenIndices9) / sizeof(GoldenIndices9[0]) }
+	};
+}